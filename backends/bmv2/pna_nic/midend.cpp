@@ -135,8 +135,14 @@ PnaNicMidEnd::PnaNicMidEnd(CompilerOptions &options, std::ostream *outStream)
             new P4::MoveDeclarations(),  // more may have been introduced
             new P4::ConstantFolding(&typeMap),
             new P4::LocalCopyPropagation(&typeMap, nullptr, policy),
-            new PassRepeated(
-                {new P4::ConstantFolding(&typeMap), new P4::StrengthReduction(&typeMap)}),
+            new PassRepeated({
+                new P4::TypeChecking(nullptr, &typeMap, true),
+                new FusedTransforms({
+                    new P4::DoConstantFolding(&typeMap),
+                    new P4::DoStrengthReduction(&typeMap, nullptr),
+                }),
+                new P4::ClearTypeMap(&typeMap),
+            }),
             new P4::MoveDeclarations(),
             new P4::ValidateTableProperties({"pna_implementation"_cs, "pna_direct_counter"_cs,
                                              "pna_direct_meter"_cs, "pna_idle_timeout"_cs,
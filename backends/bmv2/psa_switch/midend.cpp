@@ -137,8 +137,12 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options, std::ostream *outStre
             new P4::TypeChecking(&refMap, &typeMap),  // policy below relies on fresh refmap
             new P4::LocalCopyPropagation(&typeMap, nullptr, policy),
             new PassRepeated({
-                new P4::ConstantFolding(&typeMap),
-                new P4::StrengthReduction(&typeMap),
+                new P4::TypeChecking(nullptr, &typeMap, true),
+                new FusedTransforms({
+                    new P4::DoConstantFolding(&typeMap),
+                    new P4::DoStrengthReduction(&typeMap, nullptr),
+                }),
+                new P4::ClearTypeMap(&typeMap),
             }),
             new P4::MoveDeclarations(),
             new P4::ValidateTableProperties({
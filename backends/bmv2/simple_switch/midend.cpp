@@ -102,8 +102,12 @@ SimpleSwitchMidEnd::SimpleSwitchMidEnd(CompilerOptions &options, std::ostream *o
              new P4::ConstantFolding(&typeMap),
              new P4::LocalCopyPropagation(&typeMap),
              new PassRepeated({
-                 new P4::ConstantFolding(&typeMap),
-                 new P4::StrengthReduction(&typeMap),
+                 new P4::TypeChecking(nullptr, &typeMap, true),
+                 new FusedTransforms({
+                     new P4::DoConstantFolding(&typeMap),
+                     new P4::DoStrengthReduction(&typeMap, nullptr),
+                 }),
+                 new P4::ClearTypeMap(&typeMap),
              }),
              new P4::SimplifyKey(&typeMap,
                                  new P4::OrPolicy(new P4::IsValid(&typeMap), new P4::IsMask())),
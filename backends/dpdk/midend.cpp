@@ -200,8 +200,12 @@ DpdkMidEnd::DpdkMidEnd(CompilerOptions &options, std::ostream *outStream) {
             new P4::ConstantFolding(&typeMap),
             new P4::LocalCopyPropagation(&typeMap, nullptr, policy),
             new PassRepeated({
-                new P4::ConstantFolding(&typeMap),
-                new P4::StrengthReduction(&typeMap),
+                new P4::TypeChecking(nullptr, &typeMap, true),
+                new FusedTransforms({
+                    new P4::DoConstantFolding(&typeMap),
+                    new P4::DoStrengthReduction(&typeMap, nullptr),
+                }),
+                new P4::ClearTypeMap(&typeMap),
             }),
             new P4::MoveDeclarations(),
             validateTableProperties(options.arch),
@@ -5,16 +5,20 @@
 
 #include "p4test.h"
 
+#include <cstring>
 #include <fstream>  // IWYU pragma: keep
 #include <iostream>
+#include <optional>
 
 #include "backends/p4test/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compilationCache.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/evaluator/evaluator.h"
 #include "frontends/p4/frontend.h"
 #include "frontends/p4/toP4/toP4.h"
+#include "ir/binary_snapshot.h"
 #include "ir/dump.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
@@ -26,6 +30,8 @@
 #include "lib/log.h"
 #include "lib/nullstream.h"
 #include "midend.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.pb.h"
 
 P4TestOptions::P4TestOptions() {
     registerOption(
@@ -60,6 +66,25 @@ P4TestOptions::P4TestOptions() {
             return true;
         },
         "read previously dumped json instead of P4 source code");
+    registerOption(
+        "--fromBinary", "file",
+        [this](const char *arg) {
+            loadIRFromBinary = true;
+            file = arg;
+            return true;
+        },
+        "read a binary snapshot written by --toBinary instead of P4 source code");
+    registerOption(
+        "--toBinary", "file",
+        [this](const char *arg) {
+            dumpBinaryFile = arg;
+            return true;
+        },
+        "Dump the compiler IR after the midend as a binary snapshot in the specified file.\n"
+        "Snapshots are much faster to write and load than JSON, but can only be loaded by\n"
+        "a compiler built from the same IR definition.", OptionFlags::BackendOnly);
+    // Directory of the compilation cache; empty if it is not used.
+    std::filesystem::path cacheDir;
     registerOption(
         "--turn-off-logn", nullptr,
         [](const char *) {
@@ -75,10 +100,10 @@ P4TestOptions::P4TestOptions() {
             preferSwitch = true;
             return true;
         },
-        "use passes that use general switch instead of action_run");
+        "use passes that use general switch instead of action_run", OptionFlags::MidendOnly);
     registerOption(
         "--keepTuples", nullptr, [this](const char *) { return keepTuples = true; },
-        "keep tuple type, but flatten assignments of them");
+        "keep tuple type, but flatten assignments of them", OptionFlags::MidendOnly);
 }
 
 class P4TestPragmas : public P4::P4COptionPragmaParser {
@@ -130,6 +155,44 @@ static void log_dump(const IR::Node *node, const char *head) {
     }
 }
 
+/// Writes the P4Runtime files requested by @p options. With a compilation cache, the P4Runtime
+/// API is taken from @p cached, the "p4runtime" entry of @p cache, if present; otherwise it is
+/// generated from the frontend result @p program and saved in the cache.
+static void serializeP4Runtime(const IR::P4Program *program, const P4TestOptions &options,
+                               P4::CompilationCache *cache,
+                               const std::optional<std::string> &cached) {
+    if (!cache || !options.controlPlaneAPIGenEnabled()) {
+        P4::serializeP4RuntimeIfRequired(program, options);
+        return;
+    }
+    auto *serializer = P4::P4RuntimeSerializer::get();
+    // The entry is the size of the serialized P4Info message, the message and the serialized
+    // WriteRequest message with the static entries.
+    if (cached && cached->size() >= sizeof(uint64_t)) {
+        uint64_t size;
+        memcpy(&size, cached->data(), sizeof(size));
+        std::string_view rest = std::string_view(*cached).substr(sizeof(size));
+        auto *p4Info = new p4::config::v1::P4Info;
+        auto *entries = new p4::v1::WriteRequest;
+        if (size <= rest.size() && p4Info->ParseFromArray(rest.data(), size) &&
+            entries->ParseFromArray(rest.data() + size, rest.size() - size)) {
+            serializer->serializeP4RuntimeIfRequired(P4::P4RuntimeAPI(p4Info, entries), options);
+            return;
+        }
+    }
+    auto p4Runtime =
+        serializer->generateP4Runtime(program, P4::P4RuntimeSerializer::resolveArch(options));
+    if (::P4::errorCount() == 0) {
+        std::string p4Info = p4Runtime.p4Info->SerializeAsString();
+        uint64_t size = p4Info.size();
+        std::string entry(reinterpret_cast<const char *>(&size), sizeof(size));
+        entry += p4Info;
+        entry += p4Runtime.entries->SerializeAsString();
+        cache->storeData("p4runtime", entry);
+    }
+    serializer->serializeP4RuntimeIfRequired(p4Runtime, options);
+}
+
 int main(int argc, char *const argv[]) {
     setup_gc_logging();
     setup_signals();
@@ -140,12 +203,27 @@ int main(int argc, char *const argv[]) {
     options.compilerVersion = cstring(P4TEST_VERSION_STRING);
 
     if (options.process(argc, argv) != nullptr) {
-        if (options.loadIRFromJson == false) options.setInputFile();
+        if (!options.loadIRFromJson && !options.loadIRFromBinary) options.setInputFile();
     }
     if (::P4::errorCount() > 0) return 1;
+    std::optional<P4::CompilationCache> cache;
+    std::optional<std::string> cachedP4Runtime;
+    // The pretty-printed program is written by the frontend, which a cache hit skips.
+    if (!options.cacheDir.empty() && !options.loadIRFromJson && !options.loadIRFromBinary &&
+        !options.parseOnly && options.prettyPrintFile.empty()) {
+        cache.emplace(options.cacheDir, options);
+        if (!cache->readSource()) return 1;
+        if (options.controlPlaneAPIGenEnabled()) cachedP4Runtime = cache->loadData("p4runtime");
+    }
     const IR::P4Program *program = nullptr;
+    bool cachedMidend = false;
     auto hook = options.getDebugHook();
-    if (options.loadIRFromJson) {
+    if (options.loadIRFromBinary) {
+        if (auto *node = loadBinarySnapshot(options.file)) {
+            if (!(program = node->to<IR::P4Program>()))
+                error(ErrorType::ERR_INVALID, "%s is not a P4Program snapshot", options.file);
+        }
+    } else if (options.loadIRFromJson) {
         std::ifstream json(options.file);
         if (json) {
             JsonData::strict = true;
@@ -157,13 +235,21 @@ int main(int argc, char *const argv[]) {
         } else {
             error(ErrorType::ERR_IO, "Can't open %s", options.file);
         }
+    } else if (cache && (!options.controlPlaneAPIGenEnabled() || cachedP4Runtime) &&
+               (program = cache->loadMidend())) {
+        // The P4Runtime API is generated from the frontend result, so the midend result can
+        // only be used if the API has been cached too.
+        cachedMidend = true;
+    } else if (cache && (program = cache->loadFrontend())) {
+        if (Log::verbose()) std::cerr << "Using cached frontend result" << std::endl;
     } else {
         P4::DiagnosticCountInfo info;
-        program = P4::parseP4File(options);
+        program = cache ? cache->parse() : P4::parseP4File(options);
         info.emitInfo("PARSER");
 
         if (program != nullptr && ::P4::errorCount() == 0) {
             P4TestPragmas testPragmas;
+            size_t firstPragmaOption = options.processedOptionCount();
             program->apply(P4::ApplyOptionsPragmas(testPragmas));
             info.emitInfo("PASS P4COptionPragmaParser");
 
@@ -176,6 +262,8 @@ int main(int argc, char *const argv[]) {
                     // this hook
                     fe.addDebugHook(info.getPassManagerHook());
                     program = fe.run(options, program);
+                    if (cache && program && ::P4::errorCount() == 0)
+                        cache->storeFrontend(program, firstPragmaOption);
                 } catch (const std::exception &bug) {
                     std::cerr << bug.what() << std::endl;
                     return 1;
@@ -186,9 +274,12 @@ int main(int argc, char *const argv[]) {
 
     log_dump(program, "Initial program");
     if (program != nullptr && ::P4::errorCount() == 0) {
-        P4::serializeP4RuntimeIfRequired(program, options);
+        serializeP4Runtime(program, options, cache ? &*cache : nullptr, cachedP4Runtime);
 
-        if (!options.parseOnly && !options.validateOnly) {
+        if (cachedMidend) {
+            if (Log::verbose()) std::cerr << "Using cached midend result" << std::endl;
+            log_dump(program, "After midend");
+        } else if (!options.parseOnly && !options.validateOnly) {
             P4Test::MidEnd midEnd(options);
             midEnd.addDebugHook(hook);
 #if 0
@@ -204,6 +295,7 @@ int main(int argc, char *const argv[]) {
             const IR::ToplevelBlock *top = nullptr;
             try {
                 top = midEnd.process(program);
+                if (cache && program && ::P4::errorCount() == 0) cache->storeMidend(program);
                 // This can modify program!
                 log_dump(program, "After midend");
                 log_dump(top, "Top level block");
@@ -217,6 +309,8 @@ int main(int argc, char *const argv[]) {
                 auto dumpJsonStream = openFile(options.dumpJsonFile, true);
                 JSONGenerator(*dumpJsonStream, true).emit(program);
             }
+            if (!options.dumpBinaryFile.empty())
+                saveBinarySnapshot(options.dumpBinaryFile, program);
             if (options.debugJson) {
                 std::stringstream ss1, ss2;
                 JSONGenerator gen1(ss1), gen2(ss2);
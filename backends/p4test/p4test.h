@@ -8,6 +8,8 @@
 #ifndef BACKENDS_P4TEST_P4TEST_H_
 #define BACKENDS_P4TEST_P4TEST_H_
 
+#include <filesystem>
+
 #include "frontends/common/options.h"
 
 using namespace P4;
@@ -17,8 +19,13 @@ class P4TestOptions : public CompilerOptions {
     bool parseOnly = false;
     bool validateOnly = false;
     bool loadIRFromJson = false;
+    bool loadIRFromBinary = false;
     bool preferSwitch = false;
     bool keepTuples = false;  // keep tuples but flatten assignments of them
+    // Dump a binary snapshot of the IR after the midend in the file.
+    std::filesystem::path dumpBinaryFile;
+    // Directory of the compilation cache; empty if it is not used.
+    std::filesystem::path cacheDir;
     P4TestOptions();
 };
 
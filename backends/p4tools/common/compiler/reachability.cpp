@@ -1,6 +1,8 @@
 #include "backends/p4tools/common/compiler/reachability.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <string>
@@ -360,6 +362,119 @@ void P4ProgramDCGCreator::addEdge(DCGVertexType vertex, const IR::ID &vertexName
     dcg->addToHash(vertex, vertexName);
 }
 
+TargetDistances::TargetDistances(const NodesCallGraph &dcg, const DCGVertexTypeSet &targets) {
+    auto indexOf = [this](DCGVertexType vertex) {
+        auto [it, inserted] = index.emplace(vertex, successors.size());
+        if (inserted) {
+            successors.emplace_back();
+            predecessors.emplace_back();
+        }
+        return it->second;
+    };
+    for (const auto *vertex : dcg.getNodes()) {
+        indexOf(vertex);
+    }
+    for (const auto &[caller, callees] : dcg.getOutEdges()) {
+        auto from = indexOf(caller);
+        for (const auto *callee : *callees) {
+            auto to = indexOf(callee);
+            successors[from].push_back(to);
+            predecessors[to].push_back(from);
+        }
+    }
+
+    isTarget.assign(successors.size(), false);
+    distances.assign(successors.size(), UNREACHABLE);
+    nearest.assign(successors.size(), NONE);
+    std::vector<std::pair<uint32_t, uint32_t>> queued;
+    for (const auto *target : targets) {
+        auto it = index.find(target);
+        if (it == index.end() || isTarget[it->second]) {
+            continue;
+        }
+        isTarget[it->second] = true;
+        ++remainingTargets;
+        distances[it->second] = 0;
+        nearest[it->second] = it->second;
+        queued.emplace_back(0, it->second);
+    }
+    propagate(std::move(queued));
+}
+
+bool TargetDistances::contains(DCGVertexType vertex) const { return index.count(vertex) != 0; }
+
+uint32_t TargetDistances::distance(DCGVertexType vertex) const {
+    auto it = index.find(vertex);
+    return it == index.end() ? UNREACHABLE : distances[it->second];
+}
+
+size_t TargetDistances::targetCount() const { return remainingTargets; }
+
+void TargetDistances::removeTargets(const std::vector<DCGVertexType> &vertices) {
+    std::vector<bool> removed(isTarget.size(), false);
+    bool anyRemoved = false;
+    for (const auto *vertex : vertices) {
+        auto it = index.find(vertex);
+        if (it == index.end() || !isTarget[it->second]) {
+            continue;
+        }
+        isTarget[it->second] = false;
+        removed[it->second] = true;
+        --remainingTargets;
+        anyRemoved = true;
+    }
+    if (!anyRemoved) {
+        return;
+    }
+
+    // Distances only grow when targets are removed. The vertices whose nearest target remains
+    // keep their distance, all other vertices are reset.
+    std::vector<uint32_t> affected;
+    for (uint32_t vertex = 0; vertex < nearest.size(); ++vertex) {
+        if (nearest[vertex] != NONE && removed[nearest[vertex]]) {
+            affected.push_back(vertex);
+            distances[vertex] = UNREACHABLE;
+            nearest[vertex] = NONE;
+        }
+    }
+    // The reset vertices reach a remaining target through a successor that has one.
+    std::vector<std::pair<uint32_t, uint32_t>> queued;
+    for (auto vertex : affected) {
+        for (auto successor : successors[vertex]) {
+            if (nearest[successor] != NONE && distances[successor] + 1 < distances[vertex]) {
+                distances[vertex] = distances[successor] + 1;
+                nearest[vertex] = nearest[successor];
+            }
+        }
+        if (nearest[vertex] != NONE) {
+            queued.emplace_back(distances[vertex], vertex);
+        }
+    }
+    propagate(std::move(queued));
+}
+
+void TargetDistances::propagate(std::vector<std::pair<uint32_t, uint32_t>> queued) {
+    // Dijkstra's algorithm on the reversed edges.
+    std::greater<> later;
+    std::make_heap(queued.begin(), queued.end(), later);
+    while (!queued.empty()) {
+        std::pop_heap(queued.begin(), queued.end(), later);
+        auto [distance, vertex] = queued.back();
+        queued.pop_back();
+        if (distance > distances[vertex]) {
+            continue;
+        }
+        for (auto predecessor : predecessors[vertex]) {
+            if (distance + 1 < distances[predecessor]) {
+                distances[predecessor] = distance + 1;
+                nearest[predecessor] = nearest[vertex];
+                queued.emplace_back(distance + 1, predecessor);
+                std::push_heap(queued.begin(), queued.end(), later);
+            }
+        }
+    }
+}
+
 ReachabilityEngineState *ReachabilityEngineState::getInitial() {
     auto *newState = new ReachabilityEngineState();
     newState->prevNode = nullptr;
@@ -1,12 +1,15 @@
 #ifndef BACKENDS_P4TOOLS_COMMON_COMPILER_REACHABILITY_H_
 #define BACKENDS_P4TOOLS_COMMON_COMPILER_REACHABILITY_H_
 
+#include <cstdint>
+#include <limits>
 #include <list>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "frontends/common/resolveReferences/resolveReferences.h"
 #include "frontends/p4/callGraph.h"
@@ -86,6 +89,59 @@ class ExtendedCallGraph : public P4::CallGraph<T> {
 
 using NodesCallGraph = ExtendedCallGraph<DCGVertexType>;
 
+/// The shortest distances in a NodesCallGraph from every vertex to the nearest vertex of a set of
+/// targets. The distance of a vertex is the number of edges on the shortest path. Removing
+/// targets only recomputes the distances of the vertices whose nearest target was removed.
+class TargetDistances {
+ public:
+    /// The distance of vertices that can not reach any target.
+    static constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+    /// Computes the distances to the @p targets in @p dcg. Targets that are not vertices of
+    /// @p dcg are ignored.
+    TargetDistances(const NodesCallGraph &dcg, const DCGVertexTypeSet &targets);
+
+    /// @returns true if @p vertex is a vertex of the graph.
+    [[nodiscard]] bool contains(DCGVertexType vertex) const;
+
+    /// @returns the distance from @p vertex to the nearest target, or UNREACHABLE if @p vertex
+    /// can not reach any target or is not a vertex of the graph.
+    [[nodiscard]] uint32_t distance(DCGVertexType vertex) const;
+
+    /// @returns the number of remaining targets.
+    [[nodiscard]] size_t targetCount() const;
+
+    /// Removes @p vertices from the targets and updates the affected distances. Vertices that are
+    /// not targets are ignored.
+    void removeTargets(const std::vector<DCGVertexType> &vertices);
+
+ private:
+    /// The vertices without a nearest target.
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    /// Maps each vertex to its index in the vectors below.
+    std::unordered_map<DCGVertexType, uint32_t> index;
+
+    std::vector<std::vector<uint32_t>> successors;
+
+    std::vector<std::vector<uint32_t>> predecessors;
+
+    std::vector<bool> isTarget;
+
+    size_t remainingTargets = 0;
+
+    /// The distance of each vertex to its nearest target.
+    std::vector<uint32_t> distances;
+
+    /// The index of the nearest target of each vertex.
+    std::vector<uint32_t> nearest;
+
+    /// Propagates the distances of the @p queued vertices backwards to their predecessors, as long
+    /// as this shortens the distance of the predecessor. @p queued holds pairs of distances and
+    /// vertices.
+    void propagate(std::vector<std::pair<uint32_t, uint32_t>> queued);
+};
+
 /// The main class for building control flow DCG.
 class P4ProgramDCGCreator : public Inspector, private P4::ResolutionContext {
     NodesCallGraph *dcg;
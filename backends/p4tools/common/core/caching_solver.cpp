@@ -0,0 +1,286 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/common/core/caching_solver.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <unordered_set>
+#include <utility>
+
+#include "backends/p4tools/common/lib/hash_cons.h"
+#include "backends/p4tools/common/lib/logging.h"
+#include "backends/p4tools/common/lib/model.h"
+#include "ir/ir.h"
+#include "ir/visitor.h"
+#include "lib/exceptions.h"
+#include "lib/timer.h"
+
+namespace P4::P4Tools {
+
+namespace {
+
+PerformanceCounter QUERIES("solver_queries");
+PerformanceCounter GROUPS("solver_independent_groups");
+PerformanceCounter EXACT_HITS("solver_cache_exact_hits", &GROUPS);
+PerformanceCounter DERIVED_HITS("solver_cache_derived_hits", &GROUPS);
+PerformanceCounter MISSES("solver_cache_misses", &GROUPS);
+
+/// Collects the symbolic variables of an expression.
+class CollectSymbolicVariables : public Inspector {
+    std::vector<const IR::SymbolicVariable *> &result;
+
+ public:
+    explicit CollectSymbolicVariables(std::vector<const IR::SymbolicVariable *> &result)
+        : result(result) {}
+
+    bool preorder(const IR::SymbolicVariable *var) override {
+        result.push_back(var);
+        return false;
+    }
+};
+
+}  // namespace
+
+CachingSolver::CachingSolver(AbstractSolver &solver) : solver(solver) {}
+
+void CachingSolver::comment(cstring comment) { solver.comment(comment); }
+
+void CachingSolver::seed(unsigned seed) { solver.seed(seed); }
+
+void CachingSolver::timeout(unsigned tm) { solver.timeout(tm); }
+
+const SymbolicMapping &CachingSolver::getSymbolicMapping() const { return model; }
+
+void CachingSolver::toJSON(JSONGenerator &json) const { solver.toJSON(json); }
+
+bool CachingSolver::isInIncrementalMode() const { return solver.isInIncrementalMode(); }
+
+AbstractSolver &CachingSolver::getBackingSolver() const { return solver; }
+
+void CachingSolver::clear() {
+    variables.clear();
+    entries.clear();
+    exact.clear();
+    containing.clear();
+}
+
+size_t CachingSolver::ConstraintSetHash::operator()(const ConstraintSet &constraints) const {
+    size_t hash = constraints.size();
+    for (const auto *constraint : constraints) {
+        hash ^= std::hash<const Constraint *>()(constraint) + 0x9e3779b97f4a7c15ULL +
+                (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+const Constraint *CachingSolver::intern(const Constraint *constraint) {
+    const auto *representative = HashCons::intern(constraint);
+    auto [it, inserted] = variables.try_emplace(representative);
+    if (inserted) {
+        representative->apply(CollectSymbolicVariables(it->second));
+    }
+    return representative;
+}
+
+std::vector<std::vector<const Constraint *>> CachingSolver::partition(
+    const std::vector<const Constraint *> &constraints) const {
+    // Union-find over the indices of the constraints.
+    std::vector<size_t> parent(constraints.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    std::function<size_t(size_t)> find = [&](size_t i) {
+        return parent[i] == i ? i : parent[i] = find(parent[i]);
+    };
+    std::unordered_map<cstring, size_t> owner;
+    for (size_t i = 0; i < constraints.size(); ++i) {
+        for (const auto *var : variables.at(constraints[i])) {
+            auto [it, inserted] = owner.emplace(var->label, i);
+            if (!inserted) {
+                parent[find(i)] = find(it->second);
+            }
+        }
+    }
+
+    std::vector<std::vector<const Constraint *>> groups;
+    std::unordered_map<size_t, size_t> groupOf;
+    for (size_t i = 0; i < constraints.size(); ++i) {
+        auto [it, inserted] = groupOf.emplace(find(i), groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(constraints[i]);
+    }
+    return groups;
+}
+
+bool CachingSolver::satisfies(const SymbolicMapping &model,
+                              const std::vector<const Constraint *> &constraints) const {
+    for (const auto *constraint : constraints) {
+        for (const auto *var : variables.at(constraint)) {
+            if (model.find(var) == model.end()) {
+                return false;
+            }
+        }
+    }
+    const Model evaluator(model);
+    try {
+        for (const auto *constraint : constraints) {
+            const auto *value = evaluator.evaluate(constraint, false)->to<IR::BoolLiteral>();
+            if (value == nullptr || !value->value) {
+                return false;
+            }
+        }
+    } catch (const Util::P4CExceptionBase &) {
+        // Not every constraint can be evaluated to a literal, e.g., comparisons of strings.
+        return false;
+    }
+    return true;
+}
+
+const CachingSolver::Entry *CachingSolver::lookup(const ConstraintSet &group) {
+    auto it = exact.find(group);
+    if (it != exact.end()) {
+        EXACT_HITS.add();
+        return it->second;
+    }
+
+    // Compare against the cached groups that share a constraint with this group.
+    std::optional<bool> satisfiable;
+    const SymbolicMapping *model = nullptr;
+    std::unordered_set<const Entry *> seen;
+    for (const auto *constraint : group) {
+        auto candidates = containing.find(constraint);
+        if (candidates == containing.end()) {
+            continue;
+        }
+        for (const auto *entry : candidates->second) {
+            if (seen.size() >= MAX_CANDIDATES) {
+                break;
+            }
+            if (!seen.insert(entry).second) {
+                continue;
+            }
+            const auto &cached = entry->constraints;
+            bool isSubset = std::includes(group.begin(), group.end(), cached.begin(), cached.end());
+            if (!entry->satisfiable) {
+                if (isSubset) {
+                    satisfiable = false;
+                    break;
+                }
+                continue;
+            }
+            if (std::includes(cached.begin(), cached.end(), group.begin(), group.end())) {
+                satisfiable = true;
+                model = &entry->model;
+                break;
+            }
+            if (isSubset) {
+                std::vector<const Constraint *> remaining;
+                std::set_difference(group.begin(), group.end(), cached.begin(), cached.end(),
+                                    std::back_inserter(remaining));
+                if (satisfies(entry->model, remaining)) {
+                    satisfiable = true;
+                    model = &entry->model;
+                    break;
+                }
+            }
+        }
+        if (satisfiable.has_value() || seen.size() >= MAX_CANDIDATES) {
+            break;
+        }
+    }
+    if (!satisfiable.has_value()) {
+        return nullptr;
+    }
+    DERIVED_HITS.add();
+    return insert(group, *satisfiable, *satisfiable ? *model : SymbolicMapping());
+}
+
+SymbolicMapping CachingSolver::restrictTo(const SymbolicMapping &model,
+                                          const ConstraintSet &group) const {
+    SymbolicMapping result;
+    for (const auto *constraint : group) {
+        for (const auto *var : variables.at(constraint)) {
+            auto it = model.find(var);
+            if (it != model.end()) {
+                result.insert(*it);
+            }
+        }
+    }
+    return result;
+}
+
+const CachingSolver::Entry *CachingSolver::insert(ConstraintSet group, bool satisfiable,
+                                                  const SymbolicMapping &model) {
+    auto groupModel = satisfiable ? restrictTo(model, group) : SymbolicMapping();
+    const auto &entry =
+        entries.emplace_back(Entry{std::move(group), satisfiable, std::move(groupModel)});
+    exact.emplace(entry.constraints, &entry);
+    for (const auto *constraint : entry.constraints) {
+        containing[constraint].push_back(&entry);
+    }
+    return &entry;
+}
+
+std::optional<bool> CachingSolver::checkSat(const std::vector<const Constraint *> &asserts) {
+    Util::ScopedTimer timer("caching_solver");
+    QUERIES.add();
+    if (entries.size() >= MAX_ENTRIES) {
+        clear();
+    }
+
+    std::vector<const Constraint *> constraints;
+    constraints.reserve(asserts.size());
+    for (const auto *assert : asserts) {
+        if (const auto *literal = assert->to<IR::BoolLiteral>()) {
+            if (literal->value) {
+                continue;
+            }
+            return false;
+        }
+        constraints.push_back(intern(assert));
+    }
+
+    // Answer the groups from the cache first, so that a cached unsatisfiable group avoids calls
+    // into the solver.
+    SymbolicMapping result;
+    std::vector<std::vector<const Constraint *>> misses;
+    for (auto &group : partition(constraints)) {
+        GROUPS.add();
+        ConstraintSet key = group;
+        std::sort(key.begin(), key.end());
+        key.erase(std::unique(key.begin(), key.end()), key.end());
+        const auto *entry = lookup(key);
+        if (entry == nullptr) {
+            misses.push_back(std::move(group));
+            continue;
+        }
+        if (!entry->satisfiable) {
+            return false;
+        }
+        result.insert(entry->model.begin(), entry->model.end());
+    }
+
+    for (auto &group : misses) {
+        MISSES.add();
+        auto solverResult = solver.checkSat(group);
+        if (!solverResult.has_value()) {
+            return std::nullopt;
+        }
+        std::sort(group.begin(), group.end());
+        group.erase(std::unique(group.begin(), group.end()), group.end());
+        if (!*solverResult) {
+            insert(std::move(group), false, {});
+            return false;
+        }
+        const auto *entry = insert(std::move(group), true, solver.getSymbolicMapping());
+        result.insert(entry->model.begin(), entry->model.end());
+    }
+    model = std::move(result);
+    return true;
+}
+
+}  // namespace P4::P4Tools
@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_COMMON_CORE_CACHING_SOLVER_H_
+#define BACKENDS_P4TOOLS_COMMON_CORE_CACHING_SOLVER_H_
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+#include "ir/solver.h"
+#include "lib/cstring.h"
+#include "lib/rtti.h"
+
+namespace P4::P4Tools {
+
+/// An AbstractSolver that answers queries from a cache where possible and forwards the remaining
+/// queries to another solver.
+///
+/// The constraints of a query are split into independent groups, which do not share any symbolic
+/// variables. A query is satisfiable if every group is, and the model of the query is the union of
+/// the models of the groups. The result and model of each group are cached under the set of its
+/// constraints. Structurally equal constraints are identified, so that groups of sibling paths,
+/// which rebuild the same constraints, hit the cache. A group is also answered without the backing
+/// solver if
+///   - a cached unsatisfiable group is a subset of it, or
+///   - a cached satisfiable group is a superset of it, or
+///   - the model of a cached satisfiable subset of it satisfies the remaining constraints.
+/// The models may thus differ from those the backing solver returns for the whole query, and
+/// the backing solver answers each group on its own, without its incremental mode.
+class CachingSolver : public AbstractSolver {
+ public:
+    /// Forwards queries that can not be answered from the cache to @param solver.
+    explicit CachingSolver(AbstractSolver &solver);
+
+    void comment(cstring comment) override;
+
+    void seed(unsigned seed) override;
+
+    void timeout(unsigned tm) override;
+
+    std::optional<bool> checkSat(const std::vector<const Constraint *> &asserts) override;
+
+    [[nodiscard]] const SymbolicMapping &getSymbolicMapping() const override;
+
+    void toJSON(JSONGenerator &json) const override;
+
+    [[nodiscard]] bool isInIncrementalMode() const override;
+
+    /// @returns the solver that answers the queries that miss the cache.
+    [[nodiscard]] AbstractSolver &getBackingSolver() const;
+
+    /// Removes all cached results.
+    void clear();
+
+ private:
+    /// A set of constraints, sorted by address. Constraints are interned, see @ref intern.
+    using ConstraintSet = std::vector<const Constraint *>;
+
+    struct ConstraintSetHash {
+        size_t operator()(const ConstraintSet &constraints) const;
+    };
+
+    /// A cached result of a group of constraints.
+    struct Entry {
+        ConstraintSet constraints;
+        bool satisfiable;
+        /// The model of the group, if it is satisfiable.
+        SymbolicMapping model;
+    };
+
+    /// The maximum number of cached groups. The cache is cleared when it grows beyond this size.
+    static constexpr size_t MAX_ENTRIES = 1 << 16;
+
+    /// The maximum number of cached groups that are compared against a group that is not in the
+    /// cache.
+    static constexpr size_t MAX_CANDIDATES = 64;
+
+    AbstractSolver &solver;
+
+    /// The model of the last satisfiable query.
+    SymbolicMapping model;
+
+    /// The symbolic variables of each interned constraint.
+    std::unordered_map<const Constraint *, std::vector<const IR::SymbolicVariable *>> variables;
+
+    std::deque<Entry> entries;
+
+    /// Maps the constraints of each cached group to its entry.
+    std::unordered_map<ConstraintSet, const Entry *, ConstraintSetHash> exact;
+
+    /// Maps each constraint to the cached groups that contain it.
+    std::unordered_map<const Constraint *, std::vector<const Entry *>> containing;
+
+    /// @returns the representative of the constraints that are structurally equal to
+    /// @p constraint, see HashCons.
+    const Constraint *intern(const Constraint *constraint);
+
+    /// Splits the interned @p constraints into groups that do not share symbolic variables. The
+    /// constraints of each group keep their relative order.
+    std::vector<std::vector<const Constraint *>> partition(
+        const std::vector<const Constraint *> &constraints) const;
+
+    /// Looks up the group @p group in the cache. If the result is derived from a different group,
+    /// it is cached for @p group as well.
+    /// @returns the cached result, or nullptr if the cache can not answer.
+    const Entry *lookup(const ConstraintSet &group);
+
+    /// @returns true if @p model binds every symbolic variable of @p constraints and satisfies
+    /// them.
+    [[nodiscard]] bool satisfies(const SymbolicMapping &model,
+                                 const std::vector<const Constraint *> &constraints) const;
+
+    /// @returns the bindings of @p model for the symbolic variables of @p group. A model that was
+    /// found for a different group, or by a solver that saw other variables, must not leak values
+    /// into the models of the groups it is merged with.
+    [[nodiscard]] SymbolicMapping restrictTo(const SymbolicMapping &model,
+                                             const ConstraintSet &group) const;
+
+    /// Caches the result of the group @p group, with the bindings of @p model for its variables.
+    const Entry *insert(ConstraintSet group, bool satisfiable, const SymbolicMapping &model);
+
+    DECLARE_TYPEINFO(CachingSolver, AbstractSolver);
+};
+
+}  // namespace P4::P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_CORE_CACHING_SOLVER_H_ */
@@ -15,6 +15,8 @@
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include "absl/strings/str_format.h"
+#include "backends/p4tools/common/lib/hash_cons.h"
+#include "backends/p4tools/common/lib/logging.h"
 #include "ir/ir.h"
 #include "ir/irutils.h"
 #include "ir/json_loader.h"  // IWYU pragma: keep
@@ -29,6 +31,13 @@
 
 namespace P4::P4Tools {
 
+namespace {
+
+PerformanceCounter TRANSLATIONS("z3_translations");
+PerformanceCounter TRANSLATION_HITS("z3_translation_cache_hits", &TRANSLATIONS);
+
+}  // namespace
+
 /// Converts a Z3 expression to a string.
 const char *toString(const z3::expr &e) { return Z3_ast_to_string(e.ctx(), e); }
 
@@ -76,9 +85,17 @@ z3::expr Z3Solver::declareVar(const IR::SymbolicVariable &var) {
     // Need to take the reference here to avoid accidental copies.
     auto *latestVars = &declaredVarsById.back();
     latestVars->emplace(expr.id(), &var);
+    translatedVarsById.insert_or_assign(expr.id(), &var);
     return expr;
 }
 
+void Z3Solver::memoizeTranslation(const IR::Expression *expression, const z3::expr &expr) {
+    if (translations.size() >= MAX_TRANSLATIONS) {
+        translations.clear();
+    }
+    translations.emplace(expression, expr);
+}
+
 void Z3Solver::reset() {
     z3solver.reset();
     declaredVarsById.clear();
@@ -89,7 +106,12 @@ void Z3Solver::reset() {
 void Z3Solver::clearMemory() {
     auto p4AssertionsBuf = p4Assertions;
     reset();
-    Z3_finalize_memory();
+    // The cached expressions belong to the context that is released.
+    translations.clear();
+    translatedVarsById.clear();
+    if (Instance::count == 1) {
+        Z3_finalize_memory();
+    }
     z3solver = z3::solver(*new z3::context());
     p4Assertions.clear();
     for (const auto &assert : p4AssertionsBuf) {
@@ -246,6 +268,7 @@ const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
             declaredVars.emplace(var);
         }
     }
+    declaredVars.insert(translatedVarsById.begin(), translatedVarsById.end());
     // Then, get the model and match each declaration in the model to its IR::SymbolicVariable.
     try {
         Util::ScopedTimer ctCheckSat("getModel");
@@ -369,11 +392,9 @@ bool Z3Translator::preorder(const IR::Node *node) {
 }
 
 bool Z3Translator::preorder(const IR::Cast *cast) {
-    Z3Translator tCast(solver);
-    cast->expr->apply(tCast);
     uint64_t exprSize = 0;
     const auto *const castExtrType = cast->expr->type;
-    auto castExpr = tCast.result;
+    auto castExpr = translateSubexpression(cast->expr);
     if (const auto *tb = cast->destType->to<IR::Type_Bits>()) {
         uint64_t destSize = tb->width_bits();
         if (const auto *exprType = castExtrType->to<IR::Type_Bits>()) {
@@ -488,9 +509,7 @@ const ShiftType *Z3Translator::rewriteShift(const ShiftType *shift) const {
 /// General function for unary operations.
 bool Z3Translator::recurseUnary(const IR::Operation_Unary *unary, Z3UnaryOp f) {
     BUG_CHECK(unary, "Z3Translator: encountered null node during translation");
-    Z3Translator tExpr(solver);
-    unary->expr->apply(tExpr);
-    result = f(tExpr.result);
+    result = f(translateSubexpression(unary->expr));
     return false;
 }
 
@@ -573,11 +592,9 @@ bool Z3Translator::preorder(const IR::Concat *op) { return recurseBinary(op, z3:
 /// general function for binary operations
 bool Z3Translator::recurseBinary(const IR::Operation_Binary *binary, Z3BinaryOp f) {
     BUG_CHECK(binary, "Z3Translator: encountered null node during translation");
-    Z3Translator tLeft(solver);
-    Z3Translator tRight(solver);
-    binary->left->apply(tLeft);
-    binary->right->apply(tRight);
-    result = f(tLeft.result, tRight.result);
+    auto left = translateSubexpression(binary->left);
+    auto right = translateSubexpression(binary->right);
+    result = f(left, right);
     return false;
 }
 
@@ -593,21 +610,37 @@ bool Z3Translator::preorder(const IR::Slice *op) {
 /// general function for ternary operations
 bool Z3Translator::recurseTernary(const IR::Operation_Ternary *ternary, Z3TernaryOp f) {
     BUG_CHECK(ternary, "Z3Translator: encountered null node during translation");
-    Z3Translator t0(solver);
-    Z3Translator t1(solver);
-    Z3Translator t2(solver);
-    ternary->e0->apply(t0);
-    ternary->e1->apply(t1);
-    ternary->e2->apply(t2);
-    result = f(t0.result, t1.result, t2.result);
+    auto e0 = translateSubexpression(ternary->e0);
+    auto e1 = translateSubexpression(ternary->e1);
+    auto e2 = translateSubexpression(ternary->e2);
+    result = f(e0, e1, e2);
     return false;
 }
 
+z3::expr Z3Translator::translateSubexpression(const IR::Expression *expression) {
+    TRANSLATIONS.add();
+    auto &z3Solver = solver.get();
+    bool isInterned = HashCons::isInterned(expression);
+    if (isInterned) {
+        auto it = z3Solver.translations.find(expression);
+        if (it != z3Solver.translations.end()) {
+            TRANSLATION_HITS.add();
+            return it->second;
+        }
+    }
+    Z3Translator translator(z3Solver);
+    expression->apply(translator);
+    if (isInterned) {
+        z3Solver.memoizeTranslation(expression, translator.result);
+    }
+    return translator.result;
+}
+
 z3::expr Z3Translator::getResult() { return result; }
 
 z3::expr Z3Translator::translate(const IR::Expression *expression) {
     try {
-        expression->apply(*this);
+        result = translateSubexpression(expression);
     } catch (z3::exception &e) {
         BUG("Z3Translator: Z3 exception: %1%\nExpression %2%", e.msg(), expression);
     }
@@ -10,10 +10,12 @@
 #include <z3++.h>
 #include <z3.h>
 
+#include <atomic>
 #include <cstddef>
 #include <iosfwd>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "ir/ir.h"
@@ -106,6 +108,9 @@ class Z3Solver : public AbstractSolver {
     /// @returns the resulting Z3 variable.
     z3::expr declareVar(const IR::SymbolicVariable &var);
 
+    /// Caches the translation @param expr of the interned expression @param expression.
+    void memoizeTranslation(const IR::Expression *expression, const z3::expr &expr);
+
     /// Generates a Z3 name for the given symbolic variable.
     [[nodiscard]] static std::string generateName(const IR::SymbolicVariable &var);
 
@@ -123,6 +128,16 @@ class Z3Solver : public AbstractSolver {
     /// Helper function which converts a z3::check_result to a std::optional<bool>.
     static std::optional<bool> interpretSolverResult(z3::check_result result);
 
+    /// Counts the live solvers. Z3_finalize_memory frees the memory of every Z3 context, so
+    /// @ref clearMemory may only call it when no other solver is in use.
+    struct Instance {
+        static inline std::atomic<unsigned> count = 0;
+        Instance() { ++count; }
+        Instance(const Instance &) { ++count; }
+        Instance &operator=(const Instance &) = default;
+        ~Instance() { --count; }
+    } instance;
+
     /// The underlying Z3 instance.
     z3::solver z3solver;
 
@@ -130,6 +145,18 @@ class Z3Solver : public AbstractSolver {
     /// to the original state variable.
     Z3DeclaredVariablesMap declaredVarsById;
 
+    /// The maximum number of cached translations. The cache is cleared when it grows beyond this
+    /// size.
+    static constexpr size_t MAX_TRANSLATIONS = 1 << 18;
+
+    /// The Z3 translations of interned expressions in the current context, see HashCons.
+    std::unordered_map<const IR::Expression *, z3::expr> translations;
+
+    /// Maps the Z3 expression IDs of all variables declared in the current context to their state
+    /// variable. Cached translations declare their variables only once, so the model may contain
+    /// variables that are missing from @ref declaredVarsById.
+    std::unordered_map<unsigned, const IR::SymbolicVariable *> translatedVarsById;
+
     /// The sequence of P4 assertions that have been made to the solver.
     safe_vector<const Constraint *> p4Assertions;
 
@@ -235,6 +262,10 @@ class Z3Translator : public virtual Inspector {
     /// @returns false.
     bool recurseTernary(const IR::Operation_Ternary *ternary, Z3TernaryOp f);
 
+    /// Translates the subexpression @param expression with a new translator. The translations of
+    /// interned expressions are cached in the solver.
+    z3::expr translateSubexpression(const IR::Expression *expression);
+
     /// Rewrites a shift operation so that the type of the shift amount matches that of the number
     /// being shifted.
     ///
@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_COMMON_LIB_COPY_ON_WRITE_H_
+#define BACKENDS_P4TOOLS_COMMON_LIB_COPY_ON_WRITE_H_
+
+#include <memory>
+#include <utility>
+
+namespace P4::P4Tools {
+
+/// A value that is shared between copies until one of the copies is modified. Copying a
+/// CopyOnWrite is O(1). The value is only copied when it is modified through @ref mutate while
+/// other copies still refer to it.
+template <class T>
+class CopyOnWrite {
+    std::shared_ptr<T> value;
+
+ public:
+    CopyOnWrite() : value(std::make_shared<T>()) {}
+    explicit CopyOnWrite(T value) : value(std::make_shared<T>(std::move(value))) {}
+
+    const T &operator*() const { return *value; }
+    const T *operator->() const { return value.get(); }
+
+    /// @returns a reference to the value that may be modified. The reference must not be used
+    /// after this object has been copied, because the copy would see the modifications.
+    T &mutate() {
+        // A value that is only referenced by this object can not be copied concurrently, so this
+        // check is safe even if copies are used by other threads.
+        if (value.use_count() > 1) {
+            value = std::make_shared<T>(*value);
+        }
+        return *value;
+    }
+
+    /// @returns true if @p other shares the value of this object.
+    [[nodiscard]] bool shares(const CopyOnWrite &other) const { return value == other.value; }
+};
+
+}  // namespace P4::P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_LIB_COPY_ON_WRITE_H_ */
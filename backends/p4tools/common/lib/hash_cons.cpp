@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/common/lib/hash_cons.h"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
+
+#include "backends/p4tools/common/lib/logging.h"
+#include "ir/visitor.h"
+#include "lib/cstring.h"
+
+namespace P4::P4Tools {
+
+namespace {
+
+PerformanceCounter INTERNED("hash_cons_interned");
+PerformanceCounter SHARED("hash_cons_shared", &INTERNED);
+
+/// The number of shards of the table. Each shard has its own lock, so that threads interning
+/// different expressions rarely wait for each other.
+constexpr size_t kShards = 64;
+
+/// The canonical expressions. Their structural hash picks the shard that indexes them, and
+/// their address the shard that stores their hash. A lock is only held for a single lookup or
+/// insertion, never while another one is taken, so another thread may get a new canonical
+/// instance just before its hash is stored; it is then not reported as interned yet.
+class Table {
+    struct ByHash {
+        std::unordered_multimap<size_t, const IR::Expression *> expressions;
+#ifdef MULTITHREAD
+        std::mutex lock;
+#endif  // MULTITHREAD
+    };
+
+    struct Hashes {
+        std::unordered_map<const IR::Expression *, size_t> hashes;
+#ifdef MULTITHREAD
+        std::mutex lock;
+#endif  // MULTITHREAD
+    };
+
+    std::array<ByHash, kShards> byHash;
+    std::array<Hashes, kShards> hashes;
+
+    Hashes &hashesOf(const IR::Expression *expression) {
+        // The low bits of an address are the same for all nodes.
+        return hashes[(std::hash<const IR::Expression *>()(expression) >> 4) % kShards];
+    }
+
+ public:
+    /// @returns the structural hash of @p expression if it is a canonical instance.
+    std::optional<size_t> hashOf(const IR::Expression *expression) {
+        auto &shard = hashesOf(expression);
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> acquire(shard.lock);
+#endif  // MULTITHREAD
+        auto it = shard.hashes.find(expression);
+        if (it == shard.hashes.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /// @returns the canonical instance that is equivalent to @p expression, whose structural hash
+    /// is @p hash and whose subexpressions are canonical. @p expression becomes the canonical
+    /// instance if there is none yet.
+    const IR::Expression *insert(size_t hash, const IR::Expression *expression) {
+        {
+            auto &shard = byHash[hash % kShards];
+#ifdef MULTITHREAD
+            std::lock_guard<std::mutex> acquire(shard.lock);
+#endif  // MULTITHREAD
+            // equiv compares the whole subtrees, but only of the few expressions with the same
+            // structural hash, which are almost always equivalent.
+            auto [first, last] = shard.expressions.equal_range(hash);
+            for (; first != last; ++first) {
+                if (first->second->equiv(*expression)) {
+                    SHARED.add();
+                    return first->second;
+                }
+            }
+            shard.expressions.emplace(hash, expression);
+        }
+        auto &shard = hashesOf(expression);
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> acquire(shard.lock);
+#endif  // MULTITHREAD
+        shard.hashes.emplace(expression, hash);
+        return expression;
+    }
+
+    void clear() {
+        for (auto &shard : byHash) {
+#ifdef MULTITHREAD
+            std::lock_guard<std::mutex> acquire(shard.lock);
+#endif  // MULTITHREAD
+            shard.expressions.clear();
+        }
+        for (auto &shard : hashes) {
+#ifdef MULTITHREAD
+            std::lock_guard<std::mutex> acquire(shard.lock);
+#endif  // MULTITHREAD
+            shard.hashes.clear();
+        }
+    }
+
+    size_t size() {
+        size_t size = 0;
+        for (auto &shard : hashes) {
+#ifdef MULTITHREAD
+            std::lock_guard<std::mutex> acquire(shard.lock);
+#endif  // MULTITHREAD
+            size += shard.hashes.size();
+        }
+        return size;
+    }
+};
+
+Table &table() {
+    static Table table;
+    return table;
+}
+
+/// Computes a hash of an expression such that structurally equal expressions have the same hash.
+/// Canonical subexpressions contribute their known hash, so an expression whose subexpressions
+/// are canonical is hashed in constant time.
+class StructuralHash : public Inspector {
+    Table &table;
+
+    size_t hash = 0;
+
+    void mix(size_t value) { hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2); }
+
+ public:
+    explicit StructuralHash(Table &table) : table(table) { visitDagOnce = false; }
+
+    bool preorder(const IR::Node *node) override {
+        if (const auto *expression = node->to<IR::Expression>()) {
+            if (auto hash = table.hashOf(expression)) {
+                mix(*hash);
+                return false;
+            }
+        }
+        mix(std::hash<cstring>()(node->node_type_name()));
+        if (const auto *constant = node->to<IR::Constant>()) {
+            mix(std::hash<std::string>()(constant->value.str()));
+        } else if (const auto *literal = node->to<IR::BoolLiteral>()) {
+            mix(literal->value);
+        } else if (const auto *literal = node->to<IR::StringLiteral>()) {
+            mix(std::hash<cstring>()(literal->value));
+        } else if (const auto *var = node->to<IR::SymbolicVariable>()) {
+            mix(std::hash<cstring>()(var->label));
+        } else if (const auto *member = node->to<IR::Member>()) {
+            mix(std::hash<cstring>()(member->member.name));
+        } else if (const auto *path = node->to<IR::PathExpression>()) {
+            mix(std::hash<cstring>()(path->path->name.name));
+        } else if (const auto *type = node->to<IR::Type_Bits>()) {
+            mix(type->width_bits());
+            mix(type->isSigned);
+        }
+        return true;
+    }
+
+    [[nodiscard]] size_t get() const { return hash; }
+};
+
+/// Replaces every subexpression of an expression by its canonical instance, bottom-up.
+class Intern : public Transform {
+    Table &table;
+
+ public:
+    explicit Intern(Table &table) : table(table) { setName("HashCons"); }
+
+    const IR::Node *preorder(IR::Node *node) override {
+        const auto *original = getOriginal()->to<IR::Expression>();
+        if (original != nullptr && table.hashOf(original)) {
+            prune();
+            return original;
+        }
+        return node;
+    }
+
+    const IR::Node *postorder(IR::Expression *expression) override {
+        INTERNED.add();
+        StructuralHash hasher(table);
+        expression->apply(hasher);
+        // Keep the original node if none of its subexpressions changed.
+        const auto *candidate = getOriginal<IR::Expression>();
+        if (!candidate->equiv(*expression)) {
+            candidate = expression;
+        }
+        return table.insert(hasher.get(), candidate);
+    }
+};
+
+}  // namespace
+
+const IR::Expression *HashCons::intern(const IR::Expression *expression) {
+    if (table().hashOf(expression)) {
+        return expression;
+    }
+    return expression->apply(Intern(table()))->checkedTo<IR::Expression>();
+}
+
+bool HashCons::isInterned(const IR::Expression *expression) {
+    return table().hashOf(expression).has_value();
+}
+
+size_t HashCons::size() { return table().size(); }
+
+void HashCons::clear() { table().clear(); }
+
+}  // namespace P4::P4Tools
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_COMMON_LIB_HASH_CONS_H_
+#define BACKENDS_P4TOOLS_COMMON_LIB_HASH_CONS_H_
+
+#include <cstddef>
+
+#include "ir/ir.h"
+
+namespace P4::P4Tools {
+
+/// A structural intern table for symbolic expressions. Interning an expression returns the
+/// canonical instance of all structurally equal expressions, so that equal terms share a single
+/// node. Results that only depend on the structure of an expression, like its Z3 translation, can
+/// then be memoized by the address of the canonical instance.
+///
+/// Structural equality is IR::Node::equiv, which ignores source information. Canonical
+/// instances are kept until @ref clear is called. The table is sharded, so that threads can
+/// intern expressions concurrently.
+class HashCons {
+ public:
+    /// @returns the canonical instance of @param expression. The subexpressions of the canonical
+    /// instance are canonical instances as well.
+    static const IR::Expression *intern(const IR::Expression *expression);
+
+    /// @returns true if @param expression is a canonical instance.
+    static bool isInterned(const IR::Expression *expression);
+
+    /// @returns the number of canonical instances.
+    static size_t size();
+
+    /// Drops all canonical instances. Expressions interned before are no longer canonical, and
+    /// interning an equal expression afterwards returns a new canonical instance. Results
+    /// memoized by the address of former canonical instances stay valid, but are not reused.
+    static void clear();
+};
+
+}  // namespace P4::P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_LIB_HASH_CONS_H_ */
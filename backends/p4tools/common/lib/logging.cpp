@@ -6,6 +6,8 @@
 
 #include <fstream>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "lib/error.h"
 #include "lib/log.h"
@@ -13,6 +15,21 @@
 
 namespace P4::P4Tools {
 
+namespace {
+
+/// @returns all performance counters that have been constructed.
+std::vector<const PerformanceCounter *> &performanceCounters() {
+    static std::vector<const PerformanceCounter *> counters;
+    return counters;
+}
+
+}  // namespace
+
+PerformanceCounter::PerformanceCounter(std::string name, const PerformanceCounter *total)
+    : name(std::move(name)), total(total) {
+    performanceCounters().push_back(this);
+}
+
 void enableInformationLogging() { Log::addDebugSpec("tools_info:4"); }
 
 void enablePerformanceLogging() { Log::addDebugSpec("tools_performance:4"); }
@@ -48,6 +65,25 @@ void printPerformanceReport(const std::optional<std::filesystem::path> &basePath
         }
         timerList.emplace_back(timerData);
     }
+    bool printedCounterHeader = false;
+    for (const auto *counter : performanceCounters()) {
+        if (counter->get() == 0) {
+            continue;
+        }
+        if (!printedCounterHeader) {
+            printFeature("tools_performance", 4, "============ Counters ============");
+            printedCounterHeader = true;
+        }
+        const auto *total = counter->getTotal();
+        if (total != nullptr && total->get() != 0) {
+            printFeature("tools_performance", 4, "%s: %i (%0.2f %% of %s)", counter->getName(),
+                         counter->get(),
+                         static_cast<double>(counter->get()) * 100 / total->get(),
+                         total->getName());
+        } else {
+            printFeature("tools_performance", 4, "%s: %i", counter->getName(), counter->get());
+        }
+    }
     // Write the report to the file, if one was provided.
     if (basePath.has_value()) {
         auto perfFilePath = basePath.value();
@@ -7,6 +7,8 @@
 #ifndef BACKENDS_P4TOOLS_COMMON_LIB_LOGGING_H_
 #define BACKENDS_P4TOOLS_COMMON_LIB_LOGGING_H_
 
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <string>
@@ -63,6 +65,32 @@ void enableInformationLogging();
 /// Enable printing of timing reports.
 void enablePerformanceLogging();
 
+/// A counter that is listed in the performance report, e.g., the number of hits of a cache.
+/// Counters are meant to be static objects. They register themselves when they are constructed.
+class PerformanceCounter {
+    /// The name of the counter in the report.
+    std::string name;
+
+    /// If set, the report also lists this counter as a percentage of @ref total.
+    const PerformanceCounter *total;
+
+    std::atomic<uint64_t> value = 0;
+
+ public:
+    explicit PerformanceCounter(std::string name, const PerformanceCounter *total = nullptr);
+    PerformanceCounter(const PerformanceCounter &) = delete;
+    PerformanceCounter &operator=(const PerformanceCounter &) = delete;
+
+    /// Adds @param count to the counter. May be called concurrently.
+    void add(uint64_t count = 1) { value.fetch_add(count, std::memory_order_relaxed); }
+
+    [[nodiscard]] uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] const std::string &getName() const { return name; }
+
+    [[nodiscard]] const PerformanceCounter *getTotal() const { return total; }
+};
+
 /// Print a performance report if performance logging is enabled.
 /// If a file is provided, it will be written to the file.
 void printPerformanceReport(const std::optional<std::filesystem::path> &basePath = std::nullopt);
@@ -8,6 +8,7 @@
 #include <string>
 #include <utility>
 
+#include "backends/p4tools/common/lib/hash_cons.h"
 #include "frontends/p4/optimizeExpressions.h"
 #include "ir/indexed_vector.h"
 #include "ir/irutils.h"
@@ -21,6 +22,16 @@ namespace P4::P4Tools {
 Model::SubstVisitor::SubstVisitor(const Model &model, bool doComplete)
     : self(model), doComplete(doComplete) {}
 
+const IR::Node *Model::SubstVisitor::preorder(IR::Expression *expr) {
+    const auto &values = self.evaluated[doComplete ? 1 : 0];
+    auto it = values.find(getOriginal<IR::Expression>());
+    if (it != values.end()) {
+        prune();
+        return it->second;
+    }
+    return expr;
+}
+
 const IR::Literal *Model::SubstVisitor::preorder(IR::StateVariable *var) {
     BUG("At this point all state variables should have been resolved. Encountered %1%.", var);
 }
@@ -84,9 +95,19 @@ const IR::BaseListExpression *Model::evaluateListExpr(const IR::BaseListExpressi
 
 const IR::Literal *Model::evaluate(const IR::Expression *expr, bool doComplete,
                                    ExpressionMap *resolvedExpressions) const {
-    const auto *substituted = expr->apply(SubstVisitor(*this, doComplete));
-    const auto *evaluated = P4::optimizeExpression(substituted);
-    const auto *literal = evaluated->checkedTo<IR::Literal>();
+    auto &values = evaluated[doComplete ? 1 : 0];
+    const IR::Literal *literal = nullptr;
+    auto it = values.find(expr);
+    if (it != values.end()) {
+        literal = it->second;
+    } else {
+        const auto *substituted = expr->apply(SubstVisitor(*this, doComplete));
+        literal = P4::optimizeExpression(substituted)->checkedTo<IR::Literal>();
+        // Interned expressions are shared between many values, so remember their value.
+        if (HashCons::isInterned(expr)) {
+            values.emplace(expr, literal);
+        }
+    }
     // Add the variable to the resolvedExpressions list, if the list is not null.
     if (resolvedExpressions != nullptr) {
         (*resolvedExpressions)[expr] = literal;
@@ -105,6 +126,9 @@ const IR::Expression *Model::get(const IR::SymbolicVariable *var, bool checked)
 
 void Model::set(const IR::SymbolicVariable *var, const IR::Expression *val) {
     symbolicMap[var] = val;
+    for (auto &values : evaluated) {
+        values.clear();
+    }
 }
 
 const SymbolicMapping &Model::getSymbolicMap() const { return symbolicMap; }
@@ -113,6 +137,9 @@ void Model::mergeMap(const SymbolicMapping &sourceMap) {
     for (const auto &varTuple : sourceMap) {
         symbolicMap.emplace(varTuple.first, varTuple.second);
     }
+    for (auto &values : evaluated) {
+        values.clear();
+    }
 }
 
 }  // namespace P4::P4Tools
@@ -7,7 +7,9 @@
 #ifndef BACKENDS_P4TOOLS_COMMON_LIB_MODEL_H_
 #define BACKENDS_P4TOOLS_COMMON_LIB_MODEL_H_
 
+#include <array>
 #include <map>
+#include <unordered_map>
 #include <utility>
 
 #include "ir/ir.h"
@@ -26,6 +28,11 @@ class Model {
     /// The mapping of symbolic variables to values. Usually generated by an SMT solver.
     SymbolicMapping symbolicMap;
 
+    /// The values of the interned expressions that have been evaluated in this model, see
+    /// HashCons. Indexed by the doComplete argument of @ref evaluate.
+    mutable std::array<std::unordered_map<const IR::Expression *, const IR::Literal *>, 2>
+        evaluated;
+
     // A visitor that iterates over an input expression and visits all the variables in the input
     // expression. These variables correspond to variables that were used for constraints in model
     // generated by the SMT solver. A variable needs to be
@@ -40,6 +47,8 @@ class Model {
         bool doComplete;
 
      public:
+        /// Replaces expressions that have already been evaluated by their value.
+        const IR::Node *preorder(IR::Expression *expr) override;
         const IR::Literal *preorder(IR::StateVariable *var) override;
         const IR::Literal *preorder(IR::SymbolicVariable *var) override;
         const IR::Literal *preorder(IR::TaintExpression *var) override;
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_LOG_H_
+#define BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_LOG_H_
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace P4::P4Tools {
+
+/// An append-only sequence whose copies share the elements appended before they were copied.
+/// Each element links to the one appended before it, so copying a log and appending to it are
+/// O(1), and copies never see each other's elements. The links are immutable once created, so
+/// copies may be used by different threads.
+template <class T>
+class PersistentLog {
+    struct Link {
+        /// The previously appended element, or nullptr for the first one.
+        std::shared_ptr<Link> parent;
+        T value;
+        /// The size of the log ending in this link.
+        size_t size;
+    };
+
+    /// The last appended element.
+    std::shared_ptr<Link> last;
+
+ public:
+    PersistentLog() = default;
+    PersistentLog(const PersistentLog &) = default;
+    PersistentLog(PersistentLog &&) noexcept = default;
+
+    PersistentLog &operator=(const PersistentLog &other) {
+        if (this != &other) {
+            // Hold on to the new chain first, it may share links with the old one.
+            auto newLast = other.last;
+            release();
+            last = std::move(newLast);
+        }
+        return *this;
+    }
+
+    PersistentLog &operator=(PersistentLog &&other) noexcept {
+        if (this != &other) {
+            auto newLast = std::move(other.last);
+            release();
+            last = std::move(newLast);
+        }
+        return *this;
+    }
+
+    ~PersistentLog() { release(); }
+
+    void push_back(T value) {
+        auto size = this->size() + 1;
+        last = std::make_shared<Link>(Link{std::move(last), std::move(value), size});
+    }
+
+    [[nodiscard]] size_t size() const { return last ? last->size : 0; }
+
+    [[nodiscard]] bool empty() const { return last == nullptr; }
+
+    /// @returns the last appended element. The log must not be empty.
+    [[nodiscard]] const T &back() const { return last->value; }
+
+    /// Calls @p function on each element, from the last appended one to the first one.
+    template <class Function>
+    void forEachReversed(Function function) const {
+        for (const auto *link = last.get(); link != nullptr; link = link->parent.get()) {
+            function(link->value);
+        }
+    }
+
+    /// @returns true if @p predicate holds for any element. Elements are tested from the last
+    /// appended one to the first one, and the search stops at the first match.
+    template <class Predicate>
+    [[nodiscard]] bool anyOf(Predicate predicate) const {
+        for (const auto *link = last.get(); link != nullptr; link = link->parent.get()) {
+            if (predicate(link->value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @returns true if the log contains @p value.
+    [[nodiscard]] bool contains(const T &value) const {
+        return anyOf([&value](const T &element) { return element == value; });
+    }
+
+    /// @returns the elements in the order in which they were appended.
+    [[nodiscard]] std::vector<T> toVector() const {
+        std::vector<T> result;
+        result.reserve(size());
+        forEachReversed([&result](const T &value) { result.push_back(value); });
+        return {std::make_move_iterator(result.rbegin()), std::make_move_iterator(result.rend())};
+    }
+
+ private:
+    /// Releases the links that are not shared with other logs one by one, instead of
+    /// recursively through the destructors of the links, which may overflow the stack.
+    void release() {
+        while (last && last.use_count() == 1) {
+            last = std::move(last->parent);
+        }
+        last = nullptr;
+    }
+};
+
+}  // namespace P4::P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_LOG_H_ */
@@ -5,8 +5,10 @@
 #include "backends/p4tools/common/lib/symbolic_env.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <utility>
 
+#include "backends/p4tools/common/lib/hash_cons.h"
 #include "backends/p4tools/common/lib/model.h"
 #include "ir/indexed_vector.h"
 #include "ir/vector.h"
@@ -15,21 +17,64 @@
 
 namespace P4::P4Tools {
 
+/// The number of local bindings that a symbolic environment keeps before merging them.
+static constexpr size_t kMinLocalBindings = 32;
+
 const IR::Expression *SymbolicEnv::get(const IR::StateVariable &var) const {
-    auto it = map.find(var);
-    if (it != map.end()) {
+    auto it = local.find(var);
+    if (it != local.end()) {
+        return it->second;
+    }
+    it = shared->find(var);
+    if (it != shared->end()) {
         return it->second;
     }
     BUG("Unable to find var %s in the symbolic environment.", var);
 }
 
-bool SymbolicEnv::exists(const IR::StateVariable &var) const { return map.find(var) != map.end(); }
+bool SymbolicEnv::exists(const IR::StateVariable &var) const {
+    return local.find(var) != local.end() || shared->find(var) != shared->end();
+}
 
 void SymbolicEnv::set(const IR::StateVariable &var, const IR::Expression *value) {
     BUG_CHECK(value->type && !value->type->is<IR::Type_Unknown>(),
               "Cannot set value for node %1% with unspecified type: %2%", value->node_type_name(),
               value);
-    map[var] = value;
+    // Interning lets environments and solver queries share the terms of equal values.
+    local[var] = HashCons::intern(value);
+    // Merging copies the shared bindings, so only do it once the local bindings are a fair share
+    // of the environment. This keeps both copies and updates cheap on average.
+    if (local.size() > std::max<size_t>(kMinLocalBindings, shared->size() / 8)) {
+        merge();
+    }
+}
+
+SymbolicMapType SymbolicEnv::merged() const {
+    SymbolicMapType merged;
+    merged.reserve(shared->size() + local.size());
+    auto it = shared->begin();
+    auto end = shared->end();
+    for (const auto &binding : local) {
+        for (; it != end && it->first < binding.first; ++it) {
+            merged.emplace_hint(merged.end(), *it);
+        }
+        if (it != end && !(binding.first < it->first)) {
+            ++it;
+        }
+        merged.emplace_hint(merged.end(), binding);
+    }
+    for (; it != end; ++it) {
+        merged.emplace_hint(merged.end(), *it);
+    }
+    return merged;
+}
+
+void SymbolicEnv::merge() {
+    if (local.empty()) {
+        return;
+    }
+    shared = CopyOnWrite<SymbolicMapType>(merged());
+    local.clear();
 }
 
 const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
@@ -67,7 +112,12 @@ const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
     return expr->apply(SubstVisitor(*this));
 }
 
-const SymbolicMapType &SymbolicEnv::getInternalMap() const { return map; }
+SymbolicMapType SymbolicEnv::getInternalMap() const {
+    if (local.empty()) {
+        return *shared;
+    }
+    return merged();
+}
 
 bool SymbolicEnv::isSymbolicValue(const IR::Node *node) {
     // Check the obvious case first.
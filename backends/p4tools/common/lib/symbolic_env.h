@@ -7,6 +7,7 @@
 #ifndef BACKENDS_P4TOOLS_COMMON_LIB_SYMBOLIC_ENV_H_
 #define BACKENDS_P4TOOLS_COMMON_LIB_SYMBOLIC_ENV_H_
 
+#include "backends/p4tools/common/lib/copy_on_write.h"
 #include "backends/p4tools/common/lib/model.h"
 #include "ir/ir.h"
 #include "ir/node.h"
@@ -17,7 +18,19 @@ namespace P4::P4Tools {
 /// expression on the program's initial state.
 class SymbolicEnv {
  private:
-    SymbolicMapType map;
+    /// Bindings shared with the environments this one has been copied from or to.
+    CopyOnWrite<SymbolicMapType> shared;
+
+    /// Bindings set since this environment was last merged. They take precedence over the
+    /// bindings in @ref shared. Copying an environment only copies these, and they are merged into
+    /// @ref shared once they make up a sizeable part of the environment.
+    SymbolicMapType local;
+
+    /// @returns the bindings of @ref shared, overridden by those of @ref local.
+    [[nodiscard]] SymbolicMapType merged() const;
+
+    /// Merge @ref local into @ref shared.
+    void merge();
 
  public:
     // Maybe coerce from Model for concrete execution?
@@ -29,15 +42,17 @@ class SymbolicEnv {
     [[nodiscard]] bool exists(const IR::StateVariable &var) const;
 
     /// Sets the symbolic value of the given state variable to the given value. Constant folding is
-    /// done on the given value before updating the symbolic state.
+    /// done on the given value before updating the symbolic state. The stored value is the
+    /// canonical instance of the given value, see HashCons.
     void set(const IR::StateVariable &var, const IR::Expression *value);
 
     /// Substitutes state variables in @expr for their symbolic value in this environment.
     /// Variables that are unbound by this environment are left untouched.
     const IR::Expression *subst(const IR::Expression *expr) const;
 
-    /// @returns The immutable map that is internal to this symbolic environment.
-    [[nodiscard]] const SymbolicMapType &getInternalMap() const;
+    /// @returns a map of all the bindings of this symbolic environment. The map is built on each
+    /// call and does not change the environment, which can therefore be read concurrently.
+    [[nodiscard]] SymbolicMapType getInternalMap() const;
 
     /// Determines whether the given node represents a symbolic value. Symbolic values may be
     /// stored in the symbolic environment.
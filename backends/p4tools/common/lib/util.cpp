@@ -10,6 +10,7 @@
 #include <iomanip>
 #include <numeric>
 #include <optional>
+#include <sstream>
 
 #include <boost/multiprecision/cpp_int.hpp>
 #include <boost/multiprecision/cpp_int/add.hpp>
@@ -33,6 +34,19 @@ std::optional<uint32_t> Utils::currentSeed = std::nullopt;
 
 boost::random::mt19937 Utils::rng(0);
 
+thread_local Utils::ScopedRandomSeed *Utils::threadSeed = nullptr;
+
+Utils::ScopedRandomSeed::ScopedRandomSeed(uint32_t seed)
+    : seed(seed), rng(seed), previous(threadSeed) {
+    threadSeed = this;
+}
+
+Utils::ScopedRandomSeed::~ScopedRandomSeed() { threadSeed = previous; }
+
+boost::random::mt19937 &Utils::generator() {
+    return threadSeed != nullptr ? threadSeed->rng : rng;
+}
+
 std::string Utils::getTimeStamp() {
     // get current time
     auto now = std::chrono::system_clock::now();
@@ -58,19 +72,41 @@ void Utils::setRandomSeed(int seed) {
     rng.seed(seed);
 }
 
-std::optional<uint32_t> Utils::getCurrentSeed() { return currentSeed; }
+std::optional<uint32_t> Utils::getCurrentSeed() {
+    if (threadSeed != nullptr) {
+        return threadSeed->seed;
+    }
+    return currentSeed;
+}
+
+std::string Utils::getRandomState() {
+    std::stringstream state;
+    state << generator();
+    return state.str();
+}
+
+bool Utils::setRandomState(const std::string &state) {
+    std::stringstream stream(state);
+    boost::random::mt19937 restored;
+    stream >> restored;
+    if (stream.fail()) {
+        return false;
+    }
+    generator() = restored;
+    return true;
+}
 
 uint64_t Utils::getRandInt(uint64_t max) {
-    if (!currentSeed) {
+    if (!getCurrentSeed()) {
         return 0;
     }
     boost::random::uniform_int_distribution<uint64_t> dist(0, max);
-    return dist(rng);
+    return dist(generator());
 }
 
 int64_t Utils::getRandInt(int64_t min, int64_t max) {
     boost::random::uniform_int_distribution<int64_t> distribution(min, max);
-    return distribution(rng);
+    return distribution(generator());
 }
 
 int64_t Utils::getRandInt(const std::vector<int64_t> &percent) {
@@ -92,19 +128,19 @@ int64_t Utils::getRandInt(const std::vector<int64_t> &percent) {
 }
 
 big_int Utils::getRandBigInt(const big_int &max) {
-    if (!currentSeed) {
+    if (!getCurrentSeed()) {
         return 0;
     }
     boost::random::uniform_int_distribution<big_int> dist(0, max);
-    return dist(rng);
+    return dist(generator());
 }
 
 big_int Utils::getRandBigInt(const big_int &min, const big_int &max) {
-    if (!currentSeed) {
+    if (!getCurrentSeed()) {
         return 0;
     }
     boost::random::uniform_int_distribution<big_int> dist(min, max);
-    return dist(rng);
+    return dist(generator());
 }
 
 const IR::Constant *Utils::getRandConstantForWidth(int bitWidth) {
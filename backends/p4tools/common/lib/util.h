@@ -33,6 +33,33 @@ class Utils {
     /// Stores the state of the PRNG.
     static std::optional<uint32_t> currentSeed;
 
+ public:
+    /// Gives the current thread its own random generator, seeded with @p seed, for the lifetime
+    /// of this object. Other threads keep using the global random generator. This makes it
+    /// possible to produce reproducible random sequences on several threads at once.
+    class ScopedRandomSeed {
+     public:
+        explicit ScopedRandomSeed(uint32_t seed);
+        ~ScopedRandomSeed();
+        ScopedRandomSeed(const ScopedRandomSeed &) = delete;
+        ScopedRandomSeed &operator=(const ScopedRandomSeed &) = delete;
+
+     private:
+        friend class Utils;
+
+        uint32_t seed;
+        boost::random::mt19937 rng;
+        /// The seed that was active on this thread before this one, restored on destruction.
+        ScopedRandomSeed *previous;
+    };
+
+ private:
+    /// The innermost ScopedRandomSeed of the current thread, if any.
+    static thread_local ScopedRandomSeed *threadSeed;
+
+    /// @returns the random generator of the current thread.
+    static boost::random::mt19937 &generator();
+
  public:
     /// Return the current timestamp with millisecond accuracy.
     /// Format: year-month-day-hour:minute:second.millisecond
@@ -43,9 +70,17 @@ class Utils {
     /// Uses boost's mersenne twister.
     static void setRandomSeed(int seed);
 
-    /// @returns currentSeed.
+    /// @returns the seed of the current thread's ScopedRandomSeed, if any, or currentSeed.
     static std::optional<uint32_t> getCurrentSeed();
 
+    /// @returns the state of the random generator. Restoring it with @ref setRandomState continues
+    /// the sequence of random numbers where it was saved.
+    static std::string getRandomState();
+
+    /// Restores a state of the random generator that was returned by @ref getRandomState.
+    /// @returns false if @param state is not a valid state.
+    static bool setRandomState(const std::string &state);
+
     /// @returns a random integer in the range [0, @param max]. Always return 0 if no seed is set.
     static uint64_t getRandInt(uint64_t max);
 
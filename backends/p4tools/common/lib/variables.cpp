@@ -5,6 +5,9 @@
 #include "backends/p4tools/common/lib/variables.h"
 
 #include <map>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 #include <string>
 #include <tuple>
 
@@ -45,6 +48,10 @@ const IR::TaintExpression *getTaintExpression(const IR::Type *type) {
     // type.
     using key_t = std::tuple<int, bool>;
     static std::map<key_t, const IR::TaintExpression *> TAINTS;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+    std::lock_guard<std::mutex> acquire(lock);
+#endif  // MULTITHREAD
 
     auto *&result = TAINTS[{tb->width_bits(), tb->isSigned}];
     if (result == nullptr) {
@@ -0,0 +1,229 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/modules/smith/batch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+#ifdef MULTITHREAD
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#endif  // MULTITHREAD
+
+#include "backends/p4tools/common/compiler/compiler_target.h"
+#include "backends/p4tools/common/compiler/context.h"
+#include "backends/p4tools/common/lib/logging.h"
+#include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/modules/smith/common/probabilities.h"
+#include "backends/p4tools/modules/smith/common/scope.h"
+#include "backends/p4tools/modules/smith/toolname.h"
+#include "backends/p4tools/modules/smith/util/wordlist.h"
+#include "frontends/p4/toP4/toP4.h"
+#include "ir/ir.h"
+#include "lib/compile_context.h"
+#include "lib/error.h"
+#include "lib/exceptions.h"
+#include "lib/thread_pool.h"
+
+namespace P4::P4Tools::P4Smith {
+
+namespace {
+
+/// A generated program that still has to be checked.
+struct GeneratedProgram {
+    uint32_t seed;
+
+    /// The program, without the preamble of the target.
+    std::string source;
+
+    /// The error that occurred during generation, if any.
+    std::optional<std::string> failure;
+};
+
+GeneratedProgram generateCase(const SmithTarget &target, uint32_t seed) {
+    GeneratedProgram program{seed, {}, std::nullopt};
+    try {
+        program.source = generateProgram(target, seed);
+    } catch (const std::exception &e) {
+        program.failure = e.what();
+    }
+    return program;
+}
+
+/// Runs the preprocessor on @p preamble, so that it does not have to run for every program.
+std::optional<std::string> preprocessPreamble(const SmithOptions &options,
+                                              const std::string &preamble) {
+    auto path = options.file / "preamble.p4";
+    {
+        std::ofstream out(path);
+        out << preamble;
+        if (!out) {
+            error("Unable to write %1%", path.c_str());
+            return std::nullopt;
+        }
+    }
+    SmithOptions preprocessorOptions(options);
+    preprocessorOptions.file = path;
+    std::optional<std::string> result;
+    if (auto input = preprocessorOptions.preprocess()) {
+        result.emplace();
+        char buffer[4096];
+        size_t size = 0;
+        while ((size = fread(buffer, 1, sizeof(buffer), input->get())) > 0) {
+            result->append(buffer, size);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return result;
+}
+
+/// Parses @p source and runs the front and mid end on it in a new compilation context.
+/// @returns the errors, if the program is rejected or crashes the compiler.
+std::optional<std::string> compileProgram(const SmithOptions &options, const std::string &source) {
+    P4Tools::CompileContext<SmithOptions> context(P4Tools::CompileContext<SmithOptions>::get());
+    std::stringstream errors;
+    context.errorReporter().setOutputStream(&errors);
+    AutoCompileContext autoContext(&context);
+    try {
+        auto result = CompilerTarget::runCompiler(options, TOOL_NAME, source);
+        if (!result.has_value() || errorCount() > 0) {
+            return errors.str().empty() ? "Compilation failed" : errors.str();
+        }
+    } catch (const std::exception &e) {
+        return errors.str() + e.what();
+    }
+    return std::nullopt;
+}
+
+/// Writes a program that failed into @p dir, with its seed and @p failure in a leading comment.
+void writeFailure(const std::filesystem::path &dir, const std::string &preamble,
+                  const GeneratedProgram &program, const std::string &failure) {
+    auto path = dir / ("seed_" + std::to_string(program.seed) + ".p4");
+    std::ofstream out(path);
+    out << "// Generated by p4smith --seed " << program.seed << "\n";
+    std::stringstream lines(failure);
+    for (std::string line; std::getline(lines, line);) {
+        out << "// " << line << "\n";
+    }
+    out << preamble << program.source;
+    if (!out) {
+        error("Unable to write %1%", path.c_str());
+    }
+}
+
+}  // namespace
+
+std::string generateProgram(const SmithTarget &target, uint32_t seed) {
+    Utils::ScopedRandomSeed randomSeed(seed);
+    // The state of the program lives on this stack, where the garbage collector finds it.
+    P4Scope state;
+    P4Scope::Generation generation(state);
+    Wordlist::reset();
+    Probabilities::reset();
+    Declarations::reset();
+
+    const auto *program = target.generateP4Program();
+    std::stringstream out;
+    P4::ToP4 top4(&out, false);
+    program->apply(top4);
+    return out.str();
+}
+
+int runBatch(const SmithOptions &options, uint32_t baseSeed) {
+    const auto &target = SmithTarget::get();
+    std::error_code ec;
+    std::filesystem::create_directories(options.file, ec);
+    if (ec) {
+        error("Unable to create output directory %1%: %2%", options.file.c_str(), ec.message());
+        return EXIT_FAILURE;
+    }
+
+    std::stringstream preambleStream;
+    auto result = target.writeTargetPreamble(&preambleStream);
+    if (result != EXIT_SUCCESS) {
+        return result;
+    }
+    auto preamble = preambleStream.str();
+    std::string preprocessedPreamble;
+    if (options.compileCheck) {
+        auto preprocessed = preprocessPreamble(options, preamble);
+        if (!preprocessed.has_value()) {
+            return EXIT_FAILURE;
+        }
+        preprocessedPreamble = std::move(*preprocessed);
+    }
+
+    uint64_t failures = 0;
+    auto check = [&](const GeneratedProgram &program) {
+        auto failure = program.failure;
+        if (!failure.has_value() && options.compileCheck) {
+            failure = compileProgram(options, preprocessedPreamble + program.source);
+        }
+        if (failure.has_value()) {
+            ++failures;
+            printInfo("Program with seed %1% failed", program.seed);
+            writeFailure(options.file, preamble, program, *failure);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    // Seeds wrap around, like the seeds of separate invocations.
+    auto seedOf = [baseSeed](uint64_t index) { return static_cast<uint32_t>(baseSeed + index); };
+#ifdef MULTITHREAD
+    // Worker threads generate programs and the calling thread checks them. The number of
+    // programs that wait for their check is bounded.
+    const size_t maxPending = 4 * static_cast<size_t>(options.threads);
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<GeneratedProgram> pending;
+    std::atomic<uint64_t> next = 0;
+    auto threads = std::min<uint64_t>(options.threads, options.batchSize);
+    TaskGroup workers(ThreadPool::shared(threads));
+    for (uint64_t i = 0; i < threads; ++i) {
+        workers.run([&]() {
+            for (uint64_t index = next++; index < options.batchSize; index = next++) {
+                auto program = generateCase(target, seedOf(index));
+                std::unique_lock<std::mutex> acquire(lock);
+                changed.wait(acquire, [&]() { return pending.size() < maxPending; });
+                pending.push_back(std::move(program));
+                changed.notify_all();
+            }
+        });
+    }
+    for (uint64_t checked = 0; checked < options.batchSize; ++checked) {
+        std::unique_lock<std::mutex> acquire(lock);
+        changed.wait(acquire, [&]() { return !pending.empty(); });
+        auto program = std::move(pending.front());
+        pending.pop_front();
+        changed.notify_all();
+        acquire.unlock();
+        check(program);
+    }
+    workers.wait();
+#else
+    for (uint64_t index = 0; index < options.batchSize; ++index) {
+        check(generateCase(target, seedOf(index)));
+    }
+#endif  // MULTITHREAD
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    printInfo("Generated %1% programs in %2$.2f s (%3$.1f programs/s), %4% failed",
+              options.batchSize, elapsed.count(), options.batchSize / elapsed.count(), failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace P4::P4Tools::P4Smith
@@ -0,0 +1,34 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_MODULES_SMITH_BATCH_H_
+#define BACKENDS_P4TOOLS_MODULES_SMITH_BATCH_H_
+
+#include <cstdint>
+#include <string>
+
+#include "backends/p4tools/modules/smith/core/target.h"
+#include "backends/p4tools/modules/smith/options.h"
+
+namespace P4::P4Tools::P4Smith {
+
+/// Generates a program with @p target from @p seed, without the preamble of the target. The
+/// program only depends on the seed: it is the program that a separate invocation of P4Smith
+/// with this seed writes. Several threads can generate programs at the same time.
+std::string generateProgram(const SmithTarget &target, uint32_t seed);
+
+/// Generates SmithOptions::batchSize programs, using the seeds that follow @p baseSeed, on
+/// SmithOptions::threads threads. If SmithOptions::compileCheck is set, every program is parsed
+/// and run through the front and mid end of the compiler in this process. The programs whose
+/// generation or compilation fails are written to the directory SmithOptions::file, each with
+/// its seed and error. Compilation runs on the calling thread, one program at a time, because
+/// the compiler passes share the global compilation context.
+/// @returns EXIT_FAILURE if any program failed.
+int runBatch(const SmithOptions &options, uint32_t baseSeed);
+
+}  // namespace P4::P4Tools::P4Smith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_SMITH_BATCH_H_ */
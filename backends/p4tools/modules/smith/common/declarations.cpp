@@ -90,7 +90,7 @@ IR::Declaration_Constant *DeclarationGenerator::genConstantDeclaration() {
 
     IR::Declaration_Constant *ret = nullptr;
     // constant declarations need to be compile-time known
-    P4Scope::req.compile_time_known = true;
+    P4Scope::get().req.compile_time_known = true;
 
     if (tp->is<IR::Type_Bits>() || tp->is<IR::Type_InfInt>() || tp->is<IR::Type_Boolean>() ||
         tp->is<IR::Type_Name>()) {
@@ -99,7 +99,7 @@ IR::Declaration_Constant *DeclarationGenerator::genConstantDeclaration() {
     } else {
         BUG("Type %s not supported!", tp->node_type_name());
     }
-    P4Scope::req.compile_time_known = false;
+    P4Scope::get().req.compile_time_known = false;
 
     P4Scope::addToScope(ret);
 
@@ -111,14 +111,14 @@ IR::P4Action *DeclarationGenerator::genActionDeclaration() {
     IR::ParameterList *params = nullptr;
     IR::BlockStatement *blk = nullptr;
     P4Scope::startLocalScope();
-    P4Scope::prop.in_action = true;
+    P4Scope::get().prop.in_action = true;
     params = genParameterList();
 
     blk = target().statementGenerator().genBlockStatement(false);
 
     auto *ret = new IR::P4Action(name, params, blk);
 
-    P4Scope::prop.in_action = false;
+    P4Scope::get().prop.in_action = false;
     P4Scope::endLocalScope();
 
     P4Scope::addToScope(ret);
@@ -336,9 +336,9 @@ IR::Function *DeclarationGenerator::genFunctionDeclaration() {
     const auto *returnType = target().expressionGenerator().pickRndType(typePercent);
     tm = new IR::Type_Method(returnType, params, name);
 
-    P4Scope::prop.ret_type = returnType;
+    P4Scope::get().prop.ret_type = returnType;
     blk = target().statementGenerator().genBlockStatement(true);
-    P4Scope::prop.ret_type = nullptr;
+    P4Scope::get().prop.ret_type = nullptr;
 
     auto *ret = new IR::Function(name, tm, blk);
     P4Scope::endLocalScope();
@@ -395,7 +395,7 @@ IR::Type_Header *DeclarationGenerator::genHeaderTypeDeclaration() {
         fields.push_back(sf);
     }
     auto *ret = new IR::Type_Header(name, fields);
-    if (P4Scope::req.byte_align_headers) {
+    if (P4Scope::get().req.byte_align_headers) {
         auto remainder = ret->width_bits() % 8;
         if (remainder != 0) {
             const auto *padBit = IR::Type_Bits::get(8 - remainder, false);
@@ -498,7 +498,7 @@ IR::Type_Struct *DeclarationGenerator::genStructTypeDeclaration() {
         if (fieldTp->to<IR::Type_Array>() != nullptr) {
             // Right now there is now way to initialize a header stack
             // So we have to add the entire structure to the banned expressions
-            P4Scope::notInitializedStructs.insert(name);
+            P4Scope::get().notInitializedStructs.insert(name);
         }
         auto *sf = new IR::StructField(fieldName, fieldTp);
         fields.push_back(sf);
@@ -541,7 +541,7 @@ IR::Type_Struct *DeclarationGenerator::genHeaderStruct() {
                 tp = genHeaderStackType();
                 // Right now there is now way to initialize a header stack
                 // So we have to add the entire structure to the banned expressions
-                P4Scope::notInitializedStructs.insert(cstring("Headers"));
+                P4Scope::get().notInitializedStructs.insert(cstring("Headers"));
             }
         }
         fields.push_back(new IR::StructField(fieldName, tp));
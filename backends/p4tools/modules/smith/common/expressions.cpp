@@ -133,7 +133,7 @@ const IR::Type *ExpressionGenerator::pickRndType(TyperefProbs type_probs) {
             const auto *candidateType = lTypes.at(Utils::getRandInt(0, lTypes.size() - 1));
             auto typeName = candidateType->name.name;
             // check if struct is forbidden
-            if (P4Scope::notInitializedStructs.count(typeName) == 0) {
+            if (P4Scope::get().notInitializedStructs.count(typeName) == 0) {
                 tp = new IR::Type_Name(candidateType->name.name);
             } else {
                 tp = pickRndBaseType(basetypeProbs);
@@ -154,7 +154,7 @@ const IR::Type *ExpressionGenerator::pickRndType(TyperefProbs type_probs) {
             const auto *candidateType = lTypes.at(Utils::getRandInt(0, lTypes.size() - 1));
             auto typeName = candidateType->name.name;
             // check if struct is forbidden
-            if (P4Scope::notInitializedStructs.count(typeName) == 0) {
+            if (P4Scope::get().notInitializedStructs.count(typeName) == 0) {
                 tp = new IR::Type_Name(candidateType->name.name);
             } else {
                 tp = pickRndBaseType(basetypeProbs);
@@ -203,13 +203,13 @@ const IR::Type_Bits *ExpressionGenerator::genBitType(bool isSigned) const {
 
 IR::Constant *ExpressionGenerator::genIntLiteral(size_t bit_width) {
     big_int min = -((big_int(1) << bit_width - 1));
-    if (P4Scope::req.not_negative) {
+    if (P4Scope::get().req.not_negative) {
         min = 0;
     }
     big_int max = ((big_int(1) << bit_width - 1) - 1);
     big_int value = Utils::getRandBigInt(min, max);
     while (true) {
-        if (P4Scope::req.not_zero && value == 0) {
+        if (P4Scope::get().req.not_zero && value == 0) {
             value = Utils::getRandBigInt(min, max);
             // retry until we generate a value that is !zero
             continue;
@@ -228,13 +228,13 @@ IR::Constant *ExpressionGenerator::genBitLiteral(const IR::Type *tp) {
     if (tb->isSigned) {
         // int<N>
         big_int half = (maxUnsignedVal + 1) / 2;
-        big_int lo = P4Scope::req.not_negative ? big_int(0) : -half;
+        big_int lo = P4Scope::get().req.not_negative ? big_int(0) : -half;
         big_int hi = half - 1;
-        if (P4Scope::req.not_zero) {
+        if (P4Scope::get().req.not_zero) {
             lo = lo + 1;
         }
         big_int res = Utils::getRandBigInt(lo, hi);
-        if (P4Scope::req.not_zero && res == 0) {
+        if (P4Scope::get().req.not_zero && res == 0) {
             // When not_zero && !not_negative, lo = -half + 1, so 0 is still in range. Map it to
             // -half to get the desired uniform range.
             res = -half;
@@ -242,7 +242,7 @@ IR::Constant *ExpressionGenerator::genBitLiteral(const IR::Type *tp) {
         return new IR::Constant(tb, res);
     }
     // bit<N>
-    big_int lo = P4Scope::req.not_zero ? 1 : 0;
+    big_int lo = P4Scope::get().req.not_zero ? 1 : 0;
     big_int res = Utils::getRandBigInt(lo, maxUnsignedVal);
     return new IR::Constant(tb, res);
 }
@@ -251,7 +251,7 @@ IR::Expression *ExpressionGenerator::genExpression(const IR::Type *tp) {
     IR::Expression *expr = nullptr;
 
     // reset the expression depth
-    P4Scope::prop.depth = 0;
+    P4Scope::get().prop.depth = 0;
 
     if (const auto *tb = tp->to<IR::Type_Bits>()) {
         expr = constructBitExpr(tb);
@@ -279,14 +279,14 @@ IR::Expression *ExpressionGenerator::genExpression(const IR::Type *tp) {
         BUG("Expression: Type %s not yet supported", tp->node_type_name());
     }
     // reset the expression depth, just to be safe...
-    P4Scope::prop.depth = 0;
+    P4Scope::get().prop.depth = 0;
     return expr;
 }
 
 IR::MethodCallExpression *ExpressionGenerator::pickFunction(
     IR::IndexedVector<IR::Declaration> viable_functions, const IR::Type **ret_type) {
     // TODO(fruffy): Make this more sophisticated
-    if (viable_functions.empty() || P4Scope::req.compile_time_known) {
+    if (viable_functions.empty() || P4Scope::get().req.compile_time_known) {
         return nullptr;
     }
 
@@ -355,14 +355,14 @@ IR::ListExpression *ExpressionGenerator::genExpressionList(IR::Vector<IR::Type>
 IR::Expression *ExpressionGenerator::constructUnaryExpr(const IR::Type_Bits *tb) {
     IR::Expression *expr = nullptr;
 
-    if (P4Scope::prop.depth > MAX_DEPTH) {
+    if (P4Scope::get().prop.depth > MAX_DEPTH) {
         return genBitLiteral(tb);
     }
-    P4Scope::prop.depth++;
+    P4Scope::get().prop.depth++;
 
     // we want to avoid negation when we require no negative values
     int64_t negPct = Probabilities::get().EXPRESSION_BIT_UNARY_NEG;
-    if (P4Scope::req.not_negative) {
+    if (P4Scope::get().req.not_negative) {
         negPct = 0;
     }
 
@@ -379,9 +379,9 @@ IR::Expression *ExpressionGenerator::constructUnaryExpr(const IR::Type_Bits *tb)
             // pick a complement that matches the type
             // width must be known so we cast
             expr = constructBitExpr(tb);
-            if (P4Scope::prop.width_unknown) {
+            if (P4Scope::get().prop.width_unknown) {
                 expr = new IR::Cast(tb, expr);
-                P4Scope::prop.width_unknown = false;
+                P4Scope::get().prop.width_unknown = false;
             }
             expr = new IR::Cmpl(tb, expr);
         } break;
@@ -424,21 +424,21 @@ IR::Expression *ExpressionGenerator::constructUnaryExpr(const IR::Type_Bits *tb)
 IR::Expression *ExpressionGenerator::createSaturationOperand(const IR::Type_Bits *tb) {
     IR::Expression *expr = constructBitExpr(tb);
 
-    int width = P4Scope::constraints.max_phv_container_width;
+    int width = P4Scope::get().constraints.max_phv_container_width;
     if (width != 0) {
         if (tb->width_bits() > width) {
             const auto *type = IR::Type_Bits::get(width, false);
             expr = new IR::Cast(type, expr);
             expr->type = type;
-            P4Scope::prop.width_unknown = false;
+            P4Scope::get().prop.width_unknown = false;
             return expr;
         }
     }
 
     // width must be known so we cast
-    if (P4Scope::prop.width_unknown) {
+    if (P4Scope::get().prop.width_unknown) {
         expr = new IR::Cast(tb, expr);
-        P4Scope::prop.width_unknown = false;
+        P4Scope::get().prop.width_unknown = false;
     }
 
     expr->type = tb;
@@ -448,15 +448,15 @@ IR::Expression *ExpressionGenerator::createSaturationOperand(const IR::Type_Bits
 IR::Expression *ExpressionGenerator::constructBinaryBitExpr(const IR::Type_Bits *tb) {
     IR::Expression *expr = nullptr;
 
-    if (P4Scope::prop.depth > MAX_DEPTH) {
+    if (P4Scope::get().prop.depth > MAX_DEPTH) {
         return genBitLiteral(tb);
     }
-    P4Scope::prop.depth++;
+    P4Scope::get().prop.depth++;
 
     auto pctSub = Probabilities::get().EXPRESSION_BIT_BINARY_SUB;
     auto pctSubsat = Probabilities::get().EXPRESSION_BIT_BINARY_SUBSAT;
     // we want to avoid subtraction when we require no negative values
-    if (P4Scope::req.not_negative) {
+    if (P4Scope::get().req.not_negative) {
         pctSub = 0;
         pctSubsat = 0;
     }
@@ -486,26 +486,26 @@ IR::Expression *ExpressionGenerator::constructBinaryBitExpr(const IR::Type_Bits
             // pick a division that matches the type
             // TODO(fruffy): Make more sophisticated
             // this requires only compile time known values
-            bool savedNotNegative = P4Scope::req.not_negative;
-            P4Scope::req.not_negative = true;
+            bool savedNotNegative = P4Scope::get().req.not_negative;
+            P4Scope::get().req.not_negative = true;
             IR::Expression *left = genBitLiteral(tb);
-            P4Scope::req.not_zero = true;
+            P4Scope::get().req.not_zero = true;
             IR::Expression *right = genBitLiteral(tb);
-            P4Scope::req.not_zero = false;
-            P4Scope::req.not_negative = savedNotNegative;
+            P4Scope::get().req.not_zero = false;
+            P4Scope::get().req.not_negative = savedNotNegative;
             expr = new IR::Div(tb, left, right);
         } break;
         case 2: {
             // pick a modulo that matches the type
             // TODO(fruffy): Make more sophisticated
             // this requires only compile time known values
-            bool savedNotNegative = P4Scope::req.not_negative;
-            P4Scope::req.not_negative = true;
+            bool savedNotNegative = P4Scope::get().req.not_negative;
+            P4Scope::get().req.not_negative = true;
             IR::Expression *left = genBitLiteral(tb);
-            P4Scope::req.not_zero = true;
+            P4Scope::get().req.not_zero = true;
             IR::Expression *right = genBitLiteral(tb);
-            P4Scope::req.not_zero = false;
-            P4Scope::req.not_negative = savedNotNegative;
+            P4Scope::get().req.not_zero = false;
+            P4Scope::get().req.not_negative = savedNotNegative;
             expr = new IR::Mod(tb, left, right);
         } break;
         case 3: {
@@ -551,19 +551,19 @@ IR::Expression *ExpressionGenerator::constructBinaryBitExpr(const IR::Type_Bits
         case 7: {
             // width must be known so we cast
             IR::Expression *left = constructBitExpr(tb);
-            if (P4Scope::prop.width_unknown) {
+            if (P4Scope::get().prop.width_unknown) {
                 left = new IR::Cast(tb, left);
-                P4Scope::prop.width_unknown = false;
+                P4Scope::get().prop.width_unknown = false;
             }
             // TODO(fruffy): Make this more sophisticated,
-            bool savedNotNegative = P4Scope::req.not_negative;
-            P4Scope::req.not_negative = true;
+            bool savedNotNegative = P4Scope::get().req.not_negative;
+            P4Scope::get().req.not_negative = true;
             IR::Expression *right = constructBitExpr(tb);
-            P4Scope::req.not_negative = savedNotNegative;
+            P4Scope::get().req.not_negative = savedNotNegative;
             // TODO(fruffy): Make this more sophisticated
             // shifts are limited to 8 bits
-            if (P4Scope::constraints.const_lshift_count) {
-                right = genBitLiteral(IR::Type_Bits::get(P4Scope::req.shift_width, false));
+            if (P4Scope::get().constraints.const_lshift_count) {
+                right = genBitLiteral(IR::Type_Bits::get(P4Scope::get().req.shift_width, false));
             } else {
                 right = new IR::Cast(IR::Type_Bits::get(8, false), right);
             }
@@ -573,16 +573,16 @@ IR::Expression *ExpressionGenerator::constructBinaryBitExpr(const IR::Type_Bits
         case 8: {
             // width must be known so we cast
             IR::Expression *left = constructBitExpr(tb);
-            if (P4Scope::prop.width_unknown) {
+            if (P4Scope::get().prop.width_unknown) {
                 left = new IR::Cast(tb, left);
-                P4Scope::prop.width_unknown = false;
+                P4Scope::get().prop.width_unknown = false;
             }
 
             // TODO(fruffy): Make this more sophisticated,
-            bool savedNotNegative = P4Scope::req.not_negative;
-            P4Scope::req.not_negative = true;
+            bool savedNotNegative = P4Scope::get().req.not_negative;
+            P4Scope::get().req.not_negative = true;
             IR::Expression *right = constructBitExpr(tb);
-            P4Scope::req.not_negative = savedNotNegative;
+            P4Scope::get().req.not_negative = savedNotNegative;
             // shifts are limited to 8 bits
             right = new IR::Cast(IR::Type_Bits::get(8, false), right);
             // pick a right-shift that matches the type
@@ -617,14 +617,14 @@ IR::Expression *ExpressionGenerator::constructBinaryBitExpr(const IR::Type_Bits
             const auto *tr = IR::Type_Bits::get(split, false);
             // width must be known so we cast
             IR::Expression *left = constructBitExpr(tl);
-            if (P4Scope::prop.width_unknown) {
+            if (P4Scope::get().prop.width_unknown) {
                 left = new IR::Cast(tl, left);
-                P4Scope::prop.width_unknown = false;
+                P4Scope::get().prop.width_unknown = false;
             }
             IR::Expression *right = constructBitExpr(tr);
-            if (P4Scope::prop.width_unknown) {
+            if (P4Scope::get().prop.width_unknown) {
                 right = new IR::Cast(tr, right);
-                P4Scope::prop.width_unknown = false;
+                P4Scope::get().prop.width_unknown = false;
             }
             expr = new IR::Concat(tb, left, right);
         } break;
@@ -635,10 +635,10 @@ IR::Expression *ExpressionGenerator::constructBinaryBitExpr(const IR::Type_Bits
 IR::Expression *ExpressionGenerator::constructTernaryBitExpr(const IR::Type_Bits *tb) {
     IR::Expression *expr = nullptr;
 
-    if (P4Scope::prop.depth > MAX_DEPTH) {
+    if (P4Scope::get().prop.depth > MAX_DEPTH) {
         return genBitLiteral(tb);
     }
-    P4Scope::prop.depth++;
+    P4Scope::get().prop.depth++;
 
     // Slices are always unsigned, and should not be constructed for int<N> target types
     int64_t pctSlice = tb->isSigned ? 0 : Probabilities::get().EXPRESSION_BIT_BINARY_SLICE;
@@ -650,12 +650,13 @@ IR::Expression *ExpressionGenerator::constructTernaryBitExpr(const IR::Type_Bits
             // pick a slice that matches the type
             auto typeWidth = tb->width_bits();
             // TODO(fruffy): this is some arbitrary value...
-            auto newTypeSize = Utils::getRandInt(typeWidth, P4Scope::constraints.max_bitwidth);
+            auto newTypeSize =
+                Utils::getRandInt(typeWidth, P4Scope::get().constraints.max_bitwidth);
             const auto *sliceType = IR::Type_Bits::get(newTypeSize, false);
             auto *sliceExpr = constructBitExpr(sliceType);
-            if (P4Scope::prop.width_unknown) {
+            if (P4Scope::get().prop.width_unknown) {
                 sliceExpr = new IR::Cast(sliceType, sliceExpr);
-                P4Scope::prop.width_unknown = false;
+                P4Scope::get().prop.width_unknown = false;
             }
             auto margin = newTypeSize - typeWidth;
             auto high = Utils::getRandInt(0, margin) + typeWidth - 1;
@@ -667,14 +668,14 @@ IR::Expression *ExpressionGenerator::constructTernaryBitExpr(const IR::Type_Bits
             // pick a mux that matches the type
             IR::Expression *cond = constructBooleanExpr();
             IR::Expression *left = constructBitExpr(tb);
-            if (P4Scope::prop.width_unknown) {
+            if (P4Scope::get().prop.width_unknown) {
                 left = new IR::Cast(tb, left);
-                P4Scope::prop.width_unknown = false;
+                P4Scope::get().prop.width_unknown = false;
             }
             IR::Expression *right = constructBitExpr(tb);
-            if (P4Scope::prop.width_unknown) {
+            if (P4Scope::get().prop.width_unknown) {
                 right = new IR::Cast(tb, right);
-                P4Scope::prop.width_unknown = false;
+                P4Scope::get().prop.width_unknown = false;
             }
             expr = new IR::Mux(tb, cond, left, right);
         } break;
@@ -684,7 +685,7 @@ IR::Expression *ExpressionGenerator::constructTernaryBitExpr(const IR::Type_Bits
 
 IR::Expression *ExpressionGenerator::pickBitVar(const IR::Type_Bits *tb) {
     cstring nodeName = tb->node_type_name();
-    auto availBitTypes = P4Scope::lvalMap[nodeName].size();
+    auto availBitTypes = P4Scope::get().lvalMap[nodeName].size();
     if (P4Scope::checkLval(tb)) {
         cstring name = P4Scope::pickLval(tb);
         return new IR::PathExpression(name);
@@ -715,7 +716,7 @@ IR::Expression *ExpressionGenerator::constructBitExpr(const IR::Type_Bits *tb) {
             // pick a variable that matches the type
             // do !pick, if the requirement is to be a compile time known value
             // TODO(fruffy): This is lazy, we can easily check
-            if (P4Scope::req.compile_time_known) {
+            if (P4Scope::get().req.compile_time_known) {
                 expr = genBitLiteral(tb);
             } else {
                 expr = pickBitVar(tb);
@@ -723,11 +724,11 @@ IR::Expression *ExpressionGenerator::constructBitExpr(const IR::Type_Bits *tb) {
         } break;
         case 1: {
             // pick an int literal, if allowed
-            if (P4Scope::req.require_scalar) {
+            if (P4Scope::get().req.require_scalar) {
                 expr = genBitLiteral(tb);
             } else {
                 expr = constructIntExpr();
-                P4Scope::prop.width_unknown = true;
+                P4Scope::get().prop.width_unknown = true;
             }
         } break;
         case 2: {
@@ -755,7 +756,7 @@ IR::Expression *ExpressionGenerator::constructCmpExpr() {
 
     // Generate some random type. Can be either bits, int, bool, or structlike
     // For now it is just bits.
-    auto newTypeSize = Utils::getRandInt(1, P4Scope::constraints.max_bitwidth);
+    auto newTypeSize = Utils::getRandInt(1, P4Scope::get().constraints.max_bitwidth);
     const auto *newType = IR::Type_Bits::get(newTypeSize, false);
     IR::Expression *left = constructBitExpr(newType);
     IR::Expression *right = constructBitExpr(newType);
@@ -794,7 +795,7 @@ IR::Expression *ExpressionGenerator::constructBooleanExpr() {
         case 0: {
             const auto *tb = IR::Type_Boolean::get();
             // TODO(fruffy): This is lazy, we can easily check
-            if (P4Scope::req.compile_time_known) {
+            if (P4Scope::get().req.compile_time_known) {
                 expr = genBoolLiteral();
                 break;
             }
@@ -856,7 +857,7 @@ IR::Expression *ExpressionGenerator::constructBooleanExpr() {
             auto *tblSet = P4Scope::getCallableTables();
 
             // just generate a literal if there are no tables left
-            if (tblSet->empty() || P4Scope::req.compile_time_known) {
+            if (tblSet->empty() || P4Scope::get().req.compile_time_known) {
                 expr = genBoolLiteral();
                 break;
             }
@@ -877,15 +878,15 @@ IR::Expression *ExpressionGenerator::constructBooleanExpr() {
 IR::Expression *ExpressionGenerator::constructUnaryIntExpr() {
     IR::Expression *expr = nullptr;
 
-    if (P4Scope::prop.depth > MAX_DEPTH) {
+    if (P4Scope::get().prop.depth > MAX_DEPTH) {
         return genIntLiteral();
     }
     const auto *tp = IR::Type_InfInt::get();
-    P4Scope::prop.depth++;
+    P4Scope::get().prop.depth++;
 
     // we want to avoid negation when we require no negative values
     int64_t negPct = Probabilities::get().EXPRESSION_INT_UNARY_NEG;
-    if (P4Scope::req.not_negative) {
+    if (P4Scope::get().req.not_negative) {
         negPct = 0;
     }
 
@@ -925,15 +926,15 @@ IR::Expression *ExpressionGenerator::constructUnaryIntExpr() {
 
 IR::Expression *ExpressionGenerator::constructBinaryIntExpr() {
     IR::Expression *expr = nullptr;
-    if (P4Scope::prop.depth > MAX_DEPTH) {
+    if (P4Scope::get().prop.depth > MAX_DEPTH) {
         return genIntLiteral();
     }
     const auto *tp = IR::Type_InfInt::get();
-    P4Scope::prop.depth++;
+    P4Scope::get().prop.depth++;
 
     auto pctSub = Probabilities::get().EXPRESSION_INT_BINARY_SUB;
     // we want to avoid subtraction when we require no negative values
-    if (P4Scope::req.not_negative) {
+    if (P4Scope::get().req.not_negative) {
         pctSub = 0;
     }
 
@@ -958,25 +959,25 @@ IR::Expression *ExpressionGenerator::constructBinaryIntExpr() {
         case 1: {
             // pick a division that matches the type
             // TODO(fruffy): Make more sophisticated
-            bool savedNotNegative = P4Scope::req.not_negative;
-            P4Scope::req.not_negative = true;
+            bool savedNotNegative = P4Scope::get().req.not_negative;
+            P4Scope::get().req.not_negative = true;
             IR::Expression *left = genIntLiteral();
-            P4Scope::req.not_zero = true;
+            P4Scope::get().req.not_zero = true;
             IR::Expression *right = genIntLiteral();
-            P4Scope::req.not_zero = false;
-            P4Scope::req.not_negative = savedNotNegative;
+            P4Scope::get().req.not_zero = false;
+            P4Scope::get().req.not_negative = savedNotNegative;
             expr = new IR::Div(tp, left, right);
         } break;
         case 2: {
             // pick a modulo that matches the type
             // TODO(fruffy): Make more sophisticated
-            bool savedNotNegative = P4Scope::req.not_negative;
-            P4Scope::req.not_negative = true;
+            bool savedNotNegative = P4Scope::get().req.not_negative;
+            P4Scope::get().req.not_negative = true;
             IR::Expression *left = genIntLiteral();
-            P4Scope::req.not_zero = true;
+            P4Scope::get().req.not_zero = true;
             IR::Expression *right = genIntLiteral();
-            P4Scope::req.not_zero = false;
-            P4Scope::req.not_negative = savedNotNegative;
+            P4Scope::get().req.not_zero = false;
+            P4Scope::get().req.not_negative = savedNotNegative;
             expr = new IR::Mod(tp, left, right);
         } break;
         case 3: {
@@ -995,24 +996,24 @@ IR::Expression *ExpressionGenerator::constructBinaryIntExpr() {
             // width must be known so we cast
             IR::Expression *left = constructIntExpr();
             // TODO(fruffy): Make this more sophisticated,
-            bool savedNotNegative = P4Scope::req.not_negative;
-            P4Scope::req.not_negative = true;
+            bool savedNotNegative = P4Scope::get().req.not_negative;
+            P4Scope::get().req.not_negative = true;
             IR::Expression *right = constructIntExpr();
             // shifts are limited to 8 bits
             right = new IR::Cast(IR::Type_Bits::get(8, false), right);
-            P4Scope::req.not_negative = savedNotNegative;
+            P4Scope::get().req.not_negative = savedNotNegative;
             expr = new IR::Shl(tp, left, right);
         } break;
         case 6: {
             // width must be known so we cast
             IR::Expression *left = constructIntExpr();
             // TODO(fruffy): Make this more sophisticated,
-            bool savedNotNegative = P4Scope::req.not_negative;
-            P4Scope::req.not_negative = true;
+            bool savedNotNegative = P4Scope::get().req.not_negative;
+            P4Scope::get().req.not_negative = true;
             IR::Expression *right = constructIntExpr();
             // shifts are limited to 8 bits
             right = new IR::Cast(IR::Type_Bits::get(8, false), right);
-            P4Scope::req.not_negative = savedNotNegative;
+            P4Scope::get().req.not_negative = savedNotNegative;
             expr = new IR::Shr(tp, left, right);
         } break;
         case 7: {
@@ -1131,7 +1132,7 @@ IR::Expression *ExpressionGenerator::constructStructExpr(const IR::Type_Name *tn
         case 0:
             // pick a type from the available list
             // do !pick, if the requirement is to be a compile time known value
-            if (P4Scope::checkLval(tn) && !P4Scope::req.compile_time_known) {
+            if (P4Scope::checkLval(tn) && !P4Scope::get().req.compile_time_known) {
                 cstring lval = P4Scope::pickLval(tn);
                 expr = new IR::TypeNameExpression(lval);
             } else {
@@ -1182,9 +1183,9 @@ IR::Expression *ExpressionGenerator::genInputArg(const IR::Parameter *param) {
     }
     if (param->direction == IR::Direction::None) {
         // such args can only be compile-time constants
-        P4Scope::req.compile_time_known = true;
+        P4Scope::get().req.compile_time_known = true;
         auto *expr = genExpression(param->type);
-        P4Scope::req.compile_time_known = false;
+        P4Scope::get().req.compile_time_known = false;
         return expr;
     }
     // for inout and out the value must be writeable
@@ -1222,7 +1223,7 @@ IR::Expression *ExpressionGenerator::editHdrStack(cstring lval) {
     // Also, if we can not have variables inside the header stack index,
     // then just return the original expression.
     // FIXME: terrible but at least works for now
-    if ((lval.find('[') == nullptr) || P4Scope::constraints.const_header_stack_index) {
+    if ((lval.find('[') == nullptr) || P4Scope::get().constraints.const_header_stack_index) {
         return new IR::PathExpression(lval);
     }
 
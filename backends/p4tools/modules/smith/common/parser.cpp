@@ -227,9 +227,9 @@ void ParserGenerator::genState(cstring name) {
                 IR::Expression *matchSet = nullptr;
                 // TODO(fruffy): Do !always have a default
                 if (i == (numTransitions - 1)) {
-                    P4Scope::req.compile_time_known = true;
+                    P4Scope::get().req.compile_time_known = true;
                     matchSet = buildMatchExpr(types);
-                    P4Scope::req.compile_time_known = false;
+                    P4Scope::get().req.compile_time_known = false;
                 } else {
                     matchSet = new IR::DefaultExpression();
                 }
@@ -254,10 +254,10 @@ void ParserGenerator::genState(cstring name) {
                     }
                 }
             }
-            P4Scope::req.require_scalar = true;
+            P4Scope::get().req.require_scalar = true;
             IR::ListExpression *keySet =
                 target().expressionGenerator().genExpressionList(types, false);
-            P4Scope::req.require_scalar = false;
+            P4Scope::get().req.require_scalar = false;
             transition = new IR::SelectExpression(keySet, cases);
             break;
         }
@@ -266,12 +266,18 @@ void ParserGenerator::genState(cstring name) {
     // add to scope
     auto *ret = new IR::ParserState(name, components, transition);
     P4Scope::addToScope(ret);
-    state_list.push_back(ret);
+    P4Scope::get().parserStates.push_back(ret);
 }
 
 void ParserGenerator::buildParserTree() {
-    state_list.push_back(ParserGenerator::genStartState());
-    state_list.push_back(ParserGenerator::genHdrStates());
+    auto &states = P4Scope::get().parserStates;
+    states.clear();
+    states.push_back(ParserGenerator::genStartState());
+    states.push_back(ParserGenerator::genHdrStates());
+}
+
+IR::IndexedVector<IR::ParserState> ParserGenerator::getStates() const {
+    return P4Scope::get().parserStates;
 }
 
 }  // namespace P4::P4Tools::P4Smith
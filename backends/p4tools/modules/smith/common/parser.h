@@ -16,9 +16,6 @@
 namespace P4::P4Tools::P4Smith {
 
 class ParserGenerator : public Generator {
- private:
-    IR::IndexedVector<IR::ParserState> state_list;
-
  public:
     virtual ~ParserGenerator() = default;
     explicit ParserGenerator(const SmithTarget &target) : Generator(target) {}
@@ -33,7 +30,8 @@ class ParserGenerator : public Generator {
     virtual void genState(cstring name);
     virtual void buildParserTree();
 
-    [[nodiscard]] IR::IndexedVector<IR::ParserState> getStates() const { return state_list; }
+    /// @returns the states of the parser that is being generated, see P4Scope::parserStates.
+    [[nodiscard]] IR::IndexedVector<IR::ParserState> getStates() const;
 };
 
 }  // namespace P4::P4Tools::P4Smith
@@ -308,11 +308,15 @@ struct Probabilities {
     uint16_t VARIABLEDECLARATION_TYPE_VOID = TYPE_VOID;
     uint16_t VARIABLEDECLARATION_TYPE_MATCH_KIND = TYPE_MATCH_KIND;
 
+    /// @returns the instance of the current thread. Targets adjust it before generating a program.
     static Probabilities &get() {
-        static Probabilities INSTANCE;
+        static thread_local Probabilities INSTANCE;
         return INSTANCE;
     }
 
+    /// Restores the default values of the instance of the current thread.
+    static void reset() { get() = Probabilities(); }
+
  private:
     Probabilities() = default;
 };
@@ -343,11 +347,15 @@ struct Declarations {
     uint16_t MIN_TABLE = 0;
     uint16_t MAX_TABLE = 3;
 
+    /// @returns the instance of the current thread. Targets adjust it before generating a program.
     static Declarations &get() {
-        static Declarations INSTANCE;
+        static thread_local Declarations INSTANCE;
         return INSTANCE;
     }
 
+    /// Restores the default values of the instance of the current thread.
+    static void reset() { get() = Declarations(); }
+
  private:
     Declarations() = default;
 };
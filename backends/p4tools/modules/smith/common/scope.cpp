@@ -24,20 +24,25 @@
 
 namespace P4::P4Tools::P4Smith {
 
-std::vector<IR::Vector<IR::Node> *> P4Scope::scope = std::vector<IR::Vector<IR::Node> *>();
-std::set<cstring> P4Scope::usedNames;
-std::map<cstring, std::map<int, std::set<cstring>>> P4Scope::lvalMap;
-std::map<cstring, std::map<int, std::set<cstring>>> P4Scope::lvalMapRw;
-std::set<const IR::P4Table *> P4Scope::callableTables;
-
-// TODO(fruffy): This should be set by the back end
-std::set<cstring> P4Scope::notInitializedStructs;
-Properties P4Scope::prop;
-Requirements P4Scope::req;
-Constraints P4Scope::constraints;
+thread_local P4Scope *P4Scope::current = nullptr;
+
+P4Scope::Generation::Generation(P4Scope &state) : previous(current) { current = &state; }
+
+P4Scope::Generation::~Generation() { current = previous; }
+
+P4Scope &P4Scope::get() {
+    if (current != nullptr) {
+        return *current;
+    }
+    // Programs that are not generated within a Generation share this state. It is reachable
+    // from static storage, so the garbage collector sees the IR nodes it refers to.
+    static auto *shared = new P4Scope();
+    return *shared;
+}
+
 void P4Scope::addToScope(const IR::Node *node) {
     CHECK_NULL(node);
-    auto *lScope = P4Scope::scope.back();
+    auto *lScope = get().scope.back();
     lScope->push_back(node);
 
     if (const auto *dv = node->to<IR::Declaration_Variable>()) {
@@ -47,10 +52,10 @@ void P4Scope::addToScope(const IR::Node *node) {
     }
 }
 
-void P4Scope::startLocalScope() { scope.push_back(new IR::Vector<IR::Node>()); }
+void P4Scope::startLocalScope() { get().scope.push_back(new IR::Vector<IR::Node>()); }
 
 void P4Scope::endLocalScope() {
-    IR::Vector<IR::Node> *localScope = scope.back();
+    IR::Vector<IR::Node> *localScope = get().scope.back();
 
     for (const auto *node : *localScope) {
         if (const auto *decl = node->to<IR::Declaration_Variable>()) {
@@ -60,11 +65,11 @@ void P4Scope::endLocalScope() {
         } else if (const auto *param = node->to<IR::Parameter>()) {
             deleteLval(param->type, param->name.name);
         } else if (const auto *tbl = node->to<IR::P4Table>()) {
-            callableTables.erase(tbl);
+            get().callableTables.erase(tbl);
         }
     }
 
-    scope.pop_back();
+    get().scope.pop_back();
 }
 
 void addCompoundLvals(const IR::Type_StructLike *sl_type, cstring sl_name, bool read_only) {
@@ -140,28 +145,28 @@ void P4Scope::deleteLval(const IR::Type *tp, cstring name) {
     } else {
         BUG("Type %s not yet supported", tp->node_type_name());
     }
-    lvalMap[typeKey][bitBucket].erase(name);
+    get().lvalMap[typeKey][bitBucket].erase(name);
 
     // delete values in the normal map
-    if (lvalMap[typeKey][bitBucket].empty()) {
-        lvalMap[typeKey].erase(bitBucket);
+    if (get().lvalMap[typeKey][bitBucket].empty()) {
+        get().lvalMap[typeKey].erase(bitBucket);
     }
 
     // delete values in the rw map
-    if (lvalMapRw.count(typeKey) != 0) {
-        if (lvalMapRw[typeKey].count(bitBucket) != 0) {
-            lvalMapRw[typeKey][bitBucket].erase(name);
-            if (lvalMapRw[typeKey][bitBucket].empty()) {
-                lvalMapRw[typeKey].erase(bitBucket);
+    if (get().lvalMapRw.count(typeKey) != 0) {
+        if (get().lvalMapRw[typeKey].count(bitBucket) != 0) {
+            get().lvalMapRw[typeKey][bitBucket].erase(name);
+            if (get().lvalMapRw[typeKey][bitBucket].empty()) {
+                get().lvalMapRw[typeKey].erase(bitBucket);
             }
         }
     }
     // delete empty type entries
-    if (lvalMap[typeKey].empty()) {
-        lvalMap.erase(typeKey);
+    if (get().lvalMap[typeKey].empty()) {
+        get().lvalMap.erase(typeKey);
     }
-    if (lvalMapRw[typeKey].empty()) {
-        lvalMapRw.erase(typeKey);
+    if (get().lvalMapRw[typeKey].empty()) {
+        get().lvalMapRw.erase(typeKey);
     }
 }
 
@@ -226,9 +231,9 @@ void P4Scope::addLval(const IR::Type *tp, cstring name, bool read_only) {
         BUG("Type %s not yet supported", tp->node_type_name());
     }
     if (!read_only) {
-        lvalMapRw[typeKey][bitBucket].insert(name);
+        get().lvalMapRw[typeKey][bitBucket].insert(name);
     }
-    lvalMap[typeKey][bitBucket].insert(name);
+    get().lvalMap[typeKey][bitBucket].insert(name);
 }
 
 std::set<cstring> P4Scope::getCandidateLvals(const IR::Type *tp, bool must_write) {
@@ -263,9 +268,9 @@ std::set<cstring> P4Scope::getCandidateLvals(const IR::Type *tp, bool must_write
     std::map<cstring, std::map<int, std::set<cstring>>> lookupMap;
 
     if (must_write) {
-        lookupMap = lvalMapRw;
+        lookupMap = get().lvalMapRw;
     } else {
-        lookupMap = lvalMap;
+        lookupMap = get().lvalMap;
     }
 
     if (lookupMap.count(typeKey) == 0) {
@@ -281,13 +286,13 @@ std::set<cstring> P4Scope::getCandidateLvals(const IR::Type *tp, bool must_write
 
 std::optional<std::map<int, std::set<cstring>>> P4Scope::getWriteableLvalForTypeKey(
     cstring typeKey) {
-    if (lvalMapRw.find(typeKey) == lvalMapRw.end()) {
+    if (get().lvalMapRw.find(typeKey) == get().lvalMapRw.end()) {
         return std::nullopt;
     }
-    return lvalMapRw.at(typeKey);
+    return get().lvalMapRw.at(typeKey);
 }
 bool P4Scope::hasWriteableLval(cstring typeKey) {
-    return lvalMapRw.find(typeKey) != lvalMapRw.end();
+    return get().lvalMapRw.find(typeKey) != get().lvalMapRw.end();
 }
 
 bool P4Scope::checkLval(const IR::Type *tp, bool must_write) {
@@ -313,9 +318,9 @@ const IR::Type_Bits *P4Scope::pickDeclaredBitType(bool must_write) {
     std::map<cstring, std::map<int, std::set<cstring>>> lookupMap;
 
     if (must_write) {
-        lookupMap = lvalMapRw;
+        lookupMap = get().lvalMapRw;
     } else {
-        lookupMap = lvalMap;
+        lookupMap = get().lvalMap;
     }
 
     cstring bitKey = IR::Type_Bits::static_type_name();
@@ -330,7 +335,7 @@ const IR::Type_Bits *P4Scope::pickDeclaredBitType(bool must_write) {
 
 std::vector<const IR::Type_Declaration *> P4Scope::getFilteredDecls(std::set<cstring> filter) {
     std::vector<const IR::Type_Declaration *> ret;
-    for (auto *subScope : scope) {
+    for (auto *subScope : get().scope) {
         for (const auto *node : *subScope) {
             cstring name = node->node_type_name();
             if (filter.find(name) == filter.end()) {
@@ -343,10 +348,10 @@ std::vector<const IR::Type_Declaration *> P4Scope::getFilteredDecls(std::set<cst
     return ret;
 }
 
-std::set<const IR::P4Table *> *P4Scope::getCallableTables() { return &callableTables; }
+std::set<const IR::P4Table *> *P4Scope::getCallableTables() { return &get().callableTables; }
 
 const IR::Type_Declaration *P4Scope::getTypeByName(cstring name) {
-    for (auto *subScope : scope) {
+    for (auto *subScope : get().scope) {
         for (const auto *node : *subScope) {
             if (const auto *decl = node->to<IR::Type_Declaration>()) {
                 if (decl->name.name == name) {
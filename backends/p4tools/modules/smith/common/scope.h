@@ -13,6 +13,7 @@
 #include <set>
 #include <vector>
 
+#include "ir/indexed_vector.h"
 #include "ir/ir.h"
 #include "ir/node.h"
 #include "ir/vector.h"
@@ -57,41 +58,65 @@ struct Properties {
     Properties() = default;
 };
 
+/// The state of a program that is being generated. The static functions work on the state of
+/// the current thread, see @ref Generation, so that several programs can be generated at once.
 class P4Scope {
  public:
     /// This is a list of subscopes.
-    static std::vector<IR::Vector<IR::Node> *> scope;
+    std::vector<IR::Vector<IR::Node> *> scope;
 
     /// Maintain a set of names we have already used to avoid duplicates.
-    static std::set<cstring> usedNames;
+    std::set<cstring> usedNames;
 
     /// This is a map of usable lvalues we store to be used for references.
-    static std::map<cstring, std::map<int, std::set<cstring>>> lvalMap;
+    std::map<cstring, std::map<int, std::set<cstring>>> lvalMap;
 
     /// A subset of the lval map that includes rw values.
-    static std::map<cstring, std::map<int, std::set<cstring>>> lvalMapRw;
+    std::map<cstring, std::map<int, std::set<cstring>>> lvalMapRw;
 
     /// TODO: Maybe we can just remove tables from the declarations list?
     /// This is back-end specific.
-    static std::set<const IR::P4Table *> callableTables;
+    std::set<const IR::P4Table *> callableTables;
 
     /// Structs that should not be initialized because they are incomplete.
-    static std::set<cstring> notInitializedStructs;
+    // TODO(fruffy): This should be set by the back end
+    std::set<cstring> notInitializedStructs;
 
     /// Properties that define the current state of the program.
     /// For example, when should a return expression must be returned in a block.
-    static Properties prop;
+    Properties prop;
 
     /// Back-end or node-specific restrictions.
-    static Requirements req;
+    Requirements req;
 
     /// This defines all constraints specific to various targets or back-ends.
-    static Constraints constraints;
+    Constraints constraints;
+
+    /// The states of the parser that is being generated, see ParserGenerator.
+    IR::IndexedVector<IR::ParserState> parserStates;
 
     P4Scope() = default;
 
     ~P4Scope() = default;
 
+    /// Makes @p state the state of the programs generated on the current thread, for the
+    /// lifetime of this object. The caller owns @p state and must keep it where the garbage
+    /// collector finds the IR nodes it refers to, e.g., on its stack: the thread only keeps a
+    /// pointer to it, as the collector does not scan thread-local storage.
+    class Generation {
+        P4Scope *previous;
+
+     public:
+        explicit Generation(P4Scope &state);
+        ~Generation();
+        Generation(const Generation &) = delete;
+        Generation &operator=(const Generation &) = delete;
+    };
+
+    /// @returns the state of the program that is being generated on the current thread. Threads
+    /// without a Generation share a single state.
+    static P4Scope &get();
+
     static void addToScope(const IR::Node *n);
     static void startLocalScope();
     static void endLocalScope();
@@ -115,7 +140,7 @@ class P4Scope {
     static std::vector<const T *> getDecls() {
         std::vector<const T *> ret;
 
-        for (auto *subScope : scope) {
+        for (auto *subScope : get().scope) {
             for (const auto *node : *subScope) {
                 if (const T *tmpObj = node->to<T>()) {
                     ret.push_back(tmpObj);
@@ -127,6 +152,10 @@ class P4Scope {
 
     static std::vector<const IR::Type_Declaration *> getFilteredDecls(std::set<cstring> filter);
     static std::set<const IR::P4Table *> *getCallableTables();
+
+ private:
+    /// The state of the innermost Generation of the current thread, if any.
+    static thread_local P4Scope *current;
 };
 }  // namespace P4::P4Tools::P4Smith
 
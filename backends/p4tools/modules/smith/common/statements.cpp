@@ -64,7 +64,7 @@ IR::Statement *StatementGenerator::genStatement(bool is_in_func) {
             break;
         }
         case 3: {
-            stmt = genReturnStatement(P4Scope::prop.ret_type);
+            stmt = genReturnStatement(P4Scope::get().prop.ret_type);
             break;
         }
         case 4: {
@@ -121,8 +121,8 @@ IR::BlockStatement *StatementGenerator::genBlockStatement(bool is_in_func) {
 
     auto statOrDecls = genBlockStatementHelper(is_in_func);
 
-    if (is_in_func && (P4Scope::prop.ret_type->to<IR::Type_Void>() == nullptr)) {
-        auto *retStat = genReturnStatement(P4Scope::prop.ret_type);
+    if (is_in_func && (P4Scope::get().prop.ret_type->to<IR::Type_Void>() == nullptr)) {
+        auto *retStat = genReturnStatement(P4Scope::get().prop.ret_type);
         statOrDecls.push_back(retStat);
     }
     P4Scope::endLocalScope();
@@ -184,7 +184,7 @@ IR::Statement *StatementGenerator::genAssignmentStatement() {
                 return nullptr;
             }
             auto *left = target().expressionGenerator().pickLvalOrSlice(bitType);
-            if (P4Scope::constraints.single_stage_actions) {
+            if (P4Scope::get().constraints.single_stage_actions) {
                 removeLval(left, bitType);
             }
             auto *right = target().expressionGenerator().genExpression(bitType);
@@ -243,7 +243,7 @@ IR::Statement *StatementGenerator::genMethodCallStatement(bool is_in_func) {
         Probabilities::get().ASSIGNMENTORMETHODCALLSTATEMENT_METHOD_ACTION = 0;
         Probabilities::get().ASSIGNMENTORMETHODCALLSTATEMENT_METHOD_TABLE = 0;
     }
-    if (P4Scope::prop.in_action) {
+    if (P4Scope::get().prop.in_action) {
         Probabilities::get().ASSIGNMENTORMETHODCALLSTATEMENT_METHOD_CTRL = 0;
     }
     std::vector<int64_t> percent = {
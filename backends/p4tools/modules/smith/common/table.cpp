@@ -28,7 +28,7 @@ IR::P4Table *TableGenerator::genTableDeclaration() {
     cstring name = getRandomString(6);
     auto *ret = new IR::P4Table(name, tbProperties);
     P4Scope::addToScope(ret);
-    P4Scope::callableTables.emplace(ret);
+    P4Scope::get().callableTables.emplace(ret);
     return ret;
 }
 
@@ -79,9 +79,9 @@ IR::KeyElement *TableGenerator::genKeyElement(IR::ID match_kind) {
         return nullptr;
     }
     // this expression can!be an infinite precision integer
-    P4Scope::req.require_scalar = true;
+    P4Scope::get().req.require_scalar = true;
     auto *expr = target().expressionGenerator().genExpression(bitType);
-    P4Scope::req.require_scalar = false;
+    P4Scope::get().req.require_scalar = false;
     auto *key = new IR::KeyElement(expr, match, annotations);
 
     return key;
@@ -112,9 +112,9 @@ IR::MethodCallExpression *TableGenerator::genTableActionCall(cstring method_name
         IR::Argument *arg = nullptr;
         if (par->direction == IR::Direction::In) {
             // the generated expression needs to be compile-time known
-            P4Scope::req.compile_time_known = true;
+            P4Scope::get().req.compile_time_known = true;
             arg = new IR::Argument(target().expressionGenerator().genExpression(par->type));
-            P4Scope::req.compile_time_known = false;
+            P4Scope::get().req.compile_time_known = false;
         } else {
             arg = new IR::Argument(target().expressionGenerator().pickLvalOrSlice(par->type));
         }
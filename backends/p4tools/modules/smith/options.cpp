@@ -5,6 +5,8 @@
 #include "backends/p4tools/modules/smith/options.h"
 
 #include <cstdlib>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -39,6 +41,58 @@ void SmithOptions::processArgs(const std::vector<const char *> &args) {
     }
 }
 
-SmithOptions::SmithOptions() : AbstractP4cToolOptions(P4Smith::TOOL_NAME, "P4Smith options.") {}
+SmithOptions::SmithOptions() : AbstractP4cToolOptions(P4Smith::TOOL_NAME, "P4Smith options.") {
+    registerOption(
+        "--batch", "count",
+        [this](const char *arg) {
+            try {
+                batchSize = std::stoull(arg);
+                if (batchSize < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+            } catch (std::exception &) {
+                error("Invalid input value %1% for --batch. Expected positive integer.", arg);
+                return false;
+            }
+            return true;
+        },
+        "Generates the given number of programs in this process. The programs use consecutive "
+        "seeds, starting at --seed. Only the programs that fail are kept, in the directory given "
+        "as output file.");
+
+    registerOption(
+        "--threads", "threads",
+        [this](const char *arg) {
+            try {
+                threads = std::stoi(arg);
+                if (threads < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+            } catch (std::exception &) {
+                error("Invalid input value %1% for --threads. Expected positive integer.", arg);
+                return false;
+            }
+            return true;
+        },
+        "Generates programs on the given number of threads in batch mode [default: 1]. The "
+        "generated programs do not depend on the number of threads.");
+
+    registerOption(
+        "--compile-check", nullptr,
+        [this](const char *) {
+            compileCheck = true;
+            return true;
+        },
+        "Runs the front and mid end of the compiler on every program in batch mode, and keeps "
+        "the programs that are rejected or crash the compiler.");
+}
+
+bool SmithOptions::validateOptions() const {
+    if (batchSize == 0 && (threads > 1 || compileCheck)) {
+        error(ErrorType::ERR_INVALID, "--threads and --compile-check require --batch.");
+        return false;
+    }
+    return true;
+}
 
 }  // namespace P4::P4Tools
@@ -6,6 +6,7 @@
 
 #ifndef BACKENDS_P4TOOLS_MODULES_SMITH_OPTIONS_H_
 #define BACKENDS_P4TOOLS_MODULES_SMITH_OPTIONS_H_
+#include <cstdint>
 #include <vector>
 
 #include "backends/p4tools/common/options.h"
@@ -19,6 +20,20 @@ class SmithOptions : public AbstractP4cToolOptions {
     static SmithOptions &get();
 
     void processArgs(const std::vector<const char *> &args);
+
+    /// The number of programs that are generated in batch mode. In batch mode, the output file
+    /// is a directory that receives the programs that failed. Defaults to 0, which generates a
+    /// single program.
+    uint64_t batchSize = 0;
+
+    /// The number of threads that generate programs in batch mode. Defaults to 1.
+    int threads = 1;
+
+    /// Whether batch mode runs the front and mid end of the compiler on every program.
+    bool compileCheck = false;
+
+ protected:
+    bool validateOptions() const override;
 };
 
 }  // namespace P4::P4Tools
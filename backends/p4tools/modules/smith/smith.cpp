@@ -13,6 +13,7 @@
 #include "backends/p4tools/common/compiler/context.h"
 #include "backends/p4tools/common/lib/logging.h"
 #include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/modules/smith/batch.h"
 #include "backends/p4tools/modules/smith/common/probabilities.h"
 #include "backends/p4tools/modules/smith/common/scope.h"
 #include "backends/p4tools/modules/smith/core/target.h"
@@ -65,15 +66,6 @@ int Smith::mainImpl(const CompilerResult & /*result*/) {
 
     auto &smithOptions = P4Tools::SmithOptions::get();
 
-    // Use a default name if no specific output name is provided.
-    if (outputFile.empty()) {
-        outputFile = "out.p4";
-    }
-    auto ostream = openFile(outputFile, false);
-    if (ostream == nullptr) {
-        error("must have [file]");
-        exit(EXIT_FAILURE);
-    }
     if (smithOptions.seed.has_value()) {
         printInfo("Using provided seed");
     } else {
@@ -83,6 +75,20 @@ int Smith::mainImpl(const CompilerResult & /*result*/) {
         smithOptions.seed = r();
         Utils::setRandomSeed(*smithOptions.seed);
     }
+    if (smithOptions.batchSize > 0) {
+        printInfo("============ Batch seed %1% =============\n", *smithOptions.seed);
+        return runBatch(smithOptions, *smithOptions.seed);
+    }
+
+    // Use a default name if no specific output name is provided.
+    if (outputFile.empty()) {
+        outputFile = "out.p4";
+    }
+    auto ostream = openFile(outputFile, false);
+    if (ostream == nullptr) {
+        error("must have [file]");
+        exit(EXIT_FAILURE);
+    }
     // TODO(fruffy): Remove this. We are setting the seed in two frameworks.
     printInfo("============ Program seed %1% =============\n", *smithOptions.seed);
     const auto &smithTarget = SmithTarget::get();
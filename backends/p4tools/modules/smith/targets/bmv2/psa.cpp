@@ -369,7 +369,7 @@ void setBmv2PsaProbabilities() {
     // V1Model does !support headers that are !multiples of 8
     Probabilities::get().STRUCTTYPEDECLARATION_BASETYPE_BOOL = 0;
     // V1Model requires headers to be byte-aligned
-    P4Scope::req.byte_align_headers = true;
+    P4Scope::get().req.byte_align_headers = true;
 }
 
 }  // namespace
@@ -387,11 +387,11 @@ const IR::P4Program *Bmv2PsaSmithTarget::generateP4Program() const {
     P4Scope::startLocalScope();
 
     // insert banned structures
-    P4Scope::notInitializedStructs.insert("psa_ingress_parser_input_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("psa_ingress_input_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("psa_ingress_output_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("psa_egress_input_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("psa_egress_output_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_ingress_parser_input_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_ingress_input_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_ingress_output_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_egress_input_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_egress_output_metadata_t"_cs);
     // set psa-specific probabilities
     setBmv2PsaProbabilities();
     // insert some dummy metadata
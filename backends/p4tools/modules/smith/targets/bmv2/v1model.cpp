@@ -317,7 +317,7 @@ void setProbabilitiesforBmv2V1model() {
     // V1Model does  not support headers that are not multiples of 8
     Probabilities::get().STRUCTTYPEDECLARATION_BASETYPE_BOOL = 0;
     // V1Model requires headers to be byte-aligned
-    P4Scope::req.byte_align_headers = true;
+    P4Scope::get().req.byte_align_headers = true;
 }
 
 int Bmv2V1modelSmithTarget::writeTargetPreamble(std::ostream *ostream) const {
@@ -333,7 +333,7 @@ const IR::P4Program *Bmv2V1modelSmithTarget::generateP4Program() const {
     P4Scope::startLocalScope();
 
     // insert banned structures
-    P4Scope::notInitializedStructs.insert("standard_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("standard_metadata_t"_cs);
     // Set bmv2-v1model-specific probabilities.
     setProbabilitiesforBmv2V1model();
 
@@ -15,6 +15,7 @@ set(P4SMITH_GENERIC_TARGET_GTEST_SOURCES
     ${P4C_SOURCE_DIR}/test/gtest/helpers.cpp
     ${P4C_SOURCE_DIR}/test/gtest/gtestp4c.cpp
 
+    test/smith_batch_test.cpp
     test/smith_for_in_loop_test.cpp
     test/smith_for_loop_test.cpp
 )
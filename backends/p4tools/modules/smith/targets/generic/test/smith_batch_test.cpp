@@ -0,0 +1,50 @@
+#include <string>
+
+#ifdef MULTITHREAD
+#include <vector>
+#endif  // MULTITHREAD
+
+#include "backends/p4tools/modules/smith/batch.h"
+#include "backends/p4tools/modules/smith/targets/generic/target.h"
+#include "gtest/gtest.h"
+#ifdef MULTITHREAD
+#include "lib/thread_pool.h"
+#endif  // MULTITHREAD
+
+namespace P4::P4Tools::Test {
+
+using P4Tools::P4Smith::generateProgram;
+using P4Tools::P4Smith::Generic::GenericCoreSmithTarget;
+
+/// @brief The generated program only depends on the seed.
+TEST(P4SmithBatchTest, SeedDeterminesProgram) {
+    const auto &target = *GenericCoreSmithTarget::getInstance();
+    auto program = generateProgram(target, 1);
+    EXPECT_FALSE(program.empty());
+    EXPECT_NE(generateProgram(target, 2), program);
+    EXPECT_EQ(generateProgram(target, 1), program);
+}
+
+#ifdef MULTITHREAD
+/// @brief Programs generated on several threads at once match the programs generated in
+/// sequence.
+TEST(P4SmithBatchTest, ThreadsGenerateSamePrograms) {
+    const auto &target = *GenericCoreSmithTarget::getInstance();
+    constexpr int PROGRAMS = 8;
+    std::vector<std::string> expected;
+    for (int seed = 0; seed < PROGRAMS; ++seed) {
+        expected.push_back(generateProgram(target, seed));
+    }
+
+    // The workers of the pool are registered with the garbage collector.
+    std::vector<std::string> programs(PROGRAMS);
+    TaskGroup workers(ThreadPool::shared(PROGRAMS));
+    for (int seed = 0; seed < PROGRAMS; ++seed) {
+        workers.run([&, seed]() { programs[seed] = generateProgram(target, seed); });
+    }
+    workers.wait();
+    EXPECT_EQ(programs, expected);
+}
+#endif  // MULTITHREAD
+
+}  // namespace P4::P4Tools::Test
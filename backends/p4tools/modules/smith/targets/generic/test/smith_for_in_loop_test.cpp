@@ -24,10 +24,8 @@ class P4SmithForInLoopTest : public ::testing::Test {
             P4Tools::P4Smith::Generic::GenericCoreSmithTarget::getInstance();
         generator = &target->statementGenerator();
     }
-    void TearDown() override {
-        delete generator;
-        generator = nullptr;
-    }
+    // The generator is owned by the target.
+    void TearDown() override { generator = nullptr; }
 };
 
 /// @brief Test the generation of a for-in-loop statement.
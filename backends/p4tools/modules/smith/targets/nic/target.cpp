@@ -380,8 +380,8 @@ void setPnaDpdkProbabilities() {
     Probabilities::get().PARAMETER_BASETYPE_ERROR = 0;
     Probabilities::get().PARAMETER_BASETYPE_STRING = 0;
     Probabilities::get().PARAMETER_BASETYPE_VARBIT = 0;
-    P4Scope::req.byte_align_headers = true;
-    P4Scope::constraints.max_bitwidth = 64;
+    P4Scope::get().req.byte_align_headers = true;
+    P4Scope::get().constraints.max_bitwidth = 64;
 }
 
 int DpdkPnaSmithTarget::writeTargetPreamble(std::ostream *ostream) const {
@@ -396,11 +396,11 @@ int DpdkPnaSmithTarget::writeTargetPreamble(std::ostream *ostream) const {
 const IR::P4Program *DpdkPnaSmithTarget::generateP4Program() const {
     P4Scope::startLocalScope();
     // insert banned structures
-    P4Scope::notInitializedStructs.insert("psa_ingress_parser_input_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("psa_ingress_input_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("psa_ingress_output_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("psa_egress_input_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("psa_egress_output_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_ingress_parser_input_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_ingress_input_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_ingress_output_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_egress_input_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("psa_egress_output_metadata_t"_cs);
     // set psa-specific probabilities
     setPnaDpdkProbabilities();
     // insert some dummy metadata
@@ -287,15 +287,15 @@ void setTnaProbabilities() {
     // TNA does not support headers that are not multiples of 8.
     Probabilities::get().STRUCTTYPEDECLARATION_BASETYPE_BOOL = 0;
     // TNA requires headers to be byte-aligned.
-    P4Scope::req.byte_align_headers = true;
+    P4Scope::get().req.byte_align_headers = true;
     // TNA requires constant header stack indices.
-    P4Scope::constraints.const_header_stack_index = true;
+    P4Scope::get().constraints.const_header_stack_index = true;
     // TNA requires that the shift count in IR::SHL must be a constant.
-    P4Scope::constraints.const_lshift_count = true;
+    P4Scope::get().constraints.const_lshift_count = true;
     // TNA *currently* only supports single stage actions.
-    P4Scope::constraints.single_stage_actions = true;
+    P4Scope::get().constraints.single_stage_actions = true;
     // Saturating arithmetic operators mau not exceed maximum PHV container width.
-    P4Scope::constraints.max_phv_container_width = 32;
+    P4Scope::get().constraints.max_phv_container_width = 32;
 }
 
 IR::MethodCallStatement *generateDeparserEmitCall() {
@@ -549,14 +549,14 @@ const IR::P4Program *TofinoTnaSmithTarget::generateP4Program() const {
     P4Scope::startLocalScope();
 
     // insert banned structures
-    P4Scope::notInitializedStructs.insert("ingress_intrinsic_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("ingress_intrinsic_metadata_for_tm_t"_cs);
-    P4Scope::notInitializedStructs.insert("ingress_intrinsic_metadata_from_parser_t"_cs);
-    P4Scope::notInitializedStructs.insert("ingress_intrinsic_metadata_for_deparser_t"_cs);
-    P4Scope::notInitializedStructs.insert("egress_intrinsic_metadata_t"_cs);
-    P4Scope::notInitializedStructs.insert("egress_intrinsic_metadata_from_parser_t"_cs);
-    P4Scope::notInitializedStructs.insert("egress_intrinsic_metadata_for_deparser_t"_cs);
-    P4Scope::notInitializedStructs.insert("egress_intrinsic_metadata_for_output_port_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("ingress_intrinsic_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("ingress_intrinsic_metadata_for_tm_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("ingress_intrinsic_metadata_from_parser_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("ingress_intrinsic_metadata_for_deparser_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("egress_intrinsic_metadata_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("egress_intrinsic_metadata_from_parser_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("egress_intrinsic_metadata_for_deparser_t"_cs);
+    P4Scope::get().notInitializedStructs.insert("egress_intrinsic_metadata_for_output_port_t"_cs);
 
     // set tna-specific probabilities
     setTnaProbabilities();
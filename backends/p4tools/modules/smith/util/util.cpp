@@ -58,12 +58,12 @@ std::string getRandomString(size_t len) {
         }
 
         // The name is usable, break the loop.
-        if (P4Scope::usedNames.count(ret) == 0) {
+        if (P4Scope::get().usedNames.count(ret) == 0) {
             break;
         }
     }
 
-    P4Scope::usedNames.insert(ret);
+    P4Scope::get().usedNames.insert(ret);
     return ret;
 }
 
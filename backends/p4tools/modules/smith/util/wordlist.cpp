@@ -9,7 +9,7 @@
 
 namespace P4::P4Tools::P4Smith {
 
-std::size_t Wordlist::counter = 0;
+thread_local std::size_t Wordlist::counter = 0;
 
 const std::array<const char *, WORDLIST_LENGTH> Wordlist::WORDS = {
     "about",    "search",   "other",    "which",    "their",    "there",    "contact",  "business",
@@ -705,4 +705,6 @@ const char *P4Tools::P4Smith::Wordlist::getFromWordlist() {
     return "";
 }
 
+void P4Tools::P4Smith::Wordlist::reset() { counter = 0; }
+
 }  // namespace P4::P4Tools::P4Smith
@@ -25,9 +25,13 @@ class Wordlist {
     /// element from the array.
     static const char *getFromWordlist();
 
+    /// Starts again at the beginning of the array on the current thread.
+    static void reset();
+
  private:
-    /// Stores the address of the next word to be popped of the words array
-    static std::size_t counter;
+    /// Stores the address of the next word to be popped of the words array. Each thread pops its
+    /// own words.
+    static thread_local std::size_t counter;
 
     /// The actual array storing the words.
     static const std::array<const char *, WORDLIST_LENGTH> WORDS;
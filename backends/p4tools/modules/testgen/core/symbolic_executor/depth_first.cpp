@@ -6,14 +6,18 @@
 
 #include <functional>
 #include <iterator>
+#include <map>
+#include <utility>
 #include <vector>
 
+#include "backends/p4tools/common/lib/util.h"
 #include "ir/solver.h"
 #include "lib/error.h"
 #include "lib/timer.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
 #include "backends/p4tools/modules/testgen/lib/exceptions.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -23,6 +27,100 @@ namespace P4::P4Tools::P4Testgen {
 DepthFirstSearch::DepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo)
     : SymbolicExecutor(solver, programInfo) {}
 
+void DepthFirstSearch::enableCheckpoints(std::filesystem::path dir,
+                                         std::function<int64_t()> testCount) {
+    checkpointDir = std::move(dir);
+    this->testCount = std::move(testCount);
+}
+
+void DepthFirstSearch::resume(const Checkpoint &checkpoint) {
+    if (!Utils::setRandomState(checkpoint.randomState)) {
+        error("The checkpoint contains an invalid state of the random generator.");
+    }
+    // Replaying the branches consumes random numbers, so the state is restored again afterwards.
+    resumedRandomState = checkpoint.randomState;
+    std::vector<const IR::Node *> nodes(coverableNodes.begin(), coverableNodes.end());
+    for (auto position : checkpoint.visitedNodes) {
+        if (position < nodes.size()) {
+            visitedNodes.insert(nodes[position]);
+        }
+    }
+    resumedBranches = checkpoint.unexploredBranches;
+}
+
+void DepthFirstSearch::writeCheckpoint() {
+    Util::ScopedTimer checkpointTimer("checkpoint");
+    Checkpoint checkpoint;
+    checkpoint.testCount = testCount();
+    checkpoint.randomState = Utils::getRandomState();
+    uint64_t position = 0;
+    for (const auto *node : coverableNodes) {
+        if (visitedNodes.count(node) != 0) {
+            checkpoint.visitedNodes.push_back(position);
+        }
+        ++position;
+    }
+    for (const auto &branch : unexploredBranches) {
+        checkpoint.unexploredBranches.push_back(branch.nextState.get().getSelectedBranches());
+    }
+    if (checkpoint.write(*checkpointDir)) {
+        lastCheckpoint = std::chrono::steady_clock::now();
+    }
+}
+
+void DepthFirstSearch::replayBranches(const ExecutionState &initialState,
+                                      const std::vector<std::vector<uint64_t>> &branches) {
+    // The unexplored branches share most of their decisions. Remember the state after each
+    // prefix of decisions, so that every prefix is only replayed once.
+    std::map<std::vector<uint64_t>, ExecutionStateReference> replayed;
+    for (const auto &branch : branches) {
+        auto length = branch.size();
+        const ExecutionState *start = &initialState;
+        for (; length > 0; --length) {
+            auto it = replayed.find(std::vector<uint64_t>(branch.begin(), branch.begin() + length));
+            if (it != replayed.end()) {
+                start = &it->second.get();
+                break;
+            }
+        }
+
+        ExecutionStateReference state = start->clone();
+        bool valid = true;
+        try {
+            for (; valid && length < branch.size(); ++length) {
+                // Steps without a choice are not recorded as branch decisions.
+                StepResult successors = nullptr;
+                while (!state.get().isTerminal()) {
+                    successors = step(state);
+                    if (successors->size() != 1) {
+                        break;
+                    }
+                    state = successors->front().nextState;
+                }
+                auto decision = branch[length];
+                valid = !state.get().isTerminal() && decision > 0 &&
+                        decision <= successors->size();
+                if (valid) {
+                    for (uint64_t idx = 0; idx < successors->size(); ++idx) {
+                        (*successors)[idx].nextState.get().pushBranchDecision(idx + 1);
+                    }
+                    state = (*successors)[decision - 1].nextState;
+                    std::vector<uint64_t> prefix(branch.begin(), branch.begin() + length + 1);
+                    replayed.emplace(std::move(prefix), state.get().clone());
+                }
+            }
+        } catch (TestgenUnimplemented &) {
+            valid = false;
+        }
+        if (valid) {
+            unexploredBranches.emplace_back(state);
+        } else {
+            warning("Unable to replay the unexplored branch %1% of the checkpoint.",
+                    Utils::containerToString(branch));
+        }
+    }
+}
+
 std::optional<ExecutionStateReference> DepthFirstSearch::pickSuccessor(StepResult successors) {
     if (successors->empty()) {
         return std::nullopt;
@@ -33,6 +131,13 @@ std::optional<ExecutionStateReference> DepthFirstSearch::pickSuccessor(StepResul
         return successors->at(0).nextState;
     }
 
+    // Checkpoints describe the unexplored branches by the decisions that lead to them.
+    if (checkpointDir.has_value()) {
+        for (uint64_t idx = 0; idx < successors->size(); ++idx) {
+            (*successors)[idx].nextState.get().pushBranchDecision(idx + 1);
+        }
+    }
+
     // If there are multiple successors, try to pick one.
     // Pick a successor branch at random to preserve some non-determinism.
     auto newState = popRandomBranch(*successors).nextState;
@@ -43,12 +148,31 @@ std::optional<ExecutionStateReference> DepthFirstSearch::pickSuccessor(StepResul
 }
 
 void DepthFirstSearch::runImpl(const Callback &callBack, ExecutionStateReference executionState) {
+    if (resumedBranches.has_value()) {
+        replayBranches(executionState, *resumedBranches);
+        resumedBranches = std::nullopt;
+        Utils::setRandomState(*resumedRandomState);
+        resumedRandomState = std::nullopt;
+        if (unexploredBranches.empty()) {
+            if (checkpointDir.has_value()) {
+                writeCheckpoint();
+            }
+            return;
+        }
+        executionState = unexploredBranches.back().nextState;
+        unexploredBranches.pop_back();
+    }
+    lastCheckpoint = std::chrono::steady_clock::now();
+
     while (true) {
         try {
             if (executionState.get().isTerminal()) {
                 // We've reached the end of the program. Call back and (if desired) end execution.
                 bool terminate = handleTerminalState(callBack, executionState);
                 if (terminate) {
+                    if (checkpointDir.has_value()) {
+                        writeCheckpoint();
+                    }
                     return;
                 }
             } else {
@@ -74,6 +198,13 @@ void DepthFirstSearch::runImpl(const Callback &callBack, ExecutionStateReference
             warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
         }
 
+        // The current path is finished, so the unexplored branches describe all remaining work.
+        if (checkpointDir.has_value() &&
+            (unexploredBranches.empty() ||
+             std::chrono::steady_clock::now() - lastCheckpoint >= CHECKPOINT_INTERVAL)) {
+            writeCheckpoint();
+        }
+
         // Roll back to a previous branch and continue execution from there, but if there are no
         // more branches to explore, finish execution. Not all branches are viable, so we loop
         // until either we run out of unexplored branches or we find a viable branch.
@@ -7,12 +7,19 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DEPTH_FIRST_H_
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DEPTH_FIRST_H_
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include "ir/solver.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
 
 namespace P4::P4Tools::P4Testgen {
 
@@ -30,7 +37,35 @@ class DepthFirstSearch : public SymbolicExecutor {
     /// Constructor for this strategy, considering inheritance
     DepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo);
 
+    /// Periodically writes a checkpoint into @param dir, and once more when the exploration ends.
+    /// @param testCount returns the number of tests generated so far.
+    void enableCheckpoints(std::filesystem::path dir, std::function<int64_t()> testCount);
+
+    /// Continues the exploration that was saved in @param checkpoint instead of starting a new
+    /// one. Restores the visited nodes immediately. The unexplored branches are replayed from the
+    /// initial state when the executor runs, and the state of the random generator is restored
+    /// after the replay.
+    void resume(const Checkpoint &checkpoint);
+
  private:
+    /// The time between two checkpoints.
+    static constexpr auto CHECKPOINT_INTERVAL = std::chrono::seconds(60);
+
+    /// The directory that checkpoints are written into, if checkpoints are enabled.
+    std::optional<std::filesystem::path> checkpointDir;
+
+    /// Returns the number of tests generated so far.
+    std::function<int64_t()> testCount;
+
+    /// The time at which the last checkpoint was written.
+    std::chrono::steady_clock::time_point lastCheckpoint;
+
+    /// The unexplored branches of the checkpoint that is resumed, if any.
+    std::optional<std::vector<std::vector<uint64_t>>> resumedBranches;
+
+    /// The state of the random generator in the checkpoint that is resumed, if any.
+    std::optional<std::string> resumedRandomState;
+
     /// General unexplored branches.
     // Each element on this vector represents a set of alternative choices that could have been
     /// made along the current execution path.
@@ -49,6 +84,14 @@ class DepthFirstSearch : public SymbolicExecutor {
     /// nextState as this successors state.
     /// 3. If no successor with new statements was found set a random successor.
     [[nodiscard]] std::optional<ExecutionStateReference> pickSuccessor(StepResult successors);
+
+    /// Writes a checkpoint with the current unexplored branches.
+    void writeCheckpoint();
+
+    /// Replays the branch decisions of @p branches from @p initialState and adds the resulting
+    /// states to the unexplored branches. Branches that can not be replayed are skipped.
+    void replayBranches(const ExecutionState &initialState,
+                        const std::vector<std::vector<uint64_t>> &branches);
 };
 
 }  // namespace P4::P4Tools::P4Testgen
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/directed_coverage.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "backends/p4tools/common/compiler/reachability.h"
+#include "ir/ir.h"
+#include "ir/solver.h"
+#include "lib/error.h"
+#include "lib/timer.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+
+namespace P4::P4Tools::P4Testgen {
+
+DirectedCoverageSearch::DirectedCoverageSearch(AbstractSolver &solver,
+                                               const ProgramInfo &programInfo)
+    : SymbolicExecutor(solver, programInfo),
+      distances(programInfo.getCallGraph(),
+                DCGVertexTypeSet(coverableNodes.begin(), coverableNodes.end())) {}
+
+bool DirectedCoverageSearch::isFurther(const RankedBranch &left, const RankedBranch &right) {
+    if (left.distance != right.distance) {
+        return left.distance > right.distance;
+    }
+    return left.order < right.order;
+}
+
+uint32_t DirectedCoverageSearch::distanceOf(const IR::Node *node) const {
+    while (const auto *block = node->to<IR::BlockStatement>()) {
+        if (block->components.empty()) {
+            return TargetDistances::UNREACHABLE;
+        }
+        node = block->components.front();
+    }
+    return distances.distance(node);
+}
+
+uint32_t DirectedCoverageSearch::rank(const Branch &branch) const {
+    auto distance = TargetDistances::UNREACHABLE;
+    for (const auto *node : branch.potentialNodes) {
+        // Some coverable nodes, e.g., table entries, are not part of the call graph.
+        if (visitedNodes.count(node) == 0) {
+            return 0;
+        }
+        distance = std::min(distance, distances.distance(node));
+    }
+    auto nextCmd = branch.nextState.get().getNextCmd();
+    if (nextCmd.has_value()) {
+        if (const auto *node = std::get_if<const IR::Node *>(&nextCmd.value())) {
+            distance = std::min(distance, distanceOf(*node));
+        }
+    }
+    return distance;
+}
+
+void DirectedCoverageSearch::pushBranch(Branch branch, uint32_t distance) {
+    frontier.push_back({distance, rankedBranches++, std::move(branch)});
+    std::push_heap(frontier.begin(), frontier.end(), isFurther);
+}
+
+std::optional<ExecutionStateReference> DirectedCoverageSearch::popClosestBranch() {
+    while (!frontier.empty()) {
+        std::pop_heap(frontier.begin(), frontier.end(), isFurther);
+        auto closest = std::move(frontier.back());
+        frontier.pop_back();
+        // Distances only grow, so a branch whose distance is still current is the closest one.
+        if (closest.distance != TargetDistances::UNREACHABLE) {
+            auto distance = rank(closest.branch);
+            if (distance > closest.distance) {
+                closest.distance = distance;
+                frontier.push_back(std::move(closest));
+                std::push_heap(frontier.begin(), frontier.end(), isFurther);
+                continue;
+            }
+        }
+        return closest.branch.nextState;
+    }
+    return std::nullopt;
+}
+
+bool DirectedCoverageSearch::handleTerminal(const Callback &callBack,
+                                            const ExecutionState &terminalState) {
+    P4::Coverage::CoverageSet uncovered;
+    terminalState.getVisitedLog().forEachReversed([this, &uncovered](const IR::Node *node) {
+        if (visitedNodes.count(node) == 0) {
+            uncovered.insert(node);
+        }
+    });
+    bool terminate = handleTerminalState(callBack, terminalState);
+    stepsWithoutTest = 0;
+    // The nodes are only covered if a test was produced for the terminal state.
+    std::vector<DCGVertexType> covered;
+    std::copy_if(uncovered.begin(), uncovered.end(), std::back_inserter(covered),
+                 [this](const IR::Node *node) { return visitedNodes.count(node) != 0; });
+    if (!covered.empty()) {
+        Util::ScopedTimer distanceTimer("coverage_distances");
+        distances.removeTargets(covered);
+    }
+    return terminate;
+}
+
+std::optional<ExecutionStateReference> DirectedCoverageSearch::pickSuccessor(
+    StepResult successors) {
+    if (successors->empty()) {
+        return std::nullopt;
+    }
+    // If there is only one successor, choose it and move on.
+    if (successors->size() == 1) {
+        return successors->at(0).nextState;
+    }
+
+    stepsWithoutTest++;
+    for (auto &branch : *successors) {
+        // Only rank branches while we are still producing tests consistently.
+        // This guard is necessary to avoid getting caught in parser loops.
+        auto distance = stepsWithoutTest < MAX_STEPS_WITHOUT_TEST ? rank(branch)
+                                                                   : TargetDistances::UNREACHABLE;
+        pushBranch(std::move(branch), distance);
+    }
+    successors->clear();
+    return popClosestBranch();
+}
+
+void DirectedCoverageSearch::runImpl(const Callback &callBack,
+                                     ExecutionStateReference executionState) {
+    while (true) {
+        try {
+            if (executionState.get().isTerminal()) {
+                // We've reached the end of the program. Call back and (if desired) end execution.
+                if (handleTerminal(callBack, executionState)) {
+                    return;
+                }
+            } else {
+                // Take a step in the program, choose a branch, and continue execution. If
+                // branch selection fails, fall through to the roll-back code below.
+                StepResult successors = step(executionState);
+                auto nextState = pickSuccessor(successors);
+                if (nextState.has_value()) {
+                    executionState = nextState.value();
+                    continue;
+                }
+            }
+        } catch (TestgenUnimplemented &e) {
+            // If strict is enabled, bubble the exception up.
+            if (TestgenOptions::get().strict) {
+                throw;
+            }
+            // Otherwise we try to roll back as we typically do.
+            warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
+        }
+
+        // Roll back to the closest unexplored branch and continue execution from there, but if
+        // there are no more branches to explore, finish execution.
+        Util::ScopedTimer chooseBranchtimer("branch_selection");
+        auto nextState = popClosestBranch();
+        if (!nextState.has_value()) {
+            return;
+        }
+        executionState = nextState.value();
+    }
+}
+
+}  // namespace P4::P4Tools::P4Testgen
@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DIRECTED_COVERAGE_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DIRECTED_COVERAGE_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "backends/p4tools/common/compiler/reachability.h"
+#include "ir/ir.h"
+#include "ir/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+
+namespace P4::P4Tools::P4Testgen {
+
+/// Directed path selection strategy, which always continues with the unexplored branch that is
+/// closest to a node that has not been covered yet. The distances are the shortest distances in
+/// the call graph of the program, which are computed once and updated whenever a test covers new
+/// nodes. A branch is as close as the nearest of its potential nodes and of the next statement
+/// it executes. Among equally close branches, the most recent one is picked, so the strategy
+/// behaves like a depth-first search once nothing is left to cover. If the strategy takes too many
+/// steps without producing a test, new branches are ranked last until the next test. This is to
+/// prevent getting caught in a parser cycle.
+class DirectedCoverageSearch : public SymbolicExecutor {
+ public:
+    /// Executes the P4 program along the branches that are closest to uncovered nodes. When the
+    /// program terminates, the given callback is invoked. If the callback returns true, then the
+    /// executor terminates. Otherwise, execution of the P4 program continues on the next closest
+    /// branch.
+    void runImpl(const Callback &callBack, ExecutionStateReference executionState) override;
+
+    /// Constructor for this strategy, considering inheritance. Requires the call graph of the
+    /// program.
+    DirectedCoverageSearch(AbstractSolver &solver, const ProgramInfo &programInfo);
+
+ private:
+    /// An unexplored branch with its distance to the nearest uncovered node.
+    struct RankedBranch {
+        /// The distance at the time the branch was ranked. Distances only grow as coverage grows.
+        uint32_t distance;
+
+        /// The order in which the branches were ranked. Later branches win ties.
+        uint64_t order;
+
+        Branch branch;
+    };
+
+    /// The maximum number of steps without generating a test before ranking new branches last.
+    static const uint64_t MAX_STEPS_WITHOUT_TEST = 1000;
+
+    /// The number of branch decisions made without producing a test.
+    uint64_t stepsWithoutTest = 0;
+
+    /// The number of branches ranked so far.
+    uint64_t rankedBranches = 0;
+
+    /// The distances from every node of the call graph to the nearest uncovered node.
+    TargetDistances distances;
+
+    /// The unexplored branches, as a heap with the closest branch on top.
+    ///
+    /// Invariants:
+    ///   - Each element's path constraints are satisfiable.
+    ///   - The distance of each element is at most its current distance.
+    std::vector<RankedBranch> frontier;
+
+    /// Orders the frontier such that the closest and, among equally close branches, the most
+    /// recent branch is on top.
+    static bool isFurther(const RankedBranch &left, const RankedBranch &right);
+
+    /// @returns the distance from @param node to the nearest uncovered node. Block statements are
+    /// as close as their first statement.
+    [[nodiscard]] uint32_t distanceOf(const IR::Node *node) const;
+
+    /// @returns the distance from @param branch to the nearest uncovered node.
+    [[nodiscard]] uint32_t rank(const Branch &branch) const;
+
+    /// Adds @param branch to the frontier with the given @param distance.
+    void pushBranch(Branch branch, uint32_t distance);
+
+    /// Removes the closest branch from the frontier. Branches whose distance grew since they were
+    /// ranked are re-ranked first.
+    /// @returns std::nullopt if the frontier is empty.
+    [[nodiscard]] std::optional<ExecutionStateReference> popClosestBranch();
+
+    /// Invokes the callback for @param terminalState and removes the nodes that it covered from
+    /// the targets of the distances.
+    /// @returns true if symbolic execution should end.
+    bool handleTerminal(const Callback &callBack, const ExecutionState &terminalState);
+
+    /// Adds all given successors to the frontier and picks the closest unexplored branch.
+    [[nodiscard]] std::optional<ExecutionStateReference> pickSuccessor(StepResult successors);
+};
+
+}  // namespace P4::P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DIRECTED_COVERAGE_H_ */
@@ -40,12 +40,11 @@ std::optional<SymbolicExecutor::Branch> GreedyNodeSelection::popPotentialBranch(
         }
         // If we did not find anything, check whether this state covers any new nodes
         // already.
-        for (const auto &stmt : branch.nextState.get().getVisited()) {
-            if (coveredNodes.count(stmt) == 0U) {
-                candidateBranches[idx] = candidateBranches.back();
-                candidateBranches.pop_back();
-                return branch;
-            }
+        if (branch.nextState.get().getVisitedLog().anyOf(
+                [this](const IR::Node *node) { return coveredNodes.count(node) == 0U; })) {
+            candidateBranches[idx] = candidateBranches.back();
+            candidateBranches.pop_back();
+            return branch;
         }
     }
     return std::nullopt;
@@ -0,0 +1,242 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_depth_first.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "backends/p4tools/common/core/caching_solver.h"
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/util.h"
+#include "ir/ir.h"
+#include "ir/solver.h"
+#include "lib/error.h"
+#include "lib/thread_pool.h"
+#include "lib/timer.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/small_step/small_step.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+
+namespace P4::P4Tools::P4Testgen {
+
+ParallelDepthFirstSearch::ParallelDepthFirstSearch(AbstractSolver &solver,
+                                                   const ProgramInfo &programInfo,
+                                                   unsigned threads)
+    : SymbolicExecutor(solver, programInfo), threads(std::max(threads, 1U)) {}
+
+SymbolicExecutor::StepResult ParallelDepthFirstSearch::step(SmallStepEvaluator &evaluator,
+                                                            AbstractSolver &solver,
+                                                            ExecutionState &state) {
+    StepResult successors = nullptr;
+    {
+        Util::ScopedTimer st("step");
+        successors = evaluator.step(state);
+    }
+    successors->erase(
+        std::remove_if(successors->begin(), successors->end(),
+                       [&solver](const Branch &b) -> bool { return !evaluateBranch(b, solver); }),
+        successors->end());
+    return successors;
+}
+
+uint64_t ParallelDepthFirstSearch::extendPathHash(uint64_t pathHash, uint64_t value) {
+    // SplitMix64.
+    pathHash += value + 0x9e3779b97f4a7c15ULL;
+    pathHash = (pathHash ^ (pathHash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    pathHash = (pathHash ^ (pathHash >> 27)) * 0x94d049bb133111ebULL;
+    return pathHash ^ (pathHash >> 31);
+}
+
+std::vector<size_t> ParallelDepthFirstSearch::branchOrder(uint64_t pathHash, size_t count) {
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    if (count > 1) {
+        auto first = order.begin() + static_cast<int64_t>(pathHash % count);
+        std::rotate(order.begin(), first, first + 1);
+    }
+    return order;
+}
+
+std::optional<ParallelDepthFirstSearch::Work> ParallelDepthFirstSearch::takeWork(unsigned worker) {
+    // Too many terminal states are waiting for a path that precedes them. Only explore that path.
+    if (pending.size() >= MAX_PENDING_STATES && !live.empty()) {
+        const auto &first = *live.begin();
+        for (auto &queue : queues) {
+            auto it = std::find_if(queue.begin(), queue.end(),
+                                   [&first](const Work &work) { return work.key == first; });
+            if (it != queue.end()) {
+                Work work = std::move(*it);
+                queue.erase(it);
+                return work;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Continue below the most recent branch point of this thread, otherwise steal the branch
+    // closest to the root from another thread.
+    if (auto &queue = queues[worker]; !queue.empty()) {
+        Work work = std::move(queue.back());
+        queue.pop_back();
+        return work;
+    }
+    for (unsigned i = 1; i < threads; ++i) {
+        auto &queue = queues[(worker + i) % threads];
+        if (!queue.empty()) {
+            Work work = std::move(queue.front());
+            queue.pop_front();
+            return work;
+        }
+    }
+    return std::nullopt;
+}
+
+bool ParallelDepthFirstSearch::canEmit() const {
+    return !pending.empty() && (live.empty() || pending.begin()->first < *live.begin());
+}
+
+void ParallelDepthFirstSearch::explore(unsigned worker) {
+    // Z3 contexts can not be shared between threads.
+    Z3Solver z3Solver;
+    std::optional<CachingSolver> cachingSolver;
+    AbstractSolver &solver = TestgenOptions::get().solverCache
+                                 ? static_cast<AbstractSolver &>(cachingSolver.emplace(z3Solver))
+                                 : z3Solver;
+    auto seed = Utils::getCurrentSeed();
+    if (seed != std::nullopt) {
+        solver.seed(*seed);
+    }
+    SmallStepEvaluator evaluator(solver, programInfo);
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        std::optional<Work> work;
+        changed.wait(guard, [&] { return stop || live.empty() || (work = takeWork(worker)); });
+        if (!work) {
+            break;
+        }
+        guard.unlock();
+
+        auto key = std::move(work->key);
+        auto pathHash = work->pathHash;
+        auto state = work->state;
+        std::vector<Branch> successors;
+        try {
+            while (!stop && !state.get().isTerminal()) {
+                successors = std::move(*step(evaluator, solver, state));
+                if (successors.size() != 1) {
+                    break;
+                }
+                state = successors.front().nextState;
+            }
+        } catch (TestgenUnimplemented &e) {
+            successors.clear();
+            if (TestgenOptions::get().strict) {
+                guard.lock();
+                failure = failure ? failure : std::current_exception();
+                stop = true;
+                guard.unlock();
+            } else {
+                warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
+            }
+        } catch (...) {
+            successors.clear();
+            guard.lock();
+            failure = failure ? failure : std::current_exception();
+            stop = true;
+            guard.unlock();
+        }
+
+        guard.lock();
+        live.erase(key);
+        if (!stop && state.get().isTerminal()) {
+            pending.emplace(key, state);
+        } else if (!stop && successors.size() > 1) {
+            // The key of a successor is its position in the order, and the first one ends up on
+            // top. Decisions are only recorded for --track-branches.
+            auto order = branchOrder(pathHash, successors.size());
+            for (auto rank = order.size(); rank-- > 0;) {
+                auto idx = order[rank];
+                auto successorKey = key;
+                successorKey.push_back(static_cast<uint32_t>(rank));
+                live.insert(successorKey);
+                if (TestgenOptions::get().trackBranches) {
+                    successors[idx].nextState.get().pushBranchDecision(idx + 1);
+                }
+                queues[worker].push_back({std::move(successorKey),
+                                          extendPathHash(pathHash, idx + 1),
+                                          successors[idx].nextState});
+            }
+        }
+        changed.notify_all();
+    }
+}
+
+void ParallelDepthFirstSearch::runImpl(const Callback &callBack,
+                                       ExecutionStateReference executionState) {
+    queues.assign(threads, {});
+    live.clear();
+    live.insert(PathKey());
+    pending.clear();
+    stop = false;
+    failure = nullptr;
+    queues.front().push_back(
+        {PathKey(), extendPathHash(0, Utils::getCurrentSeed().value_or(0)), executionState});
+
+    TaskGroup workers(ThreadPool::shared(threads));
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.run([this, i] { explore(i); });
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        changed.wait(guard, [this] { return failure || canEmit() || live.empty(); });
+        if (failure || !canEmit()) {
+            break;
+        }
+        auto terminalState = pending.begin()->second;
+        pending.erase(pending.begin());
+        changed.notify_all();
+        guard.unlock();
+        bool terminate = false;
+        std::exception_ptr exception;
+        try {
+            terminate = handleTerminalState(callBack, terminalState);
+        } catch (TestgenUnimplemented &e) {
+            if (TestgenOptions::get().strict) {
+                exception = std::current_exception();
+                terminate = true;
+            } else {
+                warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
+            }
+        } catch (...) {
+            exception = std::current_exception();
+            terminate = true;
+        }
+        guard.lock();
+        failure = failure ? failure : exception;
+        if (terminate) {
+            break;
+        }
+    }
+    stop = true;
+    changed.notify_all();
+    guard.unlock();
+    workers.wait();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+}  // namespace P4::P4Tools::P4Testgen
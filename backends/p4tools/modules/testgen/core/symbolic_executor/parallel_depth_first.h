@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "ir/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/small_step/small_step.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+
+namespace P4::P4Tools::P4Testgen {
+
+/// A depth-first traversal that explores paths on several threads of the shared ThreadPool. Each
+/// thread owns its own solver and small-step evaluator and a deque of unexplored branches. The
+/// successors of a branch point are ordered by @ref branchOrder. A thread continues with the first
+/// successor and pushes the others onto the back of its deque. Idle threads steal from the front
+/// of the other deques, which holds the branches closest to the root.
+///
+/// Terminal states are handed to the thread that called @ref run, which checks them with the
+/// solver of this executor and invokes the callback one state at a time. The states are ordered by
+/// the positions of the successors chosen on the path to them. A state is only passed to the
+/// callback once no state that precedes it can be found anymore, so the callback sees the same
+/// paths in the same order for any number of threads. DepthFirstSearch picks branches with the
+/// global random generator instead, so it visits the paths in a different order.
+class ParallelDepthFirstSearch : public SymbolicExecutor {
+ public:
+    /// Executes the P4 program on all threads. Terminal states are passed to the given
+    /// callback in a deterministic order. If the callback returns true, all threads stop.
+    void runImpl(const Callback &callBack, ExecutionStateReference executionState) override;
+
+    ParallelDepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo,
+                             unsigned threads);
+
+ private:
+    /// The positions, in the order of @ref branchOrder, of the successors that were chosen at each
+    /// branch point on the path to a state.
+    using PathKey = std::vector<uint32_t>;
+
+    /// An unexplored branch and the path that leads to it.
+    struct Work {
+        PathKey key;
+        /// The hash of the --seed and the branch decisions on the path, see @ref extendPathHash.
+        uint64_t pathHash;
+        ExecutionStateReference state;
+    };
+
+    /// The maximum number of terminal states that wait for the callback before the threads only
+    /// explore the first remaining path.
+    static constexpr size_t MAX_PENDING_STATES = 256;
+
+    /// The number of threads that explore paths.
+    unsigned threads;
+
+    /// Protects all of the members below.
+    std::mutex lock;
+
+    /// Signalled whenever work, a terminal state or a stop request becomes available.
+    std::condition_variable changed;
+
+    /// The unexplored branches of each thread.
+    std::vector<std::deque<Work>> queues;
+
+    /// The keys of all paths that are queued or being explored.
+    std::set<PathKey> live;
+
+    /// Terminal states that have not been passed to the callback yet.
+    std::map<PathKey, ExecutionStateReference> pending;
+
+    /// Set when exploration should end.
+    std::atomic<bool> stop = false;
+
+    /// The first exception thrown by a thread.
+    std::exception_ptr failure;
+
+    /// Explores paths until there is nothing left to explore or exploration is stopped.
+    void explore(unsigned worker);
+
+    /// Removes the next branch for @p worker from the queues. Once too many terminal states are
+    /// pending, only the first live path is taken.
+    /// @returns std::nullopt if no suitable branch is queued.
+    std::optional<Work> takeWork(unsigned worker);
+
+    /// @returns true if the first pending terminal state can be passed to the callback.
+    [[nodiscard]] bool canEmit() const;
+
+    /// @returns the hash of the path that extends the path with hash @p pathHash by @p value. The
+    /// hash of the path to the initial state extends 0 by the --seed.
+    static uint64_t extendPathHash(uint64_t pathHash, uint64_t value);
+
+    /// @returns the order in which the @p count successors of a branch point are explored: a
+    /// successor chosen by @p pathHash, the hash of the path to the branch point, followed by the
+    /// others in order. The order does not depend on the order in which paths are explored.
+    static std::vector<size_t> branchOrder(uint64_t pathHash, size_t count);
+
+    /// Takes one step with @p evaluator and removes the successors that @p solver can not satisfy.
+    static StepResult step(SmallStepEvaluator &evaluator, AbstractSolver &solver,
+                           ExecutionState &state);
+};
+
+}  // namespace P4::P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_ */
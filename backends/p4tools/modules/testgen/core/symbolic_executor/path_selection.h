@@ -15,10 +15,12 @@ enum class PathSelectionPolicy {
     DepthFirst,
     RandomBacktrack,
     GreedyStmtCoverage,
+    DirectedCoverage,
 };
 
 inline bool requiresLookahead(PathSelectionPolicy &pathSelectionPolicy) {
-    static const std::set LOOKAHEAD_STRATEGYIES = {PathSelectionPolicy::GreedyStmtCoverage};
+    static const std::set LOOKAHEAD_STRATEGYIES = {PathSelectionPolicy::GreedyStmtCoverage,
+                                                  PathSelectionPolicy::DirectedCoverage};
     return LOOKAHEAD_STRATEGYIES.find(pathSelectionPolicy) != LOOKAHEAD_STRATEGYIES.end();
 }
 
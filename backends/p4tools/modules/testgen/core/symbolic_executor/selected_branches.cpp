@@ -97,7 +97,7 @@ SelectedBranches::SelectedBranches(AbstractSolver &solver, const ProgramInfo &pr
 ExecutionState *SelectedBranches::chooseBranch(const std::vector<Branch> &branches,
                                                uint64_t nextBranch) {
     for (const auto &branch : branches) {
-        const auto &selectedBranches = branch.nextState.get().getSelectedBranches();
+        const auto &selectedBranches = branch.nextState.get().getSelectedBranchLog();
         BUG_CHECK(!selectedBranches.empty(), "Corrupted selectedBranches in a execution state");
         // Find branch matching given branch identifier.
         if (selectedBranches.back() == nextBranch) {
@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "backends/p4tools/common/lib/hash_cons.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "ir/ir.h"
 #include "ir/solver.h"
@@ -26,6 +27,10 @@
 
 namespace P4::P4Tools::P4Testgen {
 
+/// The number of interned expressions above which the intern table is dropped between paths.
+/// Expressions are shared between paths, but the table otherwise grows with every path.
+static constexpr size_t kMaxInternedExpressions = 1 << 20;
+
 SymbolicExecutor::StepResult SymbolicExecutor::step(ExecutionState &state) {
     StepResult successors = nullptr;
     // Use a scope here to measure the time it takes for a step.
@@ -64,7 +69,11 @@ bool SymbolicExecutor::handleTerminalState(const Callback &callback,
     // final symbolic environment and trace, use it to evaluate the
     // final execution state, and finally delegate to the callback.
     const FinalState finalState(solver, terminalState);
-    return callback(finalState);
+    auto done = callback(finalState);
+    if (HashCons::size() > kMaxInternedExpressions) {
+        HashCons::clear();
+    }
+    return done;
 }
 
 bool SymbolicExecutor::evaluateBranch(const SymbolicExecutor::Branch &branch,
@@ -104,11 +113,11 @@ SymbolicExecutor::SymbolicExecutor(AbstractSolver &solver, const ProgramInfo &pr
     }
 }
 
-bool SymbolicExecutor::updateVisitedNodes(const P4::Coverage::CoverageSet &newNodes) {
+bool SymbolicExecutor::updateVisitedNodes(const PersistentLog<const IR::Node *> &newNodes) {
     auto hasUpdated = false;
-    for (const auto *newNode : newNodes) {
+    newNodes.forEachReversed([this, &hasUpdated](const IR::Node *newNode) {
         hasUpdated |= visitedNodes.insert(newNode).second;
-    }
+    });
     return hasUpdated;
 }
 
@@ -11,6 +11,7 @@
 #include <iosfwd>
 #include <vector>
 
+#include "backends/p4tools/common/lib/persistent_log.h"
 #include "ir/solver.h"
 #include "midend/coverage.h"
 
@@ -61,7 +62,7 @@ class SymbolicExecutor {
     const P4::Coverage::CoverageSet &getVisitedNodes();
 
     /// Update the set of visited nodes. Returns true if there was an update.
-    [[nodiscard]] bool updateVisitedNodes(const P4::Coverage::CoverageSet &newNodes);
+    [[nodiscard]] bool updateVisitedNodes(const PersistentLog<const IR::Node *> &newNodes);
 
  protected:
     /// Target-specific information about the P4 program.
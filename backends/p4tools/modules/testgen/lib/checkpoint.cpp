@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
+
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+#include "lib/error.h"
+
+namespace P4::P4Tools::P4Testgen {
+
+namespace {
+
+/// The name of the checkpoint file within the checkpoint directory.
+constexpr const char *CHECKPOINT_FILE = "checkpoint";
+
+/// The first line of a checkpoint file. Changes to the format need a new version.
+constexpr const char *CHECKPOINT_HEADER = "P4TESTGEN_CHECKPOINT 1";
+
+}  // namespace
+
+bool Checkpoint::write(const std::filesystem::path &dir) const {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        error("Unable to create checkpoint directory %1%: %2%", dir.c_str(), ec.message());
+        return false;
+    }
+    auto path = dir / CHECKPOINT_FILE;
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream out(temporaryPath);
+        out << CHECKPOINT_HEADER << "\n";
+        out << "tests " << testCount << "\n";
+        out << "random " << randomState << "\n";
+        out << "visited " << visitedNodes.size();
+        for (auto node : visitedNodes) {
+            out << " " << node;
+        }
+        out << "\n";
+        out << "branches " << unexploredBranches.size() << "\n";
+        for (const auto &branch : unexploredBranches) {
+            const char *separator = "";
+            for (auto decision : branch) {
+                out << separator << decision;
+                separator = ",";
+            }
+            out << "\n";
+        }
+        out.flush();
+        if (!out) {
+            error("Unable to write checkpoint %1%", temporaryPath.c_str());
+            return false;
+        }
+    }
+    // Replace the previous checkpoint only once the new one is complete.
+    std::filesystem::rename(temporaryPath, path, ec);
+    if (ec) {
+        error("Unable to write checkpoint %1%: %2%", path.c_str(), ec.message());
+        return false;
+    }
+    return true;
+}
+
+std::optional<Checkpoint> Checkpoint::read(const std::filesystem::path &dir) {
+    auto path = dir / CHECKPOINT_FILE;
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        error("Unable to open checkpoint %1%", path.c_str());
+        return std::nullopt;
+    }
+
+    Checkpoint checkpoint;
+    std::string header;
+    std::string keyword;
+    size_t visitedCount = 0;
+    size_t branchCount = 0;
+    bool valid = std::getline(in, header) && header == CHECKPOINT_HEADER;
+    valid = valid && in >> keyword >> checkpoint.testCount && keyword == "tests";
+    valid = valid && in >> keyword && keyword == "random" &&
+            std::getline(in >> std::ws, checkpoint.randomState);
+    valid = valid && in >> keyword >> visitedCount && keyword == "visited";
+    for (size_t i = 0; valid && i < visitedCount; ++i) {
+        uint64_t node = 0;
+        valid = static_cast<bool>(in >> node);
+        checkpoint.visitedNodes.push_back(node);
+    }
+    valid = valid && in >> keyword >> branchCount && keyword == "branches";
+    for (size_t i = 0; valid && i < branchCount; ++i) {
+        std::string line;
+        valid = static_cast<bool>(in >> line);
+        std::stringstream decisions(line);
+        auto &branch = checkpoint.unexploredBranches.emplace_back();
+        for (std::string decision; valid && std::getline(decisions, decision, ',');) {
+            try {
+                branch.push_back(std::stoull(decision));
+            } catch (std::exception &) {
+                valid = false;
+            }
+        }
+    }
+    if (!valid) {
+        error("Invalid checkpoint %1%", path.c_str());
+        return std::nullopt;
+    }
+    return checkpoint;
+}
+
+}  // namespace P4::P4Tools::P4Testgen
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace P4::P4Tools::P4Testgen {
+
+/// The state of an exploration that is needed to continue it in a later run of P4Testgen.
+struct Checkpoint {
+    /// The number of tests that have been generated.
+    int64_t testCount = 0;
+
+    /// The state of the random generator, see Utils::getRandomState.
+    std::string randomState;
+
+    /// The positions of the visited nodes in the set of coverable nodes of the program.
+    std::vector<uint64_t> visitedNodes;
+
+    /// The unexplored branches. Each branch is described by the branch decisions that lead to
+    /// it, in the format that is accepted by --input-branches.
+    std::vector<std::vector<uint64_t>> unexploredBranches;
+
+    /// Writes the checkpoint into @p dir, replacing the previous checkpoint in @p dir. A reader
+    /// either sees the previous or the new checkpoint.
+    /// @returns false if the checkpoint could not be written.
+    [[nodiscard]] bool write(const std::filesystem::path &dir) const;
+
+    /// Reads the checkpoint in @p dir. Reports an error if there is no valid checkpoint.
+    static std::optional<Checkpoint> read(const std::filesystem::path &dir);
+};
+
+}  // namespace P4::P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_ */
@@ -6,6 +6,9 @@
 
 #include <string>
 #include <vector>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 
 #include "backends/p4tools/common/lib/table_utils.h"
 #include "ir/declaration.h"
@@ -145,15 +148,25 @@ void CoverableNodesScanner::updateNodeCoverage(const IR::Node *node,
     CHECK_NULL(node);
 
     static NodeCache CACHED_NODES;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+    std::unique_lock<std::mutex> acquire(lock);
+#endif  // MULTITHREAD
     // If the node is already in the cache, return it.
     auto it = CACHED_NODES.find(node);
     if (it != CACHED_NODES.end()) {
         nodes.insert(it->second.begin(), it->second.end());
         return;
     }
+#ifdef MULTITHREAD
+    acquire.unlock();
+#endif  // MULTITHREAD
     node->apply(*this);
     nodes.insert(coverableNodes.begin(), coverableNodes.end());
     // Store the result in the cache.
+#ifdef MULTITHREAD
+    acquire.lock();
+#endif  // MULTITHREAD
     CACHED_NODES.emplace(node, coverableNodes);
 }
 
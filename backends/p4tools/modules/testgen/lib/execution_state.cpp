@@ -68,8 +68,7 @@ const NamespaceContext *ExecutionState::StackFrame::getNameSpaces() const { retu
 
 ExecutionState::ExecutionState(const IR::P4Program *program)
     : AbstractExecutionState(program),
-      body({program}),
-      stack(*(new std::stack<std::reference_wrapper<const StackFrame>>())) {
+      body({program}) {
     env.set(&PacketVars::INPUT_PACKET_LABEL, IR::Constant::get(IR::Type_Bits::get(0), 0));
     env.set(&PacketVars::PACKET_BUFFER_LABEL, IR::Constant::get(IR::Type_Bits::get(0), 0));
     // We also add the taint property and set it to false.
@@ -87,7 +86,7 @@ ExecutionState::ExecutionState(const IR::P4Program *program)
 }
 
 ExecutionState::ExecutionState(Continuation::Body body)
-    : body(std::move(body)), stack(*(new std::stack<std::reference_wrapper<const StackFrame>>())) {
+    : body(std::move(body)) {
     // We also add the taint property and set it to false.
     setProperty("inUndefinedState"_cs, false);
     // Drop is initialized to false, too.
@@ -108,13 +107,21 @@ ExecutionState &ExecutionState::clone() const { return *new ExecutionState(*this
  *  Accessors
  * ============================================================================================= */
 
-bool ExecutionState::isTerminal() const { return body.empty() && stack.empty(); }
+bool ExecutionState::isTerminal() const { return body.empty() && stack->empty(); }
 
-const std::vector<uint64_t> &ExecutionState::getSelectedBranches() const {
+std::vector<uint64_t> ExecutionState::getSelectedBranches() const {
+    return selectedBranches.toVector();
+}
+
+const PersistentLog<uint64_t> &ExecutionState::getSelectedBranchLog() const {
     return selectedBranches;
 }
 
-const std::vector<const IR::Expression *> &ExecutionState::getPathConstraint() const {
+std::vector<const IR::Expression *> ExecutionState::getPathConstraint() const {
+    return pathConstraint.toVector();
+}
+
+const PersistentLog<const IR::Expression *> &ExecutionState::getPathConstraintLog() const {
     return pathConstraint;
 }
 
@@ -177,10 +184,21 @@ void ExecutionState::markVisited(const IR::Node *node) {
     if (node->is<IR::P4Action>() && !coverageOptions.coverActions) {
         return;
     }
-    visitedNodes.emplace(node);
+    // A node that is visited several times in a row is logged once.
+    if (visitedNodes.empty() || visitedNodes.back() != node) {
+        visitedNodes.push_back(node);
+    }
 }
 
-const P4::Coverage::CoverageSet &ExecutionState::getVisited() const { return visitedNodes; }
+P4::Coverage::CoverageSet ExecutionState::getVisited() const {
+    P4::Coverage::CoverageSet visited;
+    visitedNodes.forEachReversed([&visited](const IR::Node *node) { visited.emplace(node); });
+    return visited;
+}
+
+const PersistentLog<const IR::Node *> &ExecutionState::getVisitedLog() const {
+    return visitedNodes;
+}
 
 /// Compare types, considering Extracted_Varbit and bits equal if the (real/extracted) sizes are
 /// equal. This is because the packet expression can be something like 0 ++
@@ -217,28 +235,32 @@ void ExecutionState::set(const IR::StateVariable &var, const IR::Expression *val
     env.set(var, value);
 }
 
-const std::vector<std::reference_wrapper<const TraceEvent>> &ExecutionState::getTrace() const {
-    return trace;
+std::vector<std::reference_wrapper<const TraceEvent>> ExecutionState::getTrace() const {
+    return trace.toVector();
 }
 
 const Continuation::Body &ExecutionState::getBody() const { return body; }
 
 const std::stack<std::reference_wrapper<const ExecutionState::StackFrame>> &
 ExecutionState::getStack() const {
-    return stack;
+    return *stack;
 }
 
 void ExecutionState::setProperty(cstring propertyName, Continuation::PropertyValue property) {
-    stateProperties[propertyName] = property;
+    auto it = stateProperties->find(propertyName);
+    if (it != stateProperties->end() && it->second == property) {
+        return;
+    }
+    stateProperties.mutate()[propertyName] = property;
 }
 
 bool ExecutionState::hasProperty(cstring propertyName) const {
-    return stateProperties.count(propertyName) > 0;
+    return stateProperties->count(propertyName) > 0;
 }
 
 void ExecutionState::addTestObject(cstring category, cstring objectLabel,
                                    const TestObject *object) {
-    testObjects[category][objectLabel] = object;
+    testObjects.mutate()[category][objectLabel] = object;
 }
 
 const TestObject *ExecutionState::getTestObject(cstring category, cstring objectLabel,
@@ -256,21 +278,25 @@ const TestObject *ExecutionState::getTestObject(cstring category, cstring object
 }
 
 TestObjectMap ExecutionState::getTestObjectCategory(cstring category) const {
-    auto it = testObjects.find(category);
-    if (it != testObjects.end()) {
+    auto it = testObjects->find(category);
+    if (it != testObjects->end()) {
         return it->second;
     }
     return {};
 }
 
 void ExecutionState::deleteTestObject(cstring category, cstring objectLabel) {
-    auto it = testObjects.find(category);
-    if (it != testObjects.end()) {
-        it->second.erase(objectLabel);
+    auto it = testObjects->find(category);
+    if (it != testObjects->end() && it->second.count(objectLabel) > 0) {
+        testObjects.mutate()[category].erase(objectLabel);
     }
 }
 
-void ExecutionState::deleteTestObjectCategory(cstring category) { testObjects.erase(category); }
+void ExecutionState::deleteTestObjectCategory(cstring category) {
+    if (testObjects->count(category) > 0) {
+        testObjects.mutate().erase(category);
+    }
+}
 
 void ExecutionState::setReachabilityEngineState(ReachabilityEngineState *newEngineState) {
     reachabilityEngineState = newEngineState;
@@ -284,13 +310,13 @@ ReachabilityEngineState *ExecutionState::getReachabilityEngineState() const {
  *  Trace events.
  * ============================================================================================= */
 
-void ExecutionState::add(const TraceEvent &event) { trace.emplace_back(event); }
+void ExecutionState::add(const TraceEvent &event) { trace.push_back(event); }
 
 void ExecutionState::popBody() { body.pop(); }
 
 void ExecutionState::replaceBody(const Continuation::Body &body) { this->body = body; }
 
-void ExecutionState::pushContinuation(const StackFrame &frame) { stack.push(frame); }
+void ExecutionState::pushContinuation(const StackFrame &frame) { stack.mutate().push(frame); }
 
 void ExecutionState::pushCurrentContinuation(StackFrame::ExceptionHandlers handlers) {
     pushCurrentContinuation(std::nullopt, std::move(handlers));
@@ -319,9 +345,9 @@ void ExecutionState::pushCurrentContinuation(std::optional<const IR::Type *> par
 }
 
 void ExecutionState::popContinuation(std::optional<const IR::Node *> argument_opt) {
-    BUG_CHECK(!stack.empty(), "Popped an empty continuation stack");
-    auto frame = stack.top();
-    stack.pop();
+    BUG_CHECK(!stack->empty(), "Popped an empty continuation stack");
+    auto frame = stack->top();
+    stack.mutate().pop();
 
     auto newBody = frame.get().getContinuation().apply(argument_opt);
     replaceBody(newBody);
@@ -329,8 +355,8 @@ void ExecutionState::popContinuation(std::optional<const IR::Node *> argument_op
 }
 
 void ExecutionState::handleException(Continuation::Exception e) {
-    while (!stack.empty()) {
-        auto frame = stack.top();
+    while (!stack->empty()) {
+        auto frame = stack->top();
         if (frame.get().getExceptionHandlers().count(e) > 0) {
             auto k = frame.get().getExceptionHandlers().at(e);
             auto newBody = k.apply(std::nullopt);
@@ -338,7 +364,7 @@ void ExecutionState::handleException(Continuation::Exception e) {
             setNamespaceContext(frame.get().getNameSpaces());
             return;
         }
-        stack.pop();
+        stack.mutate().pop();
     }
     BUG("Did not find exception handler for %s.", e);
 }
@@ -366,7 +392,9 @@ void ExecutionState::replaceTopBody(std::initializer_list<Continuation::Command>
  *  Packet manipulation
  * ============================================================================================= */
 
-void ExecutionState::pushPathConstraint(const IR::Expression *e) { pathConstraint.push_back(e); }
+void ExecutionState::pushPathConstraint(const IR::Expression *e) {
+    pathConstraint.push_back(e);
+}
 
 void ExecutionState::pushBranchDecision(uint64_t bIdx) { selectedBranches.push_back(bIdx); }
 
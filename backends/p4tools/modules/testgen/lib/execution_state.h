@@ -20,7 +20,9 @@
 
 #include "backends/p4tools/common/compiler/reachability.h"
 #include "backends/p4tools/common/core/abstract_execution_state.h"
+#include "backends/p4tools/common/lib/copy_on_write.h"
 #include "backends/p4tools/common/lib/namespace_context.h"
+#include "backends/p4tools/common/lib/persistent_log.h"
 #include "backends/p4tools/common/lib/symbolic_env.h"
 #include "backends/p4tools/common/lib/trace_event.h"
 #include "ir/declaration.h"
@@ -72,17 +74,19 @@ class ExecutionState : public AbstractExecutionState {
         [[nodiscard]] const NamespaceContext *getNameSpaces() const;
     };
 
-    /// No move semantics because of constant members. We always need to clone a state.
+    /// No move semantics because of constant members. We always need to clone a state. Cloning is
+    /// cheap: the lists below are persistent logs, which clones extend without copying them, and
+    /// the other containers are shared between clones until one of them modifies them.
     ExecutionState(ExecutionState &&) = delete;
     ExecutionState &operator=(ExecutionState &&) = delete;
     ~ExecutionState() override = default;
 
  private:
     /// The program trace for the current program point (i.e., how we got to the current state).
-    std::vector<std::reference_wrapper<const TraceEvent>> trace;
+    PersistentLog<std::reference_wrapper<const TraceEvent>> trace;
 
-    /// Set of visited nodes. Used for code coverage.
-    P4::Coverage::CoverageSet visitedNodes;
+    /// Visited nodes, in the order in which they were first visited. Used for code coverage.
+    PersistentLog<const IR::Node *> visitedNodes;
 
     /// The remaining body of the current function being executed.
     ///
@@ -96,7 +100,7 @@ class ExecutionState : public AbstractExecutionState {
     /// becomes the top of the stack.
     ///
     // Invariant: if the @body is empty, then so is this, and this state is terminal.
-    std::stack<std::reference_wrapper<const StackFrame>> stack;
+    CopyOnWrite<std::stack<std::reference_wrapper<const StackFrame>>> stack;
 
     /// State properties are bools, integers, or strings that can be set and propagated across
     /// execution state. They are used to influence execution along a particular continuation path.
@@ -104,7 +108,7 @@ class ExecutionState : public AbstractExecutionState {
     /// written while this variable is active is tainted. This property must be unset manually to
     /// resume normal operation by setting the property "false". Usually, this is done directly
     /// after the tainted sequence of commands has been executed.
-    std::map<cstring, Continuation::PropertyValue> stateProperties;
+    CopyOnWrite<std::map<cstring, Continuation::PropertyValue>> stateProperties;
 
     // Test objects are classes of variables that influence the execution of test frameworks. They
     // are collected during interpreter execution and consumed by the respective test framework. For
@@ -112,7 +116,7 @@ class ExecutionState : public AbstractExecutionState {
     // which defines control plane match action entries. Once the interpreter has solved for the
     // variables used by these test objects and concretized the values, they can be used to generate
     // a test. Test objects are not constant because they may be manipulated by a target back end.
-    std::map<cstring, TestObjectMap> testObjects;
+    CopyOnWrite<std::map<cstring, TestObjectMap>> testObjects;
 
     /// The parserErrorLabel is set by the parser to indicate the variable corresponding to the
     /// parser error that is set by various built-in functions such as verify or extract.
@@ -126,10 +130,10 @@ class ExecutionState : public AbstractExecutionState {
 
     /// List of path constraints - expressions that must all evaluate to true to reach this
     /// execution state.
-    std::vector<const IR::Expression *> pathConstraint;
+    PersistentLog<const IR::Expression *> pathConstraint;
 
     /// List of branch decisions leading into this state.
-    std::vector<uint64_t> selectedBranches;
+    PersistentLog<uint64_t> selectedBranches;
 
     /// State that is needed to track reachability of nodes given a query.
     ReachabilityEngineState *reachabilityEngineState = nullptr;
@@ -152,10 +156,16 @@ class ExecutionState : public AbstractExecutionState {
     [[nodiscard]] bool isTerminal() const;
 
     /// @returns list of paths constraints.
-    [[nodiscard]] const std::vector<const IR::Expression *> &getPathConstraint() const;
+    [[nodiscard]] std::vector<const IR::Expression *> getPathConstraint() const;
+
+    /// @returns the log of path constraints, which can be searched without copying it.
+    [[nodiscard]] const PersistentLog<const IR::Expression *> &getPathConstraintLog() const;
 
     /// @returns list of branch decisions leading into this state.
-    [[nodiscard]] const std::vector<uint64_t> &getSelectedBranches() const;
+    [[nodiscard]] std::vector<uint64_t> getSelectedBranches() const;
+
+    /// @returns the log of branch decisions, which can be searched without copying it.
+    [[nodiscard]] const PersistentLog<uint64_t> &getSelectedBranchLog() const;
 
     /// Adds path constraint.
     void pushPathConstraint(const IR::Expression *e);
@@ -175,15 +185,19 @@ class ExecutionState : public AbstractExecutionState {
     /// Checks whether the node has been visited in this state.
     void markVisited(const IR::Node *node);
 
-    /// @returns list of all nodes visited before reaching this state.
-    [[nodiscard]] const P4::Coverage::CoverageSet &getVisited() const;
+    /// @returns the set of all nodes visited before reaching this state.
+    [[nodiscard]] P4::Coverage::CoverageSet getVisited() const;
+
+    /// @returns the log of visited nodes, which can be searched without building the set of
+    /// getVisited(). A node is logged again if other nodes were visited in between.
+    [[nodiscard]] const PersistentLog<const IR::Node *> &getVisitedLog() const;
 
     /// Sets the symbolic value of the given state variable to the given value. Constant folding
     /// is done on the given value before updating the symbolic state.
     void set(const IR::StateVariable &var, const IR::Expression *value) override;
 
     /// @returns the current event trace.
-    [[nodiscard]] const std::vector<std::reference_wrapper<const TraceEvent>> &getTrace() const;
+    [[nodiscard]] std::vector<std::reference_wrapper<const TraceEvent>> getTrace() const;
 
     /// @returns the current body.
     [[nodiscard]] const Continuation::Body &getBody() const;
@@ -201,8 +215,8 @@ class ExecutionState : public AbstractExecutionState {
     /// BUG, If the specified type does not match or the property is not found.
     template <class T>
     [[nodiscard]] T getProperty(cstring propertyName) const {
-        auto iterator = stateProperties.find(propertyName);
-        if (iterator != stateProperties.end()) {
+        auto iterator = stateProperties->find(propertyName);
+        if (iterator != stateProperties->end()) {
             auto val = iterator->second;
             try {
                 T resolvedVal = std::get<T>(val);
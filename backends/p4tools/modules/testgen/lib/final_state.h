@@ -78,7 +78,7 @@ class FinalState {
     [[nodiscard]] const std::vector<std::reference_wrapper<const TraceEvent>> *getTraces() const;
 
     /// @returns the list of visited nodes of this state.
-    [[nodiscard]] const P4::Coverage::CoverageSet &getVisited() const;
+    [[nodiscard]] P4::Coverage::CoverageSet getVisited() const;
 };
 
 }  // namespace P4::P4Tools::P4Testgen
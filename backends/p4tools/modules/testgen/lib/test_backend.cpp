@@ -6,6 +6,7 @@
 
 #include <optional>
 
+#include "backends/p4tools/common/core/caching_solver.h"
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "backends/p4tools/common/lib/format_int.h"
 #include "backends/p4tools/common/lib/model.h"
@@ -15,6 +16,7 @@
 #include "ir/irutils.h"
 #include "lib/cstring.h"
 #include "lib/exceptions.h"
+#include "lib/log.h"
 #include "lib/null.h"
 #include "lib/timer.h"
 #include "midend/coverage.h"
@@ -81,8 +83,11 @@ bool TestBackEnd::run(const FinalState &state) {
 
         // For long-running tests periodically reset the solver state to free up memory.
         if (testCount != 0 && testCount % RESET_THRESHOLD == 0) {
-            auto &solver = state.getSolver();
-            auto *z3Solver = solver.to<Z3Solver>();
+            auto *solver = &state.getSolver();
+            if (const auto *cachingSolver = solver->to<CachingSolver>()) {
+                solver = &cachingSolver->getBackingSolver();
+            }
+            auto *z3Solver = solver->to<Z3Solver>();
             CHECK_NULL(z3Solver);
             z3Solver->clearMemory();
         }
@@ -96,10 +101,11 @@ bool TestBackEnd::run(const FinalState &state) {
 
         outputPacketExpr->apply(concolicResolver);
         outputPortExpr->apply(concolicResolver);
-        for (const auto *assert : executionState->getPathConstraint()) {
-            CHECK_NULL(assert);
-            assert->apply(concolicResolver);
-        }
+        executionState->getPathConstraintLog().forEachReversed(
+            [&concolicResolver](const IR::Expression *assert) {
+                CHECK_NULL(assert);
+                assert->apply(concolicResolver);
+            });
         const ConcolicVariableMap *resolvedConcolicVariables =
             concolicResolver.getResolvedConcolicVariables();
         // If we resolved concolic variables and substitute them, check the solver again under
@@ -133,7 +139,7 @@ bool TestBackEnd::run(const FinalState &state) {
 
         // Commit an update to the visited nodes.
         // Only do this once we are sure we are generating a test.
-        auto hasUpdated = symbex.updateVisitedNodes(replacedState.getVisited());
+        auto hasUpdated = symbex.updateVisitedNodes(executionState->getVisitedLog());
 
         // Skip test case generation if the --only-covering-tests is enabled and we do not increase
         // coverage.
@@ -155,7 +161,10 @@ bool TestBackEnd::run(const FinalState &state) {
                 static_cast<float>(visitedNodes.size()) / static_cast<float>(coverableNodes.size());
             printInfo("============ Test %1%: Nodes covered: %2% (%3%/%4%) ============", testCount,
                       coverage, visitedNodes.size(), coverableNodes.size());
-            P4::Coverage::logCoverage(coverableNodes, visitedNodes, executionState->getVisited());
+            if (LOGGING_FEATURE("coverage", 4)) {
+                P4::Coverage::logCoverage(coverableNodes, visitedNodes,
+                                          executionState->getVisited());
+            }
         }
 
         // Output the test.
@@ -273,6 +282,8 @@ bool TestBackEnd::printTestInfo(const ExecutionState * /*executionState*/, const
 
 int64_t TestBackEnd::getTestCount() const { return testCount; }
 
+void TestBackEnd::setTestCount(int64_t count) { testCount = count; }
+
 float TestBackEnd::getCoverage() const { return coverage; }
 
 const ProgramInfo &TestBackEnd::getProgramInfo() const { return programInfo; }
@@ -125,6 +125,9 @@ class TestBackEnd {
     /// Returns test count.
     [[nodiscard]] int64_t getTestCount() const;
 
+    /// Continues counting tests from @param count, e.g., when resuming from a checkpoint.
+    void setTestCount(int64_t count);
+
     /// Returns coverage achieved by all the processed tests.
     [[nodiscard]] float getCoverage() const;
 
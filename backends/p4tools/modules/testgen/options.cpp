@@ -179,6 +179,25 @@ TestgenOptions::TestgenOptions()
         "The output directory for the generated tests. The directory will be created, if it does "
         "not exist.");
 
+    registerOption(
+        "--checkpoint-dir", "checkpointDir",
+        [this](const char *arg) {
+            checkpointDir = arg;
+            return true;
+        },
+        "Periodically saves the state of the exploration into the given directory, so that an "
+        "interrupted run can be continued with --resume. Only supported by the DEPTH_FIRST path "
+        "selection policy.");
+
+    registerOption(
+        "--resume", nullptr,
+        [this](const char *) {
+            resume = true;
+            return true;
+        },
+        "Continues the exploration that was saved in the directory given by --checkpoint-dir. "
+        "Tests that were already generated are not generated again.");
+
     registerOption(
         "--test-backend", "testBackend",
         [this](const char *arg) {
@@ -257,11 +276,16 @@ TestgenOptions::TestgenOptions()
                 {"DEPTH_FIRST"_cs, PathSelectionPolicy::DepthFirst},
                 {"RANDOM_BACKTRACK"_cs, PathSelectionPolicy::RandomBacktrack},
                 {"GREEDY_STATEMENT_SEARCH"_cs, PathSelectionPolicy::GreedyStmtCoverage},
+                {"DIRECTED_COVERAGE_SEARCH"_cs, PathSelectionPolicy::DirectedCoverage},
             };
             auto selectionString = cstring(arg).toUpper();
             auto it = PATH_SELECTION_OPTIONS.find(selectionString);
             if (it != PATH_SELECTION_OPTIONS.end()) {
                 pathSelectionPolicy = it->second;
+                // The directed search ranks branches by their distances in the call graph.
+                if (pathSelectionPolicy == PathSelectionPolicy::DirectedCoverage) {
+                    dcg = true;
+                }
                 return true;
             }
             std::set<cstring> printSet;
@@ -277,8 +301,41 @@ TestgenOptions::TestgenOptions()
             return false;
         },
         "Selects a specific path selection strategy for test generation. Options are: "
-        "DEPTH_FIRST, RANDOM_BACKTRACK, and GREEDY_STATEMENT_SEARCH. "
-        "Defaults to DEPTH_FIRST.");
+        "DEPTH_FIRST, RANDOM_BACKTRACK, GREEDY_STATEMENT_SEARCH, and DIRECTED_COVERAGE_SEARCH. "
+        "DIRECTED_COVERAGE_SEARCH continues with the branch that is closest to an uncovered node "
+        "in the call graph of the program. Defaults to DEPTH_FIRST.");
+
+    registerOption(
+        "--threads", "threads",
+        [this](const char *arg) {
+            try {
+                threads = std::stoi(arg);
+                if (threads < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+            } catch (std::logic_error &) {
+                // std::invalid_argument or std::out_of_range.
+                error("Invalid input value %1% for --threads. Expected positive integer.", arg);
+                return false;
+            }
+            return true;
+        },
+        "Explores paths on the given number of threads [default: 1]. Each thread uses its own "
+        "solver. With more than one thread, tests are generated for the same paths, in the same "
+        "order, for any number of threads, but values that the solver is free to choose may "
+        "differ. Only supported by the DEPTH_FIRST path selection policy, in builds with "
+        "ENABLE_MULTITHREAD.");
+
+    registerOption(
+        "--solver-cache", nullptr,
+        [this](const char *) {
+            solverCache = true;
+            return true;
+        },
+        "[EXPERIMENTAL] Split solver queries into groups of constraints that share no variables "
+        "and answer the groups from a cache where possible. This reduces the number of solver "
+        "calls, but the values that the solver is free to choose may differ from those of an "
+        "uncached run, and queries do not use the incremental mode of the solver.");
 
     registerOption(
         "--track-coverage", "coverageItem",
@@ -435,6 +492,29 @@ bool TestgenOptions::validateOptions() const {
               "--assert-min-coverage is meaningless.");
         return false;
     }
+#ifndef MULTITHREAD
+    if (threads > 1) {
+        error(ErrorType::ERR_INVALID, "--threads requires a build with ENABLE_MULTITHREAD.");
+        return false;
+    }
+#endif  // MULTITHREAD
+    if (threads > 1 && (pathSelectionPolicy != PathSelectionPolicy::DepthFirst ||
+                        !selectedBranches.empty())) {
+        error(ErrorType::ERR_INVALID,
+              "--threads is only supported by the DEPTH_FIRST path selection policy.");
+        return false;
+    }
+    if (checkpointDir.has_value() && (pathSelectionPolicy != PathSelectionPolicy::DepthFirst ||
+                                      !selectedBranches.empty() || threads > 1)) {
+        error(ErrorType::ERR_INVALID,
+              "--checkpoint-dir is only supported by the single-threaded DEPTH_FIRST path "
+              "selection policy.");
+        return false;
+    }
+    if (resume && !checkpointDir.has_value()) {
+        error(ErrorType::ERR_INVALID, "--resume requires --checkpoint-dir.");
+        return false;
+    }
     return true;
 }
 
@@ -33,6 +33,13 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// Selects the path selection policy for test generation
     P4Testgen::PathSelectionPolicy pathSelectionPolicy = P4Testgen::PathSelectionPolicy::DepthFirst;
 
+    /// The number of threads that explore paths. Defaults to 1.
+    int threads = 1;
+
+    /// Answer solver queries from a cache of independent constraint groups, see CachingSolver.
+    /// Off by default, as the cache changes the models the solver returns.
+    bool solverCache = false;
+
     /// List of the supported stop metrics.
     static const std::set<cstring> SUPPORTED_STOP_METRICS;
 
@@ -46,6 +53,12 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// Directory for generated tests. Defaults to PWD.
     std::optional<std::filesystem::path> outputDir = std::nullopt;
 
+    /// Directory for checkpoints of the exploration. Checkpoints are disabled if not set.
+    std::optional<std::filesystem::path> checkpointDir = std::nullopt;
+
+    /// Continue the exploration from the checkpoint in @ref checkpointDir.
+    bool resume = false;
+
     /// Fail on unimplemented features instead of trying the next branch
     bool strict = false;
 
@@ -5,10 +5,18 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
 #include "backends/p4tools/common/compiler/context.h"
 #include "backends/p4tools/common/lib/logging.h"
 #include "frontends/common/options.h"
 #include "lib/compile_context.h"
+#include "lib/timer.h"
 #include "test/gtest/helpers.h"
 
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
@@ -44,10 +52,80 @@ TEST_F(P4TestgenBenchmark, SuccessfullyGenerate1000Tests) {
     // This enables performance printing.
     P4Tools::enablePerformanceLogging();
 
+    auto start = std::chrono::steady_clock::now();
     auto testList = P4Testgen::Testgen::generateTests(testgenOptions);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
     ASSERT_TRUE(testList.has_value());
 
     // Print the report.
     P4Tools::printPerformanceReport();
+
+    // Every invocation of the "step" timer evaluates one execution state.
+    uint64_t states = 0;
+    for (const auto &timer : Util::getTimers()) {
+        if (timer.timerName == "step" || timer.timerName.ends_with(".step")) {
+            states += timer.invocations;
+        }
+    }
+    std::cout << "Evaluated " << states << " states in " << elapsed.count() << " ms ("
+              << (elapsed.count() > 0 ? states * 1000 / elapsed.count() : states)
+              << " states/s)" << std::endl;
+}
+
+/// Measures the states evaluated per second over the bmv2 programs of the test corpus. It takes
+/// long, so it is disabled by default; run it with --gtest_also_run_disabled_tests
+/// --gtest_filter='*StatesPerSecondOnCorpus' before and after a change to compare.
+TEST_F(P4TestgenBenchmark, DISABLED_StatesPerSecondOnCorpus) {
+    std::vector<std::filesystem::path> programs;
+    for (const auto &entry : std::filesystem::directory_iterator(
+             P4CTestEnvironment::getProjectRoot() / "testdata/p4_16_samples")) {
+        if (entry.path().filename().string().ends_with("-bmv2.p4")) {
+            programs.push_back(entry.path());
+        }
+    }
+    std::sort(programs.begin(), programs.end());
+
+    auto stepInvocations = [] {
+        uint64_t states = 0;
+        for (const auto &timer : Util::getTimers()) {
+            if (timer.timerName == "step" || timer.timerName.ends_with(".step")) {
+                states += timer.invocations;
+            }
+        }
+        return states;
+    };
+    uint64_t states = 0;
+    std::chrono::milliseconds elapsed(0);
+    size_t failed = 0;
+    for (const auto &program : programs) {
+        // Each program gets a fresh context, so that errors in one do not fail the others.
+        auto context = P4TestgenTest::SetUp("bmv2", "v1model");
+        ASSERT_NE(context, nullptr);
+        auto &testgenOptions = P4Testgen::TestgenOptions::get();
+        auto includePath = P4CTestEnvironment::getProjectRoot() / "p4include";
+        testgenOptions.preprocessor_options = "-I" + includePath.string();
+        testgenOptions.file = program.string();
+        testgenOptions.testBackend = "PROTOBUF_IR"_cs;
+        testgenOptions.testBaseName = "dummy"_cs;
+        testgenOptions.seed = 1;
+        testgenOptions.minPktSize = 512;
+        testgenOptions.maxPktSize = 512;
+        testgenOptions.maxTests = 100;
+
+        auto statesBefore = stepInvocations();
+        auto start = std::chrono::steady_clock::now();
+        // Programs that testgen does not support only count as failures.
+        if (!P4Testgen::Testgen::generateTests(testgenOptions).has_value()) {
+            ++failed;
+        }
+        elapsed += std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        states += stepInvocations() - statesBefore;
+    }
+    std::cout << "Evaluated " << states << " states of " << programs.size() - failed << "/"
+              << programs.size() << " programs in " << elapsed.count() << " ms ("
+              << (elapsed.count() > 0 ? states * 1000 / elapsed.count() : states)
+              << " states/s)" << std::endl;
 }
 }  // namespace P4::P4Tools::Test
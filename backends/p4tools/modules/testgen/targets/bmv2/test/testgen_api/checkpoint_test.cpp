@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "backends/p4tools/common/lib/util.h"
+#include "test/gtest/helpers.h"
+
+#include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/targets/bmv2/test/gtest_utils.h"
+#include "backends/p4tools/modules/testgen/targets/bmv2/test_backend/protobuf_ir.h"
+#include "backends/p4tools/modules/testgen/testgen.h"
+
+namespace P4::P4Tools::Test {
+
+using namespace P4::literals;
+
+class P4TestgenCheckpointTest : public P4TestgenBmv2Test {
+ protected:
+    /// A temporary checkpoint directory.
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        P4TestgenBmv2Test::SetUp();
+        dir = std::filesystem::temp_directory_path() /
+              ("p4testgen-resume-" + std::to_string(getpid()));
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() override {
+        auto &testgenOptions = P4Testgen::TestgenOptions::get();
+        testgenOptions.checkpointDir = std::nullopt;
+        testgenOptions.resume = false;
+        testgenOptions.trackBranches = false;
+        std::filesystem::remove_all(dir);
+        P4TestgenBmv2Test::TearDown();
+    }
+
+    /// @returns the branch decisions on the paths of the tests generated for @p source until
+    /// there are @p maxTests tests, one entry per test. Checkpoints are written into the
+    /// temporary directory, and the exploration continues from the last checkpoint if @p resume
+    /// is set. Values that the solver is free to choose are not compared, as they depend on the
+    /// queries the solver has seen before.
+    std::vector<std::string> generatePaths(const std::string &source, int maxTests, bool resume) {
+        auto &testgenOptions = P4Testgen::TestgenOptions::get();
+        testgenOptions.target = "bmv2"_cs;
+        testgenOptions.arch = "v1model"_cs;
+        testgenOptions.testBackend = "PROTOBUF_IR"_cs;
+        testgenOptions.testBaseName = "dummy"_cs;
+        testgenOptions.seed = 1;
+        testgenOptions.maxTests = maxTests;
+        testgenOptions.minPktSize = 144;
+        testgenOptions.maxPktSize = 144;
+        testgenOptions.threads = 1;
+        testgenOptions.trackBranches = true;
+        testgenOptions.checkpointDir = dir;
+        testgenOptions.resume = resume;
+        // The seed is only applied when the options are processed.
+        Utils::setRandomSeed(1);
+
+        auto testListOpt = P4Testgen::Testgen::generateTests(source, testgenOptions);
+        std::vector<std::string> paths;
+        EXPECT_TRUE(testListOpt.has_value());
+        if (testListOpt.has_value()) {
+            for (const auto *test : testListOpt.value()) {
+                const auto *protobufIrTest =
+                    test->checkedTo<P4Tools::P4Testgen::Bmv2::ProtobufIrTest>();
+                // --track-branches stores the decisions in the metadata of the test.
+                std::istringstream formattedTest(protobufIrTest->getFormattedTest());
+                std::string line;
+                while (std::getline(formattedTest, line)) {
+                    if (line.rfind("metadata: \"Selected", 0) == 0) {
+                        paths.push_back(line);
+                    }
+                }
+            }
+        }
+        return paths;
+    }
+};
+
+// The search picks its branches at random. A run that is interrupted and resumed from its
+// checkpoint must pick the same branches as a run that is not interrupted, so both generate tests
+// for the same paths, in the same order.
+TEST_F(P4TestgenCheckpointTest, ResumedRunMatchesUninterruptedRun) {
+    std::stringstream streamTest;
+    streamTest << R"p4(
+header ethernet_t {
+    bit<48> dst_addr;
+    bit<48> src_addr;
+    bit<16> ether_type;
+}
+
+header tag_t {
+    bit<8> kind;
+    bit<8> value;
+}
+
+struct Headers {
+  ethernet_t eth_hdr;
+  tag_t tag;
+}
+
+struct Metadata {  }
+parser parse(packet_in pkt, out Headers hdr, inout Metadata m, inout standard_metadata_t sm) {
+  state start {
+      pkt.extract(hdr.eth_hdr);
+      transition select(hdr.eth_hdr.ether_type) {
+          0x1234: parse_tag;
+          default: reject;
+      }
+  }
+  state parse_tag {
+      pkt.extract(hdr.tag);
+      transition select(hdr.tag.kind) {
+          1: accept;
+          2: accept;
+          3: accept;
+          default: reject;
+      }
+  }
+}
+control ingress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {
+      if (hdr.eth_hdr.dst_addr != 0xDEADDEADDEAD || hdr.eth_hdr.src_addr != 0xBEEFBEEFBEEF) {
+          mark_to_drop(sm);
+      } else if (hdr.tag.kind == 1) {
+          sm.egress_spec = 1;
+          hdr.tag.value = 10;
+      } else if (hdr.tag.kind == 2) {
+          sm.egress_spec = 2;
+          hdr.tag.value = 20;
+      } else {
+          sm.egress_spec = 3;
+          hdr.tag.value = 30;
+      }
+  }
+}
+control egress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {}
+}
+control deparse(packet_out pkt, in Headers hdr) {
+  apply {
+    pkt.emit(hdr.eth_hdr);
+    pkt.emit(hdr.tag);
+  }
+}
+control verifyChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+control computeChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+V1Switch(parse(), verifyChecksum(), ingress(), egress(), computeChecksum(), deparse()) main;
+)p4";
+
+    auto source = P4_SOURCE(P4Headers::V1MODEL, streamTest.str().c_str());
+    auto uninterrupted = generatePaths(source, 6, false);
+    ASSERT_EQ(uninterrupted.size(), 6U);
+
+    std::filesystem::remove_all(dir);
+    auto resumed = generatePaths(source, 2, false);
+    auto remaining = generatePaths(source, 6, true);
+    resumed.insert(resumed.end(), remaining.begin(), remaining.end());
+    EXPECT_EQ(uninterrupted, resumed);
+}
+
+}  // namespace P4::P4Tools::Test
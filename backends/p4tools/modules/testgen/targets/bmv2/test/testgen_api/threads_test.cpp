@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test/gtest/helpers.h"
+
+#include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/targets/bmv2/test/gtest_utils.h"
+#include "backends/p4tools/modules/testgen/targets/bmv2/test_backend/protobuf_ir.h"
+#include "backends/p4tools/modules/testgen/testgen.h"
+
+namespace P4::P4Tools::Test {
+
+using namespace P4::literals;
+
+class P4TestgenThreadsTest : public P4TestgenBmv2Test {
+ protected:
+    /// @returns the branch decisions on the paths of the tests generated for @p source with
+    /// @p threads threads, one entry per test. Values that the solver is free to choose are not
+    /// compared, as they depend on the queries each solver has seen before.
+    static std::vector<std::string> generatePaths(const std::string &source, int threads) {
+        auto &testgenOptions = P4Testgen::TestgenOptions::get();
+        testgenOptions.target = "bmv2"_cs;
+        testgenOptions.arch = "v1model"_cs;
+        testgenOptions.testBackend = "PROTOBUF_IR"_cs;
+        testgenOptions.testBaseName = "dummy"_cs;
+        testgenOptions.seed = 1;
+        testgenOptions.maxTests = 0;
+        testgenOptions.minPktSize = 144;
+        testgenOptions.maxPktSize = 144;
+        testgenOptions.threads = threads;
+        testgenOptions.trackBranches = true;
+
+        auto testListOpt = P4Testgen::Testgen::generateTests(source, testgenOptions);
+        testgenOptions.trackBranches = false;
+        std::vector<std::string> paths;
+        EXPECT_TRUE(testListOpt.has_value());
+        if (testListOpt.has_value()) {
+            for (const auto *test : testListOpt.value()) {
+                const auto *protobufIrTest =
+                    test->checkedTo<P4Tools::P4Testgen::Bmv2::ProtobufIrTest>();
+                // --track-branches stores the decisions in the metadata of the test.
+                std::istringstream formattedTest(protobufIrTest->getFormattedTest());
+                std::string line;
+                while (std::getline(formattedTest, line)) {
+                    if (line.rfind("metadata: \"Selected", 0) == 0) {
+                        paths.push_back(line);
+                    }
+                }
+            }
+        }
+        return paths;
+    }
+};
+
+// The paths of this program differ in several branch points of the parser and the ingress control.
+// The parallel search must generate tests for the same paths, in the same order, for any number of
+// threads. The single-threaded search picks its branches at random, so it only finds the same
+// number of paths.
+TEST_F(P4TestgenThreadsTest, SamePathsForAnyNumberOfThreads) {
+#ifndef MULTITHREAD
+    GTEST_SKIP() << "--threads requires a build with ENABLE_MULTITHREAD";
+#endif  // MULTITHREAD
+    std::stringstream streamTest;
+    streamTest << R"p4(
+header ethernet_t {
+    bit<48> dst_addr;
+    bit<48> src_addr;
+    bit<16> ether_type;
+}
+
+header tag_t {
+    bit<8> kind;
+    bit<8> value;
+}
+
+struct Headers {
+  ethernet_t eth_hdr;
+  tag_t tag;
+}
+
+struct Metadata {  }
+parser parse(packet_in pkt, out Headers hdr, inout Metadata m, inout standard_metadata_t sm) {
+  state start {
+      pkt.extract(hdr.eth_hdr);
+      transition select(hdr.eth_hdr.ether_type) {
+          0x1234: parse_tag;
+          default: reject;
+      }
+  }
+  state parse_tag {
+      pkt.extract(hdr.tag);
+      transition select(hdr.tag.kind) {
+          1: accept;
+          2: accept;
+          3: accept;
+          default: reject;
+      }
+  }
+}
+control ingress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {
+      if (hdr.eth_hdr.dst_addr != 0xDEADDEADDEAD || hdr.eth_hdr.src_addr != 0xBEEFBEEFBEEF) {
+          mark_to_drop(sm);
+      } else if (hdr.tag.kind == 1) {
+          sm.egress_spec = 1;
+          hdr.tag.value = 10;
+      } else if (hdr.tag.kind == 2) {
+          sm.egress_spec = 2;
+          hdr.tag.value = 20;
+      } else {
+          sm.egress_spec = 3;
+          hdr.tag.value = 30;
+      }
+  }
+}
+control egress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {}
+}
+control deparse(packet_out pkt, in Headers hdr) {
+  apply {
+    pkt.emit(hdr.eth_hdr);
+    pkt.emit(hdr.tag);
+  }
+}
+control verifyChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+control computeChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+V1Switch(parse(), verifyChecksum(), ingress(), egress(), computeChecksum(), deparse()) main;
+)p4";
+
+    auto source = P4_SOURCE(P4Headers::V1MODEL, streamTest.str().c_str());
+    auto parallel = generatePaths(source, 2);
+    EXPECT_GE(parallel.size(), 3U);
+    for (int threads : {3, 4}) {
+        EXPECT_EQ(parallel, generatePaths(source, threads)) << "with --threads " << threads;
+    }
+    EXPECT_EQ(parallel.size(), generatePaths(source, 1).size());
+}
+
+}  // namespace P4::P4Tools::Test
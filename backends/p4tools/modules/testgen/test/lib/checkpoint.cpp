@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/modules/testgen/test/lib/checkpoint.h"
+#include "lib/error.h"
+
+namespace P4::P4Tools::Test {
+
+using P4Testgen::Checkpoint;
+
+TEST_F(CheckpointTest, RoundTrip) {
+    Checkpoint checkpoint;
+    checkpoint.testCount = 42;
+    checkpoint.randomState = Utils::getRandomState();
+    checkpoint.visitedNodes = {0, 3, 17};
+    checkpoint.unexploredBranches = {{1, 2}, {2}, {1, 1, 3}};
+    ASSERT_TRUE(checkpoint.write(dir));
+
+    auto restored = Checkpoint::read(dir);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->testCount, 42);
+    EXPECT_EQ(restored->randomState, checkpoint.randomState);
+    EXPECT_EQ(restored->visitedNodes, checkpoint.visitedNodes);
+    EXPECT_EQ(restored->unexploredBranches, checkpoint.unexploredBranches);
+
+    // A later checkpoint replaces the previous one.
+    checkpoint.unexploredBranches.clear();
+    ASSERT_TRUE(checkpoint.write(dir));
+    restored = Checkpoint::read(dir);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_TRUE(restored->unexploredBranches.empty());
+}
+
+TEST_F(CheckpointTest, RandomState) {
+    auto state = Utils::getRandomState();
+    auto first = Utils::getRandInt(int64_t(0), int64_t(1000000));
+    ASSERT_TRUE(Utils::setRandomState(state));
+    EXPECT_EQ(Utils::getRandInt(int64_t(0), int64_t(1000000)), first);
+    EXPECT_FALSE(Utils::setRandomState("not a state"));
+}
+
+TEST_F(CheckpointTest, InvalidCheckpoint) {
+    auto errors = errorCount();
+    EXPECT_FALSE(Checkpoint::read(dir).has_value());
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "checkpoint") << "P4TESTGEN_CHECKPOINT 1\ntests x\n";
+    EXPECT_FALSE(Checkpoint::read(dir).has_value());
+    EXPECT_EQ(errorCount(), errors + 2);
+}
+
+}  // namespace P4::P4Tools::Test
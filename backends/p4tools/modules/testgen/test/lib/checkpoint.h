@@ -0,0 +1,35 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_CHECKPOINT_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_CHECKPOINT_H_
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+#include <unistd.h>
+
+namespace P4::P4Tools::Test {
+
+/// Provides a temporary checkpoint directory for Checkpoint tests.
+class CheckpointTest : public testing::Test {
+ protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              ("p4testgen-checkpoint-" + std::to_string(getpid()));
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+}  // namespace P4::P4Tools::Test
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_CHECKPOINT_H_ */
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/common/lib/hash_cons.h"
+
+#include <gtest/gtest.h>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/model.h"
+#include "backends/p4tools/common/lib/variables.h"
+#include "ir/ir.h"
+#include "lib/cstring.h"
+
+namespace P4::P4Tools::Test {
+
+using namespace P4::literals;
+
+class HashConsTest : public testing::Test {
+ protected:
+    const IR::Type_Bits *eightBitType = IR::Type_Bits::get(8);
+    const IR::SymbolicVariable *fooVar =
+        ToolsVariables::getSymbolicVariable(eightBitType, "foo"_cs);
+    const IR::SymbolicVariable *barVar =
+        ToolsVariables::getSymbolicVariable(eightBitType, "bar"_cs);
+
+    /// Builds a new expression `(foo + bar) == value`.
+    const IR::Expression *sumEquals(int value) {
+        return new IR::Equ(new IR::Add(eightBitType, fooVar, barVar),
+                           IR::Constant::get(eightBitType, value));
+    }
+};
+
+TEST_F(HashConsTest, SharesEqualExpressions) {
+    const auto *first = HashCons::intern(sumEquals(3));
+    const auto *second = HashCons::intern(sumEquals(3));
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(HashCons::isInterned(first));
+
+    // Subexpressions are shared as well.
+    const auto *other = HashCons::intern(sumEquals(4))->checkedTo<IR::Equ>();
+    EXPECT_NE(other, first);
+    EXPECT_EQ(other->left, first->checkedTo<IR::Equ>()->left);
+    EXPECT_TRUE(HashCons::isInterned(other->left));
+
+    EXPECT_FALSE(HashCons::isInterned(sumEquals(3)));
+    EXPECT_EQ(HashCons::intern(first), first);
+}
+
+TEST_F(HashConsTest, ClearDropsCanonicalInstances) {
+    const auto *first = HashCons::intern(sumEquals(5));
+    EXPECT_GT(HashCons::size(), 0U);
+
+    HashCons::clear();
+    EXPECT_EQ(HashCons::size(), 0U);
+    EXPECT_FALSE(HashCons::isInterned(first));
+
+    // Equal expressions are shared again after the table has been dropped.
+    const auto *second = HashCons::intern(sumEquals(5));
+    EXPECT_TRUE(HashCons::isInterned(second));
+    EXPECT_EQ(HashCons::intern(sumEquals(5)), second);
+    EXPECT_TRUE(second->equiv(*first));
+}
+
+TEST_F(HashConsTest, CachedTranslations) {
+    Z3Solver solver;
+    const auto *fooEquals =
+        HashCons::intern(new IR::Equ(fooVar, IR::Constant::get(eightBitType, 1)));
+    const auto *barEquals =
+        HashCons::intern(new IR::Equ(barVar, IR::Constant::get(eightBitType, 2)));
+    EXPECT_EQ(solver.checkSat({fooEquals}), true);
+    EXPECT_EQ(solver.checkSat({barEquals}), true);
+
+    // The cached translation does not declare foo again, but the model still binds it.
+    EXPECT_EQ(solver.checkSat({fooEquals, barEquals}), true);
+    Model model(solver.getSymbolicMapping());
+    EXPECT_EQ(model.evaluate(fooVar, false)->checkedTo<IR::Constant>()->asUnsigned(), 1U);
+    EXPECT_EQ(model.evaluate(HashCons::intern(new IR::Add(eightBitType, fooVar, barVar)), false)
+                  ->checkedTo<IR::Constant>()
+                  ->asUnsigned(),
+              3U);
+}
+
+}  // namespace P4::P4Tools::Test
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/common/lib/persistent_log.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+/// Copies of a log share their elements, but not the elements appended after the copy.
+TEST(PersistentLogTest, CopiesAreIndependent) {
+    PersistentLog<uint64_t> log;
+    for (uint64_t i = 0; i < 10; ++i) {
+        log.push_back(i);
+    }
+    auto left = log;
+    auto right = log;
+    left.push_back(10);
+    right.push_back(20);
+    right.push_back(21);
+
+    std::vector<uint64_t> expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(log.toVector(), expected);
+    EXPECT_EQ(log.size(), 10U);
+    expected.push_back(10);
+    EXPECT_EQ(left.toVector(), expected);
+    expected.back() = 20;
+    expected.push_back(21);
+    EXPECT_EQ(right.toVector(), expected);
+    EXPECT_EQ(right.back(), 21U);
+}
+
+/// Long logs are released without recursing over their elements.
+TEST(PersistentLogTest, ReleasesLongLogs) {
+    auto *log = new PersistentLog<uint64_t>();
+    for (uint64_t i = 0; i < 1000000; ++i) {
+        log->push_back(i);
+    }
+    auto copy = *log;
+    copy.push_back(0);
+    delete log;
+    EXPECT_EQ(copy.size(), 1000001U);
+    EXPECT_TRUE(PersistentLog<uint64_t>().empty());
+
+    // Assigning to a log releases its old elements the same way.
+    copy = PersistentLog<uint64_t>();
+    EXPECT_TRUE(copy.empty());
+    for (uint64_t i = 0; i < 1000000; ++i) {
+        copy.push_back(i);
+    }
+    PersistentLog<uint64_t> other;
+    other.push_back(1);
+    copy = other;
+    EXPECT_EQ(copy.toVector(), other.toVector());
+    const auto &self = copy;
+    copy = self;
+    EXPECT_EQ(copy.size(), 1U);
+}
+
+/// Logs are searched in place.
+TEST(PersistentLogTest, Lookup) {
+    PersistentLog<uint64_t> log;
+    for (uint64_t i = 0; i < 10; ++i) {
+        log.push_back(i * 2);
+    }
+    EXPECT_TRUE(log.contains(0));
+    EXPECT_TRUE(log.contains(18));
+    EXPECT_FALSE(log.contains(7));
+    size_t tested = 0;
+    EXPECT_TRUE(log.anyOf([&tested](uint64_t value) {
+        ++tested;
+        return value == 14;
+    }));
+    // The search starts at the last element and stops at the first match.
+    EXPECT_EQ(tested, 3U);
+    EXPECT_FALSE(PersistentLog<uint64_t>().anyOf([](uint64_t) { return true; }));
+}
+
+}  // namespace
+
+}  // namespace P4::P4Tools::Test
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/common/lib/symbolic_env.h"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "backends/p4tools/common/lib/variables.h"
+#include "backends/p4tools/modules/testgen/test/lib/symbolic_env.h"
+#include "ir/ir.h"
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+std::vector<IR::StateVariable> makeVariables(int count) {
+    const auto *type = IR::Type_Bits::get(8);
+    std::vector<IR::StateVariable> variables;
+    for (int i = 0; i < count; ++i) {
+        auto name = cstring("v" + std::to_string(i));
+        variables.push_back(ToolsVariables::getStateVariable(type, name));
+    }
+    return variables;
+}
+
+/// Copies of an environment do not see each other's updates.
+TEST_F(SymbolicEnvTest, CopiesAreIndependent) {
+    const auto *type = IR::Type_Bits::get(8);
+    auto variables = makeVariables(300);
+    SymbolicEnv env;
+    for (size_t i = 0; i < variables.size(); ++i) {
+        env.set(variables[i], IR::Constant::get(type, i % 256));
+    }
+
+    auto copy = env;
+    for (size_t i = 0; i < variables.size(); i += 2) {
+        copy.set(variables[i], IR::Constant::get(type, 255));
+    }
+    for (size_t i = 0; i < variables.size(); ++i) {
+        const auto *original = env.get(variables[i])->checkedTo<IR::Constant>();
+        const auto *copied = copy.get(variables[i])->checkedTo<IR::Constant>();
+        EXPECT_EQ(original->asUnsigned(), i % 256);
+        EXPECT_EQ(copied->asUnsigned(), i % 2 == 0 ? 255 : i % 256);
+    }
+}
+
+/// The internal map contains every binding exactly once, in order.
+TEST_F(SymbolicEnvTest, InternalMap) {
+    const auto *type = IR::Type_Bits::get(8);
+    auto variables = makeVariables(100);
+    SymbolicEnv env;
+    for (const auto &variable : variables) {
+        env.set(variable, IR::Constant::get(type, 1));
+    }
+    auto copy = env;
+    copy.set(variables.front(), IR::Constant::get(type, 2));
+    EXPECT_TRUE(copy.exists(variables.back()));
+
+    const auto &map = copy.getInternalMap();
+    ASSERT_EQ(map.size(), variables.size());
+    for (auto it = map.begin(); std::next(it) != map.end(); ++it) {
+        EXPECT_TRUE(it->first < std::next(it)->first);
+    }
+    EXPECT_EQ(map.at(variables.front())->checkedTo<IR::Constant>()->asUnsigned(), 2U);
+    EXPECT_EQ(env.getInternalMap().at(variables.front())->checkedTo<IR::Constant>()->asUnsigned(),
+              1U);
+}
+
+}  // namespace
+
+}  // namespace P4::P4Tools::Test
@@ -0,0 +1,19 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_SYMBOLIC_ENV_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_SYMBOLIC_ENV_H_
+
+#include <gtest/gtest.h>
+
+namespace P4::P4Tools::Test {
+
+/// Helper methods to build configurations for SymbolicEnv Tests.
+class SymbolicEnvTest : public testing::Test {};
+
+}  // namespace P4::P4Tools::Test
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_SYMBOLIC_ENV_H_ */
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "backends/p4tools/common/compiler/reachability.h"
+#include "ir/ir.h"
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+/// Builds the graph
+///   0 -> 1 -> 2 -> 3
+///   0 -> 4 -> 3
+///   3 -> 1
+class TargetDistancesTest : public testing::Test {
+ protected:
+    std::vector<DCGVertexType> vertices;
+    NodesCallGraph dcg{"NodesCallGraph"};
+
+    void SetUp() override {
+        for (int i = 0; i < 5; ++i) {
+            vertices.push_back(new IR::Constant(i));
+        }
+        dcg.calls(vertices[0], vertices[1]);
+        dcg.calls(vertices[1], vertices[2]);
+        dcg.calls(vertices[2], vertices[3]);
+        dcg.calls(vertices[0], vertices[4]);
+        dcg.calls(vertices[4], vertices[3]);
+        dcg.calls(vertices[3], vertices[1]);
+    }
+};
+
+}  // namespace
+
+TEST_F(TargetDistancesTest, Distances) {
+    TargetDistances distances(dcg, {vertices[2]});
+    EXPECT_EQ(distances.targetCount(), 1U);
+    EXPECT_EQ(distances.distance(vertices[2]), 0U);
+    EXPECT_EQ(distances.distance(vertices[1]), 1U);
+    EXPECT_EQ(distances.distance(vertices[0]), 2U);
+    EXPECT_EQ(distances.distance(vertices[3]), 2U);
+    EXPECT_EQ(distances.distance(vertices[4]), 3U);
+    EXPECT_FALSE(distances.contains(new IR::Constant(5)));
+    EXPECT_EQ(distances.distance(new IR::Constant(5)), TargetDistances::UNREACHABLE);
+}
+
+TEST_F(TargetDistancesTest, RemoveTargets) {
+    TargetDistances distances(dcg, {vertices[1], vertices[3], vertices[4]});
+    EXPECT_EQ(distances.distance(vertices[0]), 1U);
+    EXPECT_EQ(distances.distance(vertices[2]), 1U);
+
+    // Vertex 0 still reaches vertex 4 directly.
+    distances.removeTargets({vertices[1]});
+    EXPECT_EQ(distances.targetCount(), 2U);
+    EXPECT_EQ(distances.distance(vertices[0]), 1U);
+    EXPECT_EQ(distances.distance(vertices[1]), 2U);
+    EXPECT_EQ(distances.distance(vertices[2]), 1U);
+
+    distances.removeTargets({vertices[4]});
+    EXPECT_EQ(distances.distance(vertices[0]), 2U);
+    EXPECT_EQ(distances.distance(vertices[4]), 1U);
+
+    // Removing a vertex that is not a target does not change anything.
+    distances.removeTargets({vertices[0]});
+    EXPECT_EQ(distances.targetCount(), 1U);
+
+    distances.removeTargets({vertices[3]});
+    EXPECT_EQ(distances.targetCount(), 0U);
+    for (const auto *vertex : vertices) {
+        EXPECT_EQ(distances.distance(vertex), TargetDistances::UNREACHABLE);
+    }
+}
+
+}  // namespace P4::P4Tools::Test
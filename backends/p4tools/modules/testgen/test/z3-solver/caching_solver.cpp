@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backends/p4tools/common/core/caching_solver.h"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/variables.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+#include "lib/cstring.h"
+
+namespace P4::P4Tools::Test {
+
+using namespace P4::literals;
+
+namespace {
+
+/// A Z3 solver that counts the queries it answers.
+class CountingSolver : public Z3Solver {
+ public:
+    int queries = 0;
+
+    std::optional<bool> checkSat(const std::vector<const Constraint *> &asserts) override {
+        ++queries;
+        return Z3Solver::checkSat(asserts);
+    }
+};
+
+}  // namespace
+
+class CachingSolverTest : public testing::Test {
+ protected:
+    CountingSolver backing;
+    CachingSolver solver{backing};
+
+    const IR::Type_Bits *eightBitType = IR::Type_Bits::get(8);
+    const IR::SymbolicVariable *fooVar =
+        ToolsVariables::getSymbolicVariable(eightBitType, "foo"_cs);
+    const IR::SymbolicVariable *barVar =
+        ToolsVariables::getSymbolicVariable(eightBitType, "bar"_cs);
+
+    /// Builds a new constraint `var == value`.
+    const Constraint *equals(const IR::SymbolicVariable *var, int value) {
+        return new IR::Equ(var, IR::Constant::get(eightBitType, value));
+    }
+
+    /// Builds a new constraint `var < value`.
+    const Constraint *less(const IR::SymbolicVariable *var, int value) {
+        return new IR::Lss(var, IR::Constant::get(eightBitType, value));
+    }
+
+    /// @returns the value of @p var in the last model.
+    big_int value(const IR::SymbolicVariable *var) {
+        const auto &model = solver.getSymbolicMapping();
+        auto it = model.find(var);
+        EXPECT_NE(it, model.end());
+        return it == model.end() ? -1 : it->second->checkedTo<IR::Constant>()->value;
+    }
+};
+
+TEST_F(CachingSolverTest, IndependentGroups) {
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), equals(barVar, 2)}), true);
+    EXPECT_EQ(backing.queries, 2);
+    EXPECT_EQ(value(fooVar), 1);
+    EXPECT_EQ(value(barVar), 2);
+
+    // Only the group of bar changed.
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), equals(barVar, 3)}), true);
+    EXPECT_EQ(backing.queries, 3);
+    EXPECT_EQ(value(fooVar), 1);
+    EXPECT_EQ(value(barVar), 3);
+
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), equals(barVar, 3), equals(barVar, 4)}), false);
+    EXPECT_EQ(backing.queries, 4);
+}
+
+TEST_F(CachingSolverTest, StructurallyEqualConstraints) {
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), less(barVar, 5)}), true);
+    EXPECT_EQ(backing.queries, 2);
+    EXPECT_EQ(solver.checkSat({less(barVar, 5), equals(fooVar, 1)}), true);
+    EXPECT_EQ(backing.queries, 2);
+    EXPECT_EQ(value(fooVar), 1);
+}
+
+TEST_F(CachingSolverTest, DerivedResults) {
+    // A subset of a satisfiable group is satisfiable.
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), less(fooVar, 5)}), true);
+    EXPECT_EQ(solver.checkSat({less(fooVar, 5)}), true);
+    EXPECT_EQ(backing.queries, 1);
+    EXPECT_EQ(value(fooVar), 1);
+
+    // The model of a subset satisfies the additional constraint.
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), less(fooVar, 5), less(fooVar, 9)}), true);
+    EXPECT_EQ(backing.queries, 1);
+
+    // A superset of an unsatisfiable group is unsatisfiable.
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), equals(fooVar, 2)}), false);
+    EXPECT_EQ(backing.queries, 2);
+    EXPECT_EQ(solver.checkSat({less(fooVar, 5), equals(fooVar, 2), equals(fooVar, 1)}), false);
+    EXPECT_EQ(backing.queries, 2);
+
+    // The model of the subset does not satisfy the additional constraint.
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), less(fooVar, 5), less(fooVar, 1)}), false);
+    EXPECT_EQ(backing.queries, 3);
+}
+
+TEST_F(CachingSolverTest, ModelsOfIndependentGroups) {
+    // foo and bar are in one group here.
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), new IR::Equ(barVar, fooVar)}), true);
+    EXPECT_EQ(value(barVar), 1);
+
+    // Here they are in two groups. The group of foo is a subset of the cached group, whose model
+    // binds bar as well. That binding must not override the model of the group of bar.
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), equals(barVar, 7)}), true);
+    EXPECT_EQ(backing.queries, 2);
+    EXPECT_EQ(value(fooVar), 1);
+    EXPECT_EQ(value(barVar), 7);
+
+    // The same for a group of foo that is answered by the model of a cached subset.
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), less(fooVar, 3), equals(barVar, 9)}), true);
+    EXPECT_EQ(value(fooVar), 1);
+    EXPECT_EQ(value(barVar), 9);
+}
+
+TEST_F(CachingSolverTest, TrivialConstraints) {
+    EXPECT_EQ(solver.checkSat({IR::BoolLiteral::get(true)}), true);
+    EXPECT_EQ(solver.checkSat({equals(fooVar, 1), IR::BoolLiteral::get(false)}), false);
+    EXPECT_EQ(backing.queries, 0);
+}
+
+}  // namespace P4::P4Tools::Test
@@ -12,21 +12,26 @@
 #include <utility>
 
 #include "backends/p4tools/common/compiler/compiler_target.h"
+#include "backends/p4tools/common/core/caching_solver.h"
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "frontends/common/parser_options.h"
 #include "ir/solver.h"
 #include "lib/cstring.h"
 #include "lib/error.h"
+#include "lib/exceptions.h"
 
 #include "backends/p4tools/modules/testgen/core/compiler_result.h"
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/directed_coverage.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/greedy_node_cov.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/random_backtrack.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/selected_branches.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
 #include "backends/p4tools/modules/testgen/core/target.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
 #include "backends/p4tools/modules/testgen/lib/test_backend.h"
 #include "backends/p4tools/modules/testgen/lib/test_framework.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -37,6 +42,16 @@ namespace P4::P4Tools::P4Testgen {
 
 namespace {
 
+/// @returns @p z3Solver, or a CachingSolver in front of it, constructed in @p cachingSolver, if
+/// the cache is enabled.
+AbstractSolver &pickSolver(const TestgenOptions &testgenOptions, Z3Solver &z3Solver,
+                           std::optional<CachingSolver> &cachingSolver) {
+    if (!testgenOptions.solverCache) {
+        return z3Solver;
+    }
+    return cachingSolver.emplace(z3Solver);
+}
+
 /// Pick the path selection algorithm for the symbolic executor.
 SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
                                       const ProgramInfo &programInfo, AbstractSolver &solver) {
@@ -44,6 +59,9 @@ SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
     if (pathSelectionPolicy == PathSelectionPolicy::GreedyStmtCoverage) {
         return new GreedyNodeSelection(solver, programInfo);
     }
+    if (pathSelectionPolicy == PathSelectionPolicy::DirectedCoverage) {
+        return new DirectedCoverageSearch(solver, programInfo);
+    }
     if (pathSelectionPolicy == PathSelectionPolicy::RandomBacktrack) {
         return new RandomBacktrack(solver, programInfo);
     }
@@ -51,9 +69,36 @@ SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
         std::string selectedBranchesStr = testgenOptions.selectedBranches;
         return new SelectedBranches(solver, programInfo, selectedBranchesStr);
     }
+#ifdef MULTITHREAD
+    if (testgenOptions.threads > 1) {
+        return new ParallelDepthFirstSearch(solver, programInfo, testgenOptions.threads);
+    }
+#endif  // MULTITHREAD
     return new DepthFirstSearch(solver, programInfo);
 }
 
+/// Enables checkpoints of the exploration, if requested, and restores the last checkpoint when
+/// resuming. @returns false if the checkpoint could not be restored.
+bool setUpCheckpoints(const TestgenOptions &testgenOptions, SymbolicExecutor &symbolicExecutor,
+                      TestBackEnd &testBackend) {
+    if (!testgenOptions.checkpointDir.has_value()) {
+        return true;
+    }
+    auto *depthFirstSearch = dynamic_cast<DepthFirstSearch *>(&symbolicExecutor);
+    BUG_CHECK(depthFirstSearch != nullptr, "Checkpoints require the depth-first search.");
+    if (testgenOptions.resume) {
+        auto checkpoint = Checkpoint::read(testgenOptions.checkpointDir.value());
+        if (!checkpoint.has_value()) {
+            return false;
+        }
+        depthFirstSearch->resume(checkpoint.value());
+        testBackend.setTestCount(checkpoint.value().testCount);
+    }
+    depthFirstSearch->enableCheckpoints(testgenOptions.checkpointDir.value(),
+                                        [&testBackend] { return testBackend.getTestCount(); });
+    return errorCount() == 0;
+}
+
 /// Analyse the results of the symbolic execution and generate diagnostic messages.
 int postProcess(const TestgenOptions &testgenOptions, const TestBackEnd &testBackend) {
     // Do not print this warning if assertion mode is enabled.
@@ -83,14 +128,20 @@ std::optional<AbstractTestList> generateAndCollectAbstractTests(
     TestBackendConfiguration testBackendConfiguration{testgenOptions.testBaseName.value(),
                                                       testgenOptions.maxTests, std::nullopt,
                                                       testgenOptions.seed};
-    // Need to declare the solver here to ensure its lifetime.
-    Z3Solver solver;
+    // Need to declare the solvers here to ensure their lifetime.
+    Z3Solver z3Solver;
+    std::optional<CachingSolver> cachingSolver;
+    auto &solver = pickSolver(testgenOptions, z3Solver, cachingSolver);
     auto *symbolicExecutor = pickExecutionEngine(testgenOptions, programInfo, solver);
 
     // Each test back end has a different run function.
     auto *testBackend =
         TestgenTarget::getTestBackend(programInfo, testBackendConfiguration, *symbolicExecutor);
 
+    if (!setUpCheckpoints(testgenOptions, *symbolicExecutor, *testBackend)) {
+        return std::nullopt;
+    }
+
     // Define how to handle the final state for each test. This is target defined.
     // We delegate execution to the symbolic executor.
     symbolicExecutor->run([testBackend](auto &&finalState) {
@@ -131,14 +182,20 @@ int generateAndWriteAbstractTests(const TestgenOptions &testgenOptions,
     TestBackendConfiguration testBackendConfiguration{
         cstring(testPath.c_str()), testgenOptions.maxTests, testPath, testgenOptions.seed};
 
-    // Need to declare the solver here to ensure its lifetime.
-    Z3Solver solver;
+    // Need to declare the solvers here to ensure their lifetime.
+    Z3Solver z3Solver;
+    std::optional<CachingSolver> cachingSolver;
+    auto &solver = pickSolver(testgenOptions, z3Solver, cachingSolver);
     auto *symbolicExecutor = pickExecutionEngine(testgenOptions, programInfo, solver);
 
     // Each test back end has a different run function.
     auto *testBackend =
         TestgenTarget::getTestBackend(programInfo, testBackendConfiguration, *symbolicExecutor);
 
+    if (!setUpCheckpoints(testgenOptions, *symbolicExecutor, *testBackend)) {
+        return EXIT_FAILURE;
+    }
+
     // Define how to handle the final state for each test. This is target defined.
     // We delegate execution to the symbolic executor.
     symbolicExecutor->run([testBackend](auto &&finalState) {
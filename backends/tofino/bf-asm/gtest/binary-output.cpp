@@ -0,0 +1,73 @@
+/**
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "backends/tofino/bf-asm/target.h"
+
+namespace {
+
+/* Tests for the binary config that bfas writes directly from its register objects.
+ *
+ * walle crunches the JSON dump of the same registers against the chip schema into the
+ * binary config that bfas used to rely on; the native output must match it byte for byte.
+ */
+
+std::string read_file(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/// @returns the binary config of the registers dumped in @p json, as generated by walle.
+std::string walle_binary(const std::filesystem::path &json, const char *top) {
+    auto bin = json;
+    bin.replace_extension(".bin");
+    std::stringstream cmd;
+    cmd << BFASM_WALLE << " --schema " << BFASM_TOFINO_SCHEMA << " --top " << top << " -o "
+        << bin << " " << json << " > /dev/null";
+    EXPECT_EQ(std::system(cmd.str().c_str()), 0) << cmd.str();
+    return read_file(bin);
+}
+
+TEST(binary_output, tofino_parser_regs_match_walle) {
+    auto dir = std::filesystem::temp_directory_path() /
+               ("bfas_binary_output_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+
+    ::Tofino::regs_all_parser_egress regs;
+    regs.prsr_reg.no_multi_wr.nmw[3] = 1;
+    regs.prsr_reg.no_multi_wr.nmw[17] = 1;
+    regs.prsr_reg.no_multi_wr.t_nmw[5] = 1;
+
+    auto json = dir / "regs.all.parser.egress.cfg.json";
+    {
+        std::ofstream out(json);
+        regs.emit_json(out);
+    }
+    std::stringstream native;
+    regs.emit_binary(native, 0);
+
+    auto expected = walle_binary(json, "regs.all.parser.egress");
+    auto actual = native.str();
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(actual.size(), expected.size());
+    auto mismatch = std::mismatch(actual.begin(), actual.end(), expected.begin(), expected.end());
+    EXPECT_TRUE(mismatch.first == actual.end() && mismatch.second == expected.end())
+        << "first difference at byte " << (mismatch.first - actual.begin());
+
+    std::filesystem::remove_all(dir);
+}
+
+}  // namespace
@@ -26,6 +26,7 @@
 #include <cstring>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <unordered_set>
 #include <vector>
 
@@ -555,6 +556,41 @@ BFN_Options::BFN_Options() {
         },
         "Reduce number of MAU stages available for compiler. Defaults to "
         "max number of stages available for given device. This may affect table placement");
+    registerOption(
+        "--jobs", "num",
+        [this](const char *arg) {
+            std::string argStr(arg);
+            try {
+                std::size_t end;
+                int tmp = std::stoi(argStr, &end);
+                if (end != argStr.size() || tmp <= 0) throw std::invalid_argument(argStr);
+                jobs = tmp;
+            } catch (...) {
+                ::error("Invalid number of jobs %s. Enter positive integer.", arg);
+                return false;
+            }
+            return true;
+        },
+        "Compile up to num independent pipes concurrently, each in its own worker process.\n"
+        "Output is identical to a serial compile. Defaults to 1.");
+    registerOption(
+        "--phv-jobs", "num",
+        [this](const char *arg) {
+            std::string argStr(arg);
+            try {
+                std::size_t end;
+                int tmp = std::stoi(argStr, &end);
+                if (end != argStr.size() || tmp <= 0) throw std::invalid_argument(argStr);
+                phv_jobs = tmp;
+            } catch (...) {
+                ::error("Invalid number of PHV jobs %s. Enter positive integer.", arg);
+                return false;
+            }
+            return true;
+        },
+        "Try up to num slicings of a super cluster concurrently in the alternative PHV "
+        "allocator.\nOnly has an effect if the compiler was built with ENABLE_MULTITHREAD. "
+        "Defaults to 1.");
     registerOption(
         "--enable-event-logger", nullptr,
         [this](const char *) {
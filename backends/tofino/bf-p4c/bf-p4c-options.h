@@ -65,6 +65,10 @@ class BFN_Options : public CompilerOptions {
 #endif
     int traffic_limit = 100;
     int num_stages_override = 0;
+    /// Number of pipes to run through the backend concurrently (--jobs).
+    int jobs = 1;
+    /// Number of slicings of a super cluster that PHV allocation tries concurrently (--phv-jobs).
+    int phv_jobs = 1;
     bool enable_event_logger = false;
     bool disable_parse_min_depth_limit = false;
     bool disable_parse_max_depth_limit = false;
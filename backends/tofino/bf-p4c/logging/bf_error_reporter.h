@@ -53,6 +53,16 @@ class BfErrorReporter : public ErrorReporter {
 
     void increment_the_error_count() { ++this->errorCount; }
 
+    /// Fold in the diagnostics counted by a backend worker process (see --jobs).
+    void add_worker_counts(unsigned errors, unsigned warnings) {
+        this->errorCount += errors;
+        this->warningCount += warnings;
+    }
+
+    /// True if the program contains expected error/warning checks. Those are matched in the
+    /// process that emits the diagnostic, so such programs are never compiled with --jobs.
+    bool has_checks() const { return has_error_checks; }
+
     /**
      * @brief Adds a check with no specified source code line.
      *
@@ -22,7 +22,9 @@
 
 #include <cstdlib>
 #include <filesystem>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "backends/graphs/controls.h"
 #include "backends/graphs/graph_visitor.h"
@@ -410,6 +412,54 @@ void Manifest::addLog(const int pipe, const cstring logType, const cstring logNa
     getPipeOutputs(pipe)->m_logs.insert(PathAndType(path, logType));
 }
 
+// One record per line, fields separated by tabs; the path is always the last field.
+void Manifest::exportPipeOutputs(std::ostream &out) const {
+    for (const auto &[pipe, outputs] : m_pipeOutputs) {
+        out << "pipe\t" << pipe << "\n";
+        if (outputs->m_context) out << "context\t" << outputs->m_context << "\n";
+        if (outputs->m_binary) out << "binary\t" << outputs->m_binary << "\n";
+        for (const auto &resource : outputs->m_resources)
+            out << "resource\t" << resource.second << "\t" << resource.first << "\n";
+        for (const auto &log : outputs->m_logs)
+            out << "log\t" << log.second << "\t" << log.first << "\n";
+        for (const auto &graph : outputs->m_graphs)
+            out << "graph\t" << static_cast<int>(graph.m_gress) << "\t" << graph.m_type << "\t"
+                << graph.m_format << "\t" << graph.m_path << "\n";
+    }
+}
+
+void Manifest::importPipeOutputs(std::istream &in) {
+    OutputFiles *outputs = nullptr;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::istringstream fieldStream(line);
+        for (std::string field; std::getline(fieldStream, field, '\t');) fields.push_back(field);
+        if (fields.empty()) continue;
+        const auto &kind = fields.front();
+        if (kind == "pipe" && fields.size() == 2) {
+            outputs = getPipeOutputs(std::stoi(fields[1]));
+            continue;
+        }
+        BUG_CHECK(outputs, "Manifest record '%1%' precedes its pipe", line);
+        if (kind == "context" && fields.size() == 2) {
+            outputs->m_context = cstring(fields[1]);
+        } else if (kind == "binary" && fields.size() == 2) {
+            outputs->m_binary = cstring(fields[1]);
+        } else if (kind == "resource" && fields.size() == 3) {
+            outputs->m_resources.emplace(cstring(fields[2]), cstring(fields[1]));
+        } else if (kind == "log" && fields.size() == 3) {
+            outputs->m_logs.emplace(cstring(fields[2]), cstring(fields[1]));
+        } else if (kind == "graph" && fields.size() == 5) {
+            auto gress = static_cast<gress_t>(std::stoi(fields[1]));
+            outputs->m_graphs.emplace(cstring(fields[4]), gress, cstring(fields[2]),
+                                      cstring(fields[3]));
+        } else {
+            BUG("Malformed manifest record '%1%'", line);
+        }
+    }
+}
+
 /// Return the singleton object
 Manifest &Manifest::getManifest() {
     static Manifest instance;
@@ -157,6 +157,13 @@ class Manifest : public Inspector {
         m_frontendIrLogPath = frontendIrLogPath_in;
     }
 
+    /// Write the per-pipe outputs in the line-oriented form read by importPipeOutputs().
+    /// A backend worker process (see --jobs) uses this to hand its manifest entries back
+    /// to the process that serializes the manifest.
+    void exportPipeOutputs(std::ostream &out) const;
+    /// Merge outputs written by exportPipeOutputs() into this manifest.
+    void importPipeOutputs(std::istream &in);
+
     /// serialize the entire manifest
     virtual void serialize();
 
@@ -19,17 +19,8 @@
 #include "backends/tofino/bf-p4c/mau/table_placement.h"
 
 #ifdef MULTITHREAD
-#include <pthread.h>
-
-#include <gc/gc.h>
-
-#include <atomic>
-#include <condition_variable>
 #include <map>
 #include <mutex>
-#include <queue>
-#include <thread>
-#include <vector>
 #endif
 #include <algorithm>
 #include <list>
@@ -65,6 +56,7 @@
 #include "lib/log.h"
 #include "lib/safe_vector.h"
 #include "lib/set.h"
+#include "lib/thread_pool.h"
 
 #ifndef LOGGING_FEATURE
 // FIXME -- should be in p4c code in log.h -- remove this once it is added there
@@ -3821,16 +3813,16 @@ std::optional<DecidePlacement::BacktrackPlacement *> DecidePlacement::find_backt
 }
 
 #ifdef MULTITHREAD
-/* This class is used to evaluate multiple possible table placement in parallel using x number
- * of worker threads. Typically the table placement code evaluate all of the table that can be
- * placed at any given time and choose which one to select based on some heuristics. The evaluated
- * table that are not selected can be saved as backtrack point if table placement want to try a
- * different approach going forward. The evaluation does not update any IR element nor update
- * any storage class so it is a good candidate for parallel execution. The table evaluation
- * are distributed amond the worker thread in any given order but each request have an ID that
- * specify the original request sorting order. This ID is used to re-order the table evaluation
- * with the exact same order as initially requested. The idea is to have the exact same result
- * with or without parallel evaluation.
+/* This class is used to evaluate multiple possible table placement in parallel on x number
+ * of worker threads of the shared ThreadPool. Typically the table placement code evaluate all of
+ * the table that can be placed at any given time and choose which one to select based on some
+ * heuristics. The evaluated table that are not selected can be saved as backtrack point if table
+ * placement want to try a different approach going forward. The evaluation does not update any
+ * IR element nor update any storage class so it is a good candidate for parallel execution. The
+ * table evaluation are distributed amond the worker thread in any given order but each request
+ * have an ID that specify the original request sorting order. This ID is used to re-order the
+ * table evaluation with the exact same order as initially requested. The idea is to have the
+ * exact same result with or without parallel evaluation.
  *
  * The multithreading code can be enabled by defining "ENABLE_MULTITHREAD",
  * e.g. "-DENABLE_MULTITHREAD=ON" when calling the "bootstrap_bfn_compilers.sh" step. This variable
@@ -3853,131 +3845,38 @@ std::optional<DecidePlacement::BacktrackPlacement *> DecidePlacement::find_backt
  */
 class DecidePlacement::TryPlacedPool {
     const DecidePlacement &self;
-    std::vector<pthread_t> workers;
-    std::atomic<bool> terminated{false};
-    std::condition_variable_any queue_CV;
-    std::mutex queue_mutex;
-
-    // Carry all the information needed to evaluate a table.
-    struct request_arg {
-        const IR::MAU::Table *t;
-        const Placed *done;
-        const StageUseEstimate &current;
-        TablePlacement::GatewayMergeChoices *gmc;
-        const GroupPlace *group;
-
-        request_arg(const IR::MAU::Table *t, const Placed *done, const StageUseEstimate &current,
-                    TablePlacement::GatewayMergeChoices *gmc, const GroupPlace *group)
-            : t(t), done(done), current(current), gmc(gmc), group(group) {}
-    };
-    std::queue<std::pair<int, struct request_arg *>> work_queue;
-    std::condition_variable_any res_CV;
+    TaskGroup group;
     std::mutex res_mutex;
     std::map<int, std::pair<safe_vector<TablePlacement::Placed *>, const GroupPlace *>> work_result;
 
     int num_req = 0;
-    int exe_req = 0;
-
-    // Required to bind a pthread to an object
-    static void *workerWaitCast(void *arg) {
-        DecidePlacement::TryPlacedPool *tp =
-            reinterpret_cast<DecidePlacement::TryPlacedPool *>(arg);
-        tp->workerWait();
-        return NULL;
-    }
-    void *workerWait();
 
  public:
-    explicit TryPlacedPool(DecidePlacement &self, int n) : self(self) {
-        static bool init_mt = true;
-        if (init_mt) {
-            GC_allow_register_threads();
-            init_mt = false;
-        }
-        for (int i = 0; i < n; i++) {
-            pthread_t tid;
-            pthread_attr_t attr;
-            int err;
-            // This value is to make sure the created stack will not be cached
-            size_t stack_size = 1024 * 1024 * 64;  // 64MB
-            err = pthread_attr_init(&attr);
-            BUG_CHECK(!err, "Pthread Attribute initialization fail with error: %d", err);
-            err = pthread_attr_setstacksize(&attr, stack_size);
-            BUG_CHECK(!err, "Pthread Attribute Set Stack Size fail with error: %d", err);
-            err = pthread_create(&tid, &attr, workerWaitCast, this);
-            BUG_CHECK(!err, "Pthread Creation fail with error: %d", err);
-            err = pthread_attr_destroy(&attr);
-            BUG_CHECK(!err, "Pthread Attribute destroy fail with error: %d", err);
-            workers.push_back(tid);
-        }
-    }
-    ~TryPlacedPool() {
-        if (!terminated.load()) {
-            shutdown();
-        }
-    }
+    explicit TryPlacedPool(DecidePlacement &self, int n)
+        : self(self), group(ThreadPool::shared(n)) {}
     void cleanup();
-    void shutdown();
     void addReq(const IR::MAU::Table *t, const Placed *done, const StageUseEstimate &current,
                 const TablePlacement::GatewayMergeChoices &gmc, const GroupPlace *group);
     bool fillTrial(safe_vector<const Placed *> &trial, bitvec &trial_tables);
 };
 
-// Worker thread that process request until the "terminated" flag is set
-void *DecidePlacement::TryPlacedPool::workerWait() {
-    GC_stack_base sb;
-    GC_get_stack_base(&sb);
-    GC_register_my_thread(&sb);
-
-    while (!terminated.load()) {
-        std::pair<int, struct request_arg *> req;
-        {
-            std::unique_lock<std::mutex> guard(queue_mutex);
-            queue_CV.wait(guard, [&] { return !work_queue.empty() || terminated.load(); });
-            if (terminated.load()) {
-                break;
-            }
-            req = work_queue.front();
-            work_queue.pop();
-        }
-        safe_vector<TablePlacement::Placed *> res = self.self.try_place_table(
-            req.second->t, req.second->done, req.second->current, *req.second->gmc);
-        {
-            std::lock_guard<std::mutex> guard(res_mutex);
-            work_result[req.first] = std::make_pair(std::move(res), req.second->group);
-            exe_req++;
-            res_CV.notify_one();
-        }
-    }
-    GC_unregister_my_thread();
-    return NULL;
-}
-
-// Add a request to be processed by one of the Worker Thread
+// Add a request to be processed by one of the worker threads
 void DecidePlacement::TryPlacedPool::addReq(const IR::MAU::Table *t, const Placed *done,
                                             const StageUseEstimate &current,
                                             const TablePlacement::GatewayMergeChoices &gmc,
-                                            const GroupPlace *group) {
-    TablePlacement::GatewayMergeChoices *gmc_copy = new TablePlacement::GatewayMergeChoices(gmc);
-    request_arg *req_arg = new request_arg(t, done, current, gmc_copy, group);
-    std::lock_guard<std::mutex> guard(queue_mutex);
-    work_queue.push(std::make_pair(num_req++, req_arg));
-    queue_CV.notify_one();
+                                            const GroupPlace *grp) {
+    group.run([this, id = num_req++, t, done, &current, gmc, grp]() mutable {
+        auto res = self.self.try_place_table(t, done, current, gmc);
+        std::lock_guard<std::mutex> guard(res_mutex);
+        work_result[id] = std::make_pair(std::move(res), grp);
+    });
 }
 
-// Wait for the worker thread to finalize all the requested evaluation than fill the trial vector
+// Wait for the worker threads to finalize all the requested evaluation than fill the trial vector
 // for further analysis by heuristic based best choice
 bool DecidePlacement::TryPlacedPool::fillTrial(safe_vector<const Placed *> &trial,
                                                bitvec &trial_tables) {
-    int expected_req;
-    {
-        std::lock_guard<std::mutex> guard(queue_mutex);
-        expected_req = num_req;
-    }
-    {
-        std::unique_lock<std::mutex> guard(res_mutex);
-        res_CV.wait(guard, [&] { return exe_req == expected_req; });
-    }
+    group.wait();
     for (auto &res : work_result) {
         for (auto &pl : res.second.first) {
             if (trial_tables[self.self.uid(pl->table)]) continue;
@@ -3990,30 +3889,11 @@ bool DecidePlacement::TryPlacedPool::fillTrial(safe_vector<const Placed *> &tria
     return true;
 }
 
-// Reset the executed count to zero for the next round of evaluation
+// Reset the request count to zero for the next round of evaluation
 void DecidePlacement::TryPlacedPool::cleanup() {
-    {
-        std::lock_guard<std::mutex> guard(queue_mutex);
-        BUG_CHECK(work_queue.empty(), "Multi-Threaded Work Queue not entirely processed");
-        num_req = 0;
-    }
-    {
-        std::lock_guard<std::mutex> guard(res_mutex);
-        work_result.clear();
-        exe_req = 0;
-    }
-}
-
-// Shutdown all the worker threads
-void DecidePlacement::TryPlacedPool::shutdown() {
-    void *status;
-    terminated = true;
-    // Wake up the waiting threads
-    queue_CV.notify_all();
-    for (pthread_t &tid : workers) {
-        int err = pthread_join(tid, &status);
-        BUG_CHECK(!err, "Pthread Join fail with error: %d", err);
-    }
+    group.wait();
+    work_result.clear();
+    num_req = 0;
 }
 #endif
 
@@ -78,16 +78,29 @@
  */
 
 //  All C includes should come before the first C++ include, according to one of our Git hooks.
+#include <fcntl.h>
 #include <libgen.h>
 #include <unistd.h>
 
 #include <sys/stat.h>
+#include <sys/wait.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <climits>
 #include <csignal>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "backends/graphs/controls.h"
 #include "backends/graphs/graph_visitor.h"
@@ -414,6 +427,255 @@ int handle_return(const int error_code, [[maybe_unused]] const BFN_Options &opti
     return error_code;
 }
 
+namespace {
+
+/// An exception that escaped the compilation of a pipe, in a form that a backend worker
+/// process can hand back to the main process (see --jobs).
+struct FailureReport {
+    enum Kind { NONE, COMPILER_BUG, UNIMPLEMENTED, COMPILATION_ERROR, STD_EXCEPTION, UNKNOWN };
+    Kind kind = NONE;
+    std::string message;
+};
+
+/// Thrown by compile_pipes() when a worker reported an exception. It is handled by main like
+/// the exception that the worker caught.
+struct PipeJobFailure : std::runtime_error {
+    FailureReport report;
+    explicit PipeJobFailure(FailureReport report)
+        : std::runtime_error(report.message), report(std::move(report)) {}
+};
+
+/// Must be called from a catch block. @returns the report of the exception being handled.
+FailureReport describe_current_exception() {
+    try {
+        throw;
+    } catch (const Util::CompilerBug &e) {
+        return {FailureReport::COMPILER_BUG, e.what()};
+    } catch (const Util::CompilerUnimplemented &e) {
+        return {FailureReport::UNIMPLEMENTED, e.what()};
+    } catch (const Util::CompilationError &e) {
+        return {FailureReport::COMPILATION_ERROR, e.what()};
+    } catch (const std::exception &e) {
+        return {FailureReport::STD_EXCEPTION, e.what()};
+    } catch (...) {
+        return {FailureReport::UNKNOWN, ""};
+    }
+}
+
+#if BFP4C_CATCH_EXCEPTIONS
+/// Reports an exception that escaped the compilation and @returns the exit code of bf-p4c.
+int report_failure(const FailureReport &failure, const BFN_Options &options) {
+    switch (failure.kind) {
+        case FailureReport::COMPILER_BUG: {
+            BFNContext::get().errorReporter().increment_the_error_count();
+            report_stats();
+
+#ifdef BAREFOOT_INTERNAL
+            bool barefootInternal = true;
+#else
+            bool barefootInternal = false;
+#endif
+
+            if (failure.message.find(".p4(") != std::string::npos || barefootInternal)
+                std::cerr << failure.message << std::endl;
+            std::cerr << "Internal compiler error. Please submit a bug report with your code."
+                      << std::endl;
+            return INTERNAL_COMPILER_ERROR;
+        }
+        case FailureReport::UNIMPLEMENTED:
+            BFNContext::get().errorReporter().increment_the_error_count();
+            report_stats();
+
+            std::cerr << failure.message << std::endl;
+            return COMPILER_ERROR;
+        case FailureReport::COMPILATION_ERROR:
+            std::cerr << failure.message << std::endl;
+            return handle_return(PROGRAM_ERROR, options);
+#if BAREFOOT_INTERNAL
+        case FailureReport::STD_EXCEPTION:
+            BFNContext::get().errorReporter().increment_the_error_count();
+            report_stats();
+
+            std::cerr << "Internal compiler error: " << failure.message << std::endl;
+            return INTERNAL_COMPILER_ERROR;
+#endif
+        default:
+            BFNContext::get().errorReporter().increment_the_error_count();
+            report_stats();
+
+            std::cerr << "Internal compiler error. Please submit a bug report with your code."
+                      << std::endl;
+            return INTERNAL_COMPILER_ERROR;
+    }
+}
+#endif  // BFP4C_CATCH_EXCEPTIONS
+
+/// The files through which a backend worker hands its results back to the main process.
+struct PipeJobFiles {
+    std::filesystem::path out, err, status, manifest;
+
+    PipeJobFiles(const std::filesystem::path &dir, size_t index)
+        : out(dir / (std::to_string(index) + ".out")),
+          err(dir / (std::to_string(index) + ".err")),
+          status(dir / (std::to_string(index) + ".status")),
+          manifest(dir / (std::to_string(index) + ".manifest")) {}
+};
+
+/// Compiles one pipe in a freshly forked worker process and never returns.
+[[noreturn]] void run_pipe_job(const PipeJobFiles &files, unsigned errors, unsigned warnings,
+                               const std::function<void()> &compile) {
+    int out = open(files.out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int err = open(files.err.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0 || err < 0 || dup2(out, STDOUT_FILENO) < 0 || dup2(err, STDERR_FILENO) < 0)
+        _exit(INVOCATION_ERROR);
+    close(out);
+    close(err);
+
+    FailureReport failure;
+    try {
+        compile();
+    } catch (...) {
+        failure = describe_current_exception();
+    }
+
+    // The counts exclude the diagnostics that were reported before the fork, which the main
+    // process has counted already.
+    auto &reporter = BFNContext::get().errorReporter();
+    {
+        std::ofstream status(files.status);
+        status << failure.kind << " " << reporter.getErrorCount() - errors << " "
+               << reporter.getWarningCount() - warnings << "\n"
+               << failure.message;
+    }
+    {
+        std::ofstream manifest(files.manifest);
+        Logging::Manifest::getManifest().exportPipeOutputs(manifest);
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+    // Skip the destructors and exit handlers: they belong to the main process, which for
+    // instance serializes the manifest on the way out.
+    _exit(SUCCESS);
+}
+
+/// Replays the results of the worker that compiled a pipe into the main process.
+/// @returns false if the pipe had errors, in which case the later pipes are not merged.
+bool merge_pipe_job(const PipeJobFiles &files, int wait_status) {
+    auto replay = [](const std::filesystem::path &path, std::ostream &stream) {
+        std::ifstream in(path, std::ios::binary);
+        if (in && in.peek() != std::ifstream::traits_type::eof()) stream << in.rdbuf();
+        stream.flush();
+    };
+    replay(files.out, std::cout);
+    replay(files.err, std::cerr);
+
+    std::ifstream status(files.status);
+    int kind = FailureReport::UNKNOWN;
+    unsigned errors = 0, warnings = 0;
+    if (!(status >> kind >> errors >> warnings)) {
+        // The worker died before it could write its status, e.g. on a signal.
+        FailureReport failure{FailureReport::UNKNOWN, "backend worker exited with status " +
+                                                          std::to_string(wait_status)};
+        throw PipeJobFailure(std::move(failure));
+    }
+    status.ignore(1);
+    std::string message((std::istreambuf_iterator<char>(status)),
+                        std::istreambuf_iterator<char>());
+
+    BFNContext::get().errorReporter().add_worker_counts(errors, warnings);
+    std::ifstream manifest(files.manifest);
+    Logging::Manifest::getManifest().importPipeOutputs(manifest);
+
+    if (kind != FailureReport::NONE)
+        throw PipeJobFailure({static_cast<FailureReport::Kind>(kind), std::move(message)});
+    return errors == 0;
+}
+
+/// Calls @p compile for each of @p pipes. With --jobs, the pipes are compiled concurrently in
+/// worker processes forked from this one, so that each gets its own copy of the compile
+/// context, the allocation state and the log sinks. Their output, diagnostic counts and
+/// manifest entries are merged in the order of @p pipes, and an exception escaping a worker
+/// is thrown here as a PipeJobFailure, so the result is the same as that of a serial compile.
+///
+/// The pipes are compiled serially if the event logger is enabled, as it writes a single
+/// stream of events, or if the program checks for expected diagnostics, as those are matched
+/// in the process that reports them.
+void compile_pipes(const std::vector<const IR::BFN::Pipe *> &pipes, const BFN_Options &options,
+                   const std::function<void(const IR::BFN::Pipe *)> &compile) {
+    auto &reporter = BFNContext::get().errorReporter();
+    if (options.jobs <= 1 || pipes.size() <= 1 || options.enable_event_logger ||
+        reporter.has_checks()) {
+        for (const auto *pipe : pipes) compile(pipe);
+        return;
+    }
+
+    std::string dirTemplate =
+        (std::filesystem::temp_directory_path() / "bf-p4c-jobs-XXXXXX").string();
+    if (!mkdtemp(dirTemplate.data())) {
+        ::warning("Cannot create a directory for --jobs: %1%, compiling pipes serially",
+                  strerror(errno));
+        for (const auto *pipe : pipes) compile(pipe);
+        return;
+    }
+    const std::filesystem::path dir(dirTemplate);
+    struct cleanup_guard {
+        const std::filesystem::path &dir;
+        ~cleanup_guard() {
+            std::error_code ec;
+            std::filesystem::remove_all(dir, ec);
+        }
+    } cleanup{dir};
+    const unsigned errors = reporter.getErrorCount(), warnings = reporter.getWarningCount();
+
+    // Nothing is buffered twice if the workers start with empty buffers.
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+
+    // The workers of the shared thread pool, if any, are idle at this point, so a worker process
+    // starts with no locks held. Its tasks then run on the thread that waits for them.
+    std::vector<pid_t> pids(pipes.size(), -1);
+    std::vector<int> statuses(pipes.size(), 0);
+    size_t started = 0, running = 0;
+    bool failed = false;
+    while (running > 0 || (!failed && started < pipes.size())) {
+        if (!failed && started < pipes.size() && running < unsigned(options.jobs)) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                run_pipe_job(PipeJobFiles(dir, started), errors, warnings,
+                             [&] { compile(pipes[started]); });
+            }
+            BUG_CHECK(pid > 0, "Cannot fork a backend worker: %1%", strerror(errno));
+            pids[started++] = pid;
+            ++running;
+            continue;
+        }
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            BUG("Cannot wait for the backend workers: %1%", strerror(errno));
+        }
+        auto it = std::find(pids.begin(), pids.end(), pid);
+        if (it == pids.end()) continue;
+        --running;
+        statuses[it - pids.begin()] = status;
+        // The pipes after a pipe with errors are not merged, so they need not be compiled.
+        std::ifstream report(PipeJobFiles(dir, it - pids.begin()).status);
+        int kind = FailureReport::UNKNOWN;
+        unsigned pipeErrors = 0;
+        if (!(report >> kind >> pipeErrors) || kind != FailureReport::NONE || pipeErrors > 0)
+            failed = true;
+    }
+
+    for (size_t i = 0; i < started; ++i) {
+        if (!merge_pipe_job(PipeJobFiles(dir, i), statuses[i])) break;
+    }
+}
+
+}  // namespace
+
 int main(int ac, char **av) {
     setup_gc_logging();
     setup_signals();
@@ -569,6 +831,7 @@ int main(int ac, char **av) {
         };
         manifest_generator_guard emit_manifest(manifest);
 
+        std::vector<const IR::BFN::Pipe *> pipes;
         for (auto &pipe : substitute.pipe) {
 #if BAREFOOT_INTERNAL
             if (std::all_of(pipe->names.begin(), pipe->names.end(),
@@ -576,6 +839,10 @@ int main(int ac, char **av) {
                 continue;
             }
 #endif
+            pipes.push_back(pipe);
+        }
+
+        auto compilePipe = [&](const IR::BFN::Pipe *pipe) {
             if (options.create_graphs) {
                 // generate graphs
                 // In principle this should not fail, so we call it before the backend
@@ -616,7 +883,8 @@ int main(int ac, char **av) {
             LOG3("Executing backend for pipe : " << pipe->canon_name());
             EventLogger::get().pipeChange(pipe->canon_id());
             execute_backend(pipe, options);
-        }
+        };
+        compile_pipes(pipes, options, compilePipe);
 
         report_stats();
 
@@ -634,45 +902,20 @@ int main(int ac, char **av) {
 
 #if BFP4C_CATCH_EXCEPTIONS
         // catch all exceptions here
+    } catch (const PipeJobFailure &failure) {
+        return report_failure(failure.report, options);
     } catch (const Util::CompilerBug &e) {
-        BFNContext::get().errorReporter().increment_the_error_count();
-        report_stats();
-
-#ifdef BAREFOOT_INTERNAL
-        bool barefootInternal = true;
-#else
-        bool barefootInternal = false;
-#endif
-
-        if (std::string(e.what()).find(".p4(") != std::string::npos || barefootInternal)
-            std::cerr << e.what() << std::endl;
-        std::cerr << "Internal compiler error. Please submit a bug report with your code."
-                  << std::endl;
-        return INTERNAL_COMPILER_ERROR;
+        return report_failure({FailureReport::COMPILER_BUG, e.what()}, options);
     } catch (const Util::CompilerUnimplemented &e) {
-        BFNContext::get().errorReporter().increment_the_error_count();
-        report_stats();
-
-        std::cerr << e.what() << std::endl;
-        return COMPILER_ERROR;
+        return report_failure({FailureReport::UNIMPLEMENTED, e.what()}, options);
     } catch (const Util::CompilationError &e) {
-        std::cerr << e.what() << std::endl;
-        return handle_return(PROGRAM_ERROR, options);
+        return report_failure({FailureReport::COMPILATION_ERROR, e.what()}, options);
 #if BAREFOOT_INTERNAL
     } catch (const std::exception &e) {
-        BFNContext::get().errorReporter().increment_the_error_count();
-        report_stats();
-
-        std::cerr << "Internal compiler error: " << e.what() << std::endl;
-        return INTERNAL_COMPILER_ERROR;
+        return report_failure({FailureReport::STD_EXCEPTION, e.what()}, options);
 #endif
     } catch (...) {
-        BFNContext::get().errorReporter().increment_the_error_count();
-        report_stats();
-
-        std::cerr << "Internal compiler error. Please submit a bug report with your code."
-                  << std::endl;
-        return INTERNAL_COMPILER_ERROR;
+        return report_failure({FailureReport::UNKNOWN, ""}, options);
     }
 #endif  // BFP4C_CATCH_EXCEPTIONS
 }
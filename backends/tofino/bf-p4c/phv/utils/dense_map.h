@@ -0,0 +1,179 @@
+/**
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_TOFINO_BF_P4C_PHV_UTILS_DENSE_MAP_H_
+#define BACKENDS_TOFINO_BF_P4C_PHV_UTILS_DENSE_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace PHV {
+
+/// A map whose keys have small, dense ids, e.g. containers or fields. Like ordered_map, the map
+/// iterates in insertion order, and references to values stay valid when keys are added, so it
+/// can replace an ordered_map without changing the order of any allocation decision or log. Keys
+/// cannot be erased, only cleared all at once.
+///
+/// By default, the map indexes its entries with a small hash table of their ids, which costs only
+/// as much as the map holds. This suits the many short-lived transactions of an allocation, which
+/// touch a few containers whose ids may be anywhere in the id range. A map that will hold most
+/// ids, e.g. the status of a complete allocation, should call set_dense(), after which a lookup
+/// indexes a vector by the id of the key. An empty map does not allocate in either case.
+///
+/// @p KeyId maps a key to its id, and must map different keys to different ids.
+template <class Key, class T, class KeyId>
+class DenseOrderedMap {
+ public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using iterator = typename std::list<value_type>::iterator;
+    using const_iterator = typename std::list<value_type>::const_iterator;
+
+    DenseOrderedMap() = default;
+    DenseOrderedMap(DenseOrderedMap &&) = default;
+    DenseOrderedMap &operator=(DenseOrderedMap &&) = default;
+    DenseOrderedMap(const DenseOrderedMap &other) { *this = other; }
+    DenseOrderedMap &operator=(const DenseOrderedMap &other) {
+        if (this == &other) return *this;
+        // The index points into the entries, so it is rebuilt for the copied entries.
+        clear();
+        dense = other.dense;
+        for (const auto &[key, value] : other.entries) entries.emplace_back(key, value);
+        reindex();
+        return *this;
+    }
+
+    /// Switches the index to a vector of slots indexed by id, or back to a hash table of ids.
+    /// The dense index is faster, but it is as large as the largest id in the map.
+    void set_dense(bool value = true) {
+        if (dense == value) return;
+        dense = value;
+        reindex();
+    }
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    void clear() {
+        entries.clear();
+        slots.clear();
+        sparse.clear();
+    }
+
+    iterator find(const Key &key) {
+        const auto *slot = slotOf(key);
+        return slot ? *slot : entries.end();
+    }
+    const_iterator find(const Key &key) const {
+        const auto *slot = slotOf(key);
+        return slot ? const_iterator(*slot) : entries.end();
+    }
+
+    size_t count(const Key &key) const { return slotOf(key) != nullptr; }
+
+    T &at(const Key &key) {
+        const auto *slot = slotOf(key);
+        if (!slot) throw std::out_of_range("DenseOrderedMap::at");
+        return (*slot)->second;
+    }
+    const T &at(const Key &key) const {
+        const auto *slot = slotOf(key);
+        if (!slot) throw std::out_of_range("DenseOrderedMap::at");
+        return (*slot)->second;
+    }
+
+    /// @returns the value of @p key, which is added at the end if it is not in the map yet.
+    T &operator[](const Key &key) {
+        if (const auto *slot = slotOf(key)) return (*slot)->second;
+        auto it = entries.emplace(entries.end(), key, T());
+        insert(KeyId()(key), it);
+        return it->second;
+    }
+
+ private:
+    /// An id and its entry in the sparse index. Unused slots hold noId.
+    using SparseSlot = std::pair<size_t, iterator>;
+    static constexpr size_t noId = SIZE_MAX;
+
+    /// The entries in insertion order.
+    std::list<value_type> entries;
+
+    /// Whether the entries are indexed by @a slots or by @a sparse.
+    bool dense = false;
+
+    /// The dense index: for each id, the entry of its key, if the key is present.
+    std::vector<std::optional<iterator>> slots;
+
+    /// The sparse index: an open-addressing hash table of the ids of the keys in the map. Its
+    /// size is zero or a power of two that is at least twice the number of entries.
+    std::vector<SparseSlot> sparse;
+
+    /// @returns the position of @p id in the sparse index, or of the unused slot where it
+    /// belongs. The index must not be empty.
+    size_t probe(size_t id) const {
+        size_t mask = sparse.size() - 1;
+        // Fibonacci hashing spreads ids that are strided, e.g. by container type.
+        size_t pos = ((uint64_t(id) * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+        while (sparse[pos].first != id && sparse[pos].first != noId) pos = (pos + 1) & mask;
+        return pos;
+    }
+
+    /// Adds the entry @p it of a key with @p id, which is not in the index yet, to the index.
+    void insert(size_t id, iterator it) {
+        if (dense) {
+            if (id >= slots.size()) slots.resize(id + 1);
+            slots[id] = it;
+            return;
+        }
+        if (2 * entries.size() > sparse.size()) {
+            // Rehash the other entries into a table twice as large.
+            std::vector<SparseSlot> previous(std::max<size_t>(8, 2 * sparse.size()),
+                                             SparseSlot(noId, iterator()));
+            previous.swap(sparse);
+            for (const auto &slot : previous) {
+                if (slot.first != noId) sparse[probe(slot.first)] = slot;
+            }
+        }
+        sparse[probe(id)] = SparseSlot(id, it);
+    }
+
+    /// Rebuilds the index of all entries.
+    void reindex() {
+        slots.clear();
+        sparse.clear();
+        if (!dense && !entries.empty()) {
+            size_t capacity = 8;
+            while (capacity < 2 * entries.size()) capacity *= 2;
+            sparse.assign(capacity, SparseSlot(noId, iterator()));
+        }
+        for (auto it = entries.begin(); it != entries.end(); ++it) insert(KeyId()(it->first), it);
+    }
+
+    /// @returns the entry of @p key, or nullptr if it is absent.
+    const iterator *slotOf(const Key &key) const {
+        size_t id = KeyId()(key);
+        if (dense) return id < slots.size() && slots[id] ? &*slots[id] : nullptr;
+        if (sparse.empty()) return nullptr;
+        const auto &slot = sparse[probe(id)];
+        return slot.first == id ? &slot.second : nullptr;
+    }
+};
+
+}  // namespace PHV
+
+#endif /* BACKENDS_TOFINO_BF_P4C_PHV_UTILS_DENSE_MAP_H_ */
@@ -41,6 +41,10 @@ int PHV::ClusterStats::nextId = 0;
 
 PHV::Allocation::ContainerStatus PHV::ConcreteAllocation::emptyContainerStatus;
 
+size_t PHV::Allocation::ContainerId::operator()(const PHV::Container &c) const {
+    return Device::phvSpec().containerToId(c);
+}
+
 PHV::ContainerGroup::ContainerGroup(PHV::Size sz, const std::vector<PHV::Container> containers)
     : size_i(sz), containers_i(containers) {
     // Check that all containers are the right size.
@@ -69,8 +73,9 @@ PHV::ContainerGroup::ContainerGroup(PHV::Size sz, bitvec container_group)
 }
 
 bool PHV::Allocation::addStatus(PHV::Container c, const ContainerStatus &status) {
-    bool new_slice = !(container_status_i.count(c) &&
-                       container_status_i[c].slices.size() == status.slices.size());
+    auto it = container_status_i.find(c);
+    bool new_slice =
+        !(it != container_status_i.end() && it->second.slices.size() == status.slices.size());
 
     // Update container status.
     container_status_i[c] = status;
@@ -79,16 +84,14 @@ bool PHV::Allocation::addStatus(PHV::Container c, const ContainerStatus &status)
     for (auto &slice : status.slices) {
         // If the field status already contains this slice, then update it with the updated slice
         // with the latest live range.
-        if (field_status_i.count(slice.field())) {
-            FieldStatus toBeRemoved;
-            for (auto &existingSlice : field_status_i[slice.field()]) {
-                if (!slice.representsSameFieldSlice(existingSlice)) continue;
-                toBeRemoved.insert(existingSlice);
-            }
-            for (auto &removalCandidate : toBeRemoved)
-                field_status_i[slice.field()].erase(removalCandidate);
+        auto &field_status = field_status_i[slice.field()];
+        FieldStatus toBeRemoved;
+        for (auto &existingSlice : field_status) {
+            if (!slice.representsSameFieldSlice(existingSlice)) continue;
+            toBeRemoved.insert(existingSlice);
         }
-        field_status_i[slice.field()].insert(slice);
+        for (auto &removalCandidate : toBeRemoved) field_status.erase(removalCandidate);
+        field_status.insert(slice);
     }
     return new_slice;
 }
@@ -154,34 +157,33 @@ void PHV::Allocation::addSlice(PHV::Container c, PHV::AllocSlice slice) {
     const auto *container_status = this->getStatus(c);
     ContainerStatus status = container_status ? *container_status : ContainerStatus();
     status.slices.insert(slice);
-    container_status_i[c] = status;
+    auto &new_status = container_status_i[c];
+    new_status = status;
 
     // Update field status.
     field_status_i[slice.field()].insert(slice);
 
     // Update the allocation status of the container.
-    if (container_status_i[c].alloc_status != PHV::Allocation::ContainerAllocStatus::FULL) {
-        PHV::Allocation::ContainerAllocStatus old_status = container_status_i[c].alloc_status;
+    if (new_status.alloc_status != PHV::Allocation::ContainerAllocStatus::FULL) {
+        PHV::Allocation::ContainerAllocStatus old_status = new_status.alloc_status;
         bitvec allocated_bits;
-        for (const auto &slice : container_status_i[c].slices)
+        for (const auto &slice : new_status.slices)
             allocated_bits |= bitvec(slice.container_slice().lo, slice.width());
         if (allocated_bits == bitvec())
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::EMPTY;
+            new_status.alloc_status = PHV::Allocation::ContainerAllocStatus::EMPTY;
         else if (allocated_bits == bitvec(0, c.size()))
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::FULL;
+            new_status.alloc_status = PHV::Allocation::ContainerAllocStatus::FULL;
         else
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::PARTIAL;
+            new_status.alloc_status = PHV::Allocation::ContainerAllocStatus::PARTIAL;
 
-        BUG_CHECK(
-            container_status_i[c].alloc_status != PHV::Allocation::ContainerAllocStatus::EMPTY ||
-                (container_status_i[c].alloc_status ==
-                     PHV::Allocation::ContainerAllocStatus::EMPTY &&
-                 container_status_i[c].alloc_status == old_status),
-            "Changing allocation status from FULL or PARTIAL to EMPTY");
+        BUG_CHECK(new_status.alloc_status != PHV::Allocation::ContainerAllocStatus::EMPTY ||
+                      (new_status.alloc_status == PHV::Allocation::ContainerAllocStatus::EMPTY &&
+                       new_status.alloc_status == old_status),
+                  "Changing allocation status from FULL or PARTIAL to EMPTY");
 
-        if (old_status != container_status_i[c].alloc_status) {
+        if (old_status != new_status.alloc_status) {
             --count_by_status_i[c.type().size()][old_status];
-            ++count_by_status_i[c.type().size()][container_status_i[c].alloc_status];
+            ++count_by_status_i[c.type().size()][new_status.alloc_status];
         }
     }
 }
@@ -764,6 +766,12 @@ std::set<PHV::Allocation::AvailableSpot> PHV::Allocation::available_spots() cons
 PHV::ConcreteAllocation::ConcreteAllocation(const PhvInfo &phv, const PhvUse &uses,
                                             bitvec containers, bool isTrivial)
     : PHV::Allocation(phv, uses, isTrivial) {
+    // A complete allocation holds the status of most containers and fields, so its maps are
+    // indexed by id. Transactions keep the default sparse index.
+    container_status_i.set_dense();
+    field_status_i.set_dense();
+    dark_containers_write_allocated_i.set_dense();
+    dark_containers_read_allocated_i.set_dense();
     auto &phvSpec = Device::phvSpec();
     for (auto cid : containers) {
         PHV::Container c = phvSpec.idToContainer(cid);
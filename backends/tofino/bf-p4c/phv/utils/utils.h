@@ -25,6 +25,7 @@
 #include "backends/tofino/bf-p4c/phv/error.h"
 #include "backends/tofino/bf-p4c/phv/phv_fields.h"
 #include "backends/tofino/bf-p4c/phv/pragma/pa_no_init.h"
+#include "backends/tofino/bf-p4c/phv/utils/dense_map.h"
 #include "backends/tofino/bf-p4c/phv/utils/slice_alloc.h"
 #include "backends/tofino/bf-p4c/specs/gress.h"
 #include "backends/tofino/bf-p4c/specs/phv.h"
@@ -139,8 +140,6 @@ class Allocation {
         ExtractSource parserExtractGroupSource;
     };
 
-    using const_iterator = ordered_map<PHV::Container, ContainerStatus>::const_iterator;
-
     /// This struct represents the conditional constraint information generated by
     /// ActionPhvConstraints for a single unallocated PHV::FieldSlice.
     struct ConditionalConstraintData {
@@ -171,6 +170,20 @@ class Allocation {
 
     using FieldStatus = ordered_set<AllocSlice>;
 
+    /// Maps a container to its id in Device::phvSpec().
+    struct ContainerId {
+        size_t operator()(const PHV::Container &c) const;
+    };
+
+    /// Maps a field to its id in PhvInfo.
+    struct FieldId {
+        size_t operator()(const PHV::Field *f) const { return f->id; }
+    };
+
+    using ContainerStatusMap = DenseOrderedMap<PHV::Container, ContainerStatus, ContainerId>;
+    using FieldStatusMap = DenseOrderedMap<const PHV::Field *, FieldStatus, FieldId>;
+    using const_iterator = ContainerStatusMap::const_iterator;
+
  protected:
     // These are copied from parent to child on creating a transaction, and
     // from child to parent on committing.
@@ -181,8 +194,11 @@ class Allocation {
     // For efficiency, these are NOT copied from parent to child.  Changes in
     // the child are copied back to the parent on commit.  However, parent info
     // is copied to the child when queried, as a caching optimization.
-    mutable ordered_map<PHV::Container, ContainerStatus> container_status_i;
-    mutable ordered_map<const PHV::Field *, FieldStatus> field_status_i;
+    // Both are indexed by container and field ids, so that lookups, which are the bulk of the
+    // work of speculative allocation, do not search a tree. ConcreteAllocation indexes them
+    // densely; a transaction only indexes the ids that it holds.
+    mutable ContainerStatusMap container_status_i;
+    mutable FieldStatusMap field_status_i;
     /// Structure that remembers the actions at which metadata fields need to be initialized for a
     /// particular allocation object.
     mutable ordered_map<AllocSlice, ActionSet> meta_init_points_i;
@@ -197,8 +213,8 @@ class Allocation {
      *  while the write map captures the allocation from the perspective of a write to that
      *  container.
      */
-    mutable ordered_map<PHV::Container, bitvec> dark_containers_write_allocated_i;
-    mutable ordered_map<PHV::Container, bitvec> dark_containers_read_allocated_i;
+    mutable DenseOrderedMap<PHV::Container, bitvec, ContainerId> dark_containers_write_allocated_i;
+    mutable DenseOrderedMap<PHV::Container, bitvec, ContainerId> dark_containers_read_allocated_i;
     /// Initialization information about allocating to dark containers during certain stages.
     mutable DarkInitMap init_map_i;
 
@@ -625,14 +641,14 @@ class Transaction : public Allocation {
     std::optional<ActionSet> getInitPoints(const AllocSlice &slice) const override;
 
     /// Returns the outstanding writes in this view.
-    const ordered_map<PHV::Container, ContainerStatus> &getTransactionStatus() const {
+    const ContainerStatusMap &getTransactionStatus() const {
         return container_status_i;
     }
 
     /// Returns the actual diff of outstanding writes in this view.
     ordered_map<PHV::Container, ContainerStatus> get_actual_diff() const;
 
-    const ordered_map<const PHV::Field *, FieldStatus> &getFieldStatus() const {
+    const FieldStatusMap &getFieldStatus() const {
         return field_status_i;
     }
 
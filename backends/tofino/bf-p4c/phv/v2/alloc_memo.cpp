@@ -0,0 +1,196 @@
+/**
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "backends/tofino/bf-p4c/phv/v2/alloc_memo.h"
+
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "lib/bitvec.h"
+#include "lib/ordered_set.h"
+
+namespace PHV {
+namespace v2 {
+
+namespace {
+
+/// Prints the slices of @p sc. Unlike operator<<, it leaves out the uid, which differs
+/// between rounds.
+void print_slices(std::ostream &out, const SuperCluster *sc) {
+    for (const auto *sl : sc->slice_lists()) out << *sl << "\n";
+    for (const auto *cluster : sc->clusters()) out << *cluster << "\n";
+}
+
+unsigned bits_of(const PHV::FieldUse &use) {
+    return unsigned(use.isRead()) | unsigned(use.isWrite()) << 1 | unsigned(use.isLive()) << 2;
+}
+
+int gress_of(const Allocation::GressAssignment &gress) {
+    return gress ? static_cast<int>(*gress) : -1;
+}
+
+/// Adds the tables that match on any bit of @p f to @p tables. Bits are looked up one by one,
+/// because PhvUse::ixbar_read only takes ranges that are not split by a match key.
+void add_ixbar_tables(const PhvKit &kit, const PHV::Field *f,
+                      ordered_set<const IR::MAU::Table *> &tables) {
+    for (int bit = 0; bit < f->size; bit++) {
+        for (const auto &tb_key : kit.uses.ixbar_read(f, le_bitrange(bit, bit))) {
+            tables.insert(tb_key.first);
+        }
+    }
+}
+
+/// Prints the stages that the last table placement gave to @p tables, as the score sees them.
+void print_stages(std::ostream &out, const PhvKit &kit,
+                  const ordered_set<const IR::MAU::Table *> &tables) {
+    for (const auto *tb : tables) {
+        out << tb->name << " stages";
+        for (const int stage : kit.mau.stage(tb, true)) out << " " << stage;
+        out << "\n";
+    }
+}
+
+}  // namespace
+
+std::string AllocMemo::fingerprint(const PhvKit &kit, const SuperCluster *sc) {
+    std::stringstream ss;
+    print_slices(ss, sc);
+
+    ordered_set<const PHV::Field *> fields;
+    sc->forall_fieldslices([&](const PHV::FieldSlice &fs) {
+        fields.insert(fs.field());
+        // physical live ranges reflect the table placement of the last round.
+        if (const auto *lr = kit.physical_liverange_db.get_liverange(fs)) {
+            ss << fs << " live " << *lr << "\n";
+        }
+    });
+
+    // properties of fields include most of the pragmas, e.g., pa_solitary and pa_atomic.
+    const auto &pragmas = kit.pragmas;
+    const auto &sizes = pragmas.pa_container_sizes().field_to_layout();
+    const auto &kinds = pragmas.pa_container_type().getFields();
+    ordered_set<const IR::MAU::Table *> tables;
+    for (const auto *f : fields) {
+        ss << *f;
+        if (sizes.count(f)) {
+            for (const int size : sizes.at(f)) ss << " pa_container_size " << size;
+        }
+        if (kinds.count(f)) ss << " pa_container_type " << kinds.at(f);
+        if (pragmas.pa_no_overlay().get_no_overlay_fields().count(f)) ss << " pa_no_overlay";
+        if (pragmas.pa_no_init().getFields().count(f)) ss << " pa_no_init";
+        ss << " mutex " << bitvec(kit.mutex()[f->id]) << "\n";
+        add_ixbar_tables(kit, f, tables);
+    }
+    // the score counts the match key bytes of each stage.
+    print_stages(ss, kit, tables);
+
+    const auto &settings = kit.settings;
+    ss << settings.no_code_change << settings.physical_liverange_overlay
+       << settings.limit_tmp_creation << settings.single_gress_parser_group
+       << settings.prioritize_ara_inits << kit.mau.hasTablePlacement()
+       << kit.mau.disableMetadataInitialization();
+    return ss.str();
+}
+
+std::string AllocMemo::fingerprint(const std::list<SuperCluster *> &sliced) {
+    std::stringstream ss;
+    for (const auto *sc : sliced) {
+        print_slices(ss, sc);
+        ss << "--\n";
+    }
+    return ss.str();
+}
+
+AllocMemo::Candidates AllocMemo::candidates(const Allocation &alloc,
+                                            const ContainerGroupsBySize &groups,
+                                            std::string context) {
+    // It records the slices directly instead of printing them, because it runs on every
+    // container of the device for each super cluster.
+    Candidates rv;
+    for (const auto &[size, groups_of_size] : groups) {
+        for (const auto &group : groups_of_size) {
+            for (const auto &c : group) {
+                const auto slices = alloc.slices(c);
+                auto &status = rv.status;
+                status.push_back(static_cast<int>(Allocation::ContainerId()(c)));
+                status.push_back(gress_of(alloc.gress(c)));
+                status.push_back(gress_of(alloc.parserGroupGress(c)));
+                status.push_back(gress_of(alloc.deparserGroupGress(c)));
+                status.push_back(static_cast<int>(slices.size()));
+                for (const auto &slice : slices) {
+                    const auto &earliest = slice.getEarliestLiveness();
+                    const auto &latest = slice.getLatestLiveness();
+                    status.insert(status.end(), {slice.field_slice().lo, slice.field_slice().hi,
+                                                 slice.container_slice().lo,
+                                                 slice.container_slice().hi, earliest.first,
+                                                 static_cast<int>(bits_of(earliest.second)),
+                                                 latest.first,
+                                                 static_cast<int>(bits_of(latest.second))});
+                    rv.fields.push_back(slice.field()->name);
+                }
+            }
+        }
+    }
+    rv.context = std::move(context);
+    return rv;
+}
+
+std::string AllocMemo::context(const PhvKit &kit, const Allocation &alloc,
+                               const ContainerGroupsBySize &groups, cstring vision) {
+    ordered_set<const PHV::Field *> fields;
+    for (const auto &[size, groups_of_size] : groups) {
+        for (const auto &group : groups_of_size) {
+            for (const auto &c : group) {
+                for (const auto &slice : alloc.slices(c)) fields.insert(slice.field());
+            }
+        }
+    }
+    ordered_set<const IR::MAU::Table *> tables;
+    for (const auto *f : fields) add_ixbar_tables(kit, f, tables);
+    std::stringstream ss;
+    print_stages(ss, kit, tables);
+    ss << vision;
+    return ss.str();
+}
+
+const AllocMemo::Entry *AllocMemo::lookup(const std::string &fingerprint,
+                                          const Candidates &candidates) {
+    auto it = entries.find(fingerprint);
+    if (it != entries.end() && it->second.candidates == candidates) return &it->second;
+    stats.misses++;
+    return nullptr;
+}
+
+void AllocMemo::reused(const std::string &fingerprint, bool succeeded) {
+    if (succeeded) {
+        stats.hits++;
+    } else {
+        stats.stale++;
+        entries.erase(fingerprint);
+    }
+}
+
+void AllocMemo::record(const std::string &fingerprint, const Candidates &candidates,
+                       const std::list<SuperCluster *> &sliced, int slicing_idx) {
+    Entry entry;
+    entry.slicing = AllocMemo::fingerprint(sliced);
+    entry.slicing_idx = slicing_idx;
+    entry.candidates = candidates;
+    entries[fingerprint] = std::move(entry);
+}
+
+std::ostream &operator<<(std::ostream &out, const AllocMemo &memo) {
+    const auto &stats = memo.get_stats();
+    const int total = stats.hits + stats.misses + stats.stale;
+    out << "Allocation memo: reused " << stats.hits << " of " << total << " super clusters";
+    if (total > 0) out << " (" << (100 * stats.hits / total) << "%)";
+    out << ", " << stats.stale << " stale, " << memo.size() << " recorded" << std::endl;
+    return out;
+}
+
+}  // namespace v2
+}  // namespace PHV
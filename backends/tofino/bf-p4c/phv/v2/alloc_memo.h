@@ -0,0 +1,119 @@
+/**
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BACKENDS_TOFINO_BF_P4C_PHV_V2_ALLOC_MEMO_H_
+#define BACKENDS_TOFINO_BF_P4C_PHV_V2_ALLOC_MEMO_H_
+
+#include <iosfwd>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "backends/tofino/bf-p4c/phv/utils/utils.h"
+#include "backends/tofino/bf-p4c/phv/v2/phv_kit.h"
+#include "backends/tofino/bf-p4c/phv/v2/types.h"
+
+namespace PHV {
+namespace v2 {
+
+/// AllocMemo remembers how super clusters were allocated in earlier rounds of PHV allocation,
+/// i.e., before table placement backtracked, so that a later round can reuse the slicing that
+/// won the search for a super cluster instead of trying all slicings again.
+///
+/// A super cluster is identified by a fingerprint of its slices and of the constraints that
+/// affect its allocation: field properties, pragmas, mutexes, the allocation settings, and what
+/// the last table placement decided for it, i.e., the physical live ranges of its fields and the
+/// stages of the tables that match on them. Fields are identified by name, because PhvInfo
+/// recreates them in every round. An entry is only reused if the search would start from the
+/// same state: no container of the container groups that the search could have allocated the
+/// super cluster to has changed, and neither have the stages of the tables that match on the
+/// slices in them nor the demand and supply of containers that the score weighs.
+///
+/// Keys are kept in full and compared on lookup, so that a hash collision cannot reuse the
+/// slicing of another super cluster. A reused slicing is allocated as usual, so a stale entry
+/// can cost a search, but it can never produce an invalid allocation.
+class AllocMemo {
+ public:
+    /// The state of the candidate containers of a super cluster, see candidates().
+    struct Candidates {
+        /// for each container, its id, its gress assignments and the number of its slices,
+        /// followed by the ranges and liveness of each slice.
+        std::vector<int> status;
+        /// the fields of the slices, in the same order.
+        std::vector<cstring> fields;
+        /// the other inputs of the search that depend on table placement, see context().
+        std::string context;
+
+        bool operator==(const Candidates &) const = default;
+    };
+
+    struct Entry {
+        /// fingerprint of the slicing that won the search, see fingerprint(sliced).
+        std::string slicing;
+        /// the index of that slicing when it was found, which bounds the scan for it.
+        int slicing_idx = 0;
+        /// the candidate containers before the allocation.
+        Candidates candidates;
+    };
+
+    /// Counters of the current round.
+    struct Stats {
+        /// super clusters allocated with a recorded slicing.
+        int hits = 0;
+        /// super clusters without a reusable entry.
+        int misses = 0;
+        /// super clusters whose recorded slicing could not be allocated again.
+        int stale = 0;
+    };
+
+ private:
+    std::map<std::string, Entry> entries;
+    Stats stats;
+
+ public:
+    /// @returns the fingerprint of @p sc and of the constraints that affect its allocation.
+    static std::string fingerprint(const PhvKit &kit, const SuperCluster *sc);
+
+    /// @returns the fingerprint of the slices of the slicing @p sliced.
+    static std::string fingerprint(const std::list<SuperCluster *> &sliced);
+
+    /// @returns the slices and gress of all containers of @p groups in @p alloc, together with
+    /// @p context.
+    static Candidates candidates(const Allocation &alloc, const ContainerGroupsBySize &groups,
+                                 std::string context = "");
+
+    /// @returns the inputs of the search that depend on table placement and are not part of
+    /// the containers themselves: the stages of the tables that match on the slices in the
+    /// containers of @p groups in @p alloc, and @p vision, the status of the score maker.
+    static std::string context(const PhvKit &kit, const Allocation &alloc,
+                               const ContainerGroupsBySize &groups, cstring vision);
+
+    /// Resets the counters, called at the start of a round.
+    void start_round() { stats = Stats(); }
+
+    /// @returns the entry of the super cluster with @p fingerprint, if it was recorded with
+    /// the same @p candidates, or nullptr otherwise.
+    const Entry *lookup(const std::string &fingerprint, const Candidates &candidates);
+
+    /// Counts the reuse of the entry of @p fingerprint, which is dropped if it failed.
+    void reused(const std::string &fingerprint, bool succeeded);
+
+    /// Records that slicing @p sliced was chosen for the super cluster with @p fingerprint,
+    /// when its candidate containers were @p candidates.
+    void record(const std::string &fingerprint, const Candidates &candidates,
+                const std::list<SuperCluster *> &sliced, int slicing_idx);
+
+    const Stats &get_stats() const { return stats; }
+    size_t size() const { return entries.size(); }
+};
+
+std::ostream &operator<<(std::ostream &out, const AllocMemo &memo);
+
+}  // namespace v2
+}  // namespace PHV
+
+#endif /* BACKENDS_TOFINO_BF_P4C_PHV_V2_ALLOC_MEMO_H_ */
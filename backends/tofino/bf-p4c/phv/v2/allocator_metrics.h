@@ -60,6 +60,18 @@ class AllocatorMetrics {
         if (succ) ++alloc_containers[c.type()].second;
     }
 
+    /// Adds the container counts of @p other, e.g. of an allocation that ran on another thread.
+    void merge(const AllocatorMetrics &other) {
+        for (const auto &[type, counts] : other.alloc_containers) {
+            alloc_containers[type].first += counts.first;
+            alloc_containers[type].second += counts.second;
+        }
+        for (const auto &[type, counts] : other.equiv_containers) {
+            equiv_containers[type].first += counts.first;
+            equiv_containers[type].second += counts.second;
+        }
+    }
+
     unsigned long get_containers(const ctype ct = ALLOC, const PHV::Kind *kind = nullptr,
                                  const PHV::Size *size = nullptr, bool succ = false) const {
         unsigned long containers = 0;
@@ -18,6 +18,15 @@
 
 #include "backends/tofino/bf-p4c/phv/v2/greedy_allocator.h"
 
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef MULTITHREAD
+#include <mutex>
+#endif
+
 #include "backends/tofino/bf-p4c/parde/clot/clot.h"
 #include "backends/tofino/bf-p4c/phv/utils/utils.h"
 #include "backends/tofino/bf-p4c/phv/v2/allocator_base.h"
@@ -28,6 +37,8 @@
 #include "backends/tofino/bf-p4c/phv/v2/trivial_allocator.h"
 #include "backends/tofino/bf-p4c/phv/v2/utils_v2.h"
 #include "backends/tofino/bf-p4c/specs/device.h"
+#include "lib/log.h"
+#include "lib/thread_pool.h"
 
 namespace PHV {
 namespace v2 {
@@ -401,14 +412,70 @@ void GreedyAllocator::sort_normal_clusters(std::list<PHV::SuperCluster *> &clust
     });
 }
 
+namespace {
+
+/// @returns a slicing iterator of @p sc in max packing and strict mode.
+Slicing::IteratorInterface *make_max_packing_slicing_ctx(const PhvKit &kit,
+                                                         const PHV::SuperCluster *sc) {
+    auto slicing_ctx = kit.make_slicing_ctx(sc);
+    slicing_ctx->set_config(
+        Slicing::IteratorConfig{false, false, true, true, false, (1 << 25), (1 << 16)});
+    return slicing_ctx;
+}
+
+}  // namespace
+
+GreedyAllocator::SlicingAttempt GreedyAllocator::try_slicing(
+    const ScoreContext &ctx, const Allocation &alloc, const std::list<PHV::SuperCluster *> &sliced,
+    const ContainerGroupsBySize &container_groups, int n_tried) const {
+    SlicingAttempt attempt(alloc.makeTransaction());
+    auto &this_slicing_tx = attempt.tx;
+    attempt.sliced_tx = new ordered_map<const PHV::SuperCluster *, TxContStatus>();
+    for (const auto *sc : sliced) {
+        if (kit_i.is_clot_allocated(kit_i.clot, *sc)) {
+            LOG3("skip clot allocated cluster: " << sc->uid);
+            continue;
+        }
+        if (sc->is_deparser_zero_candidate()) {
+            LOG3("Found another deparser-zero cluster: " << sc);
+#ifdef MULTITHREAD
+            // zero containers are recorded in phv_i, which is shared by all attempts.
+            static std::mutex lock;
+            std::lock_guard<std::mutex> acquire(lock);
+#endif
+            auto tx = alloc_deparser_zero_cluster(ctx, this_slicing_tx, sc, phv_i);
+            this_slicing_tx.commit(tx);
+            continue;
+        }
+        auto rst =
+            try_sliced_super_cluster(ctx, this_slicing_tx, sc, container_groups, attempt.metrics);
+        if (rst.ok()) {
+            attempt.sliced_tx->emplace(sc, rst.tx->get_actual_diff());  // copy before commit.
+            this_slicing_tx.commit(*rst.tx);
+        } else {
+            attempt.err = new AllocError(rst.err->code);
+            LOG3("Slicing-attempt-" << n_tried << ": failed, while allocating: " << sc);
+            *attempt.err << ". Failed when allocating this sliced " << sc;
+            // found a slice list that cannot be allocated because packing issue.
+            if (rst.err->code == ErrorCode::ACTION_CANNOT_BE_SYNTHESIZED &&
+                rst.err->reslice_required) {
+                attempt.reslice_required = rst.err->reslice_required;
+            } else {
+                *attempt.err << rst.err_str();
+            }
+            return attempt;
+        }
+    }
+    LOG3("Slicing-attempt-" << n_tried << ": succeeded.");
+    attempt.score = ctx.score()->make(this_slicing_tx);
+    LOG3("Slicing-attempt-" << n_tried << " score: " << attempt.score->str());
+    return attempt;
+}
+
 GreedyAllocator::AllocResultWithSlicingDetails GreedyAllocator::slice_and_allocate_sc(
     const ScoreContext &ctx, const Allocation &alloc, const PHV::SuperCluster *sc,
     const ContainerGroupsBySize &container_groups, AllocatorMetrics &alloc_metrics,
     const int max_slicings) const {
-    auto slicing_ctx = kit_i.make_slicing_ctx(sc);
-    // max packing and strict mode.
-    slicing_ctx->set_config(
-        Slicing::IteratorConfig{false, false, true, true, false, (1 << 25), (1 << 16)});
     int n_tried = 0;
     std::optional<Transaction> best_tx;
     std::optional<TxScore *> best_score;
@@ -417,67 +484,110 @@ GreedyAllocator::AllocResultWithSlicingDetails GreedyAllocator::slice_and_alloca
     int best_slicing_idx = 0;
     AllocError *last_err = new AllocError(ErrorCode::NO_SLICING_FOUND);
     *last_err << "found unsatisfiable constraints.";
-    slicing_ctx->iterate([&](std::list<PHV::SuperCluster *> sliced) {
-        n_tried++;
-        if (LOGGING(3)) {
-            LOG3("Slicing-attempt-" << n_tried << ":");
-            for (auto *sc : sliced) LOG3(sc);
-        }
-        auto sliced_tx = new ordered_map<const PHV::SuperCluster *, TxContStatus>();
-        auto this_slicing_tx = alloc.makeTransaction();
-        for (const auto *sc : sliced) {
-            if (kit_i.is_clot_allocated(kit_i.clot, *sc)) {
-                LOG3("skip clot allocated cluster: " << sc->uid);
-                continue;
-            }
-            if (sc->is_deparser_zero_candidate()) {
-                LOG3("Found another deparser-zero cluster: " << sc);
-                auto tx = alloc_deparser_zero_cluster(ctx, this_slicing_tx, sc, phv_i);
-                this_slicing_tx.commit(tx);
-                continue;
+
+    // Slicings are allocated in batches of up to n_jobs_i, on the shared thread pool, and their
+    // results are taken in slicing order, so that ties of scores go to the earlier slicing as
+    // in a serial run. A failed attempt can ask the iterator to invalidate slice lists, which
+    // changes the slicings it produces next, so the later slicings of its batch are not the ones
+    // that a serial run would have tried. They are dropped and the iterator is rewound: a fresh
+    // one replays the slicings tried so far, with the same invalidations after the same
+    // slicings, which brings it to the state of the serial run. The logs of the attempts are
+    // buffered and written out in slicing order as well, and those of the dropped slicings are
+    // discarded, so the log reads like that of the serial run.
+#ifdef MULTITHREAD
+    const size_t batch_size = std::max(n_jobs_i, 1);
+#else
+    const size_t batch_size = 1;
+#endif
+    Slicing::IteratorInterface *slicing_ctx = nullptr;
+    // the invalidations requested by the n-th tried slicing, if any, at index n - 1.
+    std::vector<const ordered_set<const SuperCluster::SliceList *> *> feedback;
+    bool rewind = false;
+    std::vector<std::list<PHV::SuperCluster *>> batch;
+    auto allocate_batch = [&]() {
+        const int first = n_tried - static_cast<int>(batch.size()) + 1;
+        std::vector<std::optional<SlicingAttempt>> attempts(batch.size());
+        // the logs of each attempt, written out below in slicing order.
+        std::vector<Log::OutputBuffer> logs(batch.size());
+        auto try_one = [&](size_t i) {
+            Log::OutputBuffer::Capture capture(logs[i]);
+            const int idx = first + static_cast<int>(i);
+            if (LOGGING(3)) {
+                LOG3("Slicing-attempt-" << idx << ":");
+                for (auto *sc : batch[i]) LOG3(sc);
             }
-            auto rst =
-                try_sliced_super_cluster(ctx, this_slicing_tx, sc, container_groups, alloc_metrics);
-            if (rst.ok()) {
-                sliced_tx->emplace(sc, rst.tx->get_actual_diff());  // copy before commit.
-                this_slicing_tx.commit(*rst.tx);
-            } else {
-                last_err = new AllocError(rst.err->code);
-                LOG3("Slicing-attempt-" << n_tried << ": failed, while allocating: " << sc);
-                *last_err << ". Failed when allocating this sliced " << sc;
-                // found a slice list that cannot be allocated because packing issue.
-                if (rst.err->code == ErrorCode::ACTION_CANNOT_BE_SYNTHESIZED &&
-                    rst.err->reslice_required) {
-                    for (const auto *sl : *rst.err->reslice_required) {
+            attempts[i].emplace(try_slicing(ctx, alloc, batch[i], container_groups, idx));
+        };
+#ifdef MULTITHREAD
+        if (batch.size() > 1) {
+            parallel_for(ThreadPool::shared(n_jobs_i), n_jobs_i, 0, batch.size(), try_one);
+        } else if (!batch.empty()) {
+            try_one(0);
+        }
+#else
+        for (size_t i = 0; i < batch.size(); ++i) try_one(i);
+#endif
+        for (size_t i = 0; i < attempts.size(); ++i) {
+            auto &attempt = *attempts[i];
+            const int idx = first + static_cast<int>(i);
+            logs[i].flush();
+            alloc_metrics.merge(attempt.metrics);
+            feedback.push_back(attempt.err ? attempt.reslice_required : nullptr);
+            if (attempt.err) {
+                last_err = attempt.err;
+                if (attempt.reslice_required) {
+                    if (i + 1 < attempts.size()) {
+                        LOG3("Dropped slicing-attempts after " << idx << " up to " << n_tried
+                                                               << ", rewinding the iterator");
+                        n_tried = idx;
+                        rewind = true;
+                        break;
+                    }
+                    for (const auto *sl : *attempt.reslice_required) {
                         LOG3("Found invalid packing slice list: " << sl);
                         slicing_ctx->invalidate(sl);
                     }
-                } else {
-                    *last_err << rst.err_str();
                 }
-                return n_tried < max_slicings;
+                continue;
             }
-        }
-        LOG3("Slicing-attempt-" << n_tried << ": succeeded.");
-        auto *this_slicing_score = ctx.score()->make(this_slicing_tx);
-        LOG3("Slicing-attempt-" << n_tried << " score: " << this_slicing_score->str());
-        if (!best_score || this_slicing_score->better_than(*best_score)) {
-            if (best_score) {
-                LOG3("Slicing-attempt-" << n_tried << " yields a *BETTER* allocation.");
-                LOG3("Previous score: " << (*best_score)->str());
+            if (!best_score || attempt.score->better_than(*best_score)) {
+                if (best_score) {
+                    LOG3("Slicing-attempt-" << idx << " yields a *BETTER* allocation.");
+                    LOG3("Previous score: " << (*best_score)->str());
+                } else {
+                    LOG3("Slicing-attempt-" << idx << " is the first succeeded slicing.");
+                }
+                best_tx = attempt.tx;
+                best_score = attempt.score;
+                best_slicing = batch[i];
+                best_sliced_tx = attempt.sliced_tx;
+                best_slicing_idx = idx;
             } else {
-                LOG3("Slicing-attempt-" << n_tried << " is the first succeeded slicing.");
+                LOG3("Slicing-attempt-" << idx << " did *NOT* yield a better allocation.");
             }
-            best_tx = this_slicing_tx;
-            best_score = this_slicing_score;
-            best_slicing = sliced;
-            best_sliced_tx = sliced_tx;
-            best_slicing_idx = n_tried;
-        } else {
-            LOG3("Slicing-attempt-" << n_tried << " did *NOT* yield a better allocation.");
         }
-        return n_tried < max_slicings;
-    });
+        batch.clear();
+        return !rewind && n_tried < max_slicings;
+    };
+    do {
+        rewind = false;
+        slicing_ctx = make_max_packing_slicing_ctx(kit_i, sc);
+        size_t n_replayed = 0;
+        slicing_ctx->iterate([&](std::list<PHV::SuperCluster *> sliced) {
+            if (n_replayed < feedback.size()) {
+                if (const auto *invalid = feedback[n_replayed]) {
+                    for (const auto *sl : *invalid) slicing_ctx->invalidate(sl);
+                }
+                n_replayed++;
+                return true;
+            }
+            n_tried++;
+            batch.push_back(std::move(sliced));
+            if (batch.size() < batch_size && n_tried < max_slicings) return true;
+            return allocate_batch();
+        });
+        if (!rewind) allocate_batch();
+    } while (rewind);
 
     /// allocation failed
     if (!best_score) {
@@ -491,10 +601,48 @@ GreedyAllocator::AllocResultWithSlicingDetails GreedyAllocator::slice_and_alloca
     return rst;
 }
 
+std::optional<GreedyAllocator::AllocResultWithSlicingDetails>
+GreedyAllocator::allocate_memoized_sc(const ScoreContext &ctx, const Allocation &alloc,
+                                      const PHV::SuperCluster *sc, const AllocMemo::Entry &entry,
+                                      const ContainerGroupsBySize &container_groups,
+                                      AllocatorMetrics &alloc_metrics) const {
+    // Without the feedback of the failed attempts of the search, the iterator may produce
+    // the recorded slicing later than it did in the search. Scanning is much cheaper than
+    // allocating a slicing, but a miss still pays for the scan before the full search, so the
+    // scan stops at twice the index of the recorded slicing, within the budget of the search.
+    const int max_scanned = std::min(max_slicing_tries_i, 2 * (entry.slicing_idx + 1));
+    int n_scanned = 0;
+    std::optional<std::list<PHV::SuperCluster *>> recorded;
+    make_max_packing_slicing_ctx(kit_i, sc)->iterate([&](std::list<PHV::SuperCluster *> sliced) {
+        if (AllocMemo::fingerprint(sliced) == entry.slicing) {
+            recorded = std::move(sliced);
+            return false;
+        }
+        return ++n_scanned < max_scanned;
+    });
+    if (!recorded) {
+        LOG3("Recorded slicing not found after " << n_scanned << " slicings");
+        return std::nullopt;
+    }
+    auto attempt = try_slicing(ctx, alloc, *recorded, container_groups, entry.slicing_idx);
+    alloc_metrics.merge(attempt.metrics);
+    if (attempt.err) {
+        LOG3("Recorded slicing cannot be allocated: " << attempt.err->str());
+        return std::nullopt;
+    }
+    AllocResultWithSlicingDetails rst(attempt.tx);
+    rst.best_score = attempt.score;
+    rst.best_slicing = *recorded;
+    rst.best_slicing_idx = entry.slicing_idx;
+    rst.sliced_tx = attempt.sliced_tx;
+    return rst;
+}
+
 bool GreedyAllocator::allocate(std::list<SuperCluster *> clusters_input,
                                AllocatorMetrics &alloc_metrics) {
     LOG1("Run GreedyAllocator.");
     alloc_metrics.start_clock();
+    if (memo_i) memo_i->start_round();
 
     // print table ixbar usage
     LOG3(kit_i.mau.get_table_summary()->ixbarUsagesStr(&phv_i));
@@ -616,8 +764,27 @@ bool GreedyAllocator::allocate(std::list<SuperCluster *> clusters_input,
         LOG3(score_maker->status());
         LOG3("Allocating a normal cluster of index " << idx << ":\n " << sc);
         history << "Allocating a normal cluster of index " << idx << ":\n " << sc;
-        auto detailed_rst = slice_and_allocate_sc(ctx, alloc, sc, container_groups, alloc_metrics,
-                                                  max_slicing_tries_i);
+        // reuse the slicing chosen for this cluster in an earlier round, if neither the cluster
+        // nor any container that the search could allocate it to has changed.
+        std::string sc_fingerprint;
+        AllocMemo::Candidates candidates;
+        std::optional<AllocResultWithSlicingDetails> memoized;
+        if (memo_i) {
+            sc_fingerprint = AllocMemo::fingerprint(kit_i, sc);
+            candidates = AllocMemo::candidates(
+                alloc, container_groups,
+                AllocMemo::context(kit_i, alloc, container_groups, score_maker->status()));
+            if (const auto *entry = memo_i->lookup(sc_fingerprint, candidates)) {
+                memoized = allocate_memoized_sc(ctx, alloc, sc, *entry, container_groups,
+                                                alloc_metrics);
+                memo_i->reused(sc_fingerprint, memoized.has_value());
+                if (memoized) history << "Reused the slicing of an earlier round.\n";
+            }
+        }
+        auto detailed_rst =
+            memoized ? *memoized
+                     : slice_and_allocate_sc(ctx, alloc, sc, container_groups, alloc_metrics,
+                                             max_slicing_tries_i);
         if (!detailed_rst.rst.ok()) {
             LOG3("Failed to allocate: SC-" << sc->uid);
             history << detailed_rst;
@@ -652,6 +819,10 @@ bool GreedyAllocator::allocate(std::list<SuperCluster *> clusters_input,
         } else {
             history << detailed_rst;
             sc_tracker.record(*detailed_rst.sliced_tx);
+            if (memo_i) {
+                memo_i->record(sc_fingerprint, candidates, detailed_rst.best_slicing,
+                               detailed_rst.best_slicing_idx);
+            }
             score_maker->record_commit(*detailed_rst.rst.tx, sc);
             alloc.commit(*detailed_rst.rst.tx);
             LOG3("Successfully allocated: SC-" << sc->uid);
@@ -692,6 +863,7 @@ bool GreedyAllocator::allocate(std::list<SuperCluster *> clusters_input,
 
     // Log Allocation Metrics
     LOG1(alloc_metrics);
+    if (memo_i) LOG1(*memo_i);
     return unallocated.empty();
 }
 
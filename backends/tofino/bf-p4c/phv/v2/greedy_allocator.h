@@ -19,7 +19,10 @@
 #ifndef BACKENDS_TOFINO_BF_P4C_PHV_V2_GREEDY_ALLOCATOR_H_
 #define BACKENDS_TOFINO_BF_P4C_PHV_V2_GREEDY_ALLOCATOR_H_
 
+#include <optional>
+
 #include "backends/tofino/bf-p4c/phv/utils/utils.h"
+#include "backends/tofino/bf-p4c/phv/v2/alloc_memo.h"
 #include "backends/tofino/bf-p4c/phv/v2/allocator_base.h"
 #include "backends/tofino/bf-p4c/phv/v2/kind_size_indexed_map.h"
 #include "backends/tofino/bf-p4c/phv/v2/phv_kit.h"
@@ -35,6 +38,10 @@ class GreedyAllocator : public AllocatorBase {
     const int pipe_id_i;
     /// the total number of slicing that we will try for a super cluster.
     const int max_slicing_tries_i = 256;
+    /// the number of slicings of a super cluster that are allocated concurrently.
+    const int n_jobs_i;
+    /// allocations of earlier rounds, reused if not null.
+    AllocMemo *memo_i;
 
  private:
     /// @returns a map from PHV::Size to container groups.
@@ -89,15 +96,51 @@ class GreedyAllocator : public AllocatorBase {
     };
     friend std::ostream &operator<<(std::ostream &, const AllocResultWithSlicingDetails &);
 
+    /// The allocation of one slicing of a super cluster.
+    struct SlicingAttempt {
+        /// allocation of all sliced clusters, complete only if err is not set.
+        Transaction tx;
+        /// score of tx, set if all sliced clusters were allocated.
+        TxScore *score = nullptr;
+        /// transaction of each sliced cluster.
+        ordered_map<const PHV::SuperCluster *, TxContStatus> *sliced_tx = nullptr;
+        AllocError *err = nullptr;
+        /// slice lists that the slicing iterator must invalidate because of err.
+        const ordered_set<const SuperCluster::SliceList *> *reslice_required = nullptr;
+        /// metrics of this attempt only.
+        AllocatorMetrics metrics;
+        explicit SlicingAttempt(const Transaction &tx) : tx(tx) {}
+    };
+
+    /// Allocate the @p n_tried th slicing, @p sliced, of a super cluster to a new transaction
+    /// of @p alloc. Attempts can run concurrently, as the state they share is read-only to
+    /// them, except where noted:
+    /// - @p alloc, the parent of all their transactions, and @p ctx and @p container_groups;
+    /// - the analyses of kit_i, including mauInitFields, which only the trivial allocator
+    ///   changes. The extract cache of the parser packing validator is filled under a lock;
+    /// - phv_i, except for the zero containers, which are recorded under a lock.
+    /// The caller captures the logs of each attempt, see Log::OutputBuffer.
+    SlicingAttempt try_slicing(const ScoreContext &ctx, const Allocation &alloc,
+                               const std::list<PHV::SuperCluster *> &sliced,
+                               const ContainerGroupsBySize &container_groups, int n_tried) const;
+
     /// Try slicing and allocate @p sc.
     AllocResultWithSlicingDetails slice_and_allocate_sc(
         const ScoreContext &ctx, const Allocation &alloc, const PHV::SuperCluster *sc,
         const ContainerGroupsBySize &container_groups, AllocatorMetrics &alloc_metrics,
         const int max_slicings = 128) const;
 
+    /// Allocate @p sc with the slicing recorded in @p entry.
+    /// @returns std::nullopt if the slicing is not found or cannot be allocated.
+    std::optional<AllocResultWithSlicingDetails> allocate_memoized_sc(
+        const ScoreContext &ctx, const Allocation &alloc, const PHV::SuperCluster *sc,
+        const AllocMemo::Entry &entry, const ContainerGroupsBySize &container_groups,
+        AllocatorMetrics &alloc_metrics) const;
+
  public:
-    GreedyAllocator(const PhvKit &kit, PhvInfo &phv, int pipe_id)
-        : AllocatorBase(kit), phv_i(phv), pipe_id_i(pipe_id) {};
+    GreedyAllocator(const PhvKit &kit, PhvInfo &phv, int pipe_id, int n_jobs = 1,
+                    AllocMemo *memo = nullptr)
+        : AllocatorBase(kit), phv_i(phv), pipe_id_i(pipe_id), n_jobs_i(n_jobs), memo_i(memo) {};
 
     /// @returns false if allocation failed.
     /// allocate all @p clusters to phv_i. This function will directly print out errors
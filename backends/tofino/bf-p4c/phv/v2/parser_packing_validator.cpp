@@ -53,6 +53,9 @@ ParserPackingValidator::StatePrimitiveMap ParserPackingValidator::get_primitives
         auto state = loc->to<IR::BFN::ParserState>();
         if (!state) continue;  // cannot be write if not in state
 
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> guard(state_extracts_cache_lock);
+#endif
         auto [it, inserted] = state_extracts_cache.try_emplace({state, expr});
         if (inserted) {  // not cached, need to calculate
             // defuse does not track extracts directly so we need to find it in the state
@@ -19,6 +19,10 @@
 #ifndef BACKENDS_TOFINO_BF_P4C_PHV_V2_PARSER_PACKING_VALIDATOR_H_
 #define BACKENDS_TOFINO_BF_P4C_PHV_V2_PARSER_PACKING_VALIDATOR_H_
 
+#ifdef MULTITHREAD
+#include <mutex>
+#endif
+
 #include "backends/tofino/bf-p4c/common/field_defuse.h"
 #include "backends/tofino/bf-p4c/lib/assoc.h"
 #include "backends/tofino/bf-p4c/parde/parser_info.h"
@@ -58,6 +62,10 @@ class ParserPackingValidator : public ParserPackingValidatorInterface {
     mutable assoc::hash_map<std::pair<const IR::BFN::ParserState *, const IR::Expression *>,
                             std::vector<const IR::BFN::ParserPrimitive *>>
         state_extracts_cache;
+#ifdef MULTITHREAD
+    /// Guards state_extracts_cache, as slicings can be allocated concurrently.
+    mutable std::mutex state_extracts_cache_lock;
+#endif
 
     /// @returns all primitives to @p fs, grouped by states.
     StatePrimitiveMap get_primitives(const FieldSlice &fs) const;
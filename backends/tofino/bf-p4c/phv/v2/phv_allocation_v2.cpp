@@ -18,6 +18,7 @@
 
 #include "backends/tofino/bf-p4c/phv/v2/phv_allocation_v2.h"
 
+#include "backends/tofino/bf-p4c/bf-p4c-options.h"
 #include "backends/tofino/bf-p4c/phv/v2/allocator_base.h"
 #include "backends/tofino/bf-p4c/phv/v2/greedy_allocator.h"
 #include "backends/tofino/bf-p4c/phv/v2/smart_packing.h"
@@ -71,7 +72,8 @@ const IR::Node *PhvAllocation::apply_visitor(const IR::Node *root_, const char *
             LOG1("Trivial allocation failed.");
         }
     } else {
-        GreedyAllocator greedy_allocator(kit_i, phv_i, pipe_id_i);
+        GreedyAllocator greedy_allocator(kit_i, phv_i, pipe_id_i, BackendOptions().phv_jobs,
+                                         &memo_i);
         if (!greedy_allocator.allocate(clusters, greedy_alloc_metrics)) {
             LOG1("Greedy allocation failed.");
         }
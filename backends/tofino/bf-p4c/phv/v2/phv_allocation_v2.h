@@ -21,6 +21,7 @@
 
 #include "backends/tofino/bf-p4c/phv/mau_backtracker.h"
 #include "backends/tofino/bf-p4c/phv/utils/utils.h"
+#include "backends/tofino/bf-p4c/phv/v2/alloc_memo.h"
 #include "backends/tofino/bf-p4c/phv/v2/phv_kit.h"
 #include "lib/cstring.h"
 
@@ -32,6 +33,8 @@ class PhvAllocation : public Visitor {
     const MauBacktracker &mau_bt_i;
     PhvInfo &phv_i;
     int pipe_id_i = -1;
+    /// allocations of super clusters, kept across the rounds of table placement backtracking.
+    AllocMemo memo_i;
 
     const IR::Node *apply_visitor(const IR::Node *root, const char *name = 0) override;
 
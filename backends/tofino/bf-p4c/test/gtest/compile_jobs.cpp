@@ -0,0 +1,180 @@
+/**
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Verify that compiling the pipes of a program concurrently with --jobs writes the same output
+ * as a serial compile.
+ */
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/gtest/env.h"
+
+namespace P4::Test {
+
+namespace CompileJobs {
+
+namespace fs = std::filesystem;
+
+// Two pipes with different programs, so that their outputs differ and a mix-up shows.
+const char *p4_prog = R"(
+#include <core.p4>
+#include <tna.p4>
+
+header h_t {
+    bit<8> a;
+    bit<8> b;
+    bit<16> c;
+}
+
+struct headers_t {
+    h_t h;
+}
+
+struct metadata_t {}
+
+parser IngressParser(packet_in pkt, out headers_t hdr, out metadata_t md,
+                     out ingress_intrinsic_metadata_t ig_intr_md) {
+    state start {
+        pkt.extract(ig_intr_md);
+        pkt.advance(PORT_METADATA_SIZE);
+        pkt.extract(hdr.h);
+        transition accept;
+    }
+}
+
+control IngressA(inout headers_t hdr, inout metadata_t md,
+                 in ingress_intrinsic_metadata_t ig_intr_md,
+                 in ingress_intrinsic_metadata_from_parser_t ig_intr_prsr_md,
+                 inout ingress_intrinsic_metadata_for_deparser_t ig_intr_dprsr_md,
+                 inout ingress_intrinsic_metadata_for_tm_t ig_intr_tm_md) {
+    action set(bit<8> v) { hdr.h.a = v; }
+    table t {
+        key = { hdr.h.b : exact; }
+        actions = { set; }
+    }
+    apply {
+        t.apply();
+        ig_intr_tm_md.ucast_egress_port = ig_intr_md.ingress_port;
+    }
+}
+
+control IngressB(inout headers_t hdr, inout metadata_t md,
+                 in ingress_intrinsic_metadata_t ig_intr_md,
+                 in ingress_intrinsic_metadata_from_parser_t ig_intr_prsr_md,
+                 inout ingress_intrinsic_metadata_for_deparser_t ig_intr_dprsr_md,
+                 inout ingress_intrinsic_metadata_for_tm_t ig_intr_tm_md) {
+    action add(bit<16> v) { hdr.h.c = hdr.h.c + v; }
+    table u {
+        key = { hdr.h.a : exact; hdr.h.b : ternary; }
+        actions = { add; }
+    }
+    apply {
+        u.apply();
+        ig_intr_tm_md.ucast_egress_port = ig_intr_md.ingress_port;
+    }
+}
+
+control IngressDeparser(packet_out pkt, inout headers_t hdr, in metadata_t md,
+                        in ingress_intrinsic_metadata_for_deparser_t ig_intr_dprsr_md) {
+    apply { pkt.emit(hdr); }
+}
+
+parser EgressParser(packet_in pkt, out headers_t hdr, out metadata_t md,
+                    out egress_intrinsic_metadata_t eg_intr_md) {
+    state start {
+        pkt.extract(eg_intr_md);
+        transition accept;
+    }
+}
+
+control Egress(inout headers_t hdr, inout metadata_t md,
+               in egress_intrinsic_metadata_t eg_intr_md,
+               in egress_intrinsic_metadata_from_parser_t eg_intr_md_from_prsr,
+               inout egress_intrinsic_metadata_for_deparser_t eg_intr_dprs_md,
+               inout egress_intrinsic_metadata_for_output_port_t eg_intr_oport_md) {
+    apply {}
+}
+
+control EgressDeparser(packet_out pkt, inout headers_t hdr, in metadata_t md,
+                       in egress_intrinsic_metadata_for_deparser_t eg_intr_dprsr_md) {
+    apply { pkt.emit(hdr); }
+}
+
+Pipeline(IngressParser(), IngressA(), IngressDeparser(),
+         EgressParser(), Egress(), EgressDeparser()) pipe0;
+Pipeline(IngressParser(), IngressB(), IngressDeparser(),
+         EgressParser(), Egress(), EgressDeparser()) pipe1;
+
+Switch(pipe0, pipe1) main;
+)";
+
+std::string read_file(const fs::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/// The run id and the build date differ between any two compiles, serial or not.
+std::string mask_run(const std::string &contents) {
+    static const std::regex run(R"(("run_id"|"build_date"|run_id)\s*:\s*"[^"]*")");
+    return std::regex_replace(contents, run, "$1: \"-\"");
+}
+
+/// Compiles the program in @p dir into @p dir/out with @p jobs.
+/// @returns the contents of all output files, by their path relative to the output directory.
+std::map<std::string, std::string> compile(const fs::path &dir, int jobs) {
+    const auto out = dir / "out";
+    fs::remove_all(out);
+    std::stringstream cmd;
+    cmd << buildPath << "p4c-barefoot --target tofino --arch tna --jobs " << jobs << " -o " << out
+        << " " << (dir / "prog.p4") << " > " << (dir / "stdout") << " 2>&1";
+    EXPECT_EQ(std::system(cmd.str().c_str()), 0) << cmd.str() << "\n" << read_file(dir / "stdout");
+
+    std::map<std::string, std::string> files;
+    for (const auto &entry : fs::recursive_directory_iterator(out)) {
+        if (!entry.is_regular_file()) continue;
+        files[fs::relative(entry.path(), out).string()] = mask_run(read_file(entry.path()));
+    }
+    return files;
+}
+
+}  // namespace CompileJobs
+
+TEST(CompileJobs, SameOutputAsSerial) {
+    namespace fs = std::filesystem;
+    auto dir = fs::temp_directory_path() / ("bf_p4c_compile_jobs_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    std::ofstream(dir / "prog.p4") << CompileJobs::p4_prog;
+    setenv("P4C_16_INCLUDE_PATH", (std::string(buildPath) + "p4include").c_str(), 1);
+
+    // Both compiles write to the same directory, because some outputs record their paths.
+    auto serial = CompileJobs::compile(dir, 1);
+    ASSERT_FALSE(serial.empty());
+    auto concurrent = CompileJobs::compile(dir, 2);
+    EXPECT_EQ(serial.size(), concurrent.size());
+    for (const auto &[path, contents] : serial) {
+        auto it = concurrent.find(path);
+        if (it == concurrent.end()) {
+            ADD_FAILURE() << path << " is missing with --jobs 2";
+            continue;
+        }
+        EXPECT_TRUE(it->second == contents) << path << " differs with --jobs 2";
+    }
+
+    fs::remove_all(dir);
+}
+
+}  // namespace P4::Test
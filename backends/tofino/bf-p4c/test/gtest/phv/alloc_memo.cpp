@@ -0,0 +1,92 @@
+/**
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Verify that a recorded slicing is only reused while neither the super cluster, the candidate
+ * containers nor the table placement have changed.
+ */
+
+#include "backends/tofino/bf-p4c/phv/v2/alloc_memo.h"
+
+#include <string>
+
+#include "backends/tofino/bf-p4c/phv/phv_fields.h"
+#include "backends/tofino/bf-p4c/phv/utils/utils.h"
+#include "backends/tofino/bf-p4c/specs/device.h"
+#include "backends/tofino/bf-p4c/test/gtest/tofino_gtest_utils.h"
+#include "gtest/gtest.h"
+#include "lib/bitvec.h"
+
+namespace P4::Test {
+
+class TofinoAllocMemo : public TofinoBackendTest {};
+
+namespace {
+
+void init_field(PHV::Field &f, int id, gress_t gress) {
+    f.id = id;
+    f.size = 8;
+    f.name = cstring("foo.f" + std::to_string(id));
+    f.gress = gress;
+    f.offset = 0;
+    f.metadata = true;
+    f.bridged = false;
+    f.pov = false;
+}
+
+}  // namespace
+
+TEST_F(TofinoAllocMemo, ReusedOnlyIfCandidatesAreUnchanged) {
+    const PhvSpec &phvSpec = Device::phvSpec();
+    PhvInfo phv;
+    PhvUse uses(phv);
+    PHV::ConcreteAllocation alloc(phv, uses);
+
+    bitvec candidate_group = phvSpec.mauGroups(PHV::Size::b8)[2];
+    PHV::v2::ContainerGroupsBySize groups;
+    groups[PHV::Size::b8].emplace_back(PHV::Size::b8, candidate_group);
+    auto in_group = phvSpec.idToContainer(*candidate_group.min());
+    auto elsewhere = phvSpec.idToContainer(*phvSpec.mauGroups(PHV::Size::b32)[0].min());
+
+    using PHV::v2::AllocMemo;
+    AllocMemo memo;
+    const std::string sc_fingerprint = "sc";
+    memo.record(sc_fingerprint, AllocMemo::candidates(alloc, groups, "placement"), {}, 3);
+
+    // a transaction without changes sees the same containers.
+    auto tx = alloc.makeTransaction();
+    const auto *entry = memo.lookup(sc_fingerprint, AllocMemo::candidates(tx, groups, "placement"));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->slicing_idx, 3);
+
+    // a different table placement misses.
+    EXPECT_EQ(memo.lookup(sc_fingerprint, AllocMemo::candidates(alloc, groups, "replaced")),
+              nullptr);
+    EXPECT_EQ(memo.get_stats().misses, 1);
+
+    // containers that the search cannot use do not matter.
+    PHV::Field f0;
+    init_field(f0, 0, alloc.gress(elsewhere).value_or(INGRESS));
+    alloc.allocate(PHV::AllocSlice(&f0, elsewhere, 0, 0, 8));
+    EXPECT_NE(memo.lookup(sc_fingerprint, AllocMemo::candidates(alloc, groups, "placement")),
+              nullptr);
+    EXPECT_EQ(memo.get_stats().misses, 1);
+
+    // any change to a candidate container invalidates the entry, even if the recorded
+    // allocation did not use that container.
+    PHV::Field f1;
+    init_field(f1, 1, alloc.gress(in_group).value_or(INGRESS));
+    alloc.allocate(PHV::AllocSlice(&f1, in_group, 0, 0, 8));
+    EXPECT_EQ(memo.lookup(sc_fingerprint, AllocMemo::candidates(alloc, groups, "placement")),
+              nullptr);
+    EXPECT_EQ(memo.get_stats().misses, 2);
+
+    // an unknown super cluster misses, even if it has a prefix of a known fingerprint.
+    EXPECT_EQ(memo.lookup("s", AllocMemo::candidates(alloc, groups, "placement")), nullptr);
+    EXPECT_EQ(memo.get_stats().misses, 3);
+}
+
+}  // namespace P4::Test
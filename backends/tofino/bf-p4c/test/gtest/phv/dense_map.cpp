@@ -0,0 +1,112 @@
+/**
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "backends/tofino/bf-p4c/phv/utils/dense_map.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace P4::Test {
+
+namespace {
+
+struct IntId {
+    size_t operator()(int key) const { return key; }
+};
+
+using Map = PHV::DenseOrderedMap<int, std::string, IntId>;
+
+std::vector<int> keys(const Map &map) {
+    std::vector<int> rv;
+    for (const auto &kv : map) rv.push_back(kv.first);
+    return rv;
+}
+
+}  // namespace
+
+TEST(DenseOrderedMap, IteratesInInsertionOrder) {
+    Map map;
+    map[7] = "a";
+    map[2] = "b";
+    map[7] += "c";
+    map[40] = "d";
+    EXPECT_EQ(keys(map), (std::vector<int>{7, 2, 40}));
+    EXPECT_EQ(map.size(), 3U);
+    EXPECT_EQ(map.at(7), "ac");
+    EXPECT_EQ(map.count(2), 1U);
+    EXPECT_EQ(map.count(3), 0U);
+    EXPECT_EQ(map.count(100), 0U);
+    EXPECT_TRUE(map.find(3) == map.end());
+    EXPECT_EQ(map.find(40)->second, "d");
+    EXPECT_THROW(map.at(3), std::out_of_range);
+}
+
+TEST(DenseOrderedMap, ReferencesStayValid) {
+    Map map;
+    std::string *value = &map[5];
+    for (int i = 0; i < 1000; ++i) map[i] = std::to_string(i);
+    EXPECT_EQ(value, &map.at(5));
+    EXPECT_EQ(*value, "5");
+}
+
+TEST(DenseOrderedMap, CopiesAreIndependent) {
+    Map map;
+    map[3] = "a";
+    map[1] = "b";
+    Map copy = map;
+    copy[1] = "c";
+    copy[9] = "d";
+    EXPECT_EQ(map.at(1), "b");
+    EXPECT_EQ(map.count(9), 0U);
+    EXPECT_EQ(keys(copy), (std::vector<int>{3, 1, 9}));
+    EXPECT_EQ(copy.find(3)->second, "a");
+
+    map = copy;
+    EXPECT_EQ(keys(map), (std::vector<int>{3, 1, 9}));
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.count(3), 0U);
+    EXPECT_EQ(copy.at(9), "d");
+}
+
+TEST(DenseOrderedMap, DenseIndex) {
+    Map map;
+    map.set_dense();
+    map[7] = "a";
+    map[2] = "b";
+    map[4000] = "c";
+    EXPECT_EQ(keys(map), (std::vector<int>{7, 2, 4000}));
+    EXPECT_EQ(map.at(4000), "c");
+    EXPECT_EQ(map.count(3), 0U);
+    EXPECT_EQ(map.count(5000), 0U);
+
+    Map copy = map;
+    copy[3] = "d";
+    EXPECT_EQ(keys(copy), (std::vector<int>{7, 2, 4000, 3}));
+    EXPECT_EQ(copy.at(2), "b");
+    EXPECT_EQ(map.count(3), 0U);
+}
+
+TEST(DenseOrderedMap, SwitchesIndex) {
+    Map map;
+    map[9] = "a";
+    map[1] = "b";
+    map[5] = "c";
+    map.set_dense();
+    map[3] = "d";
+    EXPECT_EQ(map.at(9), "a");
+    EXPECT_EQ(map.at(3), "d");
+    map.set_dense(false);
+    map[0] = "e";
+    EXPECT_EQ(keys(map), (std::vector<int>{9, 1, 5, 3, 0}));
+    for (int key : {9, 1, 5, 3, 0}) EXPECT_EQ(map.count(key), 1U) << key;
+    EXPECT_EQ(map.count(2), 0U);
+    EXPECT_EQ(map.find(5)->second, "c");
+}
+
+}  // namespace P4::Test
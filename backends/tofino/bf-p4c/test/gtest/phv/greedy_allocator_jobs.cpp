@@ -0,0 +1,167 @@
+/**
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Verify that the alternative PHV allocator allocates the same containers with --phv-jobs.
+ */
+
+#include "backends/tofino/bf-p4c/test/gtest/tofino_gtest_utils.h"
+#include "bf_gtest_helpers.h"
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+#include "test/gtest/helpers.h"
+
+namespace P4::Test {
+
+namespace GreedyAllocatorJobs {
+
+// The actions write the fields of h1 from several containers with different alignments, which
+// cannot be synthesized for some of the packings of h1. Such a slicing fails with a request to
+// reslice the slice list of h1, so the slicings tried after it depend on that feedback.
+const char *p4_prog = R"(
+header h {
+    bit<4> a;
+    bit<4> b;
+    bit<8> c;
+    bit<3> d;
+    bit<5> e;
+    bit<8> f;
+}
+
+struct headers_t {
+    h h1;
+    h h2;
+}
+
+struct metadata_t {
+    bit<4> x;
+    bit<3> y;
+    bit<5> z;
+}
+
+parser IngressParser(
+        packet_in pkt,
+        out headers_t hdr,
+        out metadata_t ig_md,
+        out ingress_intrinsic_metadata_t ig_intr_md) {
+
+    state start {
+        pkt.extract(ig_intr_md);
+        pkt.advance(PORT_METADATA_SIZE);
+        pkt.extract(hdr.h1);
+        pkt.extract(hdr.h2);
+        transition accept;
+    }
+}
+
+parser EgressParser(
+    packet_in pkt,
+    out headers_t hdr,
+    out metadata_t meta,
+    out egress_intrinsic_metadata_t eg_intr_md) {
+
+    state start {
+        transition accept;
+    }
+}
+
+control Ingress(
+    inout headers_t hdr,
+    inout metadata_t ig_md,
+    in ingress_intrinsic_metadata_t ig_intr_md,
+    in ingress_intrinsic_metadata_from_parser_t ig_intr_prsr_md,
+    inout ingress_intrinsic_metadata_for_deparser_t ig_intr_dprsr_md,
+    inout ingress_intrinsic_metadata_for_tm_t ig_intr_tm_md) {
+    action mix(bit<8> v) {
+        hdr.h1.a = hdr.h2.c[7:4];
+        hdr.h1.b = ig_md.x;
+        hdr.h1.d = hdr.h2.e[4:2];
+        hdr.h1.e = ig_md.z;
+        hdr.h1.f = v;
+    }
+    action shift() {
+        hdr.h1.a = hdr.h2.b;
+        hdr.h1.c = hdr.h2.f;
+        hdr.h1.d = ig_md.y;
+        hdr.h1.e = hdr.h2.d ++ hdr.h2.a[1:0];
+    }
+    table t {
+        key = { hdr.h1.f : exact; hdr.h2.c : exact; }
+        actions = { mix; shift; }
+    }
+    apply {
+        ig_md.x = hdr.h2.a;
+        ig_md.y = hdr.h2.d;
+        ig_md.z = hdr.h2.e;
+        t.apply();
+        ig_intr_tm_md.ucast_egress_port = ig_intr_md.ingress_port;
+    }
+}
+
+control Egress(
+    inout headers_t hdr,
+    inout metadata_t meta,
+    in egress_intrinsic_metadata_t eg_intr_md,
+    in egress_intrinsic_metadata_from_parser_t eg_intr_md_from_prsr,
+    inout egress_intrinsic_metadata_for_deparser_t ig_intr_dprs_md,
+    inout egress_intrinsic_metadata_for_output_port_t eg_intr_oport_md) {
+    apply {
+    }
+}
+
+control IngressDeparser(
+    packet_out pkt,
+    inout headers_t hdr,
+    in metadata_t ig_md,
+    in ingress_intrinsic_metadata_for_deparser_t ig_intr_dprsr_md) {
+    apply {
+        pkt.emit(hdr);
+    }
+}
+
+control EgressDeparser(
+    packet_out pkt,
+    inout headers_t hdr,
+    in metadata_t eg_md,
+    in egress_intrinsic_metadata_for_deparser_t eg_intr_dprsr_md) {
+    apply {
+        pkt.emit(hdr);
+    }
+}
+
+Pipeline(
+    IngressParser(),
+    Ingress(),
+    IngressDeparser(),
+    EgressParser(),
+    Egress(),
+    EgressDeparser()) pipe;
+
+Switch(pipe) main;)";
+
+/// @returns the PHV allocation of p4_prog, allocated with @p jobs concurrent slicings.
+std::string phv_asm(int jobs) {
+    auto blk = TestCode(TestCode::Hdr::Tofino1arch, p4_prog);
+    blk.flags(Match::TrimWhiteSpace | Match::TrimAnnotations);
+    BackendOptions().alt_phv_alloc = true;
+    BackendOptions().phv_jobs = jobs;
+
+    EXPECT_TRUE(blk.CreateBackend());
+    EXPECT_TRUE(blk.apply_pass(TestCode::Pass::FullBackend));
+    return blk.extract_code(TestCode::CodeBlock::PhvAsm);
+}
+
+}  // namespace GreedyAllocatorJobs
+
+TEST(GreedyAllocatorJobs, SameAllocationWithReslicing) {
+    auto serial = GreedyAllocatorJobs::phv_asm(1);
+    EXPECT_NE(serial, "");
+    for (int jobs : {2, 3, 8}) {
+        EXPECT_EQ(serial, GreedyAllocatorJobs::phv_asm(jobs)) << "with --phv-jobs " << jobs;
+    }
+}
+
+}  // namespace P4::Test
@@ -16,6 +16,9 @@
 /* Define to 1 if you have the LIBGC library. */
 #cmakedefine HAVE_LIBGC 1
 
+/* Define to 1 to default to arena allocation instead of garbage collection. */
+#cmakedefine ENABLE_ARENA_ALLOC 1
+
 /* Define to 1 if you have the GMP library. */
 #cmakedefine HAVE_LIBGMP 1
 
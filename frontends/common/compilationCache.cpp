@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "frontends/common/compilationCache.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "frontends/common/parseInput.h"
+#include "ir/binary_snapshot.h"
+#include "ir/ir.h"
+#include "lib/error.h"
+#include "lib/hash.h"
+
+namespace P4 {
+
+namespace {
+
+/// @return @p parts, length-prefixed, so that no two different lists of parts are the same
+/// bytes. Entries are stored under a hash of this material and keep the material itself.
+std::string keyMaterial(std::initializer_list<std::string_view> parts) {
+    std::string material;
+    for (auto part : parts) {
+        uint64_t size = part.size();
+        material.append(reinterpret_cast<const char *>(&size), sizeof(size));
+        material.append(part);
+    }
+    return material;
+}
+
+/// Hashes @p material into a 128-bit key in hex.
+std::string cacheKey(std::string material) {
+    uint64_t low = Util::hash(material.data(), material.size());
+    material.push_back('\1');
+    uint64_t high = Util::hash(material.data(), material.size());
+    return absl::StrCat(absl::Hex(high, absl::kZeroPad16), absl::Hex(low, absl::kZeroPad16));
+}
+
+}  // namespace
+
+CompilationCache::CompilationCache(std::filesystem::path dir, CompilerOptions &options)
+    : dir(std::move(dir)), options(options) {}
+
+bool CompilationCache::readSource() {
+    diagnostics = diagnosticCount();
+    std::stringstream text;
+    if (options.doNotPreprocess) {
+        std::ifstream in(options.file, std::ios::binary);
+        if (!in) {
+            ::P4::error(ErrorType::ERR_NOT_FOUND, "%1%: No such file or directory.", options.file);
+            return false;
+        }
+        text << in.rdbuf();
+    } else {
+        auto preprocessorResult = options.preprocess();
+        if (!preprocessorResult.has_value()) return false;
+        char buffer[1 << 16];
+        while (size_t size = fread(buffer, 1, sizeof(buffer), preprocessorResult.value().get()))
+            text.write(buffer, size);
+    }
+    source = text.str();
+
+    frontendMaterial = keyMaterial(
+        {"frontend", options.compilerVersion.string_view(), std::to_string(IR::binary_schema),
+         std::to_string(static_cast<int>(options.langVersion)), options.file.string(),
+         options.processedOptionsKey(Util::Options::OptionFlags::MidendOnly |
+                                     Util::Options::OptionFlags::BackendOnly),
+         source});
+    midendMaterial = keyMaterial(
+        {"midend", frontendMaterial,
+         options.processedOptionsKey(Util::Options::OptionFlags::BackendOnly)});
+    frontendKey = cacheKey(frontendMaterial);
+    midendKey = cacheKey(midendMaterial);
+    return true;
+}
+
+const IR::P4Program *CompilationCache::parse() const {
+#ifdef SUPPORT_P4_14
+    return parseP4String(options.file.c_str(), 1, source, options.langVersion);
+#else
+    return parseP4String(options.file.c_str(), 1, source);
+#endif
+}
+
+std::filesystem::path CompilationCache::entryPath(const std::string &key,
+                                                  std::string_view suffix) const {
+    // Spread the entries over subdirectories, like ccache, to keep directories small.
+    return dir / key.substr(0, 2) / absl::StrCat(key.substr(2), suffix);
+}
+
+bool CompilationCache::writeEntry(const std::filesystem::path &path, std::string_view material,
+                                  std::string_view data) const {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    auto temp = path;
+    temp += absl::StrCat(".tmp", getpid());
+    {
+        std::ofstream out(temp, std::ios::binary);
+        uint64_t size = material.size();
+        out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+        out.write(material.data(), material.size());
+        out.write(data.data(), data.size());
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temp, ec);
+            ::P4::warning(ErrorType::WARN_FAILED, "Can't write compilation cache entry %1%",
+                          path);
+            return false;
+        }
+    }
+    // Renaming is atomic, so concurrent compilations never see a partial entry.
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::string> CompilationCache::readEntry(const std::filesystem::path &path,
+                                                      std::string_view material) const {
+    std::ifstream in(path, std::ios::binary);
+    uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char *>(&size), sizeof(size)) || size != material.size())
+        return std::nullopt;
+    // Keys are hashes, so compare the material to tell a collision from a hit.
+    std::string stored(size, '\0');
+    if (!in.read(stored.data(), size) || stored != material) return std::nullopt;
+    std::stringstream data;
+    data << in.rdbuf();
+    return data.str();
+}
+
+bool CompilationCache::restoreOptions() {
+    if (optionsRestored) return true;
+    auto arguments = readEntry(entryPath(frontendKey, ".options"), frontendMaterial);
+    if (!arguments) return false;
+    // Arguments are stored null-terminated; like ApplyOptionsPragmas, start with a dummy
+    // program name, which is skipped when processing.
+    std::vector<const char *> argv = {"(from cache)"};
+    std::string_view rest = *arguments;
+    while (!rest.empty()) {
+        size_t end = rest.find('\0');
+        if (end == std::string_view::npos) return false;
+        argv.push_back(cstring(rest.substr(0, end)).c_str());
+        rest.remove_prefix(end + 1);
+    }
+    if (!options.process_options(argv.size(), const_cast<char *const *>(argv.data())))
+        return false;
+    optionsRestored = true;
+    return true;
+}
+
+const IR::P4Program *CompilationCache::load(const std::string &key, std::string_view material) {
+    auto snapshot = readEntry(entryPath(key, ".ir"), material);
+    if (!snapshot) return nullptr;
+    auto *node = tryReadBinarySnapshot(snapshot->data(), snapshot->size());
+    auto *program = node ? node->to<IR::P4Program>() : nullptr;
+    if (!program || !restoreOptions()) return nullptr;
+    return program;
+}
+
+bool CompilationCache::reportedDiagnostics() const {
+    // Warnings of the stages that a hit skips would be lost, so such results are not stored.
+    return diagnosticCount() != diagnostics;
+}
+
+void CompilationCache::store(const std::string &key, std::string_view material,
+                             const IR::P4Program *program) const {
+    std::stringstream snapshot;
+    writeBinarySnapshot(snapshot, program);
+    writeEntry(entryPath(key, ".ir"), material, snapshot.str());
+}
+
+const IR::P4Program *CompilationCache::loadFrontend() {
+    return load(frontendKey, frontendMaterial);
+}
+
+const IR::P4Program *CompilationCache::loadMidend() { return load(midendKey, midendMaterial); }
+
+void CompilationCache::storeFrontend(const IR::P4Program *program, size_t firstPragmaOption) {
+    if (reportedDiagnostics()) return;
+    std::string arguments;
+    for (const auto &arg : options.processedArguments(firstPragmaOption)) {
+        arguments += arg;
+        arguments += '\0';
+    }
+    // Results without their options would be misses, so store the options first.
+    if (!writeEntry(entryPath(frontendKey, ".options"), frontendMaterial, arguments)) return;
+    store(frontendKey, frontendMaterial, program);
+}
+
+void CompilationCache::storeMidend(const IR::P4Program *program) {
+    if (reportedDiagnostics()) return;
+    store(midendKey, midendMaterial, program);
+}
+
+std::optional<std::string> CompilationCache::loadData(std::string_view name) const {
+    return readEntry(entryPath(frontendKey, absl::StrCat(".", name)), frontendMaterial);
+}
+
+void CompilationCache::storeData(std::string_view name, std::string_view data) const {
+    if (reportedDiagnostics()) return;
+    writeEntry(entryPath(frontendKey, absl::StrCat(".", name)), frontendMaterial, data);
+}
+
+}  // namespace P4
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FRONTENDS_COMMON_COMPILATIONCACHE_H_
+#define FRONTENDS_COMMON_COMPILATIONCACHE_H_
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "frontends/common/options.h"
+
+namespace P4::IR {
+class P4Program;
+}  // namespace P4::IR
+
+namespace P4 {
+
+/// A content-addressed cache of the IR produced by the frontend and the midend (--cache-dir
+/// of p4test), like ccache, but for P4. The result of each stage is saved as a binary IR
+/// snapshot in the cache directory under a hash of everything the stage depends on, the key
+/// material:
+///  - frontend: the preprocessed source, the compiler version, the IR schema, the language
+///    version and the options that are not registered as MidendOnly or BackendOnly;
+///  - midend: the frontend key and the options that are not registered as BackendOnly.
+/// Changing only a backend option thus reuses both results, and changing a midend option
+/// reuses the frontend result.
+///
+/// Every entry starts with its key material, and is only used if that is the same, so a hash
+/// collision is a miss. Options set by pragmas in the source are saved with the frontend result
+/// and applied again when a result is reused. Results are not saved if any diagnostic has been
+/// reported since readSource(), so a hit never hides a warning; debug output of the stages that
+/// are skipped (--top4 dumps, logging) is not reproduced. Snapshots keep the source positions
+/// of the nodes with the program text, so diagnostics of later stages quote the program as
+/// usual, but not its comments. Entries are written to temporary files and renamed into place,
+/// so concurrent compilations can share a cache.
+class CompilationCache {
+ public:
+    /// Uses the cache in @p dir, creating it if needed, for compiling with @p options.
+    CompilationCache(std::filesystem::path dir, CompilerOptions &options);
+
+    /// Reads the input file, running the preprocessor unless disabled, and computes the keys
+    /// of both stages. Must be called after the command line has been processed and before
+    /// any other method. Reports an error and returns false on failure.
+    bool readSource();
+
+    /// Parses the source read by readSource(). Like parseP4File, reports an error and returns
+    /// nullptr on failure.
+    const IR::P4Program *parse() const;
+
+    /// @return the cached result of the frontend or the midend, or nullptr on a miss. Missing
+    /// and unreadable entries are misses.
+    const IR::P4Program *loadFrontend();
+    const IR::P4Program *loadMidend();
+
+    /// Saves the result of the frontend or the midend, unless diagnostics have been reported.
+    /// @p firstPragmaOption is the number of options processed (see
+    /// Util::Options::processedOptionCount) before the options pragmas of the program were
+    /// applied.
+    void storeFrontend(const IR::P4Program *program, size_t firstPragmaOption);
+    void storeMidend(const IR::P4Program *program);
+
+    /// Loads or saves data derived from the frontend result, e.g. the P4Runtime API, under
+    /// @p name. Such data must only depend on the frontend result and its options, and is
+    /// not saved if diagnostics have been reported either.
+    std::optional<std::string> loadData(std::string_view name) const;
+    void storeData(std::string_view name, std::string_view data) const;
+
+ private:
+    std::filesystem::path dir;
+    CompilerOptions &options;
+    std::string source;
+    std::string frontendMaterial, frontendKey;
+    std::string midendMaterial, midendKey;
+    /// The number of diagnostics reported before the source was read.
+    unsigned diagnostics = 0;
+    /// True once the options pragmas of a cached result have been applied.
+    bool optionsRestored = false;
+
+    std::filesystem::path entryPath(const std::string &key, std::string_view suffix) const;
+    const IR::P4Program *load(const std::string &key, std::string_view material);
+    void store(const std::string &key, std::string_view material,
+               const IR::P4Program *program) const;
+    bool reportedDiagnostics() const;
+    bool writeEntry(const std::filesystem::path &path, std::string_view material,
+                    std::string_view data) const;
+    std::optional<std::string> readEntry(const std::filesystem::path &path,
+                                         std::string_view material) const;
+    bool restoreOptions();
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_COMPILATIONCACHE_H_ */
@@ -93,7 +93,7 @@ const IR::Expression *DoConstantFolding::getConstant(const IR::Expression *expr)
 
 const IR::Node *DoConstantFolding::postorder(IR::PathExpression *e) {
     if (const auto *r = policy->hook(*this, e)) return r;
-    if (refMap == nullptr || assignmentTarget) return e;
+    if (refMap == nullptr || isAssignmentTarget()) return e;
     auto decl = refMap->getDeclaration(e->path);
     if (decl == nullptr) return e;
     if (auto dc = decl->to<IR::Declaration_Constant>()) {
@@ -196,23 +196,18 @@ const IR::Node *DoConstantFolding::postorder(IR::Declaration_Constant *d) {
     return d;
 }
 
-const IR::Node *DoConstantFolding::preorder(IR::BaseAssignmentStatement *statement) {
-    assignmentTarget = true;
-    visit(statement->left);
-    assignmentTarget = false;
-    visit(statement->right);
-    prune();
-    return statement;
+bool DoConstantFolding::isAssignmentTarget() const {
+    // Anything within the left side of an assignment is a target, including the bounds of
+    // slices, except for array indices.
+    for (const Context *ctxt = getContext(); ctxt && ctxt->node; ctxt = ctxt->parent) {
+        if (ctxt->node->is<IR::BaseAssignmentStatement>()) return ctxt->child_index == 0;
+        if (ctxt->node->is<IR::ArrayIndex>() && ctxt->child_index == 1) return false;
+        if (!ctxt->node->is<IR::Expression>()) return false;
+    }
+    return false;
 }
 
-const IR::Node *DoConstantFolding::preorder(IR::ArrayIndex *e) {
-    visit(e->left);
-    bool save = assignmentTarget;
-    assignmentTarget = false;
-    visit(e->right);
-    assignmentTarget = save;
-    prune();
-
+const IR::Node *DoConstantFolding::postorder(IR::ArrayIndex *e) {
     if (!typesKnown) return e;
     auto orig = getOriginal<IR::ArrayIndex>();
     auto type = typeMap->getType(orig->left, true);
@@ -272,17 +267,17 @@ bool isActionRun(const IR::Expression *e, const DeclarationLookup *refMap) {
 
 }  // namespace
 
-const IR::Node *DoConstantFolding::preorder(IR::SwitchCase *c) {
+const IR::Node *DoConstantFolding::preorder(IR::Expression *e) {
     // Action enum switch case labels must be action names.
     // Do not fold the switch case's 'label' expression so that it can be inspected by the
     // TypeInference pass.
-    // Note: static_cast is used as a SwitchCase's parent is always SwitchStatement.
-    const auto *parent = static_cast<const IR::SwitchStatement *>(getContext()->node);
-    if (isActionRun(parent->expression, refMap)) {
-        visit(c->statement);
-        prune();
+    const auto *ctxt = getContext();
+    if (ctxt && ctxt->child_index == 0 && ctxt->node->is<IR::SwitchCase>()) {
+        // Note: static_cast is used as a SwitchCase's parent is always SwitchStatement.
+        const auto *parent = static_cast<const IR::SwitchStatement *>(ctxt->parent->node);
+        if (isActionRun(parent->expression, refMap)) prune();
     }
-    return c;
+    return e;
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Cmpl *e) {
@@ -70,9 +70,12 @@ class DoConstantFolding : public Transform, public ResolutionContext {
 
     /// Maps declaration constants to constant expressions
     std::map<const IR::Declaration_Constant *, const IR::Expression *> constants;
-    // True if we are processing a left side of an assignment; we should not
-    // we substituting constants there.
-    bool assignmentTarget;
+
+    /// @returns true if the current node is within the left side of an assignment, but not
+    /// within an array index there; we should not be substituting constants there.  Found
+    /// from the context rather than by visiting the children of assignments in a preorder,
+    /// so that the pass visits nodes in the usual order and can be fused with others.
+    bool isAssignmentTarget() const;
 
     /// @returns a concrete type from a Type_Typedef by resolving it and also getting
     /// any updated type from ConstantFolding an expression size into a Type_Bits
@@ -119,7 +122,6 @@ class DoConstantFolding : public Transform, public ResolutionContext {
           warnings(warnings) {
         visitDagOnce = true;
         setName("DoConstantFolding");
-        assignmentTarget = false;
     }
 
     // If DeclarationLookup is not passed, then resolve by our own. We might
@@ -166,9 +168,8 @@ class DoConstantFolding : public Transform, public ResolutionContext {
     const IR::Node *postorder(IR::Type_Varbits *type) override;
     const IR::Node *postorder(IR::SelectExpression *e) override;
     const IR::Node *postorder(IR::IfStatement *statement) override;
-    const IR::Node *preorder(IR::BaseAssignmentStatement *statement) override;
-    const IR::Node *preorder(IR::ArrayIndex *e) override;
-    const IR::Node *preorder(IR::SwitchCase *c) override;
+    const IR::Node *postorder(IR::ArrayIndex *e) override;
+    const IR::Node *preorder(IR::Expression *e) override;
     const IR::BlockStatement *preorder(IR::BlockStatement *bs) override {
         if (bs->hasAnnotation(IR::Annotation::disableOptimizationAnnotation)) prune();
         return bs;
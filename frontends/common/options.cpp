@@ -40,14 +40,15 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
             return true;
         },
         "Exclude passes from midend passes whose name is equal\n"
-        "to one of `passX' strings.\n");
+        "to one of `passX' strings.\n", OptionFlags::MidendOnly);
     registerOption(
         "--toJSON", "file",
         [this](const char *arg) {
             dumpJsonFile = arg;
             return true;
         },
-        "Dump the compiler IR after the midend as JSON in the specified file.");
+        "Dump the compiler IR after the midend as JSON in the specified file.",
+        OptionFlags::BackendOnly);
     registerOption(
         "--ndebug", nullptr,
         [this](const char *) {
@@ -61,7 +62,7 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
             debugJson = true;
             return true;
         },
-        "[Compiler debugging] Dump and undump the IR");
+        "[Compiler debugging] Dump and undump the IR", OptionFlags::BackendOnly);
     registerOption(
         "--pp", "file",
         [this](const char *arg) {
@@ -77,7 +78,7 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
         },
         "Write a P4Runtime control plane API description to the specified "
         "file.\n"
-        "[Deprecated; use '--p4runtime-files' instead].");
+        "[Deprecated; use '--p4runtime-files' instead].", OptionFlags::BackendOnly);
     registerOption(
         "--p4runtime-entries-file", "file",
         [this](const char *arg) {
@@ -86,7 +87,7 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
         },
         "Write static table entries as a P4Runtime WriteRequest message"
         "to the specified file.\n"
-        "[Deprecated; use '--p4runtime-entries-files' instead].");
+        "[Deprecated; use '--p4runtime-entries-files' instead].", OptionFlags::BackendOnly);
     registerOption(
         "--p4runtime-files", "filelist",
         [this](const char *arg) {
@@ -95,7 +96,7 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
         },
         "Write the P4Runtime control plane API description to the specified\n"
         "files (comma-separated list). The format is inferred from the file\n"
-        "suffix: .txt, .json, .bin");
+        "suffix: .txt, .json, .bin", OptionFlags::BackendOnly);
     registerOption(
         "--p4runtime-entries-files", "files",
         [this](const char *arg) {
@@ -104,7 +105,8 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
         },
         "Write static table entries as a P4Runtime WriteRequest message\n"
         "to the specified files (comma-separated list); the file format is\n"
-        "inferred from the suffix. Legal suffixes are .json, .txt and .bin");
+        "inferred from the suffix. Legal suffixes are .json, .txt and .bin",
+        OptionFlags::BackendOnly);
     registerOption(
         "--p4runtime-format", "{binary,json,text}",
         [this](const char *arg) {
@@ -122,7 +124,7 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
         },
         "Choose output format for the P4Runtime API description (default is "
         "binary).\n"
-        "[Deprecated; use '--p4runtime-files' instead].");
+        "[Deprecated; use '--p4runtime-files' instead].", OptionFlags::BackendOnly);
     registerOption(
         "--target", "target",
         [this](const char *arg) {
@@ -143,7 +145,7 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
             loopsUnrolling = true;
             return true;
         },
-        "Unrolling all parser's loops");
+        "Unrolling all parser's loops", OptionFlags::MidendOnly);
     registerOption(
         "-O", nullptr,
         [this](const char *level) {
@@ -13,13 +13,18 @@
 #include <sys/wait.h>
 
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <regex>
 #include <unordered_set>
 
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
+#include "frontends/common/preprocessor.h"
 #include "frontends/p4/toP4/toP4.h"
+#include "frontends/p4/typeMap.h"
+#include "ir/pass_profile.h"
 #include "lib/exceptions.h"
 #include "lib/exename.h"
 #include "lib/log.h"
@@ -45,10 +50,27 @@ bool isSystemFile(const std::filesystem::path &file) {
 
 bool isSystemFile(cstring file) { return isSystemFile(std::filesystem::path(file.c_str())); }
 
+namespace {
+
+/// The output of the built-in preprocessor, read through fmemopen() streams, by stream.
+std::mutex preprocessedMutex;
+std::map<FILE *, std::unique_ptr<std::string>> preprocessedOutputs;
+
+}  // namespace
+
 void ParserOptions::closeFile(FILE *file) {
     if (file == nullptr) {
         return;
     }
+    {
+        std::lock_guard<std::mutex> lock(preprocessedMutex);
+        auto it = preprocessedOutputs.find(file);
+        if (it != preprocessedOutputs.end()) {
+            fclose(file);
+            preprocessedOutputs.erase(it);
+            return;
+        }
+    }
     int exitCode = pclose(file);
     if (WIFEXITED(exitCode) && WEXITSTATUS(exitCode) == 4) {
         ::P4::error(ErrorType::ERR_IO, "input file does not exist");
@@ -205,6 +227,13 @@ ParserOptions::ParserOptions(std::string_view defaultMessage) : Util::Options(de
             return true;
         },
         "Skip preprocess, assume input file is already preprocessed.");
+    registerOption(
+        "--external-preprocessor", nullptr,
+        [this](const char *) {
+            externalPreprocessor = true;
+            return true;
+        },
+        "Run the system C preprocessor instead of the built-in one.", OptionFlags::BackendOnly);
     registerOption(
         "--disable-annotations", "annotations",
         [this](const char *arg) {
@@ -287,21 +316,22 @@ ParserOptions::ParserOptions(std::string_view defaultMessage) : Util::Options(de
             P4CContext::get().errorReporter().setMaxErrorCount(maxError);
             return true;
         },
-        "Set the maximum number of errors to display before failing.");
+        "Set the maximum number of errors to display before failing.", OptionFlags::BackendOnly);
     registerOption(
         "-T", "loglevel",
         [](const char *arg) {
             Log::addDebugSpec(arg);
             return true;
         },
-        "[Compiler debugging] Adjust logging level per file (see below)");
+        "[Compiler debugging] Adjust logging level per file (see below)", OptionFlags::BackendOnly);
     registerOption(
         "-v", nullptr,
         [](const char *) {
             Log::increaseVerbosity();
             return true;
         },
-        "[Compiler debugging] Increase verbosity level (can be repeated)");
+        "[Compiler debugging] Increase verbosity level (can be repeated)",
+        OptionFlags::BackendOnly);
     registerOption(
         "--top4", "pass1[,pass2]",
         [this](const char *arg) {
@@ -312,14 +342,41 @@ ParserOptions::ParserOptions(std::string_view defaultMessage) : Util::Options(de
         "[Compiler debugging] Dump the P4 representation after\n"
         "passes whose name contains one of `passX' regex substrings. Matching is "
         "case-insensitive.\n"
-        "When '-v' is used this will include the compiler IR.\n");
+        "When '-v' is used this will include the compiler IR.\n", OptionFlags::BackendOnly);
     registerOption(
         "--dump", "folder",
         [this](const char *arg) {
             dumpFolder = arg;
             return true;
         },
-        "[Compiler debugging] Folder where P4 programs are dumped\n");
+        "[Compiler debugging] Folder where P4 programs are dumped\n", OptionFlags::BackendOnly);
+    registerOption(
+        "--pass-profile", "file",
+        [](const char *arg) {
+            PassProfiler::enable(arg);
+            return true;
+        },
+        "[Compiler debugging] Record the wall time, allocated bytes, IR nodes created and\n"
+        "visited of every pass and write them to file as a Chrome trace, with a summary\n"
+        "table sorted by time spent in each pass in file.summary.\n", OptionFlags::BackendOnly);
+    registerOption(
+        "--incremental-typecheck", "verify",
+        [](const char *arg) {
+            if (arg == nullptr) {
+                TypeMap::incremental = TypeMap::Incremental::On;
+            } else if (!strcmp(arg, "verify")) {
+                TypeMap::incremental = TypeMap::Incremental::Verify;
+            } else {
+                ::P4::error(ErrorType::ERR_INVALID,
+                            "Illegal argument %1% for --incremental-typecheck", arg);
+                return false;
+            }
+            return true;
+        },
+        "[Compiler debugging] Keep type maps across program changes that leave all\n"
+        "declared types unchanged, only inferring types for replaced nodes.\n"
+        "With 'verify', check each incremental result against full type inference.\n",
+        OptionFlags::OptionalArgument);
     registerOption(
         "--parser-inline-opt", nullptr,
         [this](const char *) {
@@ -341,7 +398,8 @@ ParserOptions::ParserOptions(std::string_view defaultMessage) : Util::Options(de
             noIncludes = true;
             return true;
         },
-        "[Compiler debugging] If true do not generate #include statements\n");
+        "[Compiler debugging] If true do not generate #include statements\n",
+        OptionFlags::BackendOnly);
     registerUsage(
         "loglevel format is: \"sourceFile:level,...,sourceFile:level\"\n"
         "where 'sourceFile' is a compiler source file and "
@@ -425,7 +483,28 @@ std::optional<ParserOptions::PreprocessorResult> ParserOptions::preprocess() con
 
     if (file == "-") {
         in = stdin;
+    } else if (auto preprocessor = externalPreprocessor
+                                       ? std::nullopt
+                                       : Preprocessor::create(preprocessor_options.string() +
+                                                              getIncludePath())) {
+        auto output = std::make_unique<std::string>();
+        if (!preprocessor->run(file, *output)) return std::nullopt;
+        if (doNotCompile) {
+            fwrite(output->data(), 1, output->size(), stdout);
+            return std::nullopt;
+        }
+        // fmemopen() does not accept an empty buffer.
+        if (output->empty()) *output = "\n";
+        in = fmemopen(output->data(), output->size(), "r");
+        if (in == nullptr) {
+            ::P4::error(ErrorType::ERR_IO, "Error reading preprocessor output");
+            return std::nullopt;
+        }
+        std::lock_guard<std::mutex> lock(preprocessedMutex);
+        preprocessedOutputs.emplace(in, std::move(output));
     } else {
+        // The options are not supported by the built-in preprocessor (or
+        // --external-preprocessor was given).
 #ifdef __clang__
         std::string cmd("cc -E -x c -Wno-comment");
 #else
@@ -80,6 +80,8 @@ class ParserOptions : public Util::Options {
     cstring compilerVersion;
     /// if true skip preprocess
     bool doNotPreprocess = false;
+    /// if true run the system C preprocessor rather than the built-in one
+    bool externalPreprocessor = false;
     /// substrings matched against pass names
     std::vector<cstring> top4;
     /// debugging dumps of programs written in this folder
@@ -0,0 +1,1663 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "frontends/common/preprocessor.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "absl/strings/str_cat.h"
+#include "lib/error.h"
+
+namespace P4 {
+
+struct Preprocessor::Token {
+    enum Kind : uint8_t {
+        Identifier,
+        Number,  ///< A preprocessing number, like 0x1F or 8w3.
+        String,  ///< A string or character literal.
+        Punctuator,
+        Other,  ///< Any other character.
+        Comment,
+        Newline,
+        End,          ///< The end of a file, or of a list of tokens being macro-expanded.
+        Placemarker,  ///< An empty macro argument next to ##.
+    };
+
+    Kind kind = End;
+    bool spaceBefore = false;
+    /// The first token of a line of a file.
+    bool atLineStart = false;
+    /// An identifier that is not expanded, because it names a macro that was being expanded.
+    bool noExpand = false;
+    /// Produced by a macro expansion rather than read from a file.
+    bool fromMacro = false;
+    /// A ## operator in a macro body.
+    bool pasteOperator = false;
+    /// The first token of a variable argument substituted next to ##, or the placemarker
+    /// for an empty one; a comma pasted to it is kept or removed, as in GCC.
+    bool vaArgs = false;
+    /// In a macro body, the index of the parameter this token names, or -1.
+    int param = -1;
+    unsigned line = 0;
+    /// Offset from the start of the line, to keep the indentation of lines.
+    unsigned column = 0;
+    std::string text;
+
+    bool is(const char *punctuator) const { return kind == Punctuator && text == punctuator; }
+};
+
+struct Preprocessor::Macro {
+    bool functionLike = false;
+    bool variadic = false;
+    /// True while the macro is being expanded, so that it does not expand recursively.
+    bool disabled = false;
+    std::vector<std::string> params;
+    std::vector<Token> body;
+
+    bool sameAs(const Macro &other) const {
+        if (functionLike != other.functionLike || variadic != other.variadic ||
+            params != other.params || body.size() != other.body.size())
+            return false;
+        for (size_t i = 0; i < body.size(); ++i) {
+            if (body[i].text != other.body[i].text ||
+                (i > 0 && body[i].spaceBefore != other.body[i].spaceBefore))
+                return false;
+        }
+        return true;
+    }
+};
+
+struct Preprocessor::SourceText {
+    std::string data;
+    /// Offsets in data at which a backslash-newline was removed, to count lines.
+    std::vector<size_t> splices;
+
+    static std::shared_ptr<const SourceText> make(std::string_view contents) {
+        auto text = std::make_shared<SourceText>();
+        text->data.reserve(contents.size());
+        for (size_t i = 0; i < contents.size(); ++i) {
+            if (contents[i] == '\\') {
+                size_t next = i + 1;
+                if (next < contents.size() && contents[next] == '\r') ++next;
+                if (next < contents.size() && contents[next] == '\n') {
+                    text->splices.push_back(text->data.size());
+                    i = next;
+                    continue;
+                }
+            }
+            text->data.push_back(contents[i]);
+        }
+        return text;
+    }
+};
+
+/// The files read by the preprocessors of the process, with the macros guarding them.
+class Preprocessor::FileCache {
+    struct Entry {
+        std::shared_ptr<const SourceText> text;
+        struct timespec mtime;
+        off_t size;
+        std::string guard;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+
+    static struct timespec modificationTime(const struct stat &st) {
+#ifdef __APPLE__
+        return st.st_mtimespec;
+#else
+        return st.st_mtim;
+#endif
+    }
+
+ public:
+    static FileCache &get() {
+        static FileCache cache;
+        return cache;
+    }
+
+    /// @return the contents of the regular file @p path, or nullptr if it can not be read.
+    std::shared_ptr<const SourceText> read(const std::string &path) {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return nullptr;
+        auto mtime = modificationTime(st);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(path);
+            if (it != entries.end() && it->second.size == st.st_size &&
+                it->second.mtime.tv_sec == mtime.tv_sec &&
+                it->second.mtime.tv_nsec == mtime.tv_nsec)
+                return it->second.text;
+        }
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return nullptr;
+        std::stringstream contents;
+        contents << in.rdbuf();
+        auto text = SourceText::make(contents.str());
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[path] = Entry{text, mtime, st.st_size, {}};
+        return text;
+    }
+
+    /// @return the macro guarding @p text, read from @p path, or an empty string.
+    std::string guard(const std::string &path, const SourceText *text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(path);
+        if (it == entries.end() || it->second.text.get() != text) return {};
+        return it->second.guard;
+    }
+
+    void setGuard(const std::string &path, const SourceText *text, const std::string &guard) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(path);
+        if (it != entries.end() && it->second.text.get() == text) it->second.guard = guard;
+    }
+};
+
+class Preprocessor::Lexer {
+    std::shared_ptr<const SourceText> text;
+    size_t pos = 0;
+    size_t lineStart = 0;
+    size_t nextSplice = 0;
+    unsigned line = 1;
+    bool atLineStart = true;
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+    }
+    static bool isIdentifierStart(char c) {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '$' ||
+               static_cast<unsigned char>(c) >= 0x80;
+    }
+    static bool isIdentifierChar(char c) {
+        return isIdentifierStart(c) || std::isdigit(static_cast<unsigned char>(c));
+    }
+
+    char peek(size_t offset = 0) const {
+        return pos + offset < text->data.size() ? text->data[pos + offset] : '\0';
+    }
+    void countSplices() {
+        while (nextSplice < text->splices.size() && text->splices[nextSplice] <= pos) {
+            ++line;
+            ++nextSplice;
+        }
+    }
+
+ public:
+    explicit Lexer(std::shared_ptr<const SourceText> text) : text(std::move(text)) {}
+
+    /// The line of the next character to be read.
+    unsigned currentLine() {
+        countSplices();
+        return line;
+    }
+
+    Token next() {
+        static const char *const punctuators[] = {
+            "...", "<<=", ">>=", "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=", "&&",
+            "||",  "*=",  "/=",  "%=", "+=", "-=", "&=", "^=", "|=", "##", "::"};
+        const std::string &data = text->data;
+        Token token;
+        while (pos < data.size() && isSpace(data[pos])) {
+            token.spaceBefore = true;
+            ++pos;
+        }
+        countSplices();
+        token.line = line;
+        token.column = pos - lineStart;
+        token.atLineStart = atLineStart;
+        atLineStart = false;
+        if (pos >= data.size()) return token;
+
+        size_t start = pos;
+        char c = data[pos];
+        if (c == '\n') {
+            ++pos;
+            ++line;
+            lineStart = pos;
+            atLineStart = true;
+            token.kind = Token::Newline;
+            token.text = "\n";
+            return token;
+        }
+        if (c == '/' && (peek(1) == '*' || peek(1) == '/')) {
+            size_t end = 0;
+            if (peek(1) == '*') {
+                end = data.find("*/", pos + 2);
+                end = end == std::string::npos ? data.size() : end + 2;
+                for (size_t i = pos; i < end; ++i) {
+                    if (data[i] == '\n') {
+                        ++line;
+                        lineStart = i + 1;
+                    }
+                }
+            } else {
+                end = data.find('\n', pos);
+                if (end == std::string::npos) end = data.size();
+            }
+            pos = end;
+            token.kind = Token::Comment;
+            token.text = data.substr(start, end - start);
+            return token;
+        }
+        if (isIdentifierStart(c)) {
+            while (isIdentifierChar(peek())) ++pos;
+            token.kind = Token::Identifier;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                   (c == '.' && std::isdigit(static_cast<unsigned char>(peek(1))))) {
+            for (++pos;; ++pos) {
+                char n = peek();
+                if ((n == '+' || n == '-') && std::strchr("eEpP", data[pos - 1])) continue;
+                if (!isIdentifierChar(n) && n != '.') break;
+            }
+            token.kind = Token::Number;
+        } else if (c == '"' || c == '\'') {
+            size_t i = pos + 1;
+            while (i < data.size() && data[i] != c && data[i] != '\n')
+                i += data[i] == '\\' ? 2 : 1;
+            if (i < data.size() && data[i] == c) {
+                pos = i + 1;
+                token.kind = Token::String;
+            } else {
+                // An unterminated quote is just a character, as in cpp for assembler.
+                ++pos;
+                token.kind = Token::Other;
+            }
+        } else {
+            token.kind = Token::Other;
+            ++pos;
+            if (c != '\0' && std::strchr("!%&()*+,-./:;<=>?[]^{}|~#", c)) {
+                token.kind = Token::Punctuator;
+                for (const char *punctuator : punctuators) {
+                    size_t length = std::strlen(punctuator);
+                    if (data.compare(start, length, punctuator) == 0) {
+                        pos = start + length;
+                        break;
+                    }
+                }
+            }
+        }
+        token.text = data.substr(start, pos - start);
+        return token;
+    }
+
+    /// Reads a <header-name> if it comes next on the line.
+    std::optional<std::string> headerName() {
+        const std::string &data = text->data;
+        size_t i = pos;
+        while (i < data.size() && isSpace(data[i])) ++i;
+        if (i >= data.size() || data[i] != '<') return std::nullopt;
+        size_t end = data.find_first_of(">\n", i + 1);
+        if (end == std::string::npos || data[end] != '>') return std::nullopt;
+        pos = end + 1;
+        return data.substr(i + 1, end - i - 1);
+    }
+
+    /// Reads the rest of the line as it is, without the newline.
+    std::string restOfLine() {
+        const std::string &data = text->data;
+        size_t end = data.find('\n', pos);
+        if (end == std::string::npos) end = data.size();
+        std::string rest = data.substr(pos, end - pos);
+        pos = end;
+        return rest;
+    }
+};
+
+/// The state of one run of the preprocessor.
+class Preprocessor::State {
+    struct File {
+        /// The path the file was opened with.
+        std::string path;
+        /// The name of the file in line markers and messages, which #line can change.
+        std::string name;
+        std::shared_ptr<const SourceText> text;
+        Lexer lexer;
+        /// The line number reported for a line, minus its number in the file.
+        int lineDelta = 0;
+        /// The index in includeDirs of the directory the file was found in, or -1.
+        int dirIndex = -1;
+        /// The number of conditionals open when the file was entered.
+        size_t conditionalBase = 0;
+        /// Detection of a macro guarding the whole file against multiple inclusion: the first
+        /// directive must be #ifndef, and nothing but comments may follow its #endif.
+        enum { GuardStart, GuardInside, GuardAfter, GuardNone } guardState = GuardStart;
+        std::string guard;
+        size_t guardLevel = 0;
+
+        File(std::string path, std::shared_ptr<const SourceText> text)
+            : path(path), name(std::move(path)), text(text), lexer(std::move(text)) {}
+        unsigned line(const Token &token) const { return token.line + lineDelta; }
+    };
+
+    /// Tokens being macro-expanded.
+    struct Context {
+        std::vector<Token> tokens;
+        size_t pos = 0;
+        /// The macro to enable again when the tokens have been read.
+        std::shared_ptr<Macro> macro;
+    };
+
+    struct Conditional {
+        bool skipping;
+        /// True once a group of the conditional was (or could not be) included.
+        bool taken;
+        bool sawElse;
+        /// The line of the #if, for errors.
+        unsigned line;
+    };
+
+    struct Value {
+        int64_t value = 0;
+        bool isUnsigned = false;
+    };
+
+    /// Evaluation of #if expressions.
+    class Expression {
+        const std::vector<Token> &tokens;
+        size_t pos = 0;
+
+        static bool truthy(Value v) { return v.value != 0; }
+        bool match(const char *punctuator) {
+            if (pos < tokens.size() && tokens[pos].is(punctuator)) {
+                ++pos;
+                return true;
+            }
+            return false;
+        }
+        void fail(std::string message) {
+            if (error.empty()) error = std::move(message);
+        }
+
+        static int precedence(const Token &token) {
+            static const std::pair<const char *, int> operators[] = {
+                {"||", 1}, {"&&", 2}, {"|", 3},  {"^", 4},  {"&", 5},  {"==", 6},
+                {"!=", 6}, {"<", 7},  {">", 7},  {"<=", 7}, {">=", 7}, {"<<", 8},
+                {">>", 8}, {"+", 9},  {"-", 9},  {"*", 10}, {"/", 10}, {"%", 10}};
+            if (token.kind != Token::Punctuator) return -1;
+            for (const auto &[op, prec] : operators)
+                if (token.text == op) return prec;
+            return -1;
+        }
+
+        Value number(const Token &token) {
+            std::string_view text = token.text;
+            bool isUnsigned = false;
+            while (!text.empty() && std::strchr("uUlL", text.back())) {
+                isUnsigned |= text.back() == 'u' || text.back() == 'U';
+                text.remove_suffix(1);
+            }
+            unsigned base = 10;
+            if (text.size() > 1 && text[0] == '0') {
+                if (text[1] == 'x' || text[1] == 'X') {
+                    base = 16;
+                    text.remove_prefix(2);
+                } else if (text[1] == 'b' || text[1] == 'B') {
+                    base = 2;
+                    text.remove_prefix(2);
+                } else {
+                    base = 8;
+                    text.remove_prefix(1);
+                }
+            }
+            uint64_t value = 0;
+            for (char c : text) {
+                unsigned digit = base;
+                if (std::isdigit(static_cast<unsigned char>(c)))
+                    digit = c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    digit = c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    digit = c - 'A' + 10;
+                if (digit >= base) {
+                    if (base == 10 && (c == '.' || c == 'e' || c == 'E'))
+                        fail("floating constant in preprocessor expression");
+                    else
+                        fail(absl::StrCat("invalid integer constant \"", token.text,
+                                          "\" in #if expression"));
+                    return {};
+                }
+                value = value * base + digit;
+            }
+            if (text.empty()) fail(absl::StrCat("invalid integer constant \"", token.text, "\""));
+            if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+                isUnsigned = true;
+            return {static_cast<int64_t>(value), isUnsigned};
+        }
+
+        static Value character(const Token &token) {
+            std::string_view text = token.text.substr(1, token.text.size() - 2);
+            int64_t value = 0;
+            for (size_t i = 0; i < text.size(); ++i) {
+                char c = text[i];
+                if (c == '\\' && i + 1 < text.size()) {
+                    c = text[++i];
+                    switch (c) {
+                        case 'n':
+                            c = '\n';
+                            break;
+                        case 't':
+                            c = '\t';
+                            break;
+                        case 'r':
+                            c = '\r';
+                            break;
+                        case 'a':
+                            c = '\a';
+                            break;
+                        case 'b':
+                            c = '\b';
+                            break;
+                        case 'f':
+                            c = '\f';
+                            break;
+                        case 'v':
+                            c = '\v';
+                            break;
+                        case 'x': {
+                            unsigned code = 0;
+                            while (i + 1 < text.size() &&
+                                   std::isxdigit(static_cast<unsigned char>(text[i + 1]))) {
+                                char d = text[++i];
+                                code = code * 16 + (std::isdigit(static_cast<unsigned char>(d))
+                                                        ? d - '0'
+                                                        : std::tolower(d) - 'a' + 10);
+                            }
+                            c = static_cast<char>(code);
+                            break;
+                        }
+                        default:
+                            if (c >= '0' && c <= '7') {
+                                unsigned code = c - '0';
+                                for (int n = 1; n < 3 && i + 1 < text.size() &&
+                                                text[i + 1] >= '0' && text[i + 1] <= '7';
+                                     ++n)
+                                    code = code * 8 + (text[++i] - '0');
+                                c = static_cast<char>(code);
+                            }
+                    }
+                }
+                value = text.size() == 1 ? static_cast<signed char>(c)
+                                         : (value << 8) | static_cast<unsigned char>(c);
+            }
+            return {value, false};
+        }
+
+        static Value shift(Value v, int64_t amount, bool left) {
+            if (amount < 0) {
+                left = !left;
+                amount = amount == std::numeric_limits<int64_t>::min()
+                             ? std::numeric_limits<int64_t>::max()
+                             : -amount;
+            }
+            auto bits = static_cast<uint64_t>(v.value);
+            if (left) {
+                v.value = amount >= 64 ? 0 : static_cast<int64_t>(bits << amount);
+            } else if (v.isUnsigned || v.value >= 0) {
+                v.value = amount >= 64 ? 0 : static_cast<int64_t>(bits >> amount);
+            } else {
+                v.value = amount >= 64 ? -1 : v.value >> amount;
+            }
+            return v;
+        }
+
+        Value apply(const std::string &op, Value lhs, Value rhs, bool evaluate) {
+            bool isUnsigned = lhs.isUnsigned || rhs.isUnsigned;
+            auto a = static_cast<uint64_t>(lhs.value);
+            auto b = static_cast<uint64_t>(rhs.value);
+            auto result = [isUnsigned](uint64_t value) {
+                return Value{static_cast<int64_t>(value), isUnsigned};
+            };
+            auto boolean = [](bool value) { return Value{value, false}; };
+            if (op == "||") return boolean(truthy(lhs) || truthy(rhs));
+            if (op == "&&") return boolean(truthy(lhs) && truthy(rhs));
+            if (op == "|") return result(a | b);
+            if (op == "^") return result(a ^ b);
+            if (op == "&") return result(a & b);
+            if (op == "==") return boolean(a == b);
+            if (op == "!=") return boolean(a != b);
+            if (op == "<") return boolean(isUnsigned ? a < b : lhs.value < rhs.value);
+            if (op == ">") return boolean(isUnsigned ? a > b : lhs.value > rhs.value);
+            if (op == "<=") return boolean(isUnsigned ? a <= b : lhs.value <= rhs.value);
+            if (op == ">=") return boolean(isUnsigned ? a >= b : lhs.value >= rhs.value);
+            if (op == "<<" || op == ">>") return shift(lhs, rhs.value, op == "<<");
+            if (op == "+") return result(a + b);
+            if (op == "-") return result(a - b);
+            if (op == "*") return result(a * b);
+            // Division and remainder.
+            if (b == 0) {
+                if (evaluate) fail("division by zero in #if");
+                return result(0);
+            }
+            if (isUnsigned) return result(op == "/" ? a / b : a % b);
+            if (lhs.value == std::numeric_limits<int64_t>::min() && rhs.value == -1)
+                return result(op == "/" ? a : 0);
+            return result(op == "/" ? lhs.value / rhs.value : lhs.value % rhs.value);
+        }
+
+        Value unary(bool evaluate) {
+            if (pos >= tokens.size()) {
+                fail(tokens.empty() ? "#if with no expression" : "missing expression in #if");
+                return {};
+            }
+            const Token &token = tokens[pos++];
+            if (token.is("(")) {
+                Value value = comma(evaluate);
+                if (!match(")")) fail("missing ')' in expression");
+                return value;
+            }
+            if (token.is("+")) return unary(evaluate);
+            if (token.is("-")) {
+                Value value = unary(evaluate);
+                value.value = static_cast<int64_t>(0 - static_cast<uint64_t>(value.value));
+                return value;
+            }
+            if (token.is("~")) {
+                Value value = unary(evaluate);
+                value.value = ~value.value;
+                return value;
+            }
+            if (token.is("!")) return {!truthy(unary(evaluate)), false};
+            if (token.kind == Token::Number) return number(token);
+            if (token.kind == Token::String && token.text[0] == '\'') return character(token);
+            // Identifiers that are not macros are 0.
+            if (token.kind == Token::Identifier) return {};
+            fail(absl::StrCat("token \"", token.text,
+                              "\" is not valid in preprocessor expressions"));
+            return {};
+        }
+
+        Value binary(int minPrecedence, bool evaluate) {
+            Value lhs = unary(evaluate);
+            while (pos < tokens.size()) {
+                int prec = precedence(tokens[pos]);
+                if (prec < minPrecedence) break;
+                const std::string &op = tokens[pos++].text;
+                bool evaluateRhs = evaluate;
+                if (op == "&&") evaluateRhs = evaluate && truthy(lhs);
+                if (op == "||") evaluateRhs = evaluate && !truthy(lhs);
+                Value rhs = binary(prec + 1, evaluateRhs);
+                lhs = apply(op, lhs, rhs, evaluateRhs);
+            }
+            return lhs;
+        }
+
+        Value conditional(bool evaluate) {
+            Value condition = binary(1, evaluate);
+            if (!match("?")) return condition;
+            bool chosen = truthy(condition);
+            Value ifTrue = comma(evaluate && chosen);
+            if (!match(":")) fail("'?' without following ':'");
+            Value ifFalse = conditional(evaluate && !chosen);
+            Value value = chosen ? ifTrue : ifFalse;
+            value.isUnsigned = ifTrue.isUnsigned || ifFalse.isUnsigned;
+            return value;
+        }
+
+        Value comma(bool evaluate) {
+            Value value = conditional(evaluate);
+            while (match(",")) value = conditional(evaluate);
+            return value;
+        }
+
+     public:
+        std::string error;
+
+        explicit Expression(const std::vector<Token> &tokens) : tokens(tokens) {}
+
+        bool evaluate() {
+            Value value = comma(true);
+            if (pos < tokens.size())
+                fail(absl::StrCat("missing binary operator before token \"", tokens[pos].text,
+                                  "\""));
+            return truthy(value);
+        }
+    };
+
+    const Preprocessor &config;
+    std::string &out;
+    std::unordered_map<std::string, std::shared_ptr<Macro>> macros;
+    std::vector<std::unique_ptr<File>> files;
+    /// Tokens of the current file that were read ahead and put back.
+    std::deque<Token> pending;
+    std::vector<Context> contexts;
+    /// True if the last token read by rawNext came from the file rather than a context.
+    bool lastFromFile = false;
+    std::vector<Conditional> conditionals;
+    std::unordered_set<std::string> onceFiles;
+    std::string baseFile;
+    std::string outFile;
+    unsigned outLine = 0;
+    unsigned counter = 0;
+    /// Set when a macro expands to nothing, so that the next token is preceded by a space.
+    bool pendingSpace = false;
+    /// Nesting of the macro arguments being read.
+    unsigned collectingArguments = 0;
+    bool failed = false;
+    /// Set on errors after which preprocessing stops, like a missing #include file.
+    bool fatal = false;
+
+    static constexpr size_t maxIncludeDepth = 200;
+
+    void reportError(unsigned line, std::string_view message) {
+        std::string name = files.empty() ? "<command-line>" : files.back()->name;
+        ::P4::error(ErrorType::ERR_INVALID, "%1%:%2%: %3%", name, line, std::string(message));
+        failed = true;
+    }
+    void reportError(const Token &at, std::string_view message) {
+        reportError(files.empty() ? 0 : files.back()->line(at), message);
+    }
+
+    static std::string quote(std::string_view text) {
+        std::string result = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') result += '\\';
+            result += c;
+        }
+        result += '"';
+        return result;
+    }
+
+    static std::vector<Token> lex(std::string_view text) {
+        Lexer lexer(SourceText::make(text));
+        std::vector<Token> tokens;
+        for (Token token = lexer.next(); token.kind != Token::End; token = lexer.next())
+            tokens.push_back(std::move(token));
+        return tokens;
+    }
+
+    static bool isBuiltin(const std::string &name) {
+        static const std::unordered_set<std::string> builtins = {
+            "__FILE__",          "__BASE_FILE__", "__LINE__", "__COUNTER__",
+            "__INCLUDE_LEVEL__", "__DATE__",      "__TIME__", "__has_include",
+            "__has_include_next"};
+        return builtins.count(name) != 0;
+    }
+
+    bool isDefined(const std::string &name) const {
+        return macros.count(name) != 0 || isBuiltin(name);
+    }
+
+    bool skipping() const { return !conditionals.empty() && conditionals.back().skipping; }
+
+    // Output
+
+    void marker(unsigned line, const std::string &name, const char *flag) {
+        absl::StrAppend(&out, "# ", line, " ", quote(name), flag, "\n");
+        outLine = line;
+        outFile = name;
+    }
+
+    /// Brings the output to @p line of the current file, with newlines if it is close enough,
+    /// otherwise with a line marker.
+    void resync(unsigned line) {
+        const File &file = *files.back();
+        if (outFile != file.name || line < outLine || line > outLine + 8) {
+            marker(line, file.name, "");
+            return;
+        }
+        out.append(line - outLine, '\n');
+        outLine = line;
+    }
+
+    /// True if printing @p next right after @p previous would make different tokens.
+    static bool wouldPaste(const Token &previous, const Token &next) {
+        if (!previous.fromMacro && !next.fromMacro) return false;
+        char c = next.text.empty() ? '\0' : next.text[0];
+        if (c == '\0') return false;
+        auto word = [](const Token &t) {
+            return t.kind == Token::Identifier || t.kind == Token::Number;
+        };
+        if (word(previous))
+            return word(next) ||
+                   (previous.kind == Token::Identifier && next.kind == Token::String) ||
+                   (previous.kind == Token::Number && (c == '.' || c == '+' || c == '-'));
+        if (previous.kind != Token::Punctuator) return false;
+        const std::string &p = previous.text;
+        if (c == '=' && (p == "<<" || p == ">>" ||
+                         (p.size() == 1 && std::strchr("=!<>+-*/%&|^", p[0]))))
+            return true;
+        if (p == ">") return c == '>';
+        if (p == "<") return c == '<' || c == '%' || c == ':';
+        if (p == "+") return c == '+';
+        if (p == "-") return c == '-' || c == '>';
+        if (p == "/") return c == '/' || c == '*';
+        if (p == "%") return c == ':' || c == '%';
+        if (p == "&") return c == '&';
+        if (p == "|") return c == '|';
+        if (p == ":") return c == ':' || c == '>';
+        if (p == "->") return c == '*';
+        if (p == ".") return c == '.' || c == '%' || next.kind == Token::Number;
+        if (p == "#") return c == '#' || c == '%';
+        return false;
+    }
+
+    // Reading tokens
+
+    Token fileToken() {
+        Token token;
+        if (!pending.empty()) {
+            token = std::move(pending.front());
+            pending.pop_front();
+            return token;
+        }
+        token = files.back()->lexer.next();
+        if (token.kind == Token::Comment && token.text[1] == '*' &&
+            (token.text.size() < 4 || token.text.compare(token.text.size() - 2, 2, "*/") != 0))
+            reportError(token, "unterminated comment");
+        return token;
+    }
+
+    Token rawNext() {
+        while (!contexts.empty()) {
+            Context &context = contexts.back();
+            if (context.pos < context.tokens.size()) {
+                lastFromFile = false;
+                return context.tokens[context.pos++];
+            }
+            if (context.macro) context.macro->disabled = false;
+            contexts.pop_back();
+        }
+        lastFromFile = true;
+        return fileToken();
+    }
+
+    /// Puts back the token just read by rawNext.
+    void unread(Token token) {
+        if (lastFromFile)
+            pending.push_front(std::move(token));
+        else
+            --contexts.back().pos;
+    }
+
+    /// Reads the rest of a directive line, without comments.
+    std::vector<Token> readLine() {
+        std::vector<Token> tokens;
+        bool space = false;
+        for (;;) {
+            Token token = fileToken();
+            if (token.kind == Token::Newline) break;
+            if (token.kind == Token::End) {
+                pending.push_front(std::move(token));
+                break;
+            }
+            if (token.kind == Token::Comment) {
+                space = true;
+                continue;
+            }
+            if (space) token.spaceBefore = true;
+            space = false;
+            tokens.push_back(std::move(token));
+        }
+        return tokens;
+    }
+
+    void skipLine() {
+        for (;;) {
+            Token token = fileToken();
+            if (token.kind == Token::Newline) return;
+            if (token.kind == Token::End) {
+                pending.push_front(std::move(token));
+                return;
+            }
+        }
+    }
+
+    /// Skips the lines of groups that are excluded by conditionals.
+    void skipGroups() {
+        while (skipping() && !fatal) {
+            Token token = fileToken();
+            if (token.kind == Token::End) {
+                pending.push_front(std::move(token));
+                return;
+            }
+            if (token.atLineStart && token.is("#"))
+                directive();
+            else if (token.kind != Token::Newline)
+                skipLine();
+        }
+    }
+
+    // Macro expansion
+
+    std::optional<Token> builtin(const Token &name) {
+        Token token;
+        token.kind = Token::Number;
+        token.line = name.line;
+        token.spaceBefore = name.spaceBefore;
+        token.fromMacro = true;
+        const File &file = *files.back();
+        if (name.text == "__FILE__") {
+            token.kind = Token::String;
+            token.text = quote(file.name);
+        } else if (name.text == "__BASE_FILE__") {
+            token.kind = Token::String;
+            token.text = quote(baseFile);
+        } else if (name.text == "__LINE__") {
+            unsigned line = name.fromMacro ? files.back()->lexer.currentLine() : name.line;
+            token.text = std::to_string(line + file.lineDelta);
+        } else if (name.text == "__COUNTER__") {
+            token.text = std::to_string(counter++);
+        } else if (name.text == "__INCLUDE_LEVEL__") {
+            token.text = std::to_string(files.size() - 1);
+        } else if (name.text == "__DATE__" || name.text == "__TIME__") {
+            std::time_t now = std::time(nullptr);
+            struct tm local;
+            localtime_r(&now, &local);
+            char buffer[32];
+            std::strftime(buffer, sizeof(buffer),
+                          name.text == "__DATE__" ? "\"%b %e %Y\"" : "\"%T\"", &local);
+            token.kind = Token::String;
+            token.text = buffer;
+        } else {
+            return std::nullopt;
+        }
+        return token;
+    }
+
+    /// Reads ahead for the '(' of a function-like macro invocation, which may follow on later
+    /// lines, and consumes it if found.
+    bool peekParen() {
+        std::vector<Token> skipped;
+        for (;;) {
+            Token token = rawNext();
+            if (token.is("(")) return true;
+            // Contexts have no newlines or comments, so only file tokens are skipped.
+            if (lastFromFile && (token.kind == Token::Newline || token.kind == Token::Comment)) {
+                skipped.push_back(std::move(token));
+                continue;
+            }
+            unread(std::move(token));
+            for (auto it = skipped.rbegin(); it != skipped.rend(); ++it)
+                pending.push_front(std::move(*it));
+            return false;
+        }
+    }
+
+    /// Reads the arguments of an invocation of @p macro, after the '('.
+    bool collectArgs(const Token &name, const Macro &macro,
+                     std::vector<std::vector<Token>> &args) {
+        args.assign(1, {});
+        int depth = 0;
+        bool space = false;
+        ++collectingArguments;
+        for (;;) {
+            Token token = rawNext();
+            if (token.kind == Token::End) {
+                unread(std::move(token));
+                --collectingArguments;
+                reportError(name, absl::StrCat("unterminated argument list invoking macro \"",
+                                               name.text, "\""));
+                return false;
+            }
+            if (lastFromFile && token.atLineStart && token.is("#")) {
+                // Directives in macro arguments are processed, as GCC does.
+                directive();
+                skipGroups();
+                continue;
+            }
+            if (token.kind == Token::Newline || token.kind == Token::Comment) {
+                space = true;
+                continue;
+            }
+            if (space) token.spaceBefore = true;
+            space = false;
+            if (token.is("(")) {
+                ++depth;
+            } else if (token.is(")")) {
+                if (depth-- == 0) break;
+            } else if (token.is(",") && depth == 0 &&
+                       !(macro.variadic && args.size() == macro.params.size())) {
+                args.emplace_back();
+                continue;
+            }
+            args.back().push_back(std::move(token));
+        }
+        --collectingArguments;
+
+        size_t count = macro.params.size();
+        if (count == 0 && args.size() == 1 && args[0].empty()) {
+            args.clear();
+        } else if (args.size() < count) {
+            if (macro.variadic && args.size() == count - 1) {
+                // GNU extension: the variable arguments may be omitted.
+                args.emplace_back();
+            } else {
+                reportError(name, absl::StrCat("macro \"", name.text, "\" requires ", count,
+                                               " arguments, but only ", args.size(), " given"));
+                return false;
+            }
+        } else if (args.size() > count) {
+            reportError(name, absl::StrCat("macro \"", name.text, "\" passed ", args.size(),
+                                           " arguments, but takes just ", count));
+            return false;
+        }
+        return true;
+    }
+
+    /// Fully macro-expands @p tokens, independently of the tokens that follow them.
+    std::vector<Token> expandList(std::vector<Token> tokens) {
+        Token end;
+        end.kind = Token::End;
+        tokens.push_back(std::move(end));
+        contexts.push_back({std::move(tokens), 0, nullptr});
+        std::vector<Token> result;
+        for (Token token = next(); token.kind != Token::End; token = next())
+            result.push_back(std::move(token));
+        // The context that ended the list is on top of the stack, and all read.
+        contexts.pop_back();
+        return result;
+    }
+
+    static Token stringify(const std::vector<Token> &arg) {
+        std::string text = "\"";
+        bool first = true;
+        for (const auto &token : arg) {
+            if (token.kind == Token::Placemarker) continue;
+            if (!first && token.spaceBefore) text += ' ';
+            first = false;
+            if (token.kind == Token::String) {
+                for (char c : token.text) {
+                    if (c == '"' || c == '\\') text += '\\';
+                    text += c;
+                }
+            } else {
+                text += token.text;
+            }
+        }
+        text += '"';
+        Token token;
+        token.kind = Token::String;
+        token.text = std::move(text);
+        return token;
+    }
+
+    /// Pastes @p rhs to @p lhs with ##. If the result is not a single token, as cpp for
+    /// assembler does, keeps both tokens.
+    static void paste(std::vector<Token> &result, Token rhs) {
+        Token &lhs = result.back();
+        auto tokens = lex(lhs.text + rhs.text);
+        if (tokens.size() == 1 && tokens[0].kind != Token::Comment) {
+            tokens[0].spaceBefore = lhs.spaceBefore;
+            tokens[0].line = lhs.line;
+            lhs = std::move(tokens[0]);
+        } else {
+            rhs.spaceBefore = false;
+            result.push_back(std::move(rhs));
+        }
+    }
+
+    std::vector<Token> substitute(const Macro &macro, std::vector<std::vector<Token>> &args) {
+        const auto &body = macro.body;
+        std::vector<Token> result;
+        std::vector<std::optional<std::vector<Token>>> expanded(args.size());
+        for (size_t i = 0; i < body.size(); ++i) {
+            const Token &token = body[i];
+            if (macro.functionLike && token.is("#") && i + 1 < body.size() &&
+                body[i + 1].param >= 0) {
+                Token string = stringify(args[body[++i].param]);
+                string.spaceBefore = token.spaceBefore;
+                result.push_back(std::move(string));
+                continue;
+            }
+            if (token.param < 0) {
+                result.push_back(token);
+                continue;
+            }
+            size_t index = token.param;
+            bool pasted = (i > 0 && body[i - 1].pasteOperator) ||
+                          (i + 1 < body.size() && body[i + 1].pasteOperator);
+            bool vaArgs = macro.variadic && index + 1 == macro.params.size();
+            size_t first = result.size();
+            if (pasted) {
+                if (args[index].empty()) {
+                    Token placemarker;
+                    placemarker.kind = Token::Placemarker;
+                    result.push_back(std::move(placemarker));
+                } else {
+                    result.insert(result.end(), args[index].begin(), args[index].end());
+                }
+                result[first].vaArgs = vaArgs;
+            } else {
+                if (!expanded[index]) expanded[index] = expandList(args[index]);
+                result.insert(result.end(), expanded[index]->begin(), expanded[index]->end());
+            }
+            // Variable arguments pasted to a comma keep their own spacing.
+            if (result.size() > first && !(pasted && vaArgs))
+                result[first].spaceBefore = token.spaceBefore;
+        }
+
+        std::vector<Token> pasted;
+        for (size_t i = 0; i < result.size(); ++i) {
+            if (!result[i].pasteOperator || pasted.empty() || i + 1 >= result.size()) {
+                pasted.push_back(std::move(result[i]));
+                continue;
+            }
+            Token rhs = std::move(result[++i]);
+            if (pasted.back().is(",") && rhs.vaArgs) {
+                // GNU extension: ", ## __VA_ARGS__" removes the comma if there are no
+                // variable arguments, and keeps it without pasting otherwise.
+                if (rhs.kind == Token::Placemarker) {
+                    pasted.pop_back();
+                } else {
+                    pasted.push_back(std::move(rhs));
+                }
+            } else if (rhs.kind == Token::Placemarker) {
+                continue;
+            } else if (pasted.back().kind == Token::Placemarker) {
+                rhs.spaceBefore = pasted.back().spaceBefore;
+                pasted.back() = std::move(rhs);
+            } else {
+                paste(pasted, std::move(rhs));
+            }
+        }
+
+        std::vector<Token> expansion;
+        expansion.reserve(pasted.size());
+        for (auto &token : pasted) {
+            if (token.kind == Token::Placemarker) continue;
+            token.fromMacro = true;
+            token.vaArgs = false;
+            token.pasteOperator = false;
+            token.atLineStart = false;
+            expansion.push_back(std::move(token));
+        }
+        return expansion;
+    }
+
+    /// Returns the next macro-expanded token.
+    Token next() {
+        for (;;) {
+            Token token = rawNext();
+            if (pendingSpace) {
+                token.spaceBefore = true;
+                pendingSpace = false;
+            }
+            if (token.kind != Token::Identifier || token.noExpand) return token;
+            auto it = macros.find(token.text);
+            if (it == macros.end()) {
+                if (auto value = builtin(token)) return *value;
+                return token;
+            }
+            auto macro = it->second;
+            if (macro->disabled) {
+                token.noExpand = true;
+                return token;
+            }
+            std::vector<std::vector<Token>> args;
+            if (macro->functionLike) {
+                if (!peekParen()) return token;
+                if (!collectArgs(token, *macro, args)) continue;
+            }
+            auto expansion = substitute(*macro, args);
+            if (expansion.empty()) {
+                pendingSpace = token.spaceBefore;
+                continue;
+            }
+            expansion.front().spaceBefore = token.spaceBefore;
+            macro->disabled = true;
+            contexts.push_back({std::move(expansion), 0, std::move(macro)});
+        }
+    }
+
+    // Text lines
+
+    void textLine(Token first) {
+        resync(files.back()->line(first));
+        unsigned indentation = first.column;
+        pending.push_front(std::move(first));
+        Token previous;
+        bool any = false;
+        bool significant = false;
+        for (;;) {
+            Token token = next();
+            if (token.kind == Token::Newline || token.kind == Token::End) break;
+            if (!any)
+                out.append(indentation, ' ');
+            else if (token.spaceBefore || wouldPaste(previous, token))
+                out += ' ';
+            out += token.text;
+            if (token.kind == Token::Comment)
+                outLine += std::count(token.text.begin(), token.text.end(), '\n');
+            else
+                significant = true;
+            previous = std::move(token);
+            any = true;
+        }
+        out += '\n';
+        ++outLine;
+        pendingSpace = false;
+        if (significant && files.back()->guardState != File::GuardInside)
+            files.back()->guardState = File::GuardNone;
+    }
+
+    // Files
+
+    void enterFile(std::string path, std::shared_ptr<const SourceText> text, int dirIndex,
+                   const char *flag) {
+        auto file = std::make_unique<File>(std::move(path), std::move(text));
+        file->dirIndex = dirIndex;
+        file->conditionalBase = conditionals.size();
+        marker(1, file->name, flag);
+        files.push_back(std::move(file));
+    }
+
+    void leaveFile() {
+        File &file = *files.back();
+        if (conditionals.size() > file.conditionalBase) {
+            reportError(conditionals.back().line, "unterminated conditional directive");
+            conditionals.resize(file.conditionalBase);
+        }
+        if (file.guardState == File::GuardAfter)
+            FileCache::get().setGuard(file.path, file.text.get(), file.guard);
+        files.pop_back();
+        if (files.empty()) return;
+        File &parent = *files.back();
+        marker(parent.lexer.currentLine() + parent.lineDelta, parent.name, " 2");
+    }
+
+    /// Finds the file @p name of an #include, with the directory it was found in.
+    std::optional<std::pair<std::string, int>> resolve(const std::string &name, bool angled,
+                                                        bool includeNext) {
+        if (!name.empty() && name[0] == '/') {
+            if (FileCache::get().read(name)) return std::make_pair(name, -1);
+            return std::nullopt;
+        }
+        auto join = [](const std::string &dir, const std::string &name) {
+            if (dir.empty()) return name;
+            return dir.back() == '/' ? dir + name : absl::StrCat(dir, "/", name);
+        };
+        size_t start = 0;
+        if (includeNext && !files.empty() && files.back()->dirIndex >= 0) {
+            start = files.back()->dirIndex + 1;
+        } else if (!angled && !files.empty()) {
+            const std::string &current = files.back()->path;
+            size_t slash = current.rfind('/');
+            std::string dir = slash == std::string::npos ? "" : current.substr(0, slash + 1);
+            auto path = join(dir, name);
+            if (FileCache::get().read(path)) return std::make_pair(path, -1);
+        }
+        for (size_t i = start; i < config.includeDirs.size(); ++i) {
+            auto path = join(config.includeDirs[i], name);
+            if (FileCache::get().read(path)) return std::make_pair(path, static_cast<int>(i));
+        }
+        return std::nullopt;
+    }
+
+    /// Reads the file name of an #include or __has_include from @p tokens at @p pos.
+    static bool includeName(const std::vector<Token> &tokens, size_t &pos, std::string &name,
+                            bool &angled) {
+        if (pos >= tokens.size()) return false;
+        if (tokens[pos].kind == Token::String && tokens[pos].text[0] == '"') {
+            name = tokens[pos].text.substr(1, tokens[pos].text.size() - 2);
+            angled = false;
+            ++pos;
+            return true;
+        }
+        if (!tokens[pos].is("<")) return false;
+        name.clear();
+        for (size_t i = pos + 1; i < tokens.size(); ++i) {
+            if (tokens[i].is(">")) {
+                angled = true;
+                pos = i + 1;
+                return true;
+            }
+            if (i > pos + 1 && tokens[i].spaceBefore) name += ' ';
+            name += tokens[i].text;
+        }
+        return false;
+    }
+
+    void include(const Token &directiveName, bool includeNext) {
+        std::string name;
+        bool angled = false;
+        std::optional<std::string> header;
+        if (pending.empty()) header = files.back()->lexer.headerName();
+        auto tokens = readLine();
+        size_t pos = 0;
+        if (header) {
+            name = *header;
+            angled = true;
+        } else {
+            tokens = expandList(std::move(tokens));
+            if (!includeName(tokens, pos, name, angled)) {
+                reportError(directiveName, absl::StrCat("#", directiveName.text,
+                                                        " expects \"FILENAME\" or <FILENAME>"));
+                return;
+            }
+        }
+        if (collectingArguments > 0) {
+            reportError(directiveName, absl::StrCat("#", directiveName.text,
+                                                    " in macro arguments is not supported"));
+            return;
+        }
+        auto found = resolve(name, angled, includeNext);
+        if (!found) {
+            reportError(directiveName, absl::StrCat(name, ": No such file or directory"));
+            fatal = true;
+            return;
+        }
+        auto &[path, dirIndex] = *found;
+        auto text = FileCache::get().read(path);
+        if (!text || onceFiles.count(path)) return;
+        auto guard = FileCache::get().guard(path, text.get());
+        if (!guard.empty() && macros.count(guard)) return;
+        if (files.size() >= maxIncludeDepth) {
+            reportError(directiveName, absl::StrCat("#include nested depth ", files.size(),
+                                                    " exceeds maximum of ", maxIncludeDepth));
+            fatal = true;
+            return;
+        }
+        enterFile(path, std::move(text), dirIndex, " 1");
+    }
+
+    // Directives
+
+    void define(const std::vector<Token> &tokens, const Token &at) {
+        if (tokens.empty() || tokens[0].kind != Token::Identifier) {
+            reportError(at, tokens.empty() ? "no macro name given in #define directive"
+                                           : "macro names must be identifiers");
+            return;
+        }
+        const Token &name = tokens[0];
+        if (name.text == "defined") {
+            reportError(name, "\"defined\" cannot be used as a macro name");
+            return;
+        }
+        auto macro = std::make_shared<Macro>();
+        size_t i = 1;
+        if (i < tokens.size() && tokens[i].is("(") && !tokens[i].spaceBefore) {
+            macro->functionLike = true;
+            ++i;
+            for (bool first = true;; first = false) {
+                if (i >= tokens.size()) {
+                    reportError(name, "missing ')' in macro parameter list");
+                    return;
+                }
+                const Token &param = tokens[i++];
+                if (first && param.is(")")) break;
+                if (param.is("...")) {
+                    macro->variadic = true;
+                    macro->params.push_back("__VA_ARGS__");
+                } else if (param.kind != Token::Identifier) {
+                    reportError(param, absl::StrCat("expected parameter name, found \"",
+                                                    param.text, "\""));
+                    return;
+                } else {
+                    for (const auto &other : macro->params) {
+                        if (other == param.text) {
+                            reportError(param, absl::StrCat("duplicate macro parameter \"",
+                                                            param.text, "\""));
+                            return;
+                        }
+                    }
+                    macro->params.push_back(param.text);
+                    if (i < tokens.size() && tokens[i].is("...")) {
+                        macro->variadic = true;
+                        ++i;
+                    }
+                }
+                if (i < tokens.size() && tokens[i].is(")")) {
+                    ++i;
+                    break;
+                }
+                if (macro->variadic || i >= tokens.size() || !tokens[i].is(",")) {
+                    reportError(name, "expected ',' or ')' in macro parameter list");
+                    return;
+                }
+                ++i;
+            }
+        }
+        for (; i < tokens.size(); ++i) {
+            Token token = tokens[i];
+            token.fromMacro = true;
+            token.atLineStart = false;
+            if (token.kind == Token::Identifier) {
+                for (size_t p = 0; p < macro->params.size(); ++p) {
+                    if (macro->params[p] == token.text) token.param = p;
+                }
+            }
+            token.pasteOperator = token.is("##");
+            macro->body.push_back(std::move(token));
+        }
+        if (!macro->body.empty()) {
+            macro->body.front().spaceBefore = false;
+            if (macro->body.front().pasteOperator || macro->body.back().pasteOperator) {
+                reportError(name, "'##' cannot appear at either end of a macro expansion");
+                return;
+            }
+        }
+        auto it = macros.find(name.text);
+        if (it != macros.end() && !it->second->sameAs(*macro)) {
+            std::string file = files.empty() ? "<command-line>" : files.back()->name;
+            ::P4::warning(ErrorType::WARN_DUPLICATE, "%1%:%2%: \"%3%\" redefined", file,
+                          files.empty() ? 0 : files.back()->line(name), name.text);
+        }
+        macros[name.text] = std::move(macro);
+    }
+
+    /// Defines or undefines a macro from the command line, like "-DNAME=VALUE".
+    void commandLineDefinition(bool isDefine, const std::string &definition) {
+        if (!isDefine) {
+            macros.erase(definition);
+            return;
+        }
+        std::string text = definition;
+        size_t equals = text.find('=');
+        if (equals == std::string::npos)
+            text += " 1";
+        else
+            text[equals] = ' ';
+        Token at;
+        define(lex(text), at);
+    }
+
+    bool evaluate(const std::vector<Token> &line, const Token &at) {
+        std::vector<Token> tokens;
+        for (size_t i = 0; i < line.size(); ++i) {
+            const Token &token = line[i];
+            bool value = false;
+            if (token.kind == Token::Identifier && token.text == "defined") {
+                bool paren = i + 1 < line.size() && line[i + 1].is("(");
+                size_t j = i + 1 + paren;
+                if (j >= line.size() || line[j].kind != Token::Identifier) {
+                    reportError(at, "operator \"defined\" requires an identifier");
+                    return false;
+                }
+                if (paren && (j + 1 >= line.size() || !line[j + 1].is(")"))) {
+                    reportError(at, "missing ')' after \"defined\"");
+                    return false;
+                }
+                value = isDefined(line[j].text);
+                i = j + paren;
+            } else if (token.kind == Token::Identifier &&
+                       (token.text == "__has_include" || token.text == "__has_include_next")) {
+                size_t j = i + 1;
+                std::string name;
+                bool angled = false;
+                if (j >= line.size() || !line[j].is("(") ||
+                    !includeName(line, ++j, name, angled) || j >= line.size() ||
+                    !line[j].is(")")) {
+                    reportError(at, absl::StrCat("operator \"", token.text,
+                                                 "\" requires a header name"));
+                    return false;
+                }
+                value = resolve(name, angled, token.text == "__has_include_next").has_value();
+                i = j;
+            } else {
+                tokens.push_back(token);
+                continue;
+            }
+            Token result;
+            result.kind = Token::Number;
+            result.text = value ? "1" : "0";
+            result.spaceBefore = token.spaceBefore;
+            tokens.push_back(std::move(result));
+        }
+        tokens = expandList(std::move(tokens));
+        Expression expression(tokens);
+        bool value = expression.evaluate();
+        if (!expression.error.empty()) {
+            reportError(at, expression.error);
+            return false;
+        }
+        return value;
+    }
+
+    /// #line and linemarkers: @p tokens are the (expanded) line number and optional file name.
+    void line(const std::vector<Token> &tokens, const Token &at) {
+        File &file = *files.back();
+        if (tokens.empty() || tokens[0].kind != Token::Number ||
+            tokens[0].text.find_first_not_of("0123456789") != std::string::npos) {
+            reportError(at, absl::StrCat("\"", tokens.empty() ? "" : tokens[0].text,
+                                         "\" after #line is not a positive integer"));
+            return;
+        }
+        if (tokens.size() > 1) {
+            if (tokens[1].kind != Token::String || tokens[1].text[0] != '"') {
+                reportError(at, absl::StrCat("invalid filename \"", tokens[1].text, "\""));
+                return;
+            }
+            std::string name;
+            const std::string &text = tokens[1].text;
+            for (size_t i = 1; i + 1 < text.size(); ++i) {
+                if (text[i] == '\\' && i + 2 < text.size()) ++i;
+                name += text[i];
+            }
+            file.name = std::move(name);
+        }
+        // The directive gives the number of the line after it, which the lexer is on.
+        file.lineDelta = static_cast<int>(std::stoul(tokens[0].text)) -
+                         static_cast<int>(file.lexer.currentLine());
+    }
+
+    void directive() {
+        File &file = *files.back();
+        Token name = fileToken();
+        if (name.kind == Token::Newline) return;
+        if (name.kind == Token::End) {
+            pending.push_front(std::move(name));
+            return;
+        }
+        const std::string &d = name.text;
+        if (file.guardState == File::GuardAfter ||
+            (file.guardState == File::GuardStart && d != "ifndef"))
+            file.guardState = File::GuardNone;
+
+        if (d == "if" || d == "ifdef" || d == "ifndef") {
+            if (skipping()) {
+                conditionals.push_back({true, true, false, file.line(name)});
+                skipLine();
+                return;
+            }
+            auto tokens = readLine();
+            bool value = false;
+            if (d == "if") {
+                value = evaluate(tokens, name);
+            } else if (tokens.empty() || tokens[0].kind != Token::Identifier) {
+                reportError(name, absl::StrCat("no macro name given in #", d, " directive"));
+            } else {
+                value = isDefined(tokens[0].text) == (d == "ifdef");
+                if (file.guardState == File::GuardStart) {
+                    file.guardState = tokens.size() == 1 ? File::GuardInside : File::GuardNone;
+                    file.guard = tokens[0].text;
+                    file.guardLevel = conditionals.size();
+                }
+            }
+            conditionals.push_back({!value, value, false, file.line(name)});
+            return;
+        }
+        if (d == "elif" || d == "else" || d == "endif") {
+            if (conditionals.size() <= file.conditionalBase) {
+                reportError(name, absl::StrCat("#", d, " without #if"));
+                skipLine();
+                return;
+            }
+            if (d == "endif") {
+                conditionals.pop_back();
+                if (file.guardState == File::GuardInside && conditionals.size() == file.guardLevel)
+                    file.guardState = File::GuardAfter;
+                skipLine();
+                return;
+            }
+            if (file.guardState == File::GuardInside &&
+                conditionals.size() == file.guardLevel + 1)
+                file.guardState = File::GuardNone;
+            Conditional &conditional = conditionals.back();
+            if (conditional.sawElse) reportError(name, absl::StrCat("#", d, " after #else"));
+            if (d == "else") {
+                conditional.sawElse = true;
+                conditional.skipping = conditional.taken;
+                conditional.taken = true;
+                skipLine();
+            } else if (conditional.taken) {
+                conditional.skipping = true;
+                skipLine();
+            } else {
+                bool value = evaluate(readLine(), name);
+                // evaluate() may not change the conditionals, so the reference is still valid.
+                conditional.skipping = !value;
+                conditional.taken = value;
+            }
+            return;
+        }
+        if (skipping()) {
+            skipLine();
+            return;
+        }
+
+        if (name.kind == Token::Number) {
+            // A linemarker, like those in the output.
+            std::vector<Token> tokens = {name};
+            for (auto &token : readLine()) tokens.push_back(std::move(token));
+            if (tokens.size() > 2) tokens.resize(2);
+            line(tokens, name);
+        } else if (d == "define") {
+            define(readLine(), name);
+        } else if (d == "undef") {
+            auto tokens = readLine();
+            if (tokens.empty() || tokens[0].kind != Token::Identifier)
+                reportError(name, "no macro name given in #undef directive");
+            else
+                macros.erase(tokens[0].text);
+        } else if (d == "include" || d == "include_next") {
+            include(name, d == "include_next");
+        } else if (d == "line") {
+            line(expandList(readLine()), name);
+        } else if (d == "error" || d == "warning") {
+            std::string message = pending.empty() ? file.lexer.restOfLine() : std::string();
+            skipLine();
+            size_t start = message.find_first_not_of(" \t");
+            message = absl::StrCat("#", d, " ",
+                                   start == std::string::npos ? "" : message.substr(start));
+            if (d == "error") {
+                reportError(name, message);
+            } else {
+                ::P4::warning(ErrorType::WARN_FAILED, "%1%:%2%: %3%", file.name, file.line(name),
+                              message);
+            }
+        } else if (d == "pragma") {
+            auto tokens = readLine();
+            if (!tokens.empty() && tokens[0].kind == Token::Identifier && tokens[0].text == "once")
+                onceFiles.insert(file.path);
+        } else if (d == "ident" || d == "sccs") {
+            skipLine();
+        } else {
+            // Unknown directives are passed through, as cpp for assembler does.
+            std::string rest = pending.empty() ? file.lexer.restOfLine() : std::string();
+            skipLine();
+            resync(file.line(name));
+            absl::StrAppend(&out, "#", d, rest, "\n");
+            ++outLine;
+        }
+    }
+
+ public:
+    State(const Preprocessor &config, std::string &out) : config(config), out(out) {}
+
+    bool run(const std::filesystem::path &path) {
+        auto text = FileCache::get().read(path.string());
+        if (!text) {
+            ::P4::error(ErrorType::ERR_NOT_FOUND, "%1%: No such file or directory", path);
+            return false;
+        }
+        for (const char *predefined : {"__STDC__", "__STDC_HOSTED__", "__ASSEMBLER__"})
+            commandLineDefinition(true, predefined);
+        for (const auto &[isDefine, definition] : config.definitions)
+            commandLineDefinition(isDefine, definition);
+        if (failed) return false;
+
+        baseFile = path.string();
+        enterFile(baseFile, std::move(text), -1, "");
+        while (!files.empty() && !fatal) {
+            Token token = fileToken();
+            if (token.kind == Token::End) {
+                leaveFile();
+            } else if (token.kind == Token::Newline) {
+                continue;
+            } else if (token.atLineStart && token.is("#")) {
+                directive();
+            } else if (skipping()) {
+                skipLine();
+            } else {
+                textLine(std::move(token));
+            }
+        }
+        return !failed;
+    }
+};
+
+std::optional<Preprocessor> Preprocessor::create(std::string_view args) {
+    // Split the arguments like a shell.
+    std::vector<std::string> words;
+    std::string word;
+    bool inWord = false;
+    char quote = 0;
+    for (size_t i = 0; i < args.size(); ++i) {
+        char c = args[i];
+        if (quote) {
+            if (c == quote) {
+                quote = 0;
+            } else if (c == '\\' && quote == '"' && i + 1 < args.size() &&
+                       std::strchr("\"\\$`", args[i + 1])) {
+                word += args[++i];
+            } else {
+                word += c;
+            }
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+            inWord = true;
+        } else if (c == '\\' && i + 1 < args.size()) {
+            word += args[++i];
+            inWord = true;
+        } else if (c == ' ' || c == '\t' || c == '\n') {
+            if (inWord) words.push_back(std::move(word));
+            word.clear();
+            inWord = false;
+        } else {
+            word += c;
+            inWord = true;
+        }
+    }
+    if (quote) return std::nullopt;
+    if (inWord) words.push_back(std::move(word));
+
+    Preprocessor preprocessor;
+    for (size_t i = 0; i < words.size(); ++i) {
+        const std::string &arg = words[i];
+        if (arg.size() < 2 || arg[0] != '-' || !std::strchr("IDU", arg[1])) return std::nullopt;
+        std::string value = arg.substr(2);
+        if (value.empty()) {
+            if (i + 1 >= words.size()) return std::nullopt;
+            value = words[++i];
+        }
+        if (arg[1] == 'I')
+            preprocessor.includeDirs.push_back(std::move(value));
+        else
+            preprocessor.definitions.emplace_back(arg[1] == 'D', std::move(value));
+    }
+    return preprocessor;
+}
+
+bool Preprocessor::run(const std::filesystem::path &file, std::string &out) const {
+    State state(*this, out);
+    return state.run(file);
+}
+
+}  // namespace P4
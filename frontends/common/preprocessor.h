@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FRONTENDS_COMMON_PREPROCESSOR_H_
+#define FRONTENDS_COMMON_PREPROCESSOR_H_
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @file
+/// @brief Built-in C preprocessor.
+
+namespace P4 {
+
+/// A C preprocessor that runs in the compiler process, so that compiling a program does not
+/// have to start `cpp -C -undef -nostdinc -x assembler-with-cpp`, which ParserOptions uses
+/// otherwise. It implements what P4 programs use: #include and #include_next with the -I
+/// search path, object-like and function-like (also variadic) macros with # and ##, -D and
+/// -U, conditional compilation with #if expressions, defined and __has_include, #line,
+/// #error and #warning. Like cpp for assembler, it ignores #pragma and passes other unknown
+/// directives through, and the line markers it writes give the same source positions.
+///
+/// The contents of the files read are cached for the whole process and revalidated with
+/// stat(), together with the macro guarding each file against multiple inclusion, so when
+/// many programs are compiled in one process the p4include files are only read once.
+class Preprocessor {
+ public:
+    /// Returns a preprocessor for the cpp command-line arguments @p args (a string like
+    /// ParserOptions::preprocessor_options, which is split like a shell would), or
+    /// std::nullopt if they contain options other than -I, -D and -U.
+    static std::optional<Preprocessor> create(std::string_view args);
+
+    /// Preprocesses @p file and appends the result to @p out. Reports errors and returns false
+    /// if the file could not be preprocessed.
+    bool run(const std::filesystem::path &file, std::string &out) const;
+
+ private:
+    struct Token;
+    struct Macro;
+    struct SourceText;
+    class FileCache;
+    class Lexer;
+    class State;
+
+    Preprocessor() = default;
+
+    std::vector<std::string> includeDirs;
+    /// -D (true) and -U (false) options, in order.
+    std::vector<std::pair<bool, std::string>> definitions;
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_PREPROCESSOR_H_ */
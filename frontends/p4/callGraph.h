@@ -9,10 +9,13 @@
 #define FRONTENDS_P4_CALLGRAPH_H_
 
 #include <algorithm>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "ir/ir.h"
+#include "lib/bitvec.h"
 #include "lib/exceptions.h"
 #include "lib/log.h"
 #include "lib/map.h"  // IWYU pragma: keep
@@ -30,11 +33,23 @@ cstring cgMakeString(const IR::INode *node);
 
 template <class T>
 class CallGraph {
+ public:
+    class Index;
+
  protected:
     cstring name;
     // Use an ordered map to make this deterministic
     ordered_map<T, std::vector<T> *> out_edges;  // map caller to list of callees
     ordered_map<T, std::vector<T> *> in_edges;
+    /// Dense view of the graph used by the queries; built on demand and dropped by every
+    /// change to the graph.  Queries on the same graph must not run concurrently.
+    mutable std::shared_ptr<const Index> denseIndex;
+
+    void invalidate() { denseIndex.reset(); }
+    std::shared_ptr<const Index> sharedIndex() const {
+        if (!denseIndex) denseIndex = std::make_shared<const Index>(*this);
+        return denseIndex;
+    }
 
  public:
     ordered_set<T> nodes;  // all nodes; do not modify this directly
@@ -69,6 +84,7 @@ class CallGraph {
         out_edges[caller] = new std::vector<T>();
         in_edges[caller] = new std::vector<T>();
         nodes.emplace(caller);
+        invalidate();
     }
     void calls(T caller, T callee) {
         LOG1(name << ": " << cgMakeString(callee) << " is called by " << cgMakeString(caller));
@@ -76,11 +92,13 @@ class CallGraph {
         add(callee);
         out_edges[caller]->push_back(callee);
         in_edges[callee]->push_back(caller);
+        invalidate();
     }
     void remove(T node) {
         auto n = nodes.find(node);
         BUG_CHECK(n != nodes.end(), "%1%: Node not in graph", node);
         nodes.erase(n);
+        invalidate();
         auto in = in_edges.find(node);
         if (in != in_edges.end()) {
             // remove all edges pointing to this node
@@ -119,25 +137,38 @@ class CallGraph {
     // Iterators over the out_edges
     const_iterator begin() const { return out_edges.cbegin(); }
     const_iterator end() const { return out_edges.cend(); }
-    std::vector<T> *getCallees(T caller) { return out_edges[caller]; }
-    std::vector<T> *getCallers(T callee) { return in_edges[callee]; }
+    // The edges can be changed through the returned vectors.
+    std::vector<T> *getCallees(T caller) {
+        invalidate();
+        return out_edges[caller];
+    }
+    std::vector<T> *getCallers(T callee) {
+        invalidate();
+        return in_edges[callee];
+    }
     // Callees are appended to 'toAppend'
     void getCallees(T caller, std::set<T> &toAppend) {
         if (isCaller(caller)) toAppend.insert(out_edges[caller]->begin(), out_edges[caller]->end());
     }
+    /// Return the dense view of the current graph; it is shared by the queries until the
+    /// graph changes.
+    [[nodiscard]] const Index &getIndex() const { return *sharedIndex(); }
     // out will contain all nodes reachable from start
     void reachable(T start, std::set<T> &out) const {
-        std::set<T> work;
-        work.emplace(start);
-        while (!work.empty()) {
-            T node = *work.begin();
-            work.erase(node);
-            if (out.find(node) != out.end()) continue;
-            out.emplace(node);
-            auto edges = out_edges.find(node);
-            if (edges == out_edges.end()) continue;
-            for (auto c : *(edges->second)) work.emplace(c);
+        if (out.find(start) != out.end()) return;
+        const auto &index = getIndex();
+        int s = index.find(start);
+        if (s < 0) {
+            out.emplace(start);
+            return;
         }
+        // The search does not go through nodes that are already in 'out'.
+        bitvec seen;
+        for (auto n : out) {
+            int i = index.find(n);
+            if (i >= 0) seen.setbit(i);
+        }
+        for (auto i : index.reachable(s, seen)) out.emplace(index.node[i]);
     }
     // remove all nodes not in 'to'
     void restrict(const std::set<T> &to) {
@@ -149,30 +180,208 @@ class CallGraph {
 
     using Set = std::unordered_set<T>;
 
+    /// A dense view of the graph: nodes are numbered in the order of 'nodes', and the edges
+    /// are stored as vectors of node numbers.  The view is not updated when the graph changes.
+    class Index {
+     public:
+        std::vector<T> node;
+        std::unordered_map<T, unsigned> number;
+        std::vector<std::vector<unsigned>> succs;
+        std::vector<std::vector<unsigned>> preds;
+
+        explicit Index(const CallGraph &graph) {
+            node.reserve(graph.nodes.size());
+            number.reserve(graph.nodes.size());
+            for (auto n : graph.nodes) {
+                number.emplace(n, node.size());
+                node.push_back(n);
+            }
+            succs.resize(node.size());
+            preds.resize(node.size());
+            for (unsigned i = 0; i < node.size(); i++) {
+                auto edges = graph.out_edges.find(node[i]);
+                if (edges == graph.out_edges.end() || edges->second == nullptr) continue;
+                for (auto callee : *edges->second) {
+                    int j = find(callee);
+                    BUG_CHECK(j >= 0, "%1%: Node not in graph", graph.name);
+                    succs[i].push_back(j);
+                    preds[j].push_back(i);
+                }
+            }
+        }
+
+        [[nodiscard]] size_t size() const { return node.size(); }
+
+        /// Return the number of @p n, or -1 if it is not in the graph.
+        [[nodiscard]] int find(T n) const {
+            auto it = number.find(n);
+            return it == number.end() ? -1 : static_cast<int>(it->second);
+        }
+
+        /// Return the numbers of the nodes reachable from @p start, including @p start.
+        /// Nodes in @p seen are not returned, and the search does not go through them.
+        [[nodiscard]] bitvec reachable(unsigned start, bitvec seen = bitvec()) const {
+            bitvec result;
+            std::vector<unsigned> work{start};
+            seen.setbit(start);
+            while (!work.empty()) {
+                unsigned n = work.back();
+                work.pop_back();
+                result.setbit(n);
+                for (auto s : succs[n]) {
+                    if (seen.getbit(s)) continue;
+                    seen.setbit(s);
+                    work.push_back(s);
+                }
+            }
+            return result;
+        }
+    };
+
+    /// The dominator tree of the graph for a start node, computed with the algorithm of
+    /// Cooper, Harvey and Kennedy ("A Simple, Fast Dominance Algorithm") on the dense view.
+    class Dominators {
+        friend class CallGraph;
+
+        static constexpr unsigned none = ~0u;
+
+        /// Keeps the view of the graph alive when the graph changes.
+        std::shared_ptr<const Index> view;
+        const Index &index;
+        unsigned start = none;
+        /// Immediate dominator of each node; 'none' for nodes not reachable from the start.
+        std::vector<unsigned> idom;
+        /// Preorder number of each node in the dominator tree, and the largest preorder
+        /// number in its subtree; a dominates b iff b's number is in a's range.
+        std::vector<unsigned> first, last;
+
+        bool dominatesAt(unsigned a, unsigned b) const {
+            if (idom[b] == none) return true;
+            return first[a] <= first[b] && first[b] <= last[a];
+        }
+
+        /// Number the nodes reachable from the start in postorder.
+        std::vector<unsigned> postorder(std::vector<unsigned> &order) const {
+            std::vector<unsigned> number(index.size(), none);
+            std::vector<bool> visited(index.size());
+            // node and the position of the next successor to visit
+            std::vector<std::pair<unsigned, size_t>> stack{{start, 0}};
+            visited[start] = true;
+            while (!stack.empty()) {
+                auto &[n, next] = stack.back();
+                if (next < index.succs[n].size()) {
+                    unsigned s = index.succs[n][next++];
+                    if (!visited[s]) {
+                        visited[s] = true;
+                        stack.emplace_back(s, 0);
+                    }
+                    continue;
+                }
+                number[n] = order.size();
+                order.push_back(n);
+                stack.pop_back();
+            }
+            return number;
+        }
+
+     public:
+        Dominators(const CallGraph &graph, T startNode)
+            : view(graph.sharedIndex()), index(*view) {
+            idom.resize(index.size(), none);
+            int s = index.find(startNode);
+            if (s < 0) return;
+            start = s;
+
+            std::vector<unsigned> order;
+            auto number = postorder(order);
+            auto intersect = [&](unsigned a, unsigned b) {
+                while (a != b) {
+                    while (number[a] < number[b]) a = idom[a];
+                    while (number[b] < number[a]) b = idom[b];
+                }
+                return a;
+            };
+            idom[start] = start;
+            bool changes = true;
+            while (changes) {
+                changes = false;
+                // reverse postorder, skipping the start node
+                for (auto it = order.rbegin() + 1; it != order.rend(); ++it) {
+                    unsigned n = *it;
+                    unsigned newIdom = none;
+                    for (auto p : index.preds[n]) {
+                        if (idom[p] == none) continue;
+                        newIdom = newIdom == none ? p : intersect(p, newIdom);
+                    }
+                    if (idom[n] != newIdom) {
+                        idom[n] = newIdom;
+                        changes = true;
+                    }
+                }
+            }
+
+            std::vector<std::vector<unsigned>> children(index.size());
+            for (auto n : order)
+                if (n != start) children[idom[n]].push_back(n);
+            first.resize(index.size(), none);
+            last.resize(index.size(), none);
+            unsigned preorder = 0;
+            std::vector<std::pair<unsigned, size_t>> stack{{start, 0}};
+            first[start] = preorder++;
+            while (!stack.empty()) {
+                auto &[n, next] = stack.back();
+                if (next < children[n].size()) {
+                    unsigned c = children[n][next++];
+                    first[c] = preorder++;
+                    stack.emplace_back(c, 0);
+                    continue;
+                }
+                last[n] = preorder - 1;
+                stack.pop_back();
+            }
+        }
+
+        [[nodiscard]] const Index &getIndex() const { return index; }
+
+        /// Return true if @p node is reachable from the start node.
+        [[nodiscard]] bool isReachable(T node) const {
+            int n = index.find(node);
+            return n >= 0 && idom[n] != none;
+        }
+
+        /// Return true if @p a dominates @p b.  Like 'dominators' below, this treats nodes
+        /// that are not reachable from the start as dominated by all nodes.
+        [[nodiscard]] bool dominates(T a, T b) const {
+            int i = index.find(a), j = index.find(b);
+            if (i < 0 || j < 0) return false;
+            return dominatesAt(i, j);
+        }
+
+        /// Return the immediate dominator of @p node, which must be reachable from the
+        /// start node.  The start node is its own immediate dominator.
+        [[nodiscard]] T immediateDominator(T node) const {
+            BUG_CHECK(isReachable(node), "%1%: node not reachable", cgMakeString(node));
+            return index.node[idom[index.find(node)]];
+        }
+    };
+
     // Compute for each node the set of dominators with the indicated start node.
     // Node d dominates node n if all paths from the start to n go through d
     // Result is deposited in 'dominators'.
     // 'dominators' should be empty when calling this function.
+    // Nodes not reachable from the start are dominated by all nodes.
     void dominators(T start, std::map<T, Set> &dominators) {
-        // initialize
-        for (auto n : nodes) {
-            if (n == start)
-                dominators[n].emplace(start);
-            else
-                dominators[n].insert(nodes.begin(), nodes.end());
-        }
-
-        // There are faster but more complicated algorithms.
-        bool changes = true;
-        while (changes) {
-            changes = false;
-            for (auto node : nodes) {
-                auto vec = in_edges[node];
-                if (vec == nullptr) continue;
-                auto size = dominators[node].size();
-                for (auto c : *vec) insersectWith(dominators[node], dominators[c]);
-                dominators[node].emplace(node);
-                if (dominators[node].size() != size) changes = true;
+        Dominators dom(*this, start);
+        const auto &index = dom.getIndex();
+        for (unsigned n = 0; n < index.size(); n++) {
+            auto &set = dominators[index.node[n]];
+            if (dom.idom[n] == Dominators::none) {
+                set.insert(nodes.begin(), nodes.end());
+                continue;
+            }
+            for (unsigned d = n;; d = dom.idom[d]) {
+                set.emplace(index.node[d]);
+                if (d == dom.start) break;
             }
         }
     }
@@ -209,117 +418,110 @@ class CallGraph {
 
     Loops *compute_loops(T start) {
         auto result = new Loops();
-        std::map<T, Set> dom;
-        dominators(start, dom);
-
-        std::map<T, Loop *> entryToLoop;
-
-        for (auto e : nodes) {
-            auto next = out_edges[e];
-            auto dome = dom[e];
-            for (auto n : *next) {
-                if (dome.find(n) != dome.end()) {
-                    // n is a loop head
-                    auto loop = get(entryToLoop, n);
-                    if (loop == nullptr) {
-                        loop = new Loop(n);
-                        entryToLoop[n] = loop;
-                        result->loops.push_back(loop);
-                    }
-                    loop->back_edge_heads.emplace(e);
-                    // reverse DFS from e to n
-
-                    std::set<T> work;
-                    work.emplace(e);
-                    while (!work.empty()) {
-                        auto crt = *work.begin();
-                        work.erase(crt);
-                        loop->body.emplace(crt);
-                        if (crt == n) continue;
-                        for (auto i : *in_edges[crt])
-                            if (loop->body.find(i) == loop->body.end()) work.emplace(i);
+        Dominators dom(*this, start);
+        const auto &index = dom.getIndex();
+
+        std::map<unsigned, Loop *> entryToLoop;
+
+        for (unsigned e = 0; e < index.size(); e++) {
+            for (auto n : index.succs[e]) {
+                if (!dom.dominatesAt(n, e)) continue;
+                // n is a loop head
+                auto loop = get(entryToLoop, n);
+                if (loop == nullptr) {
+                    loop = new Loop(index.node[n]);
+                    entryToLoop[n] = loop;
+                    result->loops.push_back(loop);
+                }
+                loop->back_edge_heads.emplace(index.node[e]);
+
+                // reverse DFS from e to n
+                bitvec body;
+                std::vector<unsigned> work{e};
+                body.setbit(e);
+                while (!work.empty()) {
+                    auto crt = work.back();
+                    work.pop_back();
+                    if (crt == n) continue;
+                    for (auto i : index.preds[crt]) {
+                        if (body.getbit(i)) continue;
+                        body.setbit(i);
+                        work.push_back(i);
                     }
                 }
+                for (auto i : body) loop->body.emplace(index.node[i]);
             }
         }
         return result;
     }
 
  protected:
-    // intersect in place
-    static void insersectWith(Set &set, Set &with) {
-        std::vector<T> toRemove;
-        for (auto e : set)
-            if (with.find(e) == with.end()) toRemove.push_back(e);
-        for (auto e : toRemove) set.erase(e);
-    }
-
     // Helper for computing strongly-connected components
-    // using Tarjan's algorithm.
+    // using Tarjan's algorithm on the dense view of the graph.
     struct sccInfo {
-        unsigned crtIndex;
-        std::vector<T> stack;
-        std::set<T> onStack;
-        std::map<T, unsigned> index;
-        std::map<T, unsigned> lowlink;
-
-        sccInfo() : crtIndex(0) {}
-        void push(T node) {
+        static constexpr unsigned none = ~0u;
+
+        Index graph;
+        unsigned crtIndex = 0;
+        std::vector<unsigned> stack;
+        std::vector<bool> onStack;
+        std::vector<unsigned> index;
+        std::vector<unsigned> lowlink;
+
+        explicit sccInfo(const CallGraph &cg)
+            : graph(cg),
+              onStack(graph.size()),
+              index(graph.size(), none),
+              lowlink(graph.size(), none) {}
+        void push(unsigned node) {
             stack.push_back(node);
-            onStack.emplace(node);
-        }
-        bool isOnStack(T node) { return onStack.count(node) != 0; }
-        bool unknown(T node) { return index.count(node) == 0; }
-        void setLowLink(T node, unsigned value) {
-            lowlink[node] = value;
-            LOG1(node << ".lowlink = " << value << " = " << get(lowlink, node));
+            onStack[node] = true;
         }
-        void setLowLink(T node, T successor) {
-            unsigned nlink = get(lowlink, node);
-            unsigned slink = get(lowlink, successor);
-            if (slink < nlink) setLowLink(node, slink);
+        bool isOnStack(unsigned node) const { return onStack[node]; }
+        bool unknown(unsigned node) const { return index[node] == none; }
+        void setLowLink(unsigned node, unsigned successor) {
+            lowlink[node] = std::min(lowlink[node], lowlink[successor]);
         }
-        T pop() {
-            T result = stack.back();
+        unsigned pop() {
+            unsigned result = stack.back();
             stack.pop_back();
-            onStack.erase(result);
+            onStack[result] = false;
             return result;
         }
     };
 
     // helper for scSort
-    bool strongConnect(T node, sccInfo &helper, std::vector<T> &out) {
+    bool strongConnect(unsigned node, sccInfo &helper, std::vector<T> &out) {
         bool loop = false;
 
-        LOG1("scc " << cgMakeString(node));
-        helper.index.emplace(node, helper.crtIndex);
-        helper.setLowLink(node, helper.crtIndex);
+        LOG1("scc " << cgMakeString(helper.graph.node[node]));
+        helper.index[node] = helper.crtIndex;
+        helper.lowlink[node] = helper.crtIndex;
         helper.crtIndex++;
         helper.push(node);
-        auto oe = out_edges[node];
-        if (oe != nullptr) {
-            for (auto next : *oe) {
-                LOG1(cgMakeString(node) << " => " << cgMakeString(next));
-                if (helper.unknown(next)) {
-                    bool l = strongConnect(next, helper, out);
-                    loop = loop | l;
-                    helper.setLowLink(node, next);
-                } else if (helper.isOnStack(next)) {
-                    helper.setLowLink(node, next);
-                    if (next == node)
-                        // the check below does not find self-loops
-                        loop = true;
-                }
+        for (auto next : helper.graph.succs[node]) {
+            LOG1(cgMakeString(helper.graph.node[node])
+                 << " => " << cgMakeString(helper.graph.node[next]));
+            if (helper.unknown(next)) {
+                bool l = strongConnect(next, helper, out);
+                loop = loop | l;
+                helper.setLowLink(node, next);
+            } else if (helper.isOnStack(next)) {
+                helper.setLowLink(node, next);
+                if (next == node)
+                    // the check below does not find self-loops
+                    loop = true;
             }
         }
 
-        if (get(helper.lowlink, node) == get(helper.index, node)) {
-            LOG1(cgMakeString(node) << " index=" << get(helper.index, node)
-                                    << " lowlink=" << get(helper.lowlink, node));
+        if (helper.lowlink[node] == helper.index[node]) {
+            LOG1(cgMakeString(helper.graph.node[node])
+                 << " index=" << helper.index[node] << " lowlink=" << helper.lowlink[node]);
             while (true) {
-                T sccMember = helper.pop();
-                LOG1("Scc order " << cgMakeString(sccMember) << "[" << cgMakeString(node) << "]");
-                out.push_back(sccMember);
+                unsigned sccMember = helper.pop();
+                LOG1("Scc order " << cgMakeString(helper.graph.node[sccMember]) << "["
+                                  << cgMakeString(helper.graph.node[node]) << "]");
+                out.push_back(helper.graph.node[sccMember]);
                 if (sccMember == node) break;
                 loop = true;
             }
@@ -328,36 +530,47 @@ class CallGraph {
         return loop;
     }
 
+    // helper for sort: strongConnect for all nodes in 'start' that are not yet in 'out'
+    bool strongConnect(const std::vector<T> &start, std::vector<T> &out) {
+        sccInfo helper(*this);
+        // Nodes that are in 'out' already are not visited again.
+        bitvec done;
+        for (auto n : out) {
+            int i = helper.graph.find(n);
+            if (i >= 0) done.setbit(i);
+        }
+        bool cycles = false;
+        for (auto n : start) {
+            int i = helper.graph.find(n);
+            if (i < 0) {
+                // not in the graph: a component by itself
+                if (std::find(out.begin(), out.end(), n) == out.end()) out.push_back(n);
+                continue;
+            }
+            if (done.getbit(i) || !helper.unknown(i)) continue;
+            bool c = strongConnect(i, helper, out);
+            cycles = cycles || c;
+        }
+        return cycles;
+    }
+
  public:
     // Sort that computes strongly-connected components - all nodes in
     // a strongly-connected components will be consecutive in the
     // sort.  Returns true if the graph contains at least one
     // cycle.  Ignores nodes not reachable from 'start'.
     bool sccSort(T start, std::vector<T> &out) {
-        sccInfo helper;
-        return strongConnect(start, helper, out);
-    }
-    bool sort(std::vector<T> &start, std::vector<T> &out) {
-        sccInfo helper;
-        bool cycles = false;
-        for (auto n : start) {
-            if (std::find(out.begin(), out.end(), n) == out.end()) {
-                bool c = strongConnect(n, helper, out);
-                cycles = cycles || c;
-            }
+        sccInfo helper(*this);
+        int i = helper.graph.find(start);
+        if (i < 0) {
+            out.push_back(start);
+            return false;
         }
-        return cycles;
+        return strongConnect(i, helper, out);
     }
+    bool sort(std::vector<T> &start, std::vector<T> &out) { return strongConnect(start, out); }
     bool sort(std::vector<T> &out) {
-        sccInfo helper;
-        bool cycles = false;
-        for (auto n : nodes) {
-            if (std::find(out.begin(), out.end(), n) == out.end()) {
-                bool c = strongConnect(n, helper, out);
-                cycles = cycles || c;
-            }
-        }
-        return cycles;
+        return strongConnect(std::vector<T>(nodes.begin(), nodes.end()), out);
     }
 };
 
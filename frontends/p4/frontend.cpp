@@ -274,11 +274,17 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
         new RemoveParserIfs(&typeMap),
         new StructInitializers(&typeMap),
         new TableKeyNames(&typeMap),
+        // The simplifications are fused into a single traversal per round, which
+        // type-checks the program once instead of before each of them.
         new PassRepeated({
-            new ConstantFolding(&typeMap, constantFoldingPolicy),
-            new StrengthReduction(&typeMap, policy->getStrengthReductionPolicy()),
-            new Reassociation(),
-            new UselessCasts(&typeMap),
+            new TypeChecking(nullptr, &typeMap, true),
+            new FusedTransforms({
+                new DoConstantFolding(&typeMap, true, constantFoldingPolicy),
+                new DoStrengthReduction(&typeMap, policy->getStrengthReductionPolicy()),
+                new Reassociation(),
+                new RemoveUselessCasts(&typeMap),
+            }),
+            new ClearTypeMap(&typeMap),
         }),
         new SimplifyControlFlow(&typeMap, policy->foldInlinedFrom()),
         new SwitchAddDefault,
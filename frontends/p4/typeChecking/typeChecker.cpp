@@ -125,7 +125,17 @@ void TypeInferenceBase::start(const IR::Node *node) {
 
 void TypeInferenceBase::finish(const IR::Node *node) {
     typeMap->updateMap(node);
-    if (node->is<IR::P4Program>()) LOG3("Typemap: " << std::endl << typeMap);
+    if (auto program = node->to<IR::P4Program>()) {
+        if (typeMap->isIncrementallyUpdated() &&
+            TypeMap::incremental == TypeMap::Incremental::Verify && ::P4::errorCount() == 0) {
+            TypeMap reference;
+            program->apply(ReadOnlyTypeInference(&reference));
+            typeMap->checkConsistentWith(reference, program);
+            LOG2("Incremental type map verified");
+        }
+        typeMap->inferenceFinished(program);
+        LOG3("Typemap: " << std::endl << typeMap);
+    }
 }
 
 ReadOnlyTypeInference *TypeInferenceBase::readOnlyClone() const {
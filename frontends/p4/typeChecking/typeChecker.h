@@ -33,8 +33,11 @@ class ClearTypeMap : public Inspector {
         // otherwise we can reuse it.  The 'force' flag is needed
         // because the program is saved only *after* typechecking,
         // so if the program changes during type-checking, the
-        // typeMap may not be complete.
-        if (force || !typeMap->checkMap(program)) typeMap->clear();
+        // typeMap may not be complete.  With incremental type checking
+        // a changed program only needs the types of the replaced nodes
+        // to be recomputed, as long as no declared type has changed.
+        if (force || (!typeMap->checkMap(program) && !typeMap->updateIncrementally(program)))
+            typeMap->clear();
         return false;  // prune()
     }
 };
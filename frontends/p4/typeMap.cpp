@@ -5,8 +5,141 @@
 
 #include "typeMap.h"
 
+#include "ir/pass_manager.h"
+
 namespace P4 {
 
+TypeMap::Incremental TypeMap::incremental = TypeMap::Incremental::Off;
+
+namespace {
+
+// True if replacing @p from with @p to leaves the types of all other nodes unchanged.
+// References to a declaration are not replaced along with it, so a replaced declaration
+// must declare the same type.  Removing a declaration is fine, as all references to it
+// must have been removed as well.
+bool keepsDeclaredTypes(const IR::Node *from, const IR::Node *to) {
+    if (!from->is<IR::IDeclaration>() || to == nullptr) return true;
+    if (from->node_type_name() != to->node_type_name()) return false;
+    if (auto f = from->to<IR::Declaration_Variable>())
+        return f->type == to->to<IR::Declaration_Variable>()->type;
+    if (auto f = from->to<IR::Declaration_Constant>()) {
+        auto t = to->to<IR::Declaration_Constant>();
+        return f->type == t->type && f->initializer == t->initializer;
+    }
+    if (auto f = from->to<IR::Declaration_Instance>()) {
+        auto t = to->to<IR::Declaration_Instance>();
+        return f->type == t->type && f->arguments == t->arguments &&
+               f->initializer == t->initializer;
+    }
+    if (auto f = from->to<IR::Parameter>()) {
+        auto t = to->to<IR::Parameter>();
+        return f->type == t->type && f->direction == t->direction;
+    }
+    if (auto f = from->to<IR::P4Control>()) {
+        auto t = to->to<IR::P4Control>();
+        return f->type == t->type && f->constructorParams == t->constructorParams;
+    }
+    if (auto f = from->to<IR::P4Parser>()) {
+        auto t = to->to<IR::P4Parser>();
+        return f->type == t->type && f->constructorParams == t->constructorParams;
+    }
+    if (auto f = from->to<IR::P4Action>())
+        return f->parameters == to->to<IR::P4Action>()->parameters;
+    if (auto f = from->to<IR::P4Table>())
+        return f->getActionList() == to->to<IR::P4Table>()->getActionList();
+    if (auto f = from->to<IR::Function>()) return f->type == to->to<IR::Function>()->type;
+    if (auto f = from->to<IR::Method>()) return f->type == to->to<IR::Method>()->type;
+    // States have no type of their own; properties are not referenced by name.
+    return from->is<IR::ParserState>() || from->is<IR::Property>();
+}
+
+// Finds references to replaced nodes in a type.
+class RefersToReplaced : public Inspector {
+    const absl::flat_hash_set<const IR::Node *> &replaced;
+    bool found = false;
+
+    bool isReplaced(const IR::Node *node) {
+        if (replaced.count(node)) found = true;
+        return found;
+    }
+    bool preorder(const IR::Node *node) override {
+        // A control or parser that has not been replaced has not changed.
+        return !isReplaced(node) && !node->is<IR::P4Control>() && !node->is<IR::P4Parser>();
+    }
+    bool preorder(const IR::Type_Table *type) override {
+        return !isReplaced(type) && !isReplaced(type->table);
+    }
+    bool preorder(const IR::Type_ActionEnum *type) override {
+        return !isReplaced(type) && !isReplaced(type->actionList);
+    }
+
+ public:
+    explicit RefersToReplaced(const absl::flat_hash_set<const IR::Node *> &replaced)
+        : replaced(replaced) {}
+    bool check(const IR::Type *type) {
+        type->apply(*this);
+        return found;
+    }
+};
+
+// True if the type contains type variables, which are fresh in every type inference.
+bool hasTypeVariables(const IR::Type *type) {
+    bool found = false;
+    forAllMatching<IR::Type>(type,
+                             [&](const IR::Type *t) { found = found || t->is<IR::ITypeVar>(); });
+    return found;
+}
+
+}  // namespace
+
+/// Records the nodes replaced in the program since the type map was last computed from
+/// scratch, as reported by the passes run by PassManagers.
+class TypeMap::ChangeTracker : public ProgramChangeObserver {
+ public:
+    /// The latest program reached from the one the map was computed for through recorded
+    /// changes; nullptr when not tracking.
+    const IR::Node *program = nullptr;
+    /// Set when a change could not be recorded or changed a declared type; the map then
+    /// has to be cleared.
+    bool broken = false;
+    std::vector<std::pair<const IR::Node *, const IR::Node *>> replaced;
+
+    ~ChangeTracker() override { ProgramChangeObserver::remove(this); }
+
+    void start(const IR::P4Program *p) {
+        program = p;
+        ProgramChangeObserver::add(this);
+    }
+    void reset() {
+        ProgramChangeObserver::remove(this);
+        program = nullptr;
+        broken = false;
+        replaced.clear();
+    }
+    void breakChain() {
+        LOG2("TypeMap: lost track of program changes");
+        reset();
+        broken = true;
+    }
+
+    void nodeReplaced(const IR::Node *from, const IR::Node *to) override {
+        if (!keepsDeclaredTypes(from, to)) {
+            LOG2("TypeMap: declared type changed by replacing " << dbp(from));
+            breakChain();
+            return;
+        }
+        if (from == program) program = to;
+        replaced.emplace_back(from, to);
+    }
+    void passFinished(const IR::Node *, const IR::Node *after) override {
+        if (after != program) breakChain();
+    }
+};
+
+TypeMap::TypeMap() : ProgramMap("TypeMap"), strictStruct(false) {}
+
+TypeMap::~TypeMap() = default;
+
 bool TypeMap::typeIsEmpty(const IR::Type *type) const {
     if (auto bt = type->to<IR::Type_Bits>()) {
         return bt->size == 0;
@@ -76,9 +209,103 @@ void TypeMap::clear() {
     constants.clear();
     allTypeVariables.clear();
     program = nullptr;
+    if (tracker) tracker->reset();
+    incrementallyUpdated = false;
     ProgramMap::clear();
 }
 
+void TypeMap::inferenceFinished(const IR::P4Program *program) {
+    incrementallyUpdated = false;
+    if (incremental == Incremental::Off) return;
+    if (!tracker) tracker = std::make_unique<ChangeTracker>();
+    if (tracker->broken) return;
+    if (tracker->program == nullptr)
+        tracker->start(program);
+    else if (tracker->program != program)
+        tracker->breakChain();
+}
+
+bool TypeMap::updateIncrementally(const IR::P4Program *program) {
+    if (incremental == Incremental::Off || !tracker || tracker->program != program) return false;
+
+    // References to a replaced control, parser or table that declares the same type are
+    // redirected to its replacement.  Any other reference to a replaced node from a type
+    // makes the type stale.
+    absl::flat_hash_map<const IR::Node *, const IR::Node *> replacement;
+    absl::flat_hash_set<const IR::Node *> replaced;
+    for (auto [from, to] : tracker->replaced) {
+        replacement[from] = to;
+        replaced.insert(from);
+    }
+    auto latest = [&](const IR::Node *node) {
+        // Bounded, as a node may be replaced and later restored.
+        for (size_t i = 0; i <= replacement.size(); ++i) {
+            auto it = replacement.find(node);
+            if (it == replacement.end() || it->second == nullptr) break;
+            node = it->second;
+        }
+        return node;
+    };
+    absl::flat_hash_map<const IR::Type *, const IR::Type *> redirected;
+    RefersToReplaced refersToReplaced(replaced);
+    for (auto &[node, type] : typeMap) {
+        auto [it, inserted] = redirected.emplace(type, type);
+        if (inserted) {
+            const IR::Type *result = type;
+            if (type->is<IR::P4Control>() || type->is<IR::P4Parser>()) {
+                result = latest(type)->to<IR::Type>();
+            } else if (auto tt = type->to<IR::Type_Type>()) {
+                if (tt->type->is<IR::P4Control>() || tt->type->is<IR::P4Parser>()) {
+                    auto inner = latest(tt->type)->to<IR::Type>();
+                    if (inner != tt->type) result = new IR::Type_Type(inner);
+                }
+            } else if (auto tt = type->to<IR::Type_Table>()) {
+                auto table = latest(tt->table)->to<IR::P4Table>();
+                if (table != tt->table) result = new IR::Type_Table(table);
+            }
+            if (refersToReplaced.check(result)) {
+                LOG2("TypeMap: " << dbp(type) << " refers to a replaced node");
+                return false;
+            }
+            it->second = result;
+        }
+        type = it->second;
+    }
+
+    for (auto [from, to] : tracker->replaced) {
+        typeMap.erase(from);
+        if (auto expression = from->to<IR::Expression>()) {
+            leftValues.erase(expression);
+            constants.erase(expression);
+        }
+    }
+    LOG2("TypeMap updated incrementally, dropping " << tracker->replaced.size()
+                                                    << " replaced nodes");
+    tracker->replaced.clear();
+    incrementallyUpdated = true;
+    return true;
+}
+
+void TypeMap::checkConsistentWith(const TypeMap &reference, const IR::Node *program) const {
+    forAllMatching<IR::Node>(program, [&](const IR::Node *node) {
+        auto type = get(reference.typeMap, node);
+        if (type == nullptr) return;
+        auto mine = get(typeMap, node);
+        BUG_CHECK(mine != nullptr, "Incremental type map has no type for %1%", dbp(node));
+        if (!hasTypeVariables(type))
+            BUG_CHECK(equivalent(mine, type, true),
+                      "Incremental type map has type %1% for %2% instead of %3%", mine,
+                      dbp(node), type);
+        if (auto expression = node->to<IR::Expression>()) {
+            BUG_CHECK(isLeftValue(expression) == reference.isLeftValue(expression),
+                      "Incremental type map disagrees on left value %1%", dbp(node));
+            BUG_CHECK(isCompileTimeConstant(expression) ==
+                          reference.isCompileTimeConstant(expression),
+                      "Incremental type map disagrees on constant %1%", dbp(node));
+        }
+    });
+}
+
 void TypeMap::checkPrecondition(const IR::Node *element, const IR::Type *type) const {
     CHECK_NULL(element);
     CHECK_NULL(type);
@@ -321,25 +548,57 @@ bool TypeMap::implicitlyConvertibleTo(const IR::Type *from, const IR::Type *to)
     return false;
 }
 
-// Used for tuples, stacks and lists only
-const IR::Type *TypeMap::getCanonical(const IR::Type *type) {
-    // Currently a linear search; hopefully this won't be too expensive in practice
-    std::vector<const IR::Type *> *searchIn;
-    if (type->is<IR::Type_Array>())
-        searchIn = &canonicalStacks;
-    else if (type->is<IR::Type_Tuple>())
-        searchIn = &canonicalTuples;
-    else if (type->is<IR::Type_List>())
-        searchIn = &canonicalLists;
-    else if (type->is<IR::Type_P4List>())
-        searchIn = &canonicalP4lists;
-    else
-        BUG("%1%: unexpected type", type);
+// Must only use properties of the type that equivalent(strict = true) compares.
+// Kinds whose equivalence is more involved are only hashed by their node type;
+// equivalent() tells them apart within a bucket.
+size_t TypeMap::structuralHash(const IR::Type *type) const {
+    if (type == nullptr) return 0;
+    Util::Hash hash;
+    size_t result = hash(type->node_type_name());
+    if (auto tb = type->to<IR::Type_Bits>())
+        return Util::hash_combine(result, hash(tb->size, tb->isSigned));
+    if (auto tv = type->to<IR::Type_Varbits>()) return Util::hash_combine(result, hash(tv->size));
+    if (auto tt = type->to<IR::Type_Type>())
+        return Util::hash_combine(result, structuralHash(tt->type));
+    if (auto ta = type->to<IR::Type_Array>()) {
+        result = Util::hash_combine(result, structuralHash(ta->elementType));
+        if (ta->sizeKnown()) result = Util::hash_combine(result, hash(ta->getSize()));
+        return result;
+    }
+    if (auto tl = type->to<IR::Type_P4List>())
+        return Util::hash_combine(result, structuralHash(tl->elementType));
+    if (auto ts = type->to<IR::Type_Set>())
+        return Util::hash_combine(result, structuralHash(ts->elementType));
+    if (auto te = type->to<IR::Type_Enum>()) return Util::hash_combine(result, hash(te->name.name));
+    if (auto te = type->to<IR::Type_SerEnum>())
+        return Util::hash_combine(result, hash(te->name.name));
+    if (auto te = type->to<IR::Type_Extern>())
+        return Util::hash_combine(result, hash(te->name.name));
+    if (auto sl = type->to<IR::Type_StructLike>()) {
+        if (!sl->is<IR::Type_UnknownStruct>())
+            result = Util::hash_combine(result, hash(sl->name.name));
+        for (auto f : sl->fields)
+            result = Util::hash_combine(result, hash(f->name.name, structuralHash(f->type)));
+        return result;
+    }
+    if (auto bl = type->to<IR::Type_BaseList>()) {
+        for (auto c : bl->components) result = Util::hash_combine(result, structuralHash(c));
+        return result;
+    }
+    if (auto sc = type->to<IR::Type_SpecializedCanonical>()) {
+        result = Util::hash_combine(result, structuralHash(sc->baseType));
+        for (auto a : *sc->arguments) result = Util::hash_combine(result, structuralHash(a));
+        return result;
+    }
+    return result;
+}
 
-    for (auto t : *searchIn) {
+const IR::Type *TypeMap::getCanonical(const IR::Type *type) {
+    auto &bucket = canonicalTypes[structuralHash(type)];
+    for (auto t : bucket) {
         if (equivalent(type, t, true)) return t;
     }
-    searchIn->push_back(type);
+    bucket.push_back(type);
     return type;
 }
 
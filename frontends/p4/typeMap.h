@@ -8,6 +8,8 @@
 #ifndef FRONTENDS_P4_TYPEMAP_H_
 #define FRONTENDS_P4_TYPEMAP_H_
 
+#include <memory>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "frontends/common/programMap.h"
@@ -32,10 +34,9 @@ Objects that have a type in the map:
 class TypeMap final : public ProgramMap {
     // We want to have the same canonical type for two
     // different tuples, lists, stacks, or p4lists with the same signature.
-    std::vector<const IR::Type *> canonicalTuples;
-    std::vector<const IR::Type *> canonicalStacks;
-    std::vector<const IR::Type *> canonicalP4lists;
-    std::vector<const IR::Type *> canonicalLists;
+    // Canonical types are bucketed by structuralHash(); types in a bucket
+    // are distinguished by strict equivalence.
+    absl::flat_hash_map<size_t, std::vector<const IR::Type *>> canonicalTypes;
 
     // Map each node to its canonical type
     absl::flat_hash_map<const IR::Node *, const IR::Type *, Util::Hash> typeMap;
@@ -48,12 +49,33 @@ class TypeMap final : public ProgramMap {
     // For each type variable in the program the actual
     // type that is substituted for it.
     TypeVariableSubstitution allTypeVariables;
+    // Changes to the program since the map was last computed from scratch;
+    // only used with incremental type checking.
+    class ChangeTracker;
+    std::unique_ptr<ChangeTracker> tracker;
+    // Set by updateIncrementally(), until the next type inference finishes.
+    bool incrementallyUpdated = false;
 
     // checks some preconditions before setting the type
     void checkPrecondition(const IR::Node *element, const IR::Type *type) const;
+    /// A hash of the structure of @p type that is consistent with
+    /// equivalent(strict = true): equivalent types have equal hashes.
+    size_t structuralHash(const IR::Type *type) const;
 
  public:
-    TypeMap() : ProgramMap("TypeMap"), strictStruct(false) {}
+    /// How ClearTypeMap treats a program that has changed since the map was computed.
+    enum class Incremental {
+        /// Clear the map.
+        Off,
+        /// Keep the map if the changes are known and leave all declared types unchanged.
+        On,
+        /// As On, and check the next type inference against one from scratch.
+        Verify
+    };
+    static Incremental incremental;
+
+    TypeMap();
+    ~TypeMap() override;
 
     /// If true we require structs to have the same name to be
     /// equivalent, if false only that the have the same fields.
@@ -90,7 +112,10 @@ class TypeMap final : public ProgramMap {
     /// is used when initializing a struct with a list expression.
     bool implicitlyConvertibleTo(const IR::Type *from, const IR::Type *to) const;
 
-    // Used for tuples and stacks only
+    /// Returns the canonical representative of all types strictly equivalent
+    /// to @p type, making @p type the representative if there is none yet.
+    /// Used for tuples, stacks and lists, whose canonical types can then be
+    /// compared by pointer.
     const IR::Type *getCanonical(const IR::Type *type);
     /// The width in bits of this type.  If the width is not
     /// well-defined this will report an error and return -1.
@@ -99,6 +124,19 @@ class TypeMap final : public ProgramMap {
 
     /// True is type occupies no storage.
     bool typeIsEmpty(const IR::Type *type) const;
+
+    /// Called when type inference of @p program finishes; with incremental type
+    /// checking, starts recording the changes made to @p program.
+    void inferenceFinished(const IR::P4Program *program);
+    /// If all changes from the program the map was computed for to @p program have been
+    /// recorded, and none changed a declared type, forget the types of the replaced nodes
+    /// and return true. The next type inference then only visits the replaced subtrees.
+    bool updateIncrementally(const IR::P4Program *program);
+    /// True if updateIncrementally() succeeded since the last type inference.
+    bool isIncrementallyUpdated() const { return incrementallyUpdated; }
+    /// BUG if this map disagrees with @p reference, which was computed from scratch for
+    /// @p program, on any node of @p program.
+    void checkConsistentWith(const TypeMap &reference, const IR::Node *program) const;
 };
 }  // namespace P4
 
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IR_ANALYSIS_CACHE_H_
+#define IR_ANALYSIS_CACHE_H_
+
+#include <utility>
+
+#include "absl/container/node_hash_map.h"
+#include "ir/node.h"
+#include "ir/pass_manager.h"
+
+namespace P4 {
+
+/// Caches the results of an analysis of IR subtrees, keyed on the root of the subtree.
+/// IR nodes are not changed once built, so an analysis whose result only depends on the
+/// subtree can reuse it for as long as the node exists; passes that are repeated (e.g. in
+/// a PassRepeated) only pay for the subtrees that changed in between.
+///
+/// The cache drops the result for a node when a Transform or Modifier run by a PassManager
+/// replaces the node, and all results when a pass changes the program in some other way.
+/// It observes program changes from its construction to its destruction, and keeps the
+/// nodes it has results for alive, so it should be owned by the pass that uses it and be
+/// freed once that pass is done, e.g. when the PassRepeated it is part of ends, not live for
+/// the whole compilation. Analyses whose results depend on anything outside the subtree
+/// (declarations, type maps, the visiting context) must only use it while that stays the same.
+template <class Result>
+class AnalysisCache final : public ProgramChangeObserver {
+    absl::node_hash_map<const IR::Node *, Result> results;
+    /// The replacement reported last; a pass that changes the program and does not end
+    /// with reporting the replacement of its root has made unreported changes.
+    const IR::Node *lastReplacement = nullptr;
+    size_t maxSize;
+
+ public:
+    /// The cache is cleared when it holds @p maxSize results.
+    explicit AnalysisCache(size_t maxSize = 1 << 20) : maxSize(maxSize) {
+        ProgramChangeObserver::add(this);
+    }
+    ~AnalysisCache() override { ProgramChangeObserver::remove(this); }
+    AnalysisCache(const AnalysisCache &) = delete;
+    AnalysisCache &operator=(const AnalysisCache &) = delete;
+
+    /// @return the cached result for @p node, or nullptr.
+    const Result *find(const IR::Node *node) const {
+        auto it = results.find(node);
+        return it == results.end() ? nullptr : &it->second;
+    }
+
+    /// @return the result for @p node, calling @p compute(node) unless it is cached.
+    /// The reference stays valid until @p node is replaced or the cache is cleared.
+    template <typename Compute>
+    const Result &get(const IR::Node *node, Compute &&compute) {
+        if (auto *result = find(node)) return *result;
+        // Computing may use the cache as well, so only insert when done.
+        Result result = compute(node);
+        if (results.size() >= maxSize) results.clear();
+        return results.emplace(node, std::move(result)).first->second;
+    }
+
+    /// @return the (default-constructed if absent) result for @p node, for analyses that
+    /// fill in results piecewise.
+    Result &operator[](const IR::Node *node) {
+        if (results.size() >= maxSize && !results.count(node)) results.clear();
+        return results[node];
+    }
+
+    size_t size() const { return results.size(); }
+    void clear() { results.clear(); }
+
+    void nodeReplaced(const IR::Node *from, const IR::Node *to) override {
+        results.erase(from);
+        lastReplacement = to;
+    }
+    void passFinished(const IR::Node *before, const IR::Node *after) override {
+        if (before != after && after != lastReplacement) clear();
+    }
+};
+
+}  // namespace P4
+
+#endif /* IR_ANALYSIS_CACHE_H_ */
@@ -0,0 +1,415 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IR_BINARY_READER_H_
+#define IR_BINARY_READER_H_
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ir.h"
+#include "json_loader.h"
+#include "lib/big_int.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/exceptions.h"
+#include "lib/hash.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/map.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+#include "lib/source_file.h"
+#include "lib/string_map.h"
+
+namespace P4 {
+
+/// Reads IR trees written by BinaryWriter from memory; see there for the encoding. The
+/// generated `Class(BinaryReader &)` constructors read the fields in declaration order.
+/// Malformed input is reported by throwing a Util::CompilationError.
+class BinaryReader {
+    template <typename T, typename = void>
+    struct has_fromBinary : std::false_type {};
+    template <typename T>
+    struct has_fromBinary<T, std::void_t<decltype(&T::fromBinary)>> : std::true_type {};
+    template <typename T, typename = void>
+    struct has_fromJSON : std::false_type {};
+    template <typename T>
+    struct has_fromJSON<T, std::void_t<decltype(&T::fromJSON)>> : std::true_type {};
+    template <typename T>
+    static constexpr bool always_false = false;
+
+    const char *begin;
+    const char *pos;
+    const char *end;
+    std::vector<cstring> strings;
+    std::vector<const IR::Node *> nodes;
+    std::vector<const Util::InputSources *> sources;
+    absl::flat_hash_map<cstring, BinaryNodeFactoryFn, Util::Hash> factories;
+
+ public:
+    BinaryReader(const char *data, size_t size) : begin(data), pos(data), end(data + size) {}
+    BinaryReader(const BinaryReader &) = delete;
+    BinaryReader &operator=(const BinaryReader &) = delete;
+
+    bool atEnd() const { return pos == end; }
+
+    [[noreturn]] void fail(const char *msg) const {
+        throw Util::CompilationError("Invalid binary IR at offset %1%: %2%", pos - begin, msg);
+    }
+
+    uint8_t readByte() {
+        if (pos == end) fail("unexpected end of data");
+        return static_cast<uint8_t>(*pos++);
+    }
+    void readBytes(void *data, size_t size) {
+        if (size > static_cast<size_t>(end - pos)) fail("unexpected end of data");
+        memcpy(data, pos, size);
+        pos += size;
+    }
+    uint64_t readUnsigned() {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = readByte();
+            v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+        fail("varint too long");
+    }
+    int64_t readSigned() {
+        uint64_t v = readUnsigned();
+        return static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1));
+    }
+
+    cstring readString() {
+        uint64_t tag = readUnsigned();
+        if (tag == 0) return cstring();
+        if (tag >= 2) {
+            if (tag - 2 >= strings.size()) fail("invalid string reference");
+            return strings[tag - 2];
+        }
+        uint64_t size = readUnsigned();
+        if (size > static_cast<uint64_t>(end - pos)) fail("unexpected end of data");
+        strings.emplace_back(std::string_view(pos, size));
+        pos += size;
+        return strings.back();
+    }
+
+    /// Reads a node. @p factory is used for types that are not in IR::binary_unpacker_table,
+    /// i.e. the instances of the IR::Vector, IR::IndexedVector and IR::NameMap templates.
+    const IR::Node *readNode(BinaryNodeFactoryFn factory = nullptr) {
+        uint64_t tag = readUnsigned();
+        if (tag == 0) return nullptr;
+        if (tag >= 2) {
+            // A node still being read can not be referenced: the IR is acyclic.
+            if (tag - 2 >= nodes.size() || !nodes[tag - 2]) fail("invalid node reference");
+            return nodes[tag - 2];
+        }
+        cstring type = readString();
+        auto [it, inserted] = factories.emplace(type, nullptr);
+        if (inserted) it->second = get(IR::binary_unpacker_table, type);
+        if (it->second) factory = it->second;
+        if (!factory) fail(("no binary factory for " + type).c_str());
+        size_t index = nodes.size();
+        nodes.push_back(nullptr);
+        const IR::Node *node = factory(*this);
+        nodes[index] = node;
+        return node;
+    }
+
+    /// Reads a node of type @p T, failing if the data has a node of another type there.
+    template <typename T>
+    const T *readNodeAs() {
+        const IR::Node *node = readNode(factoryFor<T>());
+        if (!node) return nullptr;
+        const T *result = node->to<T>();
+        if (!result) fail(("unexpected node type " + node->node_type_name()).c_str());
+        return result;
+    }
+
+    Util::SourceInfo readSourceInfo() {
+        Util::SourceInfo si;
+        uint8_t kind = readByte();
+        if (kind > 3) fail("invalid source info");
+        if (kind & 1) {
+            const auto *in = readSources();
+            auto start = readSourcePosition(in);
+            auto end = readSourcePosition(in);
+            if (end < start) fail("invalid source range");
+            si = Util::SourceInfo(in, start, end);
+        }
+        if (kind & 2) {
+            si.filename = readString();
+            read(si.line);
+            read(si.column);
+            si.srcBrief = readString();
+        }
+        return si;
+    }
+
+    template <typename T>
+    void read(T &v) {
+        if constexpr (std::is_same_v<T, bool>) {
+            v = readByte() != 0;
+        } else if constexpr (std::is_enum_v<T>) {
+            std::underlying_type_t<T> u;
+            read(u);
+            v = static_cast<T>(u);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            v = static_cast<T>(readSigned());
+        } else if constexpr (std::is_integral_v<T>) {
+            v = static_cast<T>(readUnsigned());
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double d;
+            readBytes(&d, sizeof(d));
+            v = d;
+        } else if constexpr (std::is_same_v<T, cstring>) {
+            v = readString();
+        } else if constexpr (std::is_same_v<T, IR::ID>) {
+            v.name = readString();
+            v.originalName = readString();
+        } else if constexpr (std::is_same_v<T, Util::SourceInfo>) {
+            v = readSourceInfo();
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            uint64_t size = readUnsigned();
+            if (size > static_cast<uint64_t>(end - pos)) fail("unexpected end of data");
+            v.assign(pos, size);
+            pos += size;
+        } else if constexpr (std::is_same_v<T, big_int>) {
+            readBigInt(v);
+        } else if constexpr (std::is_same_v<T, bitvec>) {
+            v.clear();
+            uint64_t words = readUnsigned();
+            for (uint64_t i = 0; i < words; ++i) v.putrange(i * 64, 64, readUnsigned());
+        } else if constexpr (std::is_same_v<T, match_t>) {
+            read(v.word0);
+            read(v.word1);
+        } else if constexpr (std::is_same_v<T, LTBitMatrix>) {
+            std::string str;
+            read(str);
+            str.c_str() >> v;
+        } else if constexpr (std::is_array_v<T>) {
+            for (auto &el : v) read(el);
+        } else if constexpr (std::is_pointer_v<T>) {
+            readPointer(v);
+        } else if constexpr (std::is_base_of_v<IR::INode, T>) {
+            const T *node = readNodeAs<T>();
+            if (!node) fail("missing inline node");
+            v = *node;
+        } else if constexpr (std::is_constructible_v<T, BinaryReader &>) {
+            v = T(*this);
+        } else if constexpr (has_fromJSON<T>::value) {
+            std::string json;
+            read(json);
+            std::istringstream in(json);
+            JSONLoader(in) >> v;
+        } else {
+            static_assert(always_false<T>, "no binary encoding for type");
+        }
+    }
+
+    template <typename T, typename A>
+    void read(std::vector<T, A> &v) {
+        v.clear();
+        for (uint64_t n = readUnsigned(); n > 0; --n) {
+            T el;
+            read(el);
+            v.push_back(std::move(el));
+        }
+    }
+    template <typename T, typename A>
+    void read(safe_vector<T, A> &v) {
+        v.clear();
+        for (uint64_t n = readUnsigned(); n > 0; --n) {
+            T el;
+            read(el);
+            v.push_back(std::move(el));
+        }
+    }
+    template <typename T, typename C, typename A>
+    void read(std::set<T, C, A> &v) {
+        readInto<T>(v);
+    }
+    template <typename T, typename C, typename A>
+    void read(ordered_set<T, C, A> &v) {
+        readInto<T>(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void read(std::map<K, V, C, A> &v) {
+        readInto<std::pair<K, V>>(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void read(std::multimap<K, V, C, A> &v) {
+        readInto<std::pair<K, V>>(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void read(ordered_map<K, V, C, A> &v) {
+        readInto<std::pair<K, V>>(v);
+    }
+    template <typename V>
+    void read(string_map<V> &v) {
+        readInto<std::pair<cstring, V>>(v);
+    }
+    template <typename T, typename U>
+    void read(std::pair<T, U> &v) {
+        read(v.first);
+        read(v.second);
+    }
+    template <typename T>
+    void read(std::optional<T> &v) {
+        if (!readByte()) {
+            v = std::nullopt;
+            return;
+        }
+        T value;
+        read(value);
+        v = std::move(value);
+    }
+    template <typename... Types>
+    void read(std::variant<Types...> &v) {
+        readVariant<0>(readUnsigned(), v);
+    }
+
+ private:
+    template <typename T>
+    static BinaryNodeFactoryFn factoryFor() {
+        if constexpr (has_fromBinary<T>::value)
+            return BinaryNodeFactoryFn(&T::fromBinary);
+        else
+            return nullptr;
+    }
+
+    template <typename T>
+    void readPointer(T *&v) {
+        using U = std::remove_const_t<T>;
+        if constexpr (std::is_base_of_v<IR::INode, U>) {
+            v = const_cast<U *>(readNodeAs<U>());
+        } else if (!readByte()) {
+            v = nullptr;
+        } else if constexpr (std::is_constructible_v<U, BinaryReader &>) {
+            v = new U(*this);
+        } else {
+            auto *value = new U();
+            read(*value);
+            v = value;
+        }
+    }
+
+    /// Positions are checked against the lines of @p in, as diagnostics quote them.
+    Util::SourcePosition readSourcePosition(const Util::InputSources *in) {
+        uint64_t line = readUnsigned();
+        uint64_t column = readUnsigned();
+        if (line == 0 || line > in->contents.size() || column > in->contents[line - 1].size())
+            fail("invalid source position");
+        return Util::SourcePosition(line, column);
+    }
+
+    const Util::InputSources *readSources() {
+        uint64_t tag = readUnsigned();
+        if (tag >= 2) {
+            if (tag - 2 >= sources.size()) fail("invalid source reference");
+            return sources[tag - 2];
+        }
+        if (tag != 1) fail("invalid source reference");
+        auto *in = new Util::InputSources;
+        read(in->sealed);
+        read(in->contents);
+        if (in->contents.empty()) fail("source without lines");
+        in->line_file_map.clear();
+        for (uint64_t n = readUnsigned(); n > 0; --n) {
+            uint64_t line = readUnsigned();
+            cstring file = readString();
+            uint64_t sourceLine = readUnsigned();
+            if (line > UINT_MAX || sourceLine > UINT_MAX) fail("invalid source line");
+            in->line_file_map.emplace(line, Util::SourceFileLine(file.string_view(), sourceLine));
+        }
+        // Line 0 is always mapped, so that every line has a source file.
+        if (!in->line_file_map.count(0)) fail("source without line mapping");
+        sources.push_back(in);
+        return in;
+    }
+
+    template <typename E, typename C>
+    void readInto(C &v) {
+        v.clear();
+        for (uint64_t n = readUnsigned(); n > 0; --n) {
+            E el;
+            read(el);
+            v.insert(std::move(el));
+        }
+    }
+
+    template <size_t N, typename Variant>
+    void readVariant(uint64_t index, Variant &v) {
+        if constexpr (N == std::variant_size_v<Variant>) {
+            fail("invalid variant index");
+        } else if (index == N) {
+            read(v.template emplace<N>());
+        } else {
+            readVariant<N + 1>(index, v);
+        }
+    }
+
+    void readBigInt(big_int &v) {
+        uint8_t kind = readByte();
+        if (kind == 0) {
+            v = readSigned();
+            return;
+        }
+        if (kind > 2) fail("invalid big integer");
+        uint64_t size = readUnsigned();
+        if (size > static_cast<uint64_t>(end - pos)) fail("unexpected end of data");
+        auto *bytes = reinterpret_cast<const uint8_t *>(pos);
+        boost::multiprecision::import_bits(v, bytes, bytes + size, 8);
+        pos += size;
+        if (kind == 2) v = -v;
+    }
+};
+
+template <class T>
+IR::Vector<T>::Vector(BinaryReader &in) : VectorBase(in) {
+    in.read(vec);
+}
+template <class T>
+IR::Node *IR::Vector<T>::fromBinary(BinaryReader &in) {
+    return new Vector<T>(in);
+}
+template <class T>
+IR::IndexedVector<T>::IndexedVector(BinaryReader &in) : Vector<T>(in) {
+    in.read(declarations);
+}
+template <class T>
+IR::Node *IR::IndexedVector<T>::fromBinary(BinaryReader &in) {
+    return new IndexedVector<T>(in);
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC>::NameMap(BinaryReader &in) : Node(in) {
+    in.read(symbols);
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::Node *IR::NameMap<T, MAP, COMP, ALLOC>::fromBinary(BinaryReader &in) {
+    return new IR::NameMap<T, MAP, COMP, ALLOC>(in);
+}
+
+}  // namespace P4
+
+#endif /* IR_BINARY_READER_H_ */
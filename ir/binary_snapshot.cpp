@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ir/binary_snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+
+#include "ir/binary_reader.h"
+#include "ir/binary_writer.h"
+#include "ir/ir.h"
+#include "lib/error.h"
+
+namespace P4 {
+
+namespace {
+
+constexpr char snapshotMagic[8] = {'P', '4', 'C', 'I', 'R', 'B', 'I', 'N'};
+constexpr uint64_t snapshotVersion = 2;
+
+}  // namespace
+
+void writeBinarySnapshot(std::ostream &out, const IR::Node *node) {
+    BinaryWriter writer(out);
+    writer.writeBytes(snapshotMagic, sizeof(snapshotMagic));
+    writer.writeUnsigned(snapshotVersion);
+    writer.writeUnsigned(IR::binary_schema);
+    writer.writeNode(node);
+}
+
+bool saveBinarySnapshot(const std::filesystem::path &path, const IR::Node *node) {
+    std::ofstream out(path, std::ios::binary);
+    if (out) writeBinarySnapshot(out, node);
+    if (!out) {
+        ::P4::error(ErrorType::ERR_IO, "Can't write %s", path);
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+/// Reads a snapshot, throwing a Util::CompilationError if it is not valid.
+const IR::Node *parseSnapshot(const char *data, size_t size) {
+    BinaryReader reader(data, size);
+    char magic[sizeof(snapshotMagic)];
+    reader.readBytes(magic, sizeof(magic));
+    if (memcmp(magic, snapshotMagic, sizeof(magic)) != 0) reader.fail("not a binary IR snapshot");
+    if (reader.readUnsigned() != snapshotVersion) reader.fail("unsupported snapshot version");
+    if (reader.readUnsigned() != IR::binary_schema)
+        reader.fail("snapshot was written by a compiler with a different IR");
+    const IR::Node *node = reader.readNode();
+    if (!reader.atEnd()) reader.fail("trailing data after snapshot");
+    return node;
+}
+
+}  // namespace
+
+const IR::Node *readBinarySnapshot(const char *data, size_t size) {
+    try {
+        return parseSnapshot(data, size);
+    } catch (const Util::CompilationError &e) {
+        ::P4::error(ErrorType::ERR_INVALID, "%s", e.what());
+        return nullptr;
+    }
+}
+
+const IR::Node *tryReadBinarySnapshot(const char *data, size_t size) {
+    try {
+        return parseSnapshot(data, size);
+    } catch (const Util::CompilationError &) {
+        return nullptr;
+    }
+}
+
+const IR::Node *loadBinarySnapshot(const std::filesystem::path &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        if (fd >= 0) close(fd);
+        ::P4::error(ErrorType::ERR_IO, "Can't open %s", path);
+        return nullptr;
+    }
+    size_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        ::P4::error(ErrorType::ERR_INVALID, "%s: empty binary IR snapshot", path);
+        return nullptr;
+    }
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        ::P4::error(ErrorType::ERR_IO, "Can't map %s", path);
+        return nullptr;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    // Strings are interned and nodes built on the heap, so nothing refers to the mapping
+    // once the snapshot has been read.
+    const IR::Node *node = readBinarySnapshot(static_cast<const char *>(data), size);
+    munmap(data, size);
+    return node;
+}
+
+}  // namespace P4
@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IR_BINARY_SNAPSHOT_H_
+#define IR_BINARY_SNAPSHOT_H_
+
+#include <filesystem>
+#include <iosfwd>
+
+#include "ir/node.h"
+
+/// @file
+/// @brief Binary IR snapshots (--toBinary / --fromBinary).
+///
+/// A snapshot is an 8-byte magic string, the format version and the IR::binary_schema of the
+/// compiler that wrote it (both as varints), followed by the root node in the encoding of
+/// BinaryWriter. It is much smaller and faster to write and read than the JSON dump, at the
+/// price of only being readable by a compiler built from the same IR definition.
+
+namespace P4 {
+
+/// Writes a snapshot of @p node to @p out.
+void writeBinarySnapshot(std::ostream &out, const IR::Node *node);
+
+/// Writes a snapshot of @p node to the file @p path. Reports an error and returns false if
+/// the file can not be written.
+bool saveBinarySnapshot(const std::filesystem::path &path, const IR::Node *node);
+
+/// Reads a snapshot from @p size bytes at @p data. Reports an error and returns nullptr if the
+/// data is not a valid snapshot for this compiler.
+const IR::Node *readBinarySnapshot(const char *data, size_t size);
+
+/// Like readBinarySnapshot, but returns nullptr without reporting an error if the data is not
+/// a valid snapshot, for callers that treat such data as absent.
+const IR::Node *tryReadBinarySnapshot(const char *data, size_t size);
+
+/// Reads a snapshot from the file @p path, which is mapped into memory rather than read.
+/// Reports an error and returns nullptr on failure.
+const IR::Node *loadBinarySnapshot(const std::filesystem::path &path);
+
+}  // namespace P4
+
+#endif /* IR_BINARY_SNAPSHOT_H_ */
@@ -0,0 +1,305 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IR_BINARY_WRITER_H_
+#define IR_BINARY_WRITER_H_
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ir/id.h"
+#include "ir/json_generator.h"
+#include "ir/node.h"
+#include "lib/big_int.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/hash.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+#include "lib/source_file.h"
+#include "lib/string_map.h"
+
+namespace P4 {
+
+/// Writes IR trees in the compact binary format read by BinaryReader; see ir/binary_snapshot.h
+/// for the file format around it. The encoding is driven by the generated toBinary methods,
+/// which write the fields of each class in declaration order, without names:
+///  - unsigned integers are LEB128 varints, signed integers zigzag-encoded varints;
+///  - each distinct cstring is written once, and later occurrences refer to it by index;
+///  - each distinct node is written once, with its type name, and later occurrences refer to
+///    it by index, so shared subtrees remain shared when read back;
+///  - values of types that only have toJSON/fromJSON methods are embedded as JSON text;
+///  - source positions refer to their InputSources, whose lines are written once, so that
+///    diagnostics for a tree read back can quote the program. Its comments are not saved.
+class BinaryWriter {
+    template <typename T, typename = void>
+    struct has_toBinary : std::false_type {};
+    template <typename T>
+    struct has_toBinary<T, std::void_t<decltype(std::declval<const T &>().toBinary(
+                               std::declval<BinaryWriter &>()))>> : std::true_type {};
+    template <typename T, typename = void>
+    struct has_toJSON : std::false_type {};
+    template <typename T>
+    struct has_toJSON<T, std::void_t<decltype(std::declval<const T &>().toJSON(
+                             std::declval<JSONGenerator &>()))>> : std::true_type {};
+    template <typename T>
+    static constexpr bool always_false = false;
+
+    std::ostream &out;
+    std::string buffer;
+    absl::flat_hash_map<cstring, uint64_t, Util::Hash> strings;
+    absl::flat_hash_map<const IR::Node *, uint64_t> nodes;
+    absl::flat_hash_map<const Util::InputSources *, uint64_t> sources;
+
+    static constexpr size_t flushSize = 1 << 16;
+
+ public:
+    explicit BinaryWriter(std::ostream &out) : out(out) {}
+    BinaryWriter(const BinaryWriter &) = delete;
+    BinaryWriter &operator=(const BinaryWriter &) = delete;
+    ~BinaryWriter() { flush(); }
+
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    void writeByte(uint8_t byte) { buffer.push_back(static_cast<char>(byte)); }
+    void writeBytes(const void *data, size_t size) {
+        buffer.append(static_cast<const char *>(data), size);
+        if (buffer.size() >= flushSize) flush();
+    }
+    void writeUnsigned(uint64_t v) {
+        while (v >= 0x80) {
+            writeByte(static_cast<uint8_t>(v) | 0x80);
+            v >>= 7;
+        }
+        writeByte(static_cast<uint8_t>(v));
+    }
+    void writeSigned(int64_t v) {
+        writeUnsigned((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+
+    /// Null is 0, a new string 1 followed by its size and characters, and a string written
+    /// before its index + 2.
+    void writeString(cstring s) {
+        if (s.isNull()) return writeByte(0);
+        auto [it, inserted] = strings.emplace(s, strings.size());
+        if (!inserted) return writeUnsigned(it->second + 2);
+        writeByte(1);
+        writeUnsigned(s.size());
+        writeBytes(s.c_str(), s.size());
+    }
+
+    /// Null is 0, a new node 1 followed by its type name and fields, and a node written
+    /// before its index + 2.
+    void writeNode(const IR::Node *node) {
+        if (!node) return writeByte(0);
+        if (buffer.size() >= flushSize) flush();
+        auto [it, inserted] = nodes.emplace(node, nodes.size());
+        if (!inserted) return writeUnsigned(it->second + 2);
+        writeByte(1);
+        writeString(node->node_type_name());
+        node->toBinary(*this);
+    }
+
+    /// A byte with bit 0 set if the position in the program follows, as its InputSources and
+    /// the start and end line and column, and bit 1 set if the filename, line, column and
+    /// srcBrief loaded from a JSON dump follow.
+    void writeSourceInfo(const Util::SourceInfo &si) {
+        bool hasPosition = si.sources != nullptr;
+        bool hasFields = si.filename != cstring::empty || si.line != -1 || si.column != -1 ||
+                         si.srcBrief != cstring::empty;
+        writeByte(hasPosition | hasFields << 1);
+        if (hasPosition) {
+            writeSources(si.sources);
+            writeUnsigned(si.start.getLineNumber());
+            writeUnsigned(si.start.getColumnNumber());
+            writeUnsigned(si.end.getLineNumber());
+            writeUnsigned(si.end.getColumnNumber());
+        }
+        if (hasFields) {
+            writeString(si.filename);
+            writeSigned(si.line);
+            writeSigned(si.column);
+            writeString(si.srcBrief);
+        }
+    }
+
+    template <typename T>
+    void write(const T &v) {
+        if constexpr (std::is_same_v<T, bool>) {
+            writeByte(v);
+        } else if constexpr (std::is_enum_v<T>) {
+            write(static_cast<std::underlying_type_t<T>>(v));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            writeSigned(v);
+        } else if constexpr (std::is_integral_v<T>) {
+            writeUnsigned(v);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double d = v;
+            writeBytes(&d, sizeof(d));
+        } else if constexpr (std::is_same_v<T, cstring>) {
+            writeString(v);
+        } else if constexpr (std::is_same_v<T, IR::ID>) {
+            writeString(v.name);
+            writeString(v.originalName);
+        } else if constexpr (std::is_same_v<T, Util::SourceInfo>) {
+            writeSourceInfo(v);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            writeUnsigned(v.size());
+            writeBytes(v.data(), v.size());
+        } else if constexpr (std::is_same_v<T, big_int>) {
+            writeBigInt(v);
+        } else if constexpr (std::is_same_v<T, bitvec>) {
+            writeBitvec(v);
+        } else if constexpr (std::is_same_v<T, match_t>) {
+            write(v.word0);
+            write(v.word1);
+        } else if constexpr (std::is_same_v<T, LTBitMatrix>) {
+            std::stringstream str;
+            str << v;
+            write(str.str());
+        } else if constexpr (std::is_array_v<T>) {
+            for (const auto &el : v) write(el);
+        } else if constexpr (std::is_pointer_v<T>) {
+            writePointer(v);
+        } else if constexpr (std::is_base_of_v<IR::INode, T>) {
+            // Inline nodes are written like pointers to them.
+            writeNode(v.getNode());
+        } else if constexpr (has_toBinary<T>::value) {
+            v.toBinary(*this);
+        } else if constexpr (has_toJSON<T>::value) {
+            std::stringstream json;
+            JSONGenerator(json).emit(v);
+            write(json.str());
+        } else {
+            static_assert(always_false<T>, "no binary encoding for type");
+        }
+    }
+
+    template <typename T, typename A>
+    void write(const std::vector<T, A> &v) {
+        writeUnsigned(v.size());
+        for (const auto &el : v) write(el);
+    }
+    template <typename T, typename A>
+    void write(const safe_vector<T, A> &v) {
+        writeUnsigned(v.size());
+        for (const auto &el : v) write(el);
+    }
+    template <typename T, typename C, typename A>
+    void write(const std::set<T, C, A> &v) {
+        writeUnsigned(v.size());
+        for (const auto &el : v) write(el);
+    }
+    template <typename T, typename C, typename A>
+    void write(const ordered_set<T, C, A> &v) {
+        writeUnsigned(v.size());
+        for (const auto &el : v) write(el);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void write(const std::map<K, V, C, A> &v) {
+        writeUnsigned(v.size());
+        for (const auto &el : v) write(el);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void write(const std::multimap<K, V, C, A> &v) {
+        writeUnsigned(v.size());
+        for (const auto &el : v) write(el);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void write(const ordered_map<K, V, C, A> &v) {
+        writeUnsigned(v.size());
+        for (const auto &el : v) write(el);
+    }
+    template <typename V>
+    void write(const string_map<V> &v) {
+        writeUnsigned(v.size());
+        for (const auto &el : v) write(el);
+    }
+    template <typename T, typename U>
+    void write(const std::pair<T, U> &v) {
+        write(v.first);
+        write(v.second);
+    }
+    template <typename T>
+    void write(const std::optional<T> &v) {
+        writeByte(v.has_value());
+        if (v) write(*v);
+    }
+    template <typename... Types>
+    void write(const std::variant<Types...> &v) {
+        writeUnsigned(v.index());
+        std::visit([this](const auto &value) { write(value); }, v);
+    }
+
+ private:
+    /// A new InputSources is 1 followed by its lines and line mapping, one written before its
+    /// index + 2.
+    void writeSources(const Util::InputSources *in) {
+        auto [it, inserted] = sources.emplace(in, sources.size());
+        if (!inserted) return writeUnsigned(it->second + 2);
+        writeByte(1);
+        write(in->sealed);
+        write(in->contents);
+        writeUnsigned(in->line_file_map.size());
+        for (const auto &[line, fileLine] : in->line_file_map) {
+            writeUnsigned(line);
+            writeString(fileLine.fileName);
+            writeUnsigned(fileLine.sourceLine);
+        }
+    }
+
+    template <typename T>
+    void writePointer(const T *v) {
+        if constexpr (std::is_base_of_v<IR::INode, T>) {
+            writeNode(v ? v->getNode() : nullptr);
+        } else {
+            writeByte(v != nullptr);
+            if (v) write(*v);
+        }
+    }
+
+    /// Values that fit into 64 bits are 0 followed by the value, others 1 (positive) or 2
+    /// (negative) followed by the bytes of the magnitude.
+    void writeBigInt(const big_int &v) {
+        if (v >= std::numeric_limits<int64_t>::min() && v <= std::numeric_limits<int64_t>::max()) {
+            writeByte(0);
+            writeSigned(static_cast<int64_t>(v));
+            return;
+        }
+        writeByte(v < 0 ? 2 : 1);
+        std::vector<uint8_t> bytes;
+        boost::multiprecision::export_bits(big_int(abs(v)), std::back_inserter(bytes), 8);
+        writeUnsigned(bytes.size());
+        writeBytes(bytes.data(), bytes.size());
+    }
+
+    void writeBitvec(const bitvec &v) {
+        size_t words = v.empty() ? 0 : v.max().index() / 64 + 1;
+        writeUnsigned(words);
+        for (size_t i = 0; i < words; ++i) writeUnsigned(v.getrange(i * 64, 64));
+    }
+};
+
+}  // namespace P4
+
+#endif /* IR_BINARY_WRITER_H_ */
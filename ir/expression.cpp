@@ -4,6 +4,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <ostream>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 
 #include "absl/container/flat_hash_map.h"
 #include "ir/id.h"
@@ -151,6 +154,10 @@ const IR::Constant *IR::Constant::get(const IR::Type *t, big_int v, Util::Source
     // Constants are interned. Keys in the intern map are pairs of types and values.
     using key_t = std::tuple<int, RTTI::TypeId, bool, big_int>;
     static absl::flat_hash_map<key_t, const Constant *, Util::Hash> CONSTANTS;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+    std::lock_guard<std::mutex> acquire(lock);
+#endif  // MULTITHREAD
 
     auto *&result = CONSTANTS[{tb->width_bits(), t->typeId(), tb->isSigned, v}];
     if (result == nullptr) {
@@ -180,6 +187,10 @@ const IR::StringLiteral *IR::StringLiteral::get(cstring value, const IR::Type *t
     // String literals are interned.
     using key_t = std::pair<cstring, const IR::Type *>;
     static absl::flat_hash_map<key_t, const IR::StringLiteral *, Util::Hash> STRINGS;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+    std::lock_guard<std::mutex> acquire(lock);
+#endif  // MULTITHREAD
 
     auto *&result = STRINGS[{value, t}];
     if (result == nullptr) {
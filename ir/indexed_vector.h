@@ -19,6 +19,8 @@
 
 namespace P4 {
 class JSONLoader;
+class BinaryReader;
+class BinaryWriter;
 }  // namespace P4
 
 namespace P4::IR {
@@ -75,6 +77,7 @@ class IndexedVector : public Vector<T> {
         insert(Vector<T>::end(), start, end);
     }
     explicit IndexedVector(JSONLoader &json);
+    explicit IndexedVector(BinaryReader &in);
 
     void clear() {
         IR::Vector<T>::clear();
@@ -212,6 +215,8 @@ class IndexedVector : public Vector<T> {
 
     void toJSON(JSONGenerator &json) const override;
     static Node *fromJSON(JSONLoader &json);
+    void toBinary(BinaryWriter &out) const override;
+    static Node *fromBinary(BinaryReader &in);
     void validate() const override {
         if (invalid) return;  // don't crash the compiler because an error happened
         for (auto el : *this) {
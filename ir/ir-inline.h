@@ -8,6 +8,7 @@
 #ifndef IR_IR_INLINE_H_
 #define IR_IR_INLINE_H_
 
+#include "ir/binary_writer.h"
 #include "ir/id.h"
 #include "ir/indexed_vector.h"
 #include "ir/json_generator.h"
@@ -135,6 +136,11 @@ void IR::Vector<T>::toJSON(JSONGenerator &json) const {
     for (auto &k : vec) json.emit(k);
     json.end_vector(state);
 }
+template <class T>
+void IR::Vector<T>::toBinary(BinaryWriter &out) const {
+    Node::toBinary(out);
+    out.write(vec);
+}
 
 std::ostream &operator<<(std::ostream &out, const IR::Vector<IR::Expression> &v);
 std::ostream &operator<<(std::ostream &out, const IR::Vector<IR::Annotation> &v);
@@ -178,6 +184,11 @@ void IR::IndexedVector<T>::toJSON(JSONGenerator &json) const {
     for (auto &k : declarations) json.emit(k.first, k.second);
     json.end_object(state);
 }
+template <class T>
+void IR::IndexedVector<T>::toBinary(BinaryWriter &out) const {
+    Vector<T>::toBinary(out);
+    out.write(declarations);
+}
 IRNODE_DEFINE_APPLY_OVERLOAD(IndexedVector, template <class T>, <T>)
 
 template <class MAP>
@@ -261,6 +272,13 @@ void IR::NameMap<T, MAP, COMP, ALLOC>::toJSON(JSONGenerator &json) const {
     for (auto &k : symbols) json.emit(k.first, k.second);
     json.end_object(state);
 }
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+void IR::NameMap<T, MAP, COMP, ALLOC>::toBinary(BinaryWriter &out) const {
+    Node::toBinary(out);
+    out.write(symbols);
+}
 
 template <class KEY, class VALUE,
           template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
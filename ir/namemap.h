@@ -19,6 +19,8 @@
 
 namespace P4 {
 class JSONLoader;
+class BinaryReader;
+class BinaryWriter;
 }  // namespace P4
 
 namespace P4::IR {
@@ -46,6 +48,7 @@ class NameMap : public Node {
     NameMap(const NameMap &) = default;
     NameMap(NameMap &&) = default;
     explicit NameMap(JSONLoader &);
+    explicit NameMap(BinaryReader &);
     NameMap &operator=(const NameMap &) = default;
     NameMap &operator=(NameMap &&) = default;
     typedef typename map_t::value_type value_type;
@@ -141,6 +144,8 @@ class NameMap : public Node {
     void visit_children(Visitor &v, const char *) const override;
     void toJSON(JSONGenerator &json) const override;
     static Node *fromJSON(JSONLoader &json);
+    void toBinary(BinaryWriter &out) const override;
+    static Node *fromBinary(BinaryReader &in);
 
     Util::Enumerator<const T *> *valueEnumerator() const {
         return Util::enumerate(Values(symbols));
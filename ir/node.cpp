@@ -12,6 +12,8 @@
 // use in combination with "raise" below
 // #include <csignal>
 
+#include "ir/binary_reader.h"
+#include "ir/binary_writer.h"
 #include "ir/declaration.h"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
@@ -36,7 +38,11 @@ void IR::Node::traceCreation() const {
     LOG5("Created node " << id);
 }
 
+#ifdef MULTITHREAD
+std::atomic<int> IR::Node::currentId = 0;
+#else
 int IR::Node::currentId = 0;
+#endif  // MULTITHREAD
 
 void IR::Node::toJSON(JSONGenerator &json) const {
     json.emit("Node_ID", id);
@@ -45,13 +51,36 @@ void IR::Node::toJSON(JSONGenerator &json) const {
 
 IR::Node::Node(JSONLoader &json) : id(-1) {
     json.load("Node_ID", id) || json.error("missing field Node_Id");
-    if (id < 0)
-        id = currentId++;
-    else if (id >= currentId)
-        currentId = id + 1;
+    id = loadedId(id);
     clone_id = id;
 }
 
+void IR::Node::toBinary(BinaryWriter &out) const {
+    out.write(srcInfo);
+    out.write(id);
+    out.write(clone_id);
+}
+
+IR::Node::Node(BinaryReader &in) : id(-1) {
+    in.read(srcInfo);
+    in.read(id);
+    in.read(clone_id);
+    id = loadedId(id);
+}
+
+int IR::Node::loadedId(int id) {
+    if (id < 0) return currentId++;
+#ifdef MULTITHREAD
+    // Other threads may create or load nodes at the same time.
+    int current = currentId.load();
+    while (id >= current && !currentId.compare_exchange_weak(current, id + 1)) {
+    }
+#else
+    if (id >= currentId) currentId = id + 1;
+#endif  // MULTITHREAD
+    return id;
+}
+
 // Abbreviated debug print
 cstring IR::dbp(const IR::INode *node) {
     std::stringstream str;
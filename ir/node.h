@@ -9,6 +9,9 @@
 #define IR_NODE_H_
 
 #include <iosfwd>
+#ifdef MULTITHREAD
+#include <atomic>
+#endif  // MULTITHREAD
 
 #include "ir/gen-tree-macro.h"
 #include "ir/inode.h"
@@ -24,6 +27,8 @@ class Modifier;
 class Transform;
 class JSONGenerator;
 class JSONLoader;
+class BinaryWriter;
+class BinaryReader;
 }  // namespace P4
 
 namespace P4::Util {
@@ -57,9 +62,18 @@ class Node : public virtual INode {
     virtual void apply_visitor_loop_revisit(Transform &v) const;
     Node &operator=(const Node &) = default;
     Node &operator=(Node &&) = default;
+    /// The id of the next node to be created.
+    static int nextId() { return currentId; }
 
  protected:
+#ifdef MULTITHREAD
+    static std::atomic<int> currentId;
+#else
     static int currentId;
+#endif  // MULTITHREAD
+    /// Returns the id for a node read from a JSON or binary dump: a new one if @p id is
+    /// negative, else @p id, which later nodes will not reuse.
+    static int loadedId(int id);
     void traceVisit(const char *visitor) const;
     friend class ::P4::Visitor;
     friend class ::P4::Inspector;
@@ -99,6 +113,9 @@ class Node : public virtual INode {
     void toJSON(JSONGenerator &json) const override;
     void sourceInfoToJSON(JSONGenerator &json) const;
     void sourceInfoFromJSON(JSONLoader &json);
+    explicit Node(BinaryReader &in);
+    /// Writes the fields of the node for a binary snapshot; see ir/binary_writer.h.
+    virtual void toBinary(BinaryWriter &out) const;
     Util::JsonObject *sourceInfoJsonObj() const;
     /* operator== does a 'shallow' comparison, comparing two Node subclass objects for equality,
      * and comparing pointers in the Node directly for equality */
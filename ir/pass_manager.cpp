@@ -5,8 +5,10 @@
 
 #include "pass_manager.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <stdexcept>
 #include <string>
@@ -14,6 +16,7 @@
 
 #include "ir/dump.h"
 #include "ir/node.h"
+#include "ir/pass_profile.h"
 #include "ir/visitor.h"
 #include "lib/error.h"
 #include "lib/gc.h"
@@ -23,6 +26,115 @@
 
 namespace P4 {
 
+namespace {
+
+/// The registered observers, see ProgramChangeObserver.
+struct ObserverRegistry {
+    std::vector<ProgramChangeObserver *> observers;
+    /// The depth of nested notifications. Observers removed while notifying are only nulled
+    /// out, and removed from the list once the outermost notification is done.
+    int notifying = 0;
+#ifdef MULTITHREAD
+    /// Held while the observers are changed or notified. It is recursive, as observers may add
+    /// or remove observers while being notified.
+    std::recursive_mutex lock;
+#endif  // MULTITHREAD
+};
+
+ObserverRegistry &registry() {
+    static ObserverRegistry registry;
+    return registry;
+}
+
+}  // namespace
+
+std::vector<ProgramChangeObserver *> &ProgramChangeObserver::observers() {
+    return registry().observers;
+}
+
+bool ProgramChangeObserver::any() {
+    auto &reg = registry();
+#ifdef MULTITHREAD
+    std::lock_guard<std::recursive_mutex> acquire(reg.lock);
+#endif  // MULTITHREAD
+    return !reg.observers.empty();
+}
+
+void ProgramChangeObserver::add(ProgramChangeObserver *observer) {
+    auto &reg = registry();
+#ifdef MULTITHREAD
+    std::lock_guard<std::recursive_mutex> acquire(reg.lock);
+#endif  // MULTITHREAD
+    auto &all = reg.observers;
+    if (std::find(all.begin(), all.end(), observer) == all.end()) all.push_back(observer);
+}
+
+void ProgramChangeObserver::remove(ProgramChangeObserver *observer) {
+    auto &reg = registry();
+#ifdef MULTITHREAD
+    std::lock_guard<std::recursive_mutex> acquire(reg.lock);
+#endif  // MULTITHREAD
+    auto &all = reg.observers;
+    if (reg.notifying)
+        std::replace(all.begin(), all.end(), observer,
+                     static_cast<ProgramChangeObserver *>(nullptr));
+    else
+        all.erase(std::remove(all.begin(), all.end(), observer), all.end());
+}
+
+template <typename Notify>
+static void notifyAll(Notify notify) {
+    auto &reg = registry();
+#ifdef MULTITHREAD
+    std::lock_guard<std::recursive_mutex> acquire(reg.lock);
+#endif  // MULTITHREAD
+    auto &all = reg.observers;
+    ++reg.notifying;
+    // Observers added while notifying are notified as well.
+    for (size_t i = 0; i < all.size(); ++i)
+        if (all[i]) notify(all[i]);
+    if (--reg.notifying == 0)
+        all.erase(std::remove(all.begin(), all.end(), nullptr), all.end());
+}
+
+void ProgramChangeObserver::notifyReplaced(const IR::Node *from, const IR::Node *to) {
+    notifyAll([&](ProgramChangeObserver *o) { o->nodeReplaced(from, to); });
+}
+
+void ProgramChangeObserver::notifyPassFinished(const IR::Node *before, const IR::Node *after) {
+    notifyAll([&](ProgramChangeObserver *o) { o->passFinished(before, after); });
+}
+
+namespace {
+
+/// Makes the Transform or Modifier @p v report its replacements to the program change
+/// observers while it runs. Passes that already have a hook of their own are left alone,
+/// so their changes are unknown to the observers.
+class ReportReplacements {
+    Transform *transform = nullptr;
+    Modifier *modifier = nullptr;
+
+ public:
+    explicit ReportReplacements(Visitor *v) {
+        if (!ProgramChangeObserver::any()) return;
+        if (auto *t = dynamic_cast<Transform *>(v)) {
+            if (t->hasOnNodeTransformedHook()) return;
+            transform = t;
+            transform->setOnNodeTransformedHook(ProgramChangeObserver::notifyReplaced);
+        } else if (auto *m = dynamic_cast<Modifier *>(v)) {
+            if (m->hasOnNodeTransformedHook()) return;
+            modifier = m;
+            modifier->setOnNodeTransformedHook(ProgramChangeObserver::notifyReplaced);
+        }
+    }
+    ~ReportReplacements() {
+        if (transform) transform->setOnNodeTransformedHook(nullptr);
+        if (modifier) modifier->setOnNodeTransformedHook(nullptr);
+    }
+};
+
+}  // namespace
+
 void PassManager::removePasses(const std::vector<cstring> &exclude) {
     for (auto it : exclude) {
         bool excluded = false;
@@ -70,7 +182,15 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
         try {
             try {
                 LOG1(log_indent << name() << " invoking " << v->name());
-                program = program->apply(**it, getChildContext());
+                PassProfiler::Scope profile;
+                const auto *before = program;
+                {
+                    ReportReplacements report(v);
+                    program = program->apply(**it, getChildContext());
+                    if (ProgramChangeObserver::any())
+                        ProgramChangeObserver::notifyPassFinished(before, program);
+                }
+                profile.finish(name(), v->name(), program != before);
                 if (LOGGING(3)) {
                     size_t maxmem, mem = gc_mem_inuse(&maxmem);  // triggers gc
                     LOG3(log_indent << "heap after " << v->name() << ": in use " << n4(mem)
@@ -152,6 +272,112 @@ const IR::Node *PassRepeated::apply_visitor(const IR::Node *program, const char
     return program;
 }
 
+FusedTransforms::FusedTransforms(std::initializer_list<Transform *> init) : passes(init) {
+    BUG_CHECK(!passes.empty(), "no passes to fuse");
+    std::string names;
+    for (auto *pass : passes) {
+        // The passes share this traversal, so they must agree on how to traverse DAGs.
+        BUG_CHECK(pass->visitDagOnce == passes.front()->visitDagOnce,
+                  "%1% and %2% cannot be fused", passes.front()->name(), pass->name());
+        if (!names.empty()) names += '+';
+        names += pass->name();
+    }
+    visitDagOnce = passes.front()->visitDagOnce;
+    setName(names.c_str());
+}
+
+/// Makes @p pass see the node this traversal is at.
+void FusedTransforms::share(Transform *pass) {
+    pass->ctxt = ctxt;
+    pass->prune_flag = false;
+}
+
+Visitor::profile_t FusedTransforms::init_apply(const IR::Node *root) {
+    auto rv = Transform::init_apply(root);
+    active.clear();
+    profiles.clear();
+    for (auto *pass : passes) {
+        profiles.push_back(pass->init_apply(root));
+        pass->onNodeTransformedHook = onNodeTransformedHook;
+    }
+    return rv;
+}
+
+void FusedTransforms::end_apply(const IR::Node *root) {
+    for (auto *pass : passes) {
+        pass->ctxt = nullptr;
+        pass->onNodeTransformedHook = nullptr;
+        pass->end_apply(root);
+    }
+    profiles.clear();
+    Transform::end_apply(root);
+}
+
+const IR::Node *FusedTransforms::preorder(IR::Node *n) {
+    size_t depth = ctxt->depth;
+    if (active.size() <= depth) active.resize(depth + 1);
+    // Nothing is recorded above the root: all passes visit it.
+    if (active[depth - 1].empty())
+        active[depth].assign(passes.size(), true);
+    else
+        active[depth] = active[depth - 1];
+    auto &mask = active[depth];
+    // Nodes created by a pass are new to the analyses the other passes use (e.g. they are
+    // not typed yet), so once a pass changes the node in its preorder it visits the node
+    // and its subtree alone; the other passes see them in the next round.
+    const IR::Node *before = nullptr;
+    if (std::count(mask.begin(), mask.end(), true) > 1)
+        before = *n == *getOriginal() ? getOriginal() : n->clone();
+    bool visitChildren = false;
+    for (size_t i = 0; i < passes.size(); ++i) {
+        if (!mask[i]) continue;
+        share(passes[i]);
+        const auto *result = n->apply_visitor_preorder(*passes[i]);
+        if (passes[i]->prune_flag)
+            mask[i] = false;
+        else
+            visitChildren = true;
+        if (result != n || (before && *n != *before)) {
+            bool alone = mask[i];
+            mask.assign(passes.size(), false);
+            mask[i] = alone;
+            if (!alone) prune();
+            return result;
+        }
+    }
+    if (!visitChildren) prune();
+    return n;
+}
+
+const IR::Node *FusedTransforms::postorder(IR::Node *n) {
+    const auto &mask = active.at(ctxt->depth);
+    // A rewrite by one pass may enable a rewrite by another one, including one that came
+    // before it, so the passes visit the rewritten node again until none of them changes it.
+    // Passes look at the original node through the context, so this stops if the class of
+    // the node changes; the rest is left to the next round.
+    const IR::Node *before = nullptr;
+    if (std::count(mask.begin(), mask.end(), true) > 1)
+        before = *n == *getOriginal() ? getOriginal() : n->clone();
+    const IR::Node *result = n;
+    bool changed = false;
+    size_t unchanged = 0, steps = 0;
+    for (size_t i = 0; unchanged < passes.size(); i = (i + 1) % passes.size()) {
+        ++unchanged;
+        if (!mask[i]) continue;
+        BUG_CHECK(++steps <= maxRounds * passes.size(), "%1%: rewrites of %2% do not converge",
+                  name(), n);
+        auto *node = changed ? result->clone() : n;
+        share(passes[i]);
+        const auto *rv = node->apply_visitor_postorder(*passes[i]);
+        if (rv == node && (changed ? *node == *result : !before || *node == *before)) continue;
+        result = rv;
+        changed = true;
+        unchanged = 1;
+        if (!result || result->typeId() != n->typeId()) break;
+    }
+    return result;
+}
+
 const IR::Node *PassRepeatUntil::apply_visitor(const IR::Node *program, const char *name) {
     do {
         running = true;
@@ -28,6 +28,33 @@ typedef std::function<void(const char *manager, unsigned seqNo, const char *pass
                            const IR::Node *node)>
     DebugHook;
 
+/// Observes the changes made to the program by the passes run by a PassManager. While any
+/// observer is registered, each Transform or Modifier pass run by a PassManager reports
+/// every node it replaces, and every pass reports the program it started from and ended
+/// with. Observers use the latter to detect changes whose replacements were not reported,
+/// e.g. by passes other than Transforms and Modifiers.
+class ProgramChangeObserver {
+ public:
+    virtual ~ProgramChangeObserver() = default;
+    /// A pass replaced @p from with @p to; @p to is nullptr if @p from was removed.
+    virtual void nodeReplaced(const IR::Node *from, const IR::Node *to) = 0;
+    /// A pass turned the program @p before into @p after.  Unless the replacement of
+    /// @p before by @p after has been passed to nodeReplaced(), the changes the pass made
+    /// are unknown.
+    virtual void passFinished(const IR::Node *before, const IR::Node *after) = 0;
+
+    /// Observers may add or remove observers while being notified.
+    static void add(ProgramChangeObserver *observer);
+    static void remove(ProgramChangeObserver *observer);
+    static bool any();
+
+    /// Notify all observers; used by PassManager.
+    static void notifyReplaced(const IR::Node *from, const IR::Node *to);
+    static void notifyPassFinished(const IR::Node *before, const IR::Node *after);
+
+    static std::vector<ProgramChangeObserver *> &observers();
+};
+
 class PassManager : virtual public Visitor, virtual public Backtrack {
     bool early_exit_flag = false;
     mutable int never_backtracks_cache = -1;
@@ -172,6 +199,41 @@ class PassIf : virtual public PassManager {
     PassIf *clone() const override { return new PassIf(*this); }
 };
 
+/// Runs several Transforms over the program in a single traversal.  At each node the
+/// preorders of the passes run in sequence, and so do their postorders once the children
+/// have been visited; a pass that prunes a node does not see that node's subtree.  A node
+/// changed by a preorder is left to that pass alone, as analyses such as the TypeMap know
+/// nothing about it yet.  Once a postorder rewrites a node, the postorders of all passes
+/// run again on the result until none of them changes it, so the node reaches a local
+/// fixpoint, unless the rewrite changes the class of the node, which the other passes
+/// then see in the next round.  Running the fused passes in a PassRepeated reaches the
+/// same fixpoint as running them one after the other, as long as each pass only rewrites
+/// the node it visits, looking up the original node in analyses (e.g. DoConstantFolding,
+/// DoStrengthReduction), and does not prune nodes that the other passes rewrite.
+class FusedTransforms : public Transform {
+    safe_vector<Transform *> passes;
+    /// For each depth of the current context, the passes still visiting the node there.
+    std::vector<std::vector<bool>> active;
+    std::vector<profile_t> profiles;
+    /// Bound on the rounds of postorders at one node, which are expected to converge quickly.
+    static constexpr size_t maxRounds = 16;
+
+    void share(Transform *pass);
+
+ public:
+    explicit FusedTransforms(std::initializer_list<Transform *> passes);
+    FusedTransforms(const FusedTransforms &other)
+        : Visitor(other), Transform(other), passes(other.passes) {}
+    using Transform::postorder;
+    using Transform::preorder;
+
+    profile_t init_apply(const IR::Node *root) override;
+    void end_apply(const IR::Node *root) override;
+    const IR::Node *preorder(IR::Node *n) override;
+    const IR::Node *postorder(IR::Node *n) override;
+    FusedTransforms *clone() const override { return new FusedTransforms(*this); }
+};
+
 // Converts a function Node* -> Node* into a visitor
 class VisitFunctor : virtual public Visitor {
     std::function<const IR::Node *(const IR::Node *)> fn;
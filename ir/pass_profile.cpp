@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ir/pass_profile.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ir/node.h"
+#include "ir/visitor.h"
+#include "lib/cstring.h"
+#include "lib/gc.h"
+
+namespace P4 {
+
+bool PassProfiler::isEnabled = false;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Counters = PassProfiler::Counters;
+
+/// One finished pass invocation.
+struct Event {
+    cstring manager;
+    cstring pass;
+    int64_t startNs;
+    /// Costs including those of nested passes.
+    Counters total;
+    /// Costs of the pass itself, excluding nested passes.
+    Counters self;
+    bool changed;
+};
+
+struct ProfileState {
+    std::filesystem::path traceFile;
+    Clock::time_point origin = Clock::now();
+    std::vector<Event> events;
+    /// Costs of the nested passes of each pass currently running.
+    std::vector<Counters> nested;
+    /// The thread passes are profiled on.
+    std::thread::id thread;
+    bool written = false;
+
+    Counters sample() const {
+        Counters c;
+        c.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin)
+                       .count();
+        c.bytesAllocated = gc_bytes_allocated();
+        c.nodesCreated = IR::Node::nextId();
+        c.nodesVisited = Visitor::nodesVisited;
+        return c;
+    }
+
+    static ProfileState &get() {
+        static ProfileState state;
+        return state;
+    }
+};
+
+Counters operator-(const Counters &a, const Counters &b) {
+    Counters c;
+    c.timeNs = a.timeNs - b.timeNs;
+    c.bytesAllocated = a.bytesAllocated - b.bytesAllocated;
+    c.nodesCreated = a.nodesCreated - b.nodesCreated;
+    c.nodesVisited = a.nodesVisited - b.nodesVisited;
+    return c;
+}
+
+Counters &operator+=(Counters &a, const Counters &b) {
+    a.timeNs += b.timeNs;
+    a.bytesAllocated += b.bytesAllocated;
+    a.nodesCreated += b.nodesCreated;
+    a.nodesVisited += b.nodesVisited;
+    return a;
+}
+
+void writeTrace(std::ostream &out, const std::vector<Event> &events) {
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    const char *sep = "\n";
+    for (const auto &e : events) {
+        out << sep << "{\"name\": \"" << e.pass.escapeJson() << "\", \"cat\": \"pass\", "
+            << "\"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": " << e.startNs / 1000.0
+            << ", \"dur\": " << e.total.timeNs / 1000.0 << ", \"args\": {\"manager\": \""
+            << e.manager.escapeJson() << "\", \"alloc_bytes\": " << e.total.bytesAllocated
+            << ", \"nodes_created\": " << e.total.nodesCreated
+            << ", \"nodes_visited\": " << e.total.nodesVisited
+            << ", \"changed\": " << (e.changed ? "true" : "false") << "}}";
+        sep = ",\n";
+    }
+    out << "\n]}\n";
+}
+
+void writeSummary(std::ostream &out, const std::vector<Event> &events) {
+    struct Row {
+        uint64_t calls = 0;
+        uint64_t changed = 0;
+        Counters total;
+        Counters self;
+    };
+    std::map<cstring, Row> rows;
+    for (const auto &e : events) {
+        auto &row = rows[e.pass];
+        ++row.calls;
+        row.changed += e.changed;
+        row.total += e.total;
+        row.self += e.self;
+    }
+    std::vector<std::pair<cstring, Row>> sorted(rows.begin(), rows.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        return a.second.self.timeNs > b.second.self.timeNs;
+    });
+
+    out << std::setw(10) << "self ms" << std::setw(10) << "total ms" << std::setw(8) << "calls"
+        << std::setw(8) << "changed" << std::setw(14) << "self alloc B" << std::setw(12)
+        << "self nodes" << std::setw(14) << "self visited"
+        << "  pass\n";
+    out << std::fixed << std::setprecision(1);
+    for (const auto &[pass, row] : sorted) {
+        out << std::setw(10) << row.self.timeNs / 1e6 << std::setw(10) << row.total.timeNs / 1e6
+            << std::setw(8) << row.calls << std::setw(8) << row.changed << std::setw(14)
+            << row.self.bytesAllocated << std::setw(12) << row.self.nodesCreated
+            << std::setw(14) << row.self.nodesVisited << "  " << pass << "\n";
+    }
+}
+
+}  // namespace
+
+void PassProfiler::enable(std::filesystem::path traceFile) {
+    auto &state = ProfileState::get();
+    state.traceFile = std::move(traceFile);
+    state.thread = std::this_thread::get_id();
+    if (!isEnabled) std::atexit(write);
+    isEnabled = true;
+}
+
+void PassProfiler::write() {
+    auto &state = ProfileState::get();
+    if (!isEnabled || state.written) return;
+    state.written = true;
+
+    // This usually runs at exit, after the compile context is gone, so report problems
+    // directly rather than through the error reporter.
+    std::ofstream trace(state.traceFile);
+    if (!trace) {
+        std::cerr << "Could not open pass profile file " << state.traceFile << std::endl;
+        return;
+    }
+    writeTrace(trace, state.events);
+
+    auto summaryFile = state.traceFile;
+    summaryFile += ".summary";
+    std::ofstream summary(summaryFile);
+    if (!summary) {
+        std::cerr << "Could not open pass profile file " << summaryFile << std::endl;
+        return;
+    }
+    writeSummary(summary, state.events);
+}
+
+PassProfiler::Scope::Scope() : active(PassProfiler::enabled()) {
+    if (!active) return;
+    auto &state = ProfileState::get();
+    if (!(active = std::this_thread::get_id() == state.thread)) return;
+    state.nested.emplace_back();
+    start = state.sample();
+}
+
+PassProfiler::Scope::~Scope() {
+    if (active) ProfileState::get().nested.pop_back();
+}
+
+void PassProfiler::Scope::finish(const char *manager, const char *pass, bool changed) {
+    if (!active) return;
+    active = false;
+    auto &state = ProfileState::get();
+    Event e;
+    e.manager = cstring(manager);
+    e.pass = cstring(pass);
+    e.startNs = start.timeNs;
+    e.total = state.sample() - start;
+    e.self = e.total - state.nested.back();
+    e.changed = changed;
+    state.nested.pop_back();
+    if (!state.nested.empty()) state.nested.back() += e.total;
+    state.events.push_back(e);
+}
+
+}  // namespace P4
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IR_PASS_PROFILE_H_
+#define IR_PASS_PROFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+/// @file
+/// @brief Per-pass performance ledger (--pass-profile).
+
+namespace P4 {
+
+/// Records the cost of every pass run by a PassManager, including passes of nested
+/// PassManagers and every iteration of a PassRepeated: wall time, bytes allocated through
+/// the garbage-collected operator new, IR nodes created, IR nodes visited and whether the
+/// pass changed the tree. At exit the record is written as a Chrome trace (loadable in
+/// chrome://tracing or Perfetto) to the requested file, and a summary table sorted by the
+/// time spent in each pass itself is written next to it with a `.summary` suffix.
+///
+/// Profiling is off unless enable() has been called; PassManager then pays a single
+/// flag test per pass. The profiler is not thread-safe and only records passes run from
+/// the thread that enabled it.
+class PassProfiler {
+ public:
+    /// Start profiling and write the results to @p traceFile when the process exits.
+    static void enable(std::filesystem::path traceFile);
+    static bool enabled() { return isEnabled; }
+
+    /// Write the trace and summary now. Called automatically at exit.
+    static void write();
+
+    /// Counters sampled at the start and end of a pass.
+    struct Counters {
+        int64_t timeNs = 0;
+        size_t bytesAllocated = 0;
+        int64_t nodesCreated = 0;
+        uint64_t nodesVisited = 0;
+    };
+
+    /// Profiles one pass invocation. Passes that do not finish normally (an exception or a
+    /// backtrack trigger) are not recorded.
+    class Scope {
+        bool active;
+        Counters start;
+
+     public:
+        Scope();
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        /// Record the pass @p pass of @p manager; @p changed says whether it returned a
+        /// different tree.
+        void finish(const char *manager, const char *pass, bool changed);
+    };
+
+ private:
+    static bool isEnabled;
+};
+
+}  // namespace P4
+
+#endif /* IR_PASS_PROFILE_H_ */
@@ -5,6 +5,9 @@
 
 #include <cstddef>
 #include <map>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 #include <utility>
 
 #include "frontends/common/parser_options.h"
@@ -48,6 +51,10 @@ const Type_Bits *Type_Bits::get(int width, bool isSigned) {
     // map (width, signed) to type
     using bit_type_key = std::pair<int, bool>;
     static std::map<bit_type_key, const IR::Type_Bits *> *type_map = nullptr;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+    std::lock_guard<std::mutex> acquire(lock);
+#endif  // MULTITHREAD
     if (type_map == nullptr) type_map = new std::map<bit_type_key, const IR::Type_Bits *>();
     auto &result = (*type_map)[std::make_pair(width, isSigned)];
     if (!result) result = new Type_Bits(width, isSigned);
@@ -16,6 +16,8 @@
 
 namespace P4 {
 class JSONLoader;
+class BinaryReader;
+class BinaryWriter;
 }  // namespace P4
 
 namespace P4::IR {
@@ -40,6 +42,7 @@ class VectorBase : public Node {
 
  protected:
     explicit VectorBase(JSONLoader &json) : Node(json) {}
+    explicit VectorBase(BinaryReader &in) : Node(in) {}
 
     DECLARE_TYPEINFO_WITH_TYPEID(VectorBase, NodeKind::VectorBase, Node);
 };
@@ -56,6 +59,7 @@ class Vector : public VectorBase {
     Vector(const Vector &) = default;
     Vector(Vector &&) = default;
     explicit Vector(JSONLoader &json);
+    explicit Vector(BinaryReader &in);
     Vector &operator=(const Vector &) = default;
     Vector &operator=(Vector &&) = default;
     explicit Vector(const T *a) { vec.emplace_back(a); }
@@ -66,6 +70,7 @@ class Vector : public VectorBase {
     Vector(Util::Enumerator<const T *> *e)  // NOLINT(runtime/explicit)
         : vec(e->begin(), e->end()) {}
     static Node *fromJSON(JSONLoader &json);
+    static Node *fromBinary(BinaryReader &in);
 
     using iterator = typename safe_vector<const T *>::iterator;
     using const_iterator = typename safe_vector<const T *>::const_iterator;
@@ -183,6 +188,7 @@ class Vector : public VectorBase {
     virtual void parallel_visit_children(Visitor &v, const char *name = nullptr);
     virtual void parallel_visit_children(Visitor &v, const char *name = nullptr) const;
     void toJSON(JSONGenerator &json) const override;
+    void toBinary(BinaryWriter &out) const override;
     Util::Enumerator<const T *> *getEnumerator() const { return Util::enumerate(vec); }
     template <typename S>
     Util::Enumerator<const S *> *only() const {
@@ -336,6 +336,8 @@ bool Visitor::warning_enabled(const Visitor *visitor, int warning_kind) {
     return true;
 }
 
+thread_local uint64_t Visitor::nodesVisited = 0;
+
 Visitor::profile_t Visitor::init_apply(const IR::Node *root) {
     ctxt = nullptr;
     if (joinFlows) init_join_flows(root);
@@ -364,8 +366,8 @@ Visitor::profile_t Transform::init_apply(const IR::Node *root) {
 void Visitor::end_apply() {}
 void Visitor::end_apply(const IR::Node *) {}
 
-static indent_t profile_indent;
-static absl::Time first_start = absl::InfinitePast();
+static thread_local indent_t profile_indent;
+static thread_local absl::Time first_start = absl::InfinitePast();
 
 Visitor::profile_t::profile_t(Visitor &v_) : v(v_) {
     start = absl::Now();
@@ -469,6 +471,7 @@ const IR::Node *Modifier::apply_visitor(const IR::Node *n, const char *name) {
                 n = visited->result(n);
                 break;
             default: {  // New or Revisit
+                ++nodesVisited;
                 IR::Node *copy = n->clone();
                 local.current.node = copy;
                 if (!dontForwardChildrenBeforePreorder) {
@@ -507,6 +510,7 @@ const IR::Node *Inspector::apply_visitor(const IR::Node *n, const char *name) {
                 n->apply_visitor_revisit(*this);
                 break;
             default:  // New or Revisit
+                ++nodesVisited;
                 if (n->apply_visitor_preorder(*this)) {
                     n->visit_children(*this, name);
                     n->apply_visitor_postorder(*this);
@@ -538,6 +542,7 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
                 n = visited->result(n);
                 break;
             default: {  // New or Revisit
+                ++nodesVisited;
                 auto *copy = n->clone();
                 local.current.node = copy;
                 if (!dontForwardChildrenBeforePreorder) {
@@ -85,6 +85,10 @@ class Visitor {
     };
     virtual ~Visitor() = default;
 
+    /// Number of nodes visited (not counting revisits) by Inspectors, Modifiers and
+    /// Transforms on this thread. Sampled by the pass profiler.
+    static thread_local uint64_t nodesVisited;
+
     mutable cstring internalName;
     // Some visitors are created and applied by other visitors.
     // This field keeps track of the caller.
@@ -371,6 +375,7 @@ class Visitor {
     friend class Modifier;
     friend class Transform;
     friend class ControlFlowVisitor;
+    friend class FusedTransforms;
 };
 
 class Modifier : public virtual Visitor {
@@ -401,6 +406,7 @@ class Modifier : public virtual Visitor {
         const std::function<void(const IR::Node *from, const IR::Node *to)> &hook) {
         onNodeTransformedHook = hook;
     }
+    bool hasOnNodeTransformedHook() const { return bool(onNodeTransformedHook); }
 
  protected:
     bool forceClone = false;  // force clone whole tree even if unchanged
@@ -461,6 +467,7 @@ class Transform : public virtual Visitor {
         const std::function<void(const IR::Node *from, const IR::Node *to)> &hook) {
         onNodeTransformedHook = hook;
     }
+    bool hasOnNodeTransformedHook() const { return bool(onNodeTransformedHook); }
 
  protected:
     const IR::Node *transform_child(const IR::Node *child) {
@@ -469,6 +476,7 @@ class Transform : public virtual Visitor {
         return rv;
     }
     bool forceClone = false;  // force clone whole tree even if unchanged
+    friend class FusedTransforms;
 };
 
 // turn this on for extra info tracking control joinFlows for debugging
@@ -5,6 +5,11 @@
 
 #include "lib/compile_context.h"
 
+#include <list>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
+
 #include "lib/error.h"
 #include "lib/exceptions.h"
 
@@ -37,8 +42,30 @@ ICompileContext::~ICompileContext() {}
 }
 
 /* static */ CompileContextStack::StackType &CompileContextStack::getStack() {
-    static StackType stack;
-    return stack;
+    // The stack may hold the only reference to a context, and libgc does not scan thread local
+    // storage. The stacks of all threads therefore live in static storage, and each thread only
+    // keeps an iterator to its own, which it removes when it exits.
+    static std::list<StackType> stacks;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+#define STACKS_LOCK std::lock_guard<std::mutex> guard(lock)
+#else
+#define STACKS_LOCK
+#endif  // MULTITHREAD
+    struct Slot {
+        std::list<StackType>::iterator stack;
+        Slot() {
+            STACKS_LOCK;
+            stack = stacks.emplace(stacks.end());
+        }
+        ~Slot() {
+            STACKS_LOCK;
+            stacks.erase(stack);
+        }
+    };
+#undef STACKS_LOCK
+    static thread_local Slot slot;
+    return *slot.stack;
 }
 
 AutoCompileContext::AutoCompileContext(ICompileContext *context) {
@@ -27,7 +27,8 @@ class ICompileContext {
 
 /// A stack of active compilation contexts. Only the top context is accessible.
 /// Compilation contexts can be nested to allow composing programs without
-/// intermingling their stack.
+/// intermingling their stack. Each thread has its own stack; the tasks of a
+/// TaskGroup run with the context of the thread that added them.
 struct CompileContextStack final {
     CompileContextStack() = delete;
 
@@ -17,15 +17,19 @@
 #endif /* HAVE_LIBGC */
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <climits>
 #include <cstddef>
 #include <cstring>
 #include <functional>
 #include <iomanip>
 #include <ios>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_set>
 
 #include "hash.h"
@@ -141,52 +145,120 @@ class table_entry {
     }
 };
 
+// A string together with its hash. The hash is computed once, picks the shard and is then
+// reused by the shard's hash set, so sharding costs no extra hashing.
+struct hashed_key {
+    std::string_view string;
+    size_t hash;
+
+    explicit hashed_key(std::string_view string)
+        : string(string), hash(Util::hash(string.data(), string.length())) {}
+};
+
+inline bool operator==(const table_entry &entry, const hashed_key &key) {
+    return entry == key.string;
+}
+
+inline bool operator==(const hashed_key &key, const table_entry &entry) {
+    return entry == key.string;
+}
+
 // We'd make Util::Hash to be transparent instead. However, this would enable
 // transparent hashing globally and in some cases in very undesired manner. So
 // for now aim for more fine-grained approach.
 struct TableEntryHash {
     using is_transparent = void;
 
-    // IMPORTANT: These two hashes MUST match in order for heterogenous
+    // IMPORTANT: These hashes MUST match in order for heterogenous
     // lookup to work properly
     size_t operator()(const table_entry &entry) const {
         return Util::hash(entry.string(), entry.length());
     }
 
-    size_t operator()(std::string_view entry) const {
-        return Util::hash(entry.data(), entry.length());
+    size_t operator()(const hashed_key &key) const { return key.hash; }
+};
+
+// Test-and-test-and-set spin lock. Acquiring it uncontended is a single atomic exchange,
+// which is cheaper than a mutex on the common single-threaded path; critical sections
+// are a single hash set operation.
+class spin_lock {
+    std::atomic<bool> locked{false};
+
+ public:
+    void lock() {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+            while (locked.load(std::memory_order_relaxed)) std::this_thread::yield();
+        }
     }
+    void unlock() { locked.store(false, std::memory_order_release); }
 };
 
-auto &cache() {
-    // We need node_hash_set due to SSO: we return address of embedded string
-    // that should be stable
-    static absl::node_hash_set<table_entry, TableEntryHash, std::equal_to<>> g_cache;
+// The intern table is split into independently locked shards, selected by the top bits of
+// the string hash (the hash set itself uses the low bits), so threads interning different
+// strings rarely contend.
+class intern_table {
+    static constexpr unsigned shard_bits = 6;
+    static constexpr size_t shard_count = size_t(1) << shard_bits;
+
+    struct alignas(64) shard {
+        spin_lock lock;
+        // We need node_hash_set due to SSO: we return address of embedded string
+        // that should be stable
+        absl::node_hash_set<table_entry, TableEntryHash, std::equal_to<>> entries;
+    };
+
+    shard shards[shard_count];
 
+ public:
+    shard &shard_for(const hashed_key &key) {
+        static_assert(sizeof(size_t) * CHAR_BIT > shard_bits);
+        return shards[key.hash >> (sizeof(size_t) * CHAR_BIT - shard_bits)];
+    }
+
+    const char *save(const char *string, std::size_t length, table_entry_flags flags) {
+        hashed_key key(std::string_view(string, length));
+        auto &s = shard_for(key);
+        std::lock_guard<spin_lock> guard(s.lock);
+        // Checks if string is already cached and if not, calls ctor to construct in
+        // place.  As a result, only a single lookup is performed regardless whether
+        // entry is in cache or not.
+        auto construct = [string, length, flags](const auto &ctor) { ctor(string, length, flags); };
+        return s.entries.lazy_emplace(key, construct)->string();
+    }
+
+    const char *find(std::string_view string) {
+        hashed_key key(string);
+        auto &s = shard_for(key);
+        std::lock_guard<spin_lock> guard(s.lock);
+        auto entry = s.entries.find(key);
+        return entry == s.entries.end() ? nullptr : entry->string();
+    }
+
+    template <typename Fn>
+    void for_each_shard(Fn fn) {
+        for (auto &s : shards) {
+            std::lock_guard<spin_lock> guard(s.lock);
+            fn(s.entries);
+        }
+    }
+};
+
+intern_table &cache() {
+    static intern_table g_cache;
     return g_cache;
 }
 
 const char *save_to_cache(const char *string, std::size_t length, table_entry_flags flags) {
-    // Checks if string is already cached and if not, calls ctor to construct in
-    // place.  As a result, only a single lookup is performed regardless whether
-    // entry is in cache or not.
-    return cache()
-        .lazy_emplace(table_entry(string, length, table_entry_flags::no_need_copy),
-                      [string, length, flags](const auto &ctor) { ctor(string, length, flags); })
-        ->string();
+    return cache().save(string, length, flags);
 }
 
 }  // namespace
 
-bool cstring::is_cached(std::string_view s) { return cache().contains(s); }
+bool cstring::is_cached(std::string_view s) { return cache().find(s) != nullptr; }
 
 cstring cstring::get_cached(std::string_view s) {
-    auto entry = cache().find(s);
-    if (entry == cache().end()) return nullptr;
-
     cstring res;
-    res.str = entry->string();
-
+    res.str = cache().find(s);
     return res;
 }
 
@@ -205,8 +277,11 @@ void cstring::construct_from_literal(const char *string, std::size_t length) {
 
 size_t cstring::cache_size(size_t &count) {
     size_t rv = 0;
-    count = cache().size();
-    for (auto &s : cache()) rv += sizeof(s) + s.length();
+    count = 0;
+    cache().for_each_shard([&](const auto &entries) {
+        count += entries.size();
+        for (auto &s : entries) rv += sizeof(s) + s.length();
+    });
     return rv;
 }
 
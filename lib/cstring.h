@@ -45,8 +45,10 @@
  *     std::string.
  *   - Interned strings can never be freed, so they'll stick around for the
  *     lifetime of the program.
- *   - The string interning cstring performs is currently not threadsafe, so you
- *     can't safely use cstrings off the main thread.
+ *
+ * Interning is thread-safe: the intern table is sharded by hash and each shard is
+ * guarded by its own lock, so cstrings may be created concurrently from several
+ * threads and still compare equal by pointer.
  *
  * Given these tradeoffs, the general rule of thumb to follow is that you should
  * try to convert strings to cstrings early and keep them in that form. That
@@ -11,6 +11,9 @@
 #include <iostream>
 #include <ostream>
 #include <set>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 #include <type_traits>
 #include <unordered_map>
 
@@ -60,12 +63,25 @@ class ErrorReporter {
         outputstream->flush();
     }
 
+#ifdef MULTITHREAD
+    /// Serializes the diagnostics reported by ThreadPool workers that share a compile
+    /// context, such as the testgen --threads workers or the concurrent PHV and table
+    /// placement searches of the Tofino backend.
+    static std::unique_lock<std::recursive_mutex> serialize() {
+        static std::recursive_mutex theLock;
+        return std::unique_lock<std::recursive_mutex>(theLock);
+    }
+#else
+    static int serialize() { return 0; }
+#endif  // MULTITHREAD
+
     /// Check whether an error has already been reported, by keeping track of error type
     /// and source info.
     /// If the error has been reported, return true. Otherwise, insert add the error to the
     /// list of seen errors, and return false.
     bool error_reported(int err, const Util::SourceInfo source) {
         if (!source.isValid()) return false;
+        [[maybe_unused]] auto guard = serialize();
         auto p = errorTracker.emplace(err, source);
         return !p.second;  // if insertion took place, then we have not seen the error.
     }
@@ -129,6 +145,7 @@ class ErrorReporter {
     void diagnose(DiagnosticAction action, const char *diagnosticName, const char *format,
                   const char *suffix, Args &&...args) {
         if (action == DiagnosticAction::Ignore) return;
+        [[maybe_unused]] auto guard = serialize();
 
         ErrorMessage::MessageType msgType = ErrorMessage::MessageType::None;
         if (action == DiagnosticAction::Info) {
@@ -185,6 +202,7 @@ class ErrorReporter {
     /// position information provided by Bison.
     template <typename T>
     void parser_error(const Util::SourceInfo &location, const T &message) {
+        [[maybe_unused]] auto guard = serialize();
         errorCount++;
         std::stringstream ss;
         ss << message;
@@ -200,6 +218,7 @@ class ErrorReporter {
      */
     template <typename... Args>
     void parser_error(const Util::InputSources *sources, const char *fmt, Args &&...args) {
+        [[maybe_unused]] auto guard = serialize();
         errorCount++;
 
         Util::SourcePosition position = sources->getCurrentPosition();
@@ -23,8 +23,13 @@
 #include <gc/gc_mark.h>
 #endif /* HAVE_LIBGC */
 #include <sys/mman.h>
+#include <sys/resource.h>
 
+#include <atomic>
+#include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <new>
 
@@ -57,18 +62,95 @@ static bool tracing = false;
         tracing = false;                                   \
     }
 
-static void maybe_initialize_gc() {
-    if (!done_init) {
-        started_init = true;
-        GC_INIT();
-        done_init = true;
+// Arena mode: for a one-shot compile almost nothing needs to be freed before exit, so
+// instead of paying for collections, operator new bumps a pointer through thread-local
+// chunks of memory that are never reused and only released when the process exits. The
+// collector is disabled, so memory obtained through malloc is never collected either.
+// Selected with P4C_ALLOCATOR=arena (or =gc), defaulting to arena mode when built with
+// ENABLE_ARENA_ALLOC.
+static bool arena_mode;
+static std::chrono::steady_clock::time_point alloc_start;
+
+namespace {
+
+struct arena_t {
+    static constexpr size_t chunk_size = 4 << 20;
+    // Larger requests get a mapping of their own rather than wasting the rest of a chunk.
+    static constexpr size_t max_small = chunk_size / 8;
+
+    char *ptr = nullptr;
+    char *end = nullptr;
+    // Bytes handed out by this thread, see gc_bytes_allocated().
+    size_t allocated = 0;
+
+    static std::atomic<size_t> mapped_bytes;
+    static std::atomic<size_t> mapped_chunks;
+
+    static char *map(size_t size) {
+        void *rv = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (rv == MAP_FAILED) return nullptr;
+        mapped_bytes += size;
+        ++mapped_chunks;
+        return static_cast<char *>(rv);
+    }
+
+    void *alloc(size_t size, size_t align) {
+        if (align < alignof(std::max_align_t)) align = alignof(std::max_align_t);
+        if (size == 0) size = 1;
+        allocated += size;
+        if (size > max_small) return map(size);
+        char *rv = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(ptr) + align - 1) &
+                                            ~(uintptr_t(align) - 1));
+        if (!ptr || rv + size > end) {
+            if (!(ptr = map(chunk_size))) return nullptr;
+            end = ptr + chunk_size;
+            rv = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(ptr) + align - 1) &
+                                          ~(uintptr_t(align) - 1));
+        }
+        ptr = rv + size;
+        return rv;
+    }
+};
+
+std::atomic<size_t> arena_t::mapped_bytes;
+std::atomic<size_t> arena_t::mapped_chunks;
+
+thread_local arena_t arena;
+
+}  // namespace
+
+static void initialize_allocator() {
+    started_init = true;
+    GC_INIT();
+    alloc_start = std::chrono::steady_clock::now();
+#if ENABLE_ARENA_ALLOC
+    arena_mode = true;
+#endif
+    if (const char *mode = getenv("P4C_ALLOCATOR")) {
+        if (!strcmp(mode, "arena"))
+            arena_mode = true;
+        else if (!strcmp(mode, "gc"))
+            arena_mode = false;
     }
+    if (arena_mode) GC_disable();
+    done_init = true;
+}
+
+static void maybe_initialize_gc() {
+    if (!done_init) initialize_allocator();
+}
+
+static void *arena_new(std::size_t size, std::size_t align) {
+    auto *rv = arena.alloc(size, align);
+    if (!rv) throw backtrace_exception<std::bad_alloc>();
+    return rv;
 }
 
 void *operator new(std::size_t size) {
     TRACE_ALLOC(size)
 
     maybe_initialize_gc();
+    if (arena_mode) return arena_new(size, alignof(std::max_align_t));
     auto *rv = ::operator new(size, UseGC, 0, 0);
     if (!rv && emergency_ptr && emergency_ptr + size < emergency_pool + sizeof(emergency_pool)) {
         rv = emergency_ptr;
@@ -86,6 +168,7 @@ void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
     TRACE_ALLOC(size)
 
     maybe_initialize_gc();
+    if (arena_mode) return arena.alloc(size, alignof(std::max_align_t));
     // FIXME: Call nothrow operator new from libgc with suitable new libgc
     // versions
     auto *rv = ::operator new(size, UseGC, 0, 0);
@@ -105,6 +188,7 @@ void *operator new(std::size_t size, std::align_val_t alignment) {
         alignment = std::align_val_t(sizeof(void *));
 
     maybe_initialize_gc();
+    if (arena_mode) return arena_new(size, static_cast<size_t>(alignment));
 
     void *rv = nullptr;
     if (GC_posix_memalign(&rv, static_cast<size_t>(alignment), size) != 0)
@@ -120,6 +204,7 @@ void *operator new(std::size_t size, std::align_val_t alignment, const std::noth
         alignment = std::align_val_t(sizeof(void *));
 
     maybe_initialize_gc();
+    if (arena_mode) return arena.alloc(size, static_cast<size_t>(alignment));
 
     void *rv = nullptr;
     if (GC_posix_memalign(&rv, static_cast<size_t>(alignment), size) != 0) rv = nullptr;
@@ -140,7 +225,9 @@ alloc_trace_cb_t set_alloc_trace(void (*fn)(void *, void **, size_t), void *arg)
     return old;
 }
 
+// Arena memory is never reused, so in arena mode deleting is a no-op.
 void operator delete(void *p) noexcept {
+    if (arena_mode) return;
     if (p >= emergency_pool && p < emergency_pool + sizeof(emergency_pool)) {
         return;
     }
@@ -148,6 +235,7 @@ void operator delete(void *p) noexcept {
 }
 
 void operator delete(void *p, std::size_t /*size*/) noexcept {
+    if (arena_mode) return;
     if (p >= emergency_pool && p < emergency_pool + sizeof(emergency_pool)) {
         return;
     }
@@ -156,9 +244,13 @@ void operator delete(void *p, std::size_t /*size*/) noexcept {
 
 // FIXME: We can get rid of GC_base here with suitable new libgc
 // See https://github.com/ivmai/bdwgc/issues/589 for more info
-void operator delete(void *p, std::align_val_t) noexcept { gc::operator delete(GC_base(p)); }
+void operator delete(void *p, std::align_val_t) noexcept {
+    if (arena_mode) return;
+    gc::operator delete(GC_base(p));
+}
 
 void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    if (arena_mode) return;
     gc::operator delete(GC_base(p));
 }
 
@@ -183,7 +275,7 @@ namespace {
 
 constexpr size_t headerSize = 16;
 using max_align_t = std::max_align_t;
-static_assert(headerSize >= alignof(max_align_t), "mmap header size not large enough");
+static_assert(headerSize >= alignof(std::max_align_t), "mmap header size not large enough");
 static_assert(headerSize >= sizeof(size_t), "mmap header size not large enough");
 
 void *data_to_header(void *ptr) { return static_cast<char *>(ptr) - headerSize; }
@@ -223,9 +315,7 @@ void *realloc(void *ptr, size_t size) {
             }
             return rv;
         } else {
-            started_init = true;
-            GC_INIT();
-            done_init = true;
+            initialize_allocator();
         }
     }
     TRACE_ALLOC(size)
@@ -292,6 +382,24 @@ void silent(const char * /*unused*/, GC_word /*unused*/) {}
 void silent(char * /*unused*/, GC_word /*unused*/) {}
 #endif
 
+// Reports the cost of the allocation mode in use, so that arena and GC mode runs of the same
+// compile can be compared.
+static void report_allocator_stats() {
+    if (gc_logging_level < 1) return;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    auto wall = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - alloc_start)
+                    .count();
+    std::clog << "****** allocator: " << (arena_mode ? "arena" : "gc") << ", wall time "
+              << wall / 1000.0 << "s, peak RSS " << n4(uint64_t(usage.ru_maxrss) * 1024) << "B";
+    if (arena_mode)
+        std::clog << ", arenas " << n4(arena_t::mapped_bytes) << "B in "
+                  << arena_t::mapped_chunks << " mappings";
+    std::clog << ", GC heap " << n4(GC_get_heap_size()) << "B, GC collections "
+              << GC_get_gc_no() << std::endl;
+}
+
 void reset_gc_logging() {
     gc_logging_level = Log::Detail::fileLogLevel(__FILE__);
 #if HAVE_GC_PRINT_STATS
@@ -307,11 +415,16 @@ void setup_gc_logging() {
     reset_gc_logging();
     Log::Detail::addInvalidateCallback(reset_gc_logging);
     GC_set_warn_proc(&silent);
+    std::atexit(report_allocator_stats);
 #endif /* HAVE_LIBGC */
 }
 
 size_t gc_mem_inuse(size_t *max) {
 #if HAVE_LIBGC
+    if (arena_mode) {
+        if (max) *max = arena_t::mapped_bytes + GC_get_heap_size();
+        return arena_t::mapped_bytes + GC_get_heap_size() - GC_get_free_bytes();
+    }
     GC_word heapsize, heapfree;
     GC_gcollect();
     GC_get_heap_usage_safe(&heapsize, &heapfree, 0, 0, 0);
@@ -322,3 +435,33 @@ size_t gc_mem_inuse(size_t *max) {
     return 0;
 #endif
 }
+
+size_t gc_bytes_allocated() {
+#if HAVE_LIBGC
+    if (arena_mode) return arena.allocated + GC_get_total_bytes();
+    return done_init ? GC_get_total_bytes() : 0;
+#else
+    return 0;
+#endif
+}
+
+void gc_allow_threads() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    maybe_initialize_gc();
+    GC_allow_register_threads();
+#endif
+}
+
+void gc_register_thread() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    GC_stack_base sb;
+    GC_get_stack_base(&sb);
+    GC_register_my_thread(&sb);
+#endif
+}
+
+void gc_unregister_thread() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    GC_unregister_my_thread();
+#endif
+}
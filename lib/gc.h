@@ -14,6 +14,16 @@
 
 void setup_gc_logging();
 size_t gc_mem_inuse(size_t *max = 0);  // trigger GC, return inuse after
+/// Total bytes allocated by the garbage collector since startup, without triggering a
+/// collection. In arena mode (P4C_ALLOCATOR=arena) this includes the arena bytes allocated
+/// by the calling thread. Always 0 when built without the garbage collector.
+size_t gc_bytes_allocated();
+/// Threads other than the main one must be registered with the garbage collector while
+/// they allocate. gc_allow_threads() must be called on the main thread before the first
+/// registration. All three do nothing unless built with the collector and MULTITHREAD.
+void gc_allow_threads();
+void gc_register_thread();
+void gc_unregister_thread();
 
 struct alloc_trace_cb_t {
     void (*fn)(void *arg, void **pc, size_t sz);
@@ -33,7 +33,7 @@ namespace Detail {
 int verbosity = 0;
 int maximumLogLevel = 0;
 bool enableLoggingGlobally = true;
-bool enableLoggingInContext = false;
+thread_local bool enableLoggingInContext = false;
 
 // The time at which logging was initialized; used so that log messages can have
 // relative rather than absolute timestamps.
@@ -59,6 +59,9 @@ static std::unordered_map<std::string, std::unique_ptr<std::ostream>> logfiles;
 
 static std::vector<void (*)(void)> invalidateCallbacks;
 
+// The buffer that collects the log output of this thread, if any.
+static thread_local OutputBuffer *capturingBuffer = nullptr;
+
 int OutputLogPrefix::ostream_xalloc = -1;
 void OutputLogPrefix::setup_ostream_xalloc(std::ostream &out) {
     if (ostream_xalloc < 0) {
@@ -279,6 +282,7 @@ std::ostream &fileLogOutput(const char *file) {
             info->out = &uncachedFileLogOutput(file);
         }
     }
+    if (capturingBuffer) return capturingBuffer->streamFor(*info->out);
     return *info->out;
 }
 
@@ -294,6 +298,24 @@ void addInvalidateCallback(void (*fn)(void)) { invalidateCallbacks.push_back(fn)
 
 }  // namespace Detail
 
+OutputBuffer::Capture::Capture(OutputBuffer &buffer) : previous(Detail::capturingBuffer) {
+    Detail::capturingBuffer = &buffer;
+}
+
+OutputBuffer::Capture::~Capture() { Detail::capturingBuffer = previous; }
+
+std::ostream &OutputBuffer::streamFor(std::ostream &out) {
+    for (auto &[stream, buffer] : streams)
+        if (stream == &out) return *buffer;
+    streams.emplace_back(&out, std::make_unique<std::stringstream>());
+    return *streams.back().second;
+}
+
+void OutputBuffer::flush() {
+    for (auto &[stream, buffer] : streams) *stream << buffer->str() << std::flush;
+    streams.clear();
+}
+
 void addDebugSpec(const char *spec) {
 #ifdef CLOCK_MONOTONIC
     if (!Detail::initTime) {
@@ -10,8 +10,10 @@
 
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <set>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include "config.h"
@@ -33,7 +35,7 @@ extern int maximumLogLevel;
 
 // Used to restrict logging to a specific IR context.
 extern bool enableLoggingGlobally;
-extern bool enableLoggingInContext;  // if enableLoggingGlobally is true, this is ignored.
+extern thread_local bool enableLoggingInContext;  // ignored if enableLoggingGlobally is true
 
 // Look up the log level of @file.
 int fileLogLevel(const char *file);
@@ -91,6 +93,35 @@ inline bool enableLogging() {
 }
 void increaseVerbosity();
 
+/// Collects the log output of a thread, while a Capture of it is alive on that thread, instead
+/// of writing it to the log streams. Tasks that run concurrently can each log to their own
+/// buffer, and the buffers can then be flushed in task order, so that the logs do not interleave
+/// and come out as in a serial run. The output meant for each log stream is kept apart.
+class OutputBuffer {
+ public:
+    /// Redirects the log output of the current thread to a buffer for its lifetime.
+    class Capture {
+        OutputBuffer *previous;
+
+     public:
+        explicit Capture(OutputBuffer &buffer);
+        ~Capture();
+        Capture(const Capture &) = delete;
+        Capture &operator=(const Capture &) = delete;
+    };
+
+    /// Writes the collected output to the log streams it was meant for, and clears it.
+    void flush();
+
+ private:
+    friend std::ostream &Detail::fileLogOutput(const char *file);
+
+    /// @returns the stream that collects the output meant for @p out.
+    std::ostream &streamFor(std::ostream &out);
+
+    std::vector<std::pair<std::ostream *, std::unique_ptr<std::stringstream>>> streams;
+};
+
 }  // namespace Log
 }  // namespace P4
 
@@ -101,6 +101,7 @@ std::vector<const char *> *Util::Options::process_options(int argc, char *const
                 }
                 arg = argv[++i];
             }
+            processedOptions.emplace_back(option, cstring(arg));
             bool success = option->processor(arg);
             if (!success) {
                 shortUsage();
@@ -118,6 +119,37 @@ std::vector<const char *> *Util::Options::process_options(int argc, char *const
     return &remainingOptions;
 }
 
+std::vector<std::string> Util::Options::processedArguments(size_t start) const {
+    std::vector<std::string> result;
+    for (size_t i = start; i < processedOptions.size(); ++i) {
+        const auto &[option, arg] = processedOptions[i];
+        if (arg.isNull()) {
+            result.push_back(option->option.string());
+        } else if (option->option.startsWith("--")) {
+            result.push_back(option->option + "=" + arg);
+        } else if (option->flags & OptionFlags::OptionalArgument) {
+            // Single-dash options only accept optional arguments without a separator.
+            result.push_back(option->option + arg);
+        } else {
+            result.push_back(option->option.string());
+            result.push_back(arg.string());
+        }
+    }
+    return result;
+}
+
+std::string Util::Options::processedOptionsKey(unsigned ignoredFlags) const {
+    std::string result;
+    for (const auto &[option, arg] : processedOptions) {
+        if (option->flags & ignoredFlags) continue;
+        result += option->option.string_view();
+        result += '\0';
+        if (!arg.isNull()) result += arg.string_view();
+        result += '\0';
+    }
+    return result;
+}
+
 void Util::Options::usage() {
     *outStream << binaryName << ": " << message << std::endl;
 
@@ -13,6 +13,7 @@
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cstring.h"
@@ -37,6 +38,12 @@ class Options {
         /// `--foo` were omitted. If the argument is omitted, null will be
         /// passed to the OptionProcessor.
         OptionalArgument = 1 << 1,
+        /// This option does not change the IR produced by the frontend, only what later
+        /// stages do; the compilation cache (--cache-dir) ignores it for frontend results.
+        MidendOnly = 1 << 2,
+        /// This option does not change the IR produced by the frontend and the midend (e.g.
+        /// it names an output file); the compilation cache ignores it for both.
+        BackendOnly = 1 << 3,
     };
 
     // return true if processing is successful
@@ -64,6 +71,8 @@ class Options {
     std::vector<cstring> optionOrder;
     std::vector<const char *> additionalUsage;
     std::vector<const char *> remainingOptions;  // produced as output
+    // options processed so far with their argument (null if none), in order
+    std::vector<std::pair<const Option *, cstring>> processedOptions;
     // if true unknown options are collected in remainingOptions
     bool collectUnknownOptions = false;
 
@@ -112,6 +121,15 @@ class Options {
     cstring getCompileCommand() { return compileCommand; }
     cstring getBuildDate() { return buildDate; }
     cstring getBinaryName() { return cstring(binaryName); }
+
+    /// @return the number of options processed so far, including options from pragmas.
+    size_t processedOptionCount() const { return processedOptions.size(); }
+    /// @return the options processed after the first @p start ones as arguments for
+    /// process_options(), e.g. to replay the options set by pragmas in another run.
+    std::vector<std::string> processedArguments(size_t start = 0) const;
+    /// @return a string identifying the processed options that have none of the flags in
+    /// @p ignoredFlags, and their arguments, in order. Used to key cached compilation results.
+    std::string processedOptionsKey(unsigned ignoredFlags) const;
     virtual void usage();
 };
 
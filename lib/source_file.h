@@ -27,6 +27,11 @@
 #include "gtest/gtest_prod.h"
 #endif
 
+namespace P4 {
+class BinaryReader;
+class BinaryWriter;
+}  // namespace P4
+
 namespace P4::Test {
 class UtilSourceFile;
 }
@@ -121,6 +126,10 @@ exclusive (the first position after the language element).
 SourceInfo can also be "invalid"
 */
 class SourceInfo final {
+    // Binary IR snapshots save and restore the positions.
+    friend class P4::BinaryReader;
+    friend class P4::BinaryWriter;
+
  public:
     cstring filename = ""_cs;
     int line = -1;
@@ -281,6 +290,8 @@ class InputSources final {
 #ifdef P4C_GTEST_ENABLED
     FRIEND_TEST(UtilSourceFile, InputSources);
 #endif
+    friend class P4::BinaryReader;
+    friend class P4::BinaryWriter;
 
  public:
     InputSources();
@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "lib/thread_pool.h"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+#ifdef MULTITHREAD
+#include <pthread.h>
+#endif
+
+#include "lib/compile_context.h"
+#include "lib/exceptions.h"
+#include "lib/gc.h"
+
+namespace P4 {
+
+struct ThreadPool::Worker {
+    ThreadPool *pool = nullptr;
+    std::mutex lock;
+    std::deque<Task> tasks;
+#ifdef MULTITHREAD
+    pthread_t thread;
+#endif
+};
+
+thread_local ThreadPool::Worker *ThreadPool::current = nullptr;
+
+ThreadPool::ThreadPool(unsigned threads) : workers(MAX_THREADS + 1) {
+    // The last entry holds the tasks that are added without any workers.
+    workers.back() = std::make_unique<Worker>();
+    workers.back()->pool = this;
+    gc_allow_threads();
+    grow(threads);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+#ifdef MULTITHREAD
+    // A destructor must not throw, so a failure to join is ignored.
+    for (unsigned i = 0; i < workerCount.load(); ++i) pthread_join(workers[i]->thread, nullptr);
+#endif
+}
+
+ThreadPool &ThreadPool::shared(unsigned threads) {
+    // Never destroyed: the workers may still run when static objects are destroyed.
+    static auto *pool = new ThreadPool(0);
+    pool->grow(threads);
+    return *pool;
+}
+
+void ThreadPool::grow(unsigned threads) {
+#ifdef MULTITHREAD
+    std::lock_guard<std::mutex> guard(growLock);
+    threads = std::min(threads, MAX_THREADS);
+    for (unsigned i = workerCount.load(); i < threads; ++i) {
+        auto &worker = workers[i];
+        worker = std::make_unique<Worker>();
+        worker->pool = this;
+        pthread_attr_t attr;
+        int err = pthread_attr_init(&attr);
+        BUG_CHECK(!err, "Pthread Attribute initialization fail with error: %d", err);
+        err = pthread_attr_setstacksize(&attr, STACK_SIZE);
+        BUG_CHECK(!err, "Pthread Attribute Set Stack Size fail with error: %d", err);
+        err = pthread_create(
+            &worker->thread, &attr,
+            [](void *arg) -> void * {
+                auto *self = static_cast<Worker *>(arg);
+                self->pool->work(*self);
+                return nullptr;
+            },
+            worker.get());
+        BUG_CHECK(!err, "Pthread Creation fail with error: %d", err);
+        pthread_attr_destroy(&attr);
+        workerCount.store(i + 1);
+    }
+#else
+    (void)threads;
+#endif
+}
+
+ThreadPool::Worker *ThreadPool::currentWorker() const {
+    auto *worker = current;
+    return worker != nullptr && worker->pool == this ? worker : nullptr;
+}
+
+void ThreadPool::push(Task task) {
+    auto *worker = currentWorker();
+    if (worker == nullptr) {
+        auto count = workerCount.load();
+        worker = count == 0 ? workers.back().get() : workers[nextWorker++ % count].get();
+    }
+    {
+        std::lock_guard<std::mutex> guard(worker->lock);
+        worker->tasks.push_back(std::move(task));
+    }
+    ++queued;
+    // Taking the lock orders the update of queued before the check of a worker going to sleep.
+    { std::lock_guard<std::mutex> guard(sleepLock); }
+    wakeUp.notify_one();
+}
+
+std::optional<ThreadPool::Task> ThreadPool::take(Worker *self, const TaskGroup *group) {
+    if (queued.load() == 0) return std::nullopt;
+    auto matches = [group](const Task &task) { return group == nullptr || task.group == group; };
+    auto takeFrom = [&](Worker &worker, bool fromBack) -> std::optional<Task> {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        auto &tasks = worker.tasks;
+        if (fromBack) {
+            auto it = std::find_if(tasks.rbegin(), tasks.rend(), matches);
+            if (it == tasks.rend()) return std::nullopt;
+            auto task = std::move(*it);
+            tasks.erase(std::next(it).base());
+            return task;
+        }
+        auto it = std::find_if(tasks.begin(), tasks.end(), matches);
+        if (it == tasks.end()) return std::nullopt;
+        auto task = std::move(*it);
+        tasks.erase(it);
+        return task;
+    };
+
+    std::optional<Task> task;
+    if (self != nullptr) task = takeFrom(*self, true);
+    auto count = workerCount.load();
+    // Start at a different victim on every attempt, so that the stealing is spread out.
+    auto start = count == 0 ? 0 : nextWorker++ % count;
+    for (unsigned i = 0; !task && i < count; ++i) {
+        auto &victim = *workers[(start + i) % count];
+        if (&victim != self) task = takeFrom(victim, false);
+    }
+    if (!task) task = takeFrom(*workers.back(), false);
+    if (task) --queued;
+    return task;
+}
+
+void ThreadPool::run(Task &task) {
+    std::exception_ptr exception;
+    try {
+        if (task.context != nullptr) {
+            AutoCompileContext autoContext(task.context);
+            task.function();
+        } else {
+            task.function();
+        }
+    } catch (...) {
+        exception = std::current_exception();
+    }
+    task.group->taskFinished(exception);
+}
+
+void ThreadPool::work(Worker &self) {
+    gc_register_thread();
+    current = &self;
+    while (true) {
+        if (auto task = take(&self, nullptr)) {
+            run(*task);
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wakeUp.wait(guard, [this] { return queued.load() > 0 || stopping; });
+        if (stopping && queued.load() == 0) break;
+    }
+    current = nullptr;
+    gc_unregister_thread();
+}
+
+TaskGroup::TaskGroup(ThreadPool &pool) : pool(pool) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // The exceptions are only reported by an explicit call to wait().
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    ICompileContext *context = nullptr;
+    if (!CompileContextStack::isEmpty()) context = &CompileContextStack::top<ICompileContext>();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ++unfinished;
+    }
+    pool.push({std::move(task), this, context});
+}
+
+void TaskGroup::wait() {
+    auto *self = pool.currentWorker();
+    while (true) {
+        // Run the queued tasks of this group here rather than waiting for a worker to take them.
+        if (auto task = pool.take(self, this)) {
+            ThreadPool::run(*task);
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(lock);
+        if (unfinished == 0) break;
+        // The remaining tasks are running elsewhere.
+        finished.wait(guard, [this] { return unfinished == 0; });
+        break;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    if (auto exception = std::exchange(failure, nullptr)) std::rethrow_exception(exception);
+}
+
+void TaskGroup::taskFinished(std::exception_ptr exception) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (exception && !failure) failure = exception;
+    if (--unfinished == 0) finished.notify_all();
+}
+
+}  // namespace P4
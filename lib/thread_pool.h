@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LIB_THREAD_POOL_H_
+#define LIB_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace P4 {
+
+class ICompileContext;
+class TaskGroup;
+
+/// A pool of worker threads that run the tasks of TaskGroups. Each worker has its own deque of
+/// tasks. A task that is added by a worker goes to the back of that worker's deque, and the
+/// worker takes its next task from the back as well, so that nested tasks run depth-first on
+/// the worker that created them. Idle workers steal from the front of the other deques, which
+/// holds the oldest, usually largest, tasks.
+///
+/// Workers are registered with the garbage collector for their whole lifetime and have large
+/// stacks, as the visitors recurse deeply. Each task runs with the compilation context that was
+/// current when it was added to its group.
+///
+/// Without MULTITHREAD, a pool has no workers and the tasks of a group run on the thread that
+/// waits for the group.
+class ThreadPool {
+ public:
+    /// The stack size of the workers.
+    static constexpr size_t STACK_SIZE = size_t(64) << 20;
+
+    /// The maximum number of workers of a pool.
+    static constexpr unsigned MAX_THREADS = 256;
+
+    /// Starts @p threads workers.
+    explicit ThreadPool(unsigned threads);
+
+    /// Stops the workers once they have run all queued tasks.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// @returns the pool shared by all compiler subsystems, with at least @p threads workers.
+    /// The pool is created by the first call, which must happen on the main thread, and grows
+    /// when a later call asks for more workers.
+    static ThreadPool &shared(unsigned threads);
+
+    /// @returns the number of workers.
+    [[nodiscard]] unsigned size() const { return workerCount.load(); }
+
+    /// Starts workers until there are @p threads, or MAX_THREADS.
+    void grow(unsigned threads);
+
+ private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> function;
+        TaskGroup *group;
+        /// The compilation context of the thread that added the task, if any.
+        ICompileContext *context;
+    };
+
+    struct Worker;
+
+    /// The worker that is the current thread, if any.
+    static thread_local Worker *current;
+
+    /// The workers. Only the first workerCount entries are set, and set entries never change,
+    /// so the vector can be read without a lock.
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<unsigned> workerCount = 0;
+
+    /// Serializes the calls to grow.
+    std::mutex growLock;
+
+    /// The number of queued tasks. Idle workers sleep until it is not zero.
+    std::atomic<size_t> queued = 0;
+    std::mutex sleepLock;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+
+    /// Used to spread tasks that are added by threads that are not workers of this pool.
+    std::atomic<unsigned> nextWorker = 0;
+
+    /// Queues @p task, see the class comment.
+    void push(Task task);
+
+    /// Takes a task, preferring the back of the deque of @p self, if it is not null, and
+    /// stealing from the front of the other deques otherwise. If @p group is not null, only
+    /// takes the tasks of @p group.
+    std::optional<Task> take(Worker *self, const TaskGroup *group);
+
+    /// Runs @p task and reports its completion to its group.
+    static void run(Task &task);
+
+    /// The main loop of a worker.
+    void work(Worker &self);
+
+    /// @returns the worker of this pool that is the current thread, or nullptr.
+    Worker *currentWorker() const;
+};
+
+/// A set of tasks that run on a ThreadPool and can be waited for together. Tasks can add more
+/// tasks to their own or to other groups. The thread that waits for a group runs the queued
+/// tasks of that group itself, so waiting on a worker does not block it.
+///
+/// @code
+///     TaskGroup group(ThreadPool::shared(jobs));
+///     for (auto *object : objects) group.run([object] { process(object); });
+///     group.wait();
+/// @endcode
+class TaskGroup {
+ public:
+    explicit TaskGroup(ThreadPool &pool);
+
+    /// Waits for the tasks of the group. Their exceptions are dropped, unless wait() was called.
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    /// Adds @p task to the group. It runs with the current compilation context, which must
+    /// stay alive until the group has been waited for.
+    void run(std::function<void()> task);
+
+    /// Waits until all tasks of the group have finished. Rethrows the first exception that a
+    /// task threw; the other tasks still run to completion.
+    void wait();
+
+    /// @returns the pool that runs the tasks.
+    [[nodiscard]] ThreadPool &getPool() const { return pool; }
+
+ private:
+    friend class ThreadPool;
+
+    ThreadPool &pool;
+
+    std::mutex lock;
+    std::condition_variable finished;
+    /// The number of tasks that have been added but have not finished.
+    size_t unfinished = 0;
+    /// The first exception thrown by a task.
+    std::exception_ptr failure;
+
+    /// Called by the pool when a task of the group has finished.
+    void taskFinished(std::exception_ptr exception);
+};
+
+/// Calls @p body(i) for each i in [@p begin, @p end) on the workers of @p pool and the calling
+/// thread, with at most @p jobs calls at a time, and waits for all of them. The indices are
+/// handed out one at a time, in order. Rethrows the first exception thrown by @p body; the
+/// indices after it may not be visited.
+template <typename Body>
+void parallel_for(ThreadPool &pool, unsigned jobs, size_t begin, size_t end, const Body &body) {
+    if (begin >= end) return;
+    std::atomic<size_t> next = begin;
+    auto loop = [&]() {
+        for (size_t i; (i = next++) < end;) body(i);
+    };
+    size_t tasks = std::min<size_t>(std::max(jobs, 1U), end - begin);
+    TaskGroup group(pool);
+    for (size_t i = 0; i < tasks; ++i) group.run(loop);
+    group.wait();
+}
+
+}  // namespace P4
+
+#endif /* LIB_THREAD_POOL_H_ */
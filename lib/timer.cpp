@@ -8,6 +8,10 @@
 #include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
 #include <cstdint>
 #include <memory>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
@@ -48,30 +52,45 @@ struct CounterEntry {
 struct RootCounter {
     /// The topmost counter.
     CounterEntry counter;
-    /// The most inner currently active counter.
-    CounterEntry *current;
     Clock::time_point start;
+#ifdef MULTITHREAD
+    /// Protects the counters, which are shared by all threads.
+    std::mutex lock;
+#endif  // MULTITHREAD
 
     static RootCounter &get() {
-        // TODO: not threadsafe currently. Instance of RootCounter could be thread_local:
-        //
-        // thread_local RootCounter root;
-        //
-        // however libgc cannot scan thread local data, which can lead to premature object
-        // garbage collection.
         static RootCounter ROOT;
-        ROOT.counter.duration = Clock::now() - ROOT.start;
         return ROOT;
     }
 
-    CounterEntry *getCurrent() const { return current; }
+    /// Must be called with the lock held.
+    CounterEntry *getCurrent() {
+        auto it = current.find(std::this_thread::get_id());
+        return it != current.end() ? it->second : &counter;
+    }
 
-    void setCurrent(CounterEntry *c) { current = c; }
+    /// Must be called with the lock held.
+    void setCurrent(CounterEntry *c) {
+        if (c == &counter)
+            current.erase(std::this_thread::get_id());
+        else
+            current[std::this_thread::get_id()] = c;
+    }
 
  private:
-    RootCounter() : counter(""), current(&counter) { start = Clock::now(); }
+    /// The most inner currently active counter of each thread with an active counter. It is
+    /// kept here rather than in thread local storage, which libgc does not scan.
+    std::unordered_map<std::thread::id, CounterEntry *> current;
+
+    RootCounter() : counter("") { start = Clock::now(); }
 };
 
+#ifdef MULTITHREAD
+#define TIMER_LOCK std::lock_guard<std::mutex> acquire(RootCounter::get().lock)
+#else
+#define TIMER_LOCK
+#endif  // MULTITHREAD
+
 }  // namespace
 
 #pragma GCC diagnostic push
@@ -90,16 +109,21 @@ struct ScopedTimerCtx {
     CounterEntry *self = nullptr;
     Clock::time_point startTime;
 
-    explicit ScopedTimerCtx(const char *timerName)
-        : parent(RootCounter::get().getCurrent()), self(parent->openSubcounter(timerName)) {
+    explicit ScopedTimerCtx(const char *timerName) {
+        {
+            TIMER_LOCK;
+            // Push new active counter - the current active counter becomes the parent of this
+            // counter, and this counter becomes the current active counter.
+            parent = RootCounter::get().getCurrent();
+            self = parent->openSubcounter(timerName);
+            RootCounter::get().setCurrent(self);
+        }
         startTime = Clock::now();
-        // Push new active counter - the current active counter becomes the parent of this
-        // counter, and this counter becomes the current active counter.
-        RootCounter::get().setCurrent(self);
     }
     ~ScopedTimerCtx() {
         // Close the current timer invocation, measure time and add it to the counter.
         auto duration = Clock::now() - startTime;
+        TIMER_LOCK;
         self->add(duration);
         // Restore previous counter as current.
         RootCounter::get().setCurrent(parent);
@@ -146,8 +170,13 @@ static void formatCounters(std::vector<TimerEntry> &out, CounterEntry &current,
 std::vector<TimerEntry> getTimers() {
     std::vector<TimerEntry> ret;
     std::string namePrefix;
-    formatCounters(ret, RootCounter::get().counter, namePrefix, 0);
+    auto &root = RootCounter::get();
+    TIMER_LOCK;
+    root.counter.duration = Clock::now() - root.start;
+    formatCounters(ret, root.counter, namePrefix, 0);
     return ret;
 }
 
+#undef TIMER_LOCK
+
 }  // namespace P4::Util
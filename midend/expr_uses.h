@@ -8,15 +8,22 @@
 #ifndef MIDEND_EXPR_USES_H_
 #define MIDEND_EXPR_USES_H_
 
+#include "absl/container/flat_hash_map.h"
+#include "ir/analysis_cache.h"
 #include "ir/ir.h"
 
 namespace P4 {
 
 /* Should this be a method on IR::Expression? */
 
+/// Results of exprUses per expression and lvalue.
+using ExprUsesCache = AnalysisCache<absl::flat_hash_map<cstring, bool>>;
+
 /// Functor to check if an expression uses an lvalue.  The lvalue is specified as a
 /// a cstring, which can be the name of a variable with optional field names and constant
 /// array indexes for fields of headers or structs or unions or elements of stacks.
+/// The result only depends on the expression, so a pass that asks the same questions about
+/// the same expressions many times can keep the results in an ExprUsesCache.
 class exprUses : public Inspector {
     cstring look_for;
     const char *search_tail = nullptr;  // pointer into look_for for partial match
@@ -69,9 +76,19 @@ class exprUses : public Inspector {
     void postorder(const IR::Expression *) override { search_tail = nullptr; }
 
  public:
-    exprUses(const IR::Expression *e, cstring n) : look_for(n) {
+    exprUses(const IR::Expression *e, cstring n, ExprUsesCache *cache = nullptr) : look_for(n) {
         visitDagOnce = false;
+        if (!cache) {
+            e->apply(*this);
+            return;
+        }
+        auto &known = (*cache)[e];
+        if (auto it = known.find(n); it != known.end()) {
+            result = it->second;
+            return;
+        }
         e->apply(*this);
+        known.emplace(n, result);
     }
     explicit operator bool() const { return result; }
 };
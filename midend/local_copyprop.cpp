@@ -266,7 +266,7 @@ void DoLocalCopyPropagation::dropValuesUsing(cstring name) {
             LOG4("   dropping " << (var.second.val ? "" : "(nop) ") << "as " << name
                                 << " is being assigned to");
             var.second.val = nullptr;
-        } else if (var.second.val && exprUses(var.second.val, name)) {
+        } else if (var.second.val && exprUses(var.second.val, name, usesCache)) {
             LOG4("   dropping " << (var.second.val ? "" : "(nop) ") << var.first << " as it uses "
                                 << name);
             var.second.val = nullptr;
@@ -417,7 +417,7 @@ IR::AssignmentStatement *DoLocalCopyPropagation::postorder(IR::AssignmentStateme
                  * we can copyprop them */
                 return as;
             }
-            if (exprUses(as->right, dest)) {
+            if (exprUses(as->right, dest, usesCache)) {
                 /* can't propagate the value as it is defined in terms of itself.
                  * FIXME -- we could propagate if we introduced a new temp, but that
                  * may make things worse rather than better */
@@ -937,4 +937,24 @@ void DoLocalCopyPropagation::end_apply(const IR::Node *node) {
     Transform::end_apply(node);
 }
 
+const IR::Node *LocalCopyPropagation::apply_visitor(const IR::Node *node, const char *name) {
+    // The results of exprUses only depend on the expression, so they stay valid from one run to
+    // the next; the cache drops the results for the nodes that other passes replace.  It is freed
+    // once a run changes nothing, which usually ends the PassRepeated this pass is part of, so it
+    // does not keep the program alive for the rest of the compilation.
+    if (!usesCache) usesCache = std::make_shared<ExprUsesCache>();
+    copyProp->usesCache = usesCache.get();
+    const IR::Node *result = nullptr;
+    try {
+        result = PassManager::apply_visitor(node, name);
+    } catch (...) {
+        copyProp->usesCache = nullptr;
+        usesCache.reset();
+        throw;
+    }
+    copyProp->usesCache = nullptr;
+    if (result == node) usesCache.reset();
+    return result;
+}
+
 }  // namespace P4
@@ -8,8 +8,11 @@
 #ifndef MIDEND_LOCAL_COPYPROP_H_
 #define MIDEND_LOCAL_COPYPROP_H_
 
+#include <memory>
+
 #include "frontends/common/resolveReferences/resolveReferences.h"
 #include "frontends/p4/typeChecking/typeChecker.h"
+#include "expr_uses.h"
 #include "has_side_effects.h"
 #include "ir/ir.h"
 #include "ir/visitor.h"
@@ -82,6 +85,12 @@ class DoLocalCopyPropagation : public ControlFlowVisitor,
     int uid = -1;
     static int uid_ctr;
 
+    /// Results of exprUses, which the dataflow revisits and the loop prepasses repeat for the
+    /// same expressions.  Set by LocalCopyPropagation for the duration of a run, shared by the
+    /// clones.
+    ExprUsesCache *usesCache = nullptr;
+    friend class LocalCopyPropagation;
+
     DoLocalCopyPropagation *clone() const override {
         auto *rv = new DoLocalCopyPropagation(*this);
         rv->uid = ++uid_ctr;
@@ -154,6 +163,11 @@ class DoLocalCopyPropagation : public ControlFlowVisitor,
 };
 
 class LocalCopyPropagation : public PassManager {
+    DoLocalCopyPropagation *copyProp;
+    /// Kept from one run to the next, e.g. over the iterations of a PassRepeated, until a run
+    /// changes nothing.
+    std::shared_ptr<ExprUsesCache> usesCache;
+
  public:
     LocalCopyPropagation(
         TypeMap *typeMap, TypeChecking *typeChecking = nullptr,
@@ -164,10 +178,13 @@ class LocalCopyPropagation : public PassManager {
         bool elimUnusedTables = false) {
         if (!typeChecking) typeChecking = new TypeChecking(nullptr, typeMap, true);
         passes.push_back(typeChecking);
-        passes.push_back(new DoLocalCopyPropagation(typeMap, policy, elimUnusedTables));
+        copyProp = new DoLocalCopyPropagation(typeMap, policy, elimUnusedTables);
+        passes.push_back(copyProp);
     }
     LocalCopyPropagation(TypeMap *typeMap, LocalCopyPropPolicyCallbackFn policy)
         : LocalCopyPropagation(typeMap, nullptr, policy) {}
+
+    const IR::Node *apply_visitor(const IR::Node *, const char * = 0) override;
 };
 
 }  // namespace P4
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ir/analysis_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "ir/ir.h"
+#include "ir/pass_manager.h"
+
+namespace P4::Test {
+
+using namespace P4::literals;
+
+namespace {
+
+/// Replaces every reference to @p from by a reference to @p to.
+class RenamePath : public Transform {
+    cstring from, to;
+
+ public:
+    RenamePath(cstring from, cstring to) : from(from), to(to) {}
+    const IR::Node *postorder(IR::PathExpression *p) override {
+        if (p->path->name == from) return new IR::PathExpression(to);
+        return p;
+    }
+};
+
+int countNodes(const IR::Node *node) {
+    int count = 0;
+    forAllMatching<IR::Node>(node, [&](const IR::Node *) { ++count; });
+    return count;
+}
+
+}  // namespace
+
+TEST(AnalysisCache, ComputesOnce) {
+    AnalysisCache<int> cache;
+    auto *expr = new IR::Add(new IR::PathExpression("a"), new IR::PathExpression("b"));
+    int computed = 0;
+    auto compute = [&](const IR::Node *node) {
+        ++computed;
+        return countNodes(node);
+    };
+    EXPECT_EQ(cache.get(expr, compute), 5);
+    EXPECT_EQ(cache.get(expr, compute), 5);
+    EXPECT_EQ(computed, 1);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(AnalysisCache, DropsReplacedNodes) {
+    AnalysisCache<int> cache;
+    auto *a = new IR::PathExpression("a");
+    auto *b = new IR::PathExpression("b");
+    auto *expr = new IR::Add(a, b);
+    for (const IR::Node *node : {static_cast<const IR::Node *>(a),
+                                 static_cast<const IR::Node *>(b),
+                                 static_cast<const IR::Node *>(expr)})
+        cache.get(node, countNodes);
+    EXPECT_EQ(cache.size(), 3u);
+
+    PassManager passes({new RenamePath("a"_cs, "c"_cs)});
+    auto *result = expr->apply(passes);
+    ASSERT_NE(result, expr);
+    // The result for b is still valid; those for a and the expression using it are not.
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_NE(cache.find(b), nullptr);
+    EXPECT_EQ(cache.find(a), nullptr);
+    EXPECT_EQ(cache.find(expr), nullptr);
+}
+
+TEST(AnalysisCache, ClearsOnUnreportedChanges) {
+    AnalysisCache<int> cache;
+    auto *expr = new IR::Add(new IR::PathExpression("a"), new IR::PathExpression("b"));
+    cache.get(expr, countNodes);
+    cache.get(expr->left, countNodes);
+
+    // A pass that changes nothing leaves the cache alone.
+    PassManager unchanged({new RenamePath("x"_cs, "y"_cs)});
+    EXPECT_EQ(expr->apply(unchanged), expr);
+    EXPECT_EQ(cache.size(), 2u);
+
+    // Changes that are not reported drop everything.
+    cache.passFinished(expr, expr->clone());
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+}  // namespace P4::Test
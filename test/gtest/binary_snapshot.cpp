@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ir/binary_snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "frontends/common/parseInput.h"
+#include "helpers.h"
+#include "ir/binary_reader.h"
+#include "ir/binary_writer.h"
+#include "ir/ir.h"
+#include "lib/exceptions.h"
+#include "lib/source_file.h"
+
+using namespace P4;
+using namespace P4::literals;
+
+namespace P4::Test {
+
+namespace {
+
+const IR::Node *roundTrip(const IR::Node *node) {
+    std::stringstream ss;
+    writeBinarySnapshot(ss, node);
+    auto data = ss.str();
+    return readBinarySnapshot(data.data(), data.size());
+}
+
+template <typename T>
+T roundTripValue(const T &value) {
+    std::stringstream ss;
+    BinaryWriter(ss).write(value);
+    auto data = ss.str();
+    BinaryReader reader(data.data(), data.size());
+    T copy;
+    reader.read(copy);
+    EXPECT_TRUE(reader.atEnd());
+    return copy;
+}
+
+}  // namespace
+
+struct BinarySnapshot : P4CTest {};
+
+TEST_F(BinarySnapshot, SharedNodes) {
+    auto *c = new IR::Constant(IR::Type_Bits::get(8), 2);
+    auto *e1 = new IR::Add(c, c);
+
+    auto *e2 = roundTrip(e1)->checkedTo<IR::Add>();
+    EXPECT_NE(e2, e1);
+    EXPECT_TRUE(e2->equiv(*e1));
+    EXPECT_EQ(e2->left, e2->right);
+    EXPECT_EQ(e2->left->id, c->id);
+}
+
+TEST_F(BinarySnapshot, Values) {
+    std::map<big_int, bitvec> map;
+    map[big_int(1) << 100].setrange(100, 100);
+    map[-(big_int(1) << 70)] = bitvec(1);
+    map[-3] = bitvec();
+    EXPECT_EQ(roundTripValue(map), map);
+
+    std::vector<string_map<std::string>> strings(2);
+    strings[0]["x"] = "\ttab";
+    strings[1]["x"] = "";
+    strings[1]["\x1c"] = "esc";
+    EXPECT_EQ(roundTripValue(strings), strings);
+
+    std::vector<std::optional<std::pair<cstring, int64_t>>> values = {
+        std::nullopt, std::make_pair("a"_cs, -1), std::make_pair(cstring(), INT64_MIN)};
+    EXPECT_EQ(roundTripValue(values), values);
+}
+
+TEST_F(BinarySnapshot, Program) {
+    auto *program = P4::parseP4String(P4_SOURCE(R"(
+        header h_t { bit<8> f; bit<16> g; }
+        struct s_t { h_t h; }
+        control c(inout s_t s) {
+            action a(bit<8> v) { s.h.f = v; }
+            table t { key = { s.h.g : exact; } actions = { a; } }
+            apply {
+                if (s.h.isValid()) t.apply();
+            }
+        }
+    )"));
+    ASSERT_TRUE(program);
+    auto *copy = roundTrip(program);
+    ASSERT_TRUE(copy);
+    EXPECT_TRUE(copy->equiv(*program));
+}
+
+TEST_F(BinarySnapshot, SourceInfo) {
+    auto *program = P4::parseP4String(P4_SOURCE(R"(
+        header h_t { bit<8> f; }
+    )"));
+    ASSERT_TRUE(program);
+    auto *copy = roundTrip(program);
+    ASSERT_TRUE(copy);
+    const auto *header = program->objects.back();
+    const auto *copyHeader = copy->checkedTo<IR::P4Program>()->objects.back();
+    ASSERT_TRUE(header->srcInfo.isValid());
+    EXPECT_EQ(copyHeader->srcInfo, header->srcInfo);
+    EXPECT_EQ(copyHeader->srcInfo.toSourceFragment(), header->srcInfo.toSourceFragment());
+    EXPECT_EQ(copyHeader->srcInfo.toPosition().toString(),
+              header->srcInfo.toPosition().toString());
+
+    // the fields loaded from a JSON dump.
+    auto *c = new IR::Constant(1);
+    c->srcInfo = Util::SourceInfo("x.p4"_cs, 3, 4, "brief"_cs);
+    auto *c2 = roundTrip(c)->checkedTo<IR::Constant>();
+    EXPECT_FALSE(c2->srcInfo.isValid());
+    EXPECT_EQ(c2->srcInfo.filename, "x.p4");
+    EXPECT_EQ(c2->srcInfo.line, 3);
+    EXPECT_EQ(c2->srcInfo.column, 4);
+    EXPECT_EQ(c2->srcInfo.srcBrief, "brief");
+}
+
+TEST_F(BinarySnapshot, Malformed) {
+    std::stringstream types;
+    BinaryWriter(types).writeNode(IR::Type_Bits::get(8));
+    auto data = types.str();
+    BinaryReader typeReader(data.data(), data.size());
+    const IR::Expression *expr = nullptr;
+    EXPECT_THROW(typeReader.read(expr), Util::CompilationError);
+
+    // a position after the last line of its source.
+    std::stringstream positions;
+    {
+        BinaryWriter writer(positions);
+        writer.writeByte(1);
+        writer.writeByte(1);
+        writer.write(false);
+        writer.write(std::vector<std::string>{"line\n", ""});
+        writer.writeUnsigned(1);
+        writer.writeUnsigned(0);
+        writer.writeString(""_cs);
+        writer.writeUnsigned(1);
+        for (unsigned line : {1, 3}) {
+            writer.writeUnsigned(line);
+            writer.writeUnsigned(0);
+        }
+    }
+    data = positions.str();
+    BinaryReader positionReader(data.data(), data.size());
+    EXPECT_THROW(positionReader.readSourceInfo(), Util::CompilationError);
+}
+
+TEST_F(BinarySnapshot, Invalid) {
+    std::stringstream ss;
+    writeBinarySnapshot(ss, new IR::Constant(1));
+    auto data = ss.str();
+    EXPECT_EQ(readBinarySnapshot(data.data(), data.size() - 1), nullptr);
+    data[0] = 'X';
+    EXPECT_EQ(readBinarySnapshot(data.data(), data.size()), nullptr);
+    EXPECT_GT(::P4::errorCount(), 0u);
+}
+
+}  // namespace P4::Test
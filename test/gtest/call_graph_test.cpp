@@ -5,6 +5,9 @@
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <set>
+#include <unordered_set>
 #include <vector>
 
 #include "frontends/p4/callGraph.h"
@@ -14,13 +17,13 @@ namespace P4::Test {
 template <class T>
 static void sameSet(std::unordered_set<T> &set, std::vector<T> vector) {
     EXPECT_EQ(vector.size(), set.size());
-    for (T v : vector) EXPECT_NEQ(set.end(), set.find(v));
+    for (T v : vector) EXPECT_NE(set.end(), set.find(v));
 }
 
 template <class T>
 static void sameSet(std::set<T> &set, std::vector<T> vector) {
     EXPECT_EQ(vector.size(), set.size());
-    for (T v : vector) EXPECT_NEQ(set.end(), set.find(v));
+    for (T v : vector) EXPECT_NE(set.end(), set.find(v));
 }
 
 TEST(CallGraph, Acyclic) {
@@ -40,4 +43,116 @@ TEST(CallGraph, Acyclic) {
     EXPECT_EQ('a', sorted.at(2));
 }
 
+TEST(CallGraph, Dominators) {
+    P4::CallGraph<char> cg("dominators");
+    // a->b->c->e
+    //  \->d-^  ^
+    // f--------/
+    cg.calls('a', 'b');
+    cg.calls('b', 'c');
+    cg.calls('b', 'd');
+    cg.calls('c', 'e');
+    cg.calls('d', 'e');
+    cg.calls('f', 'e');
+
+    P4::CallGraph<char>::Dominators dom(cg, 'a');
+    EXPECT_TRUE(dom.dominates('a', 'e'));
+    EXPECT_TRUE(dom.dominates('b', 'e'));
+    EXPECT_FALSE(dom.dominates('c', 'e'));
+    EXPECT_FALSE(dom.dominates('e', 'b'));
+    EXPECT_EQ('b', dom.immediateDominator('e'));
+    EXPECT_EQ('a', dom.immediateDominator('a'));
+    EXPECT_FALSE(dom.isReachable('f'));
+
+    std::map<char, std::unordered_set<char>> sets;
+    cg.dominators('a', sets);
+    sameSet(sets['a'], {'a'});
+    sameSet(sets['e'], {'a', 'b', 'e'});
+    sameSet(sets['d'], {'a', 'b', 'd'});
+    // unreachable nodes are dominated by all nodes
+    sameSet(sets['f'], {'a', 'b', 'c', 'd', 'e', 'f'});
+}
+
+TEST(CallGraph, Loops) {
+    P4::CallGraph<char> cg("loops");
+    // a->b->c->d
+    //    ^--/  |
+    //    ^-----/
+    //       c->c
+    cg.calls('a', 'b');
+    cg.calls('b', 'c');
+    cg.calls('c', 'b');
+    cg.calls('c', 'c');
+    cg.calls('c', 'd');
+    cg.calls('d', 'b');
+
+    auto *loops = cg.compute_loops('a');
+    ASSERT_EQ(2u, loops->loops.size());
+    int b = loops->isLoopEntryPoint('b');
+    int c = loops->isLoopEntryPoint('c');
+    ASSERT_NE(-1, b);
+    ASSERT_NE(-1, c);
+    EXPECT_EQ(-1, loops->isLoopEntryPoint('a'));
+    sameSet(loops->loops.at(b)->body, {'b', 'c', 'd'});
+    sameSet(loops->loops.at(b)->back_edge_heads, {'c', 'd'});
+    sameSet(loops->loops.at(c)->body, {'c'});
+    EXPECT_FALSE(loops->isInLoop(b, 'a'));
+
+    std::set<char> reachable;
+    cg.reachable('c', reachable);
+    sameSet(reachable, {'b', 'c', 'd'});
+}
+
+TEST(CallGraph, ReachableAfterChanges) {
+    P4::CallGraph<char> cg("changes");
+    cg.calls('a', 'b');
+    cg.calls('c', 'd');
+
+    std::set<char> reachable;
+    cg.reachable('a', reachable);
+    sameSet(reachable, {'a', 'b'});
+
+    P4::CallGraph<char>::Dominators dom(cg, 'a');
+    cg.calls('b', 'c');
+    reachable.clear();
+    cg.reachable('a', reachable);
+    sameSet(reachable, {'a', 'b', 'c', 'd'});
+    // the dominators keep the graph as it was when they were computed
+    EXPECT_FALSE(dom.isReachable('c'));
+
+    cg.remove('d');
+    reachable.clear();
+    cg.reachable('a', reachable);
+    sameSet(reachable, {'a', 'b', 'c'});
+
+    cg.remove('b');
+    reachable.clear();
+    cg.reachable('a', reachable);
+    sameSet(reachable, {'a'});
+}
+
+TEST(CallGraph, StronglyConnected) {
+    P4::CallGraph<char> cg("scc");
+    // a->b->c->b, c->d
+    cg.calls('a', 'b');
+    cg.calls('b', 'c');
+    cg.calls('c', 'b');
+    cg.calls('c', 'd');
+
+    std::vector<char> sorted;
+    EXPECT_TRUE(cg.sccSort('a', sorted));
+    EXPECT_EQ((std::vector<char>{'d', 'c', 'b', 'a'}), sorted);
+
+    // a long chain
+    P4::CallGraph<int> chain("chain");
+    for (int i = 0; i < 10000; i++) chain.calls(i, i + 1);
+    std::vector<int> order;
+    EXPECT_FALSE(chain.sort(order));
+    ASSERT_EQ(10001u, order.size());
+    EXPECT_EQ(10000, order.front());
+    P4::CallGraph<int>::Dominators dom(chain, 0);
+    EXPECT_TRUE(dom.dominates(5000, 10000));
+    EXPECT_FALSE(dom.dominates(10000, 5000));
+}
+
 }  // namespace P4::Test
@@ -0,0 +1,245 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "frontends/common/compilationCache.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+namespace P4::Test {
+
+class CompilationCacheTest : public P4CTest {
+ protected:
+    std::filesystem::path dir;
+    std::filesystem::path file;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              absl::StrCat("p4c-compilation-cache-", getpid(), "-",
+                           ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        file = dir / "program.p4";
+        std::ofstream(file) << P4_SOURCE(R"(
+            header H { bit<8> f; }
+            control c(inout H h) { apply { h.f = 1; } }
+        )");
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    /// Sets up @p options to compile the test program with the command-line arguments @p args.
+    void setOptions(CompilerOptions &options, std::vector<const char *> args = {}) {
+        options.file = file;
+        options.doNotPreprocess = true;
+        args.insert(args.begin(), "test");
+        ASSERT_NE(options.process_options(args.size(), const_cast<char *const *>(args.data())),
+                  nullptr);
+    }
+
+    /// Stores the parsed program as the result of both stages.
+    void populate(const std::vector<const char *> &args = {}) {
+        CompilerOptions options;
+        setOptions(options, args);
+        CompilationCache cache(dir / "cache", options);
+        ASSERT_TRUE(cache.readSource());
+        const auto *program = cache.parse();
+        ASSERT_NE(program, nullptr);
+        cache.storeFrontend(program, options.processedOptionCount());
+        cache.storeMidend(program);
+    }
+};
+
+TEST_F(CompilationCacheTest, ProcessedArguments) {
+    CompilerOptions options;
+    size_t start = options.processedOptionCount();
+    setOptions(options, {"--arch", "v1model", "--toJSON", "out.json", "--loopsUnroll", "-O2"});
+    std::vector<std::string> expected = {"--arch=v1model", "--toJSON=out.json", "--loopsUnroll",
+                                         "-O2"};
+    EXPECT_EQ(options.processedArguments(start), expected);
+
+    // Midend and backend options are left out of the keys of the stages they do not affect.
+    CompilerOptions other;
+    setOptions(other, {"--arch", "v1model", "-O2"});
+    EXPECT_NE(options.processedOptionsKey(Util::Options::OptionFlags::BackendOnly),
+              other.processedOptionsKey(Util::Options::OptionFlags::BackendOnly));
+    EXPECT_EQ(options.processedOptionsKey(Util::Options::OptionFlags::MidendOnly |
+                                          Util::Options::OptionFlags::BackendOnly),
+              other.processedOptionsKey(Util::Options::OptionFlags::MidendOnly |
+                                        Util::Options::OptionFlags::BackendOnly));
+}
+
+TEST_F(CompilationCacheTest, StoresAndLoadsStages) {
+    CompilerOptions options;
+    setOptions(options);
+    CompilationCache cache(dir / "cache", options);
+    ASSERT_TRUE(cache.readSource());
+    EXPECT_EQ(cache.loadFrontend(), nullptr);
+    EXPECT_EQ(cache.loadMidend(), nullptr);
+
+    const auto *program = cache.parse();
+    ASSERT_NE(program, nullptr);
+    cache.storeFrontend(program, options.processedOptionCount());
+    const auto *frontend = cache.loadFrontend();
+    ASSERT_NE(frontend, nullptr);
+    EXPECT_NE(frontend, program);
+    EXPECT_TRUE(program->equiv(*frontend));
+    // Diagnostics for a cached result still quote the program.
+    const auto *control = program->objects.back();
+    const auto *cachedControl = frontend->objects.back();
+    ASSERT_TRUE(control->srcInfo.isValid());
+    EXPECT_EQ(cachedControl->srcInfo, control->srcInfo);
+    EXPECT_EQ(cachedControl->srcInfo.toSourceFragment(), control->srcInfo.toSourceFragment());
+    EXPECT_EQ(cache.loadMidend(), nullptr);
+
+    cache.storeMidend(program);
+    const auto *midend = cache.loadMidend();
+    ASSERT_NE(midend, nullptr);
+    EXPECT_TRUE(program->equiv(*midend));
+}
+
+TEST_F(CompilationCacheTest, KeysDependOnStageOptions) {
+    populate({"--arch", "v1model"});
+
+    // Backend options reuse both stages.
+    CompilerOptions backend;
+    setOptions(backend, {"--arch", "v1model", "--toJSON", "out.json"});
+    CompilationCache backendCache(dir / "cache", backend);
+    ASSERT_TRUE(backendCache.readSource());
+    EXPECT_NE(backendCache.loadMidend(), nullptr);
+
+    // Midend options only reuse the frontend.
+    CompilerOptions midend;
+    setOptions(midend, {"--arch", "v1model", "--loopsUnroll"});
+    CompilationCache midendCache(dir / "cache", midend);
+    ASSERT_TRUE(midendCache.readSource());
+    EXPECT_EQ(midendCache.loadMidend(), nullptr);
+    EXPECT_NE(midendCache.loadFrontend(), nullptr);
+
+    // Other options reuse nothing.
+    CompilerOptions frontend;
+    setOptions(frontend, {"--arch", "psa"});
+    CompilationCache frontendCache(dir / "cache", frontend);
+    ASSERT_TRUE(frontendCache.readSource());
+    EXPECT_EQ(frontendCache.loadFrontend(), nullptr);
+
+    // Neither does a different source.
+    std::ofstream(file, std::ios::app) << "// changed\n";
+    CompilerOptions changed;
+    setOptions(changed, {"--arch", "v1model"});
+    CompilationCache changedCache(dir / "cache", changed);
+    ASSERT_TRUE(changedCache.readSource());
+    EXPECT_EQ(changedCache.loadFrontend(), nullptr);
+}
+
+TEST_F(CompilationCacheTest, RestoresPragmaOptions) {
+    {
+        CompilerOptions options;
+        setOptions(options);
+        CompilationCache cache(dir / "cache", options);
+        ASSERT_TRUE(cache.readSource());
+        const auto *program = cache.parse();
+        ASSERT_NE(program, nullptr);
+        // Options processed after the keys were computed, as ApplyOptionsPragmas does.
+        size_t firstPragmaOption = options.processedOptionCount();
+        std::vector<const char *> pragmaArgs = {"(from pragmas)", "--loopsUnroll"};
+        ASSERT_NE(options.process_options(pragmaArgs.size(),
+                                          const_cast<char *const *>(pragmaArgs.data())),
+                  nullptr);
+        cache.storeFrontend(program, firstPragmaOption);
+    }
+
+    CompilerOptions options;
+    setOptions(options);
+    CompilationCache cache(dir / "cache", options);
+    ASSERT_TRUE(cache.readSource());
+    EXPECT_FALSE(options.loopsUnrolling);
+    EXPECT_NE(cache.loadFrontend(), nullptr);
+    EXPECT_TRUE(options.loopsUnrolling);
+}
+
+TEST_F(CompilationCacheTest, IgnoresInvalidEntries) {
+    populate();
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(dir / "cache")) {
+        if (entry.path().extension() == ".ir") std::ofstream(entry.path()) << "garbage";
+    }
+
+    CompilerOptions options;
+    setOptions(options);
+    CompilationCache cache(dir / "cache", options);
+    ASSERT_TRUE(cache.readSource());
+    EXPECT_EQ(cache.loadFrontend(), nullptr);
+    EXPECT_EQ(cache.loadMidend(), nullptr);
+    EXPECT_EQ(errorCount(), 0u);
+}
+
+TEST_F(CompilationCacheTest, ComparesKeyMaterial) {
+    populate();
+    std::vector<std::filesystem::path> first;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(dir / "cache"))
+        if (entry.path().extension() == ".ir") first.push_back(entry.path());
+    ASSERT_EQ(first.size(), 2u);
+
+    // Put the entries of the first program where those of another program go, as if their
+    // keys collided.
+    std::ofstream(file, std::ios::app) << "// changed\n";
+    populate();
+    size_t replaced = 0;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(dir / "cache")) {
+        if (entry.path().extension() != ".ir" ||
+            std::find(first.begin(), first.end(), entry.path()) != first.end())
+            continue;
+        std::filesystem::copy_file(first.at(replaced++ % first.size()), entry.path(),
+                                   std::filesystem::copy_options::overwrite_existing);
+    }
+    ASSERT_EQ(replaced, 2u);
+
+    CompilerOptions options;
+    setOptions(options);
+    CompilationCache cache(dir / "cache", options);
+    ASSERT_TRUE(cache.readSource());
+    EXPECT_EQ(cache.loadFrontend(), nullptr);
+    EXPECT_EQ(cache.loadMidend(), nullptr);
+    EXPECT_EQ(errorCount(), 0u);
+}
+
+TEST_F(CompilationCacheTest, SkipsResultsWithDiagnostics) {
+    CompilerOptions options;
+    setOptions(options);
+    CompilationCache cache(dir / "cache", options);
+    ASSERT_TRUE(cache.readSource());
+    const auto *program = cache.parse();
+    ASSERT_NE(program, nullptr);
+    // A hit would skip the stage that reported the warning, and hide it.
+    ::P4::warning(ErrorType::WARN_UNUSED, "unused %1%", "something");
+    cache.storeFrontend(program, options.processedOptionCount());
+    cache.storeMidend(program);
+    cache.storeData("p4runtime", "data");
+    EXPECT_EQ(cache.loadFrontend(), nullptr);
+    EXPECT_EQ(cache.loadMidend(), nullptr);
+    EXPECT_FALSE(cache.loadData("p4runtime"));
+}
+
+TEST_F(CompilationCacheTest, StoresData) {
+    CompilerOptions options;
+    setOptions(options);
+    CompilationCache cache(dir / "cache", options);
+    ASSERT_TRUE(cache.readSource());
+    EXPECT_FALSE(cache.loadData("p4runtime"));
+    std::string data("binary\0data", 11);
+    cache.storeData("p4runtime", data);
+    EXPECT_EQ(cache.loadData("p4runtime"), data);
+}
+
+}  // namespace P4::Test
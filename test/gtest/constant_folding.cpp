@@ -134,4 +134,33 @@ TEST_F(P4CConstantFoldingValidation, filter) {
     EXPECT_TRUE(ts_2->size->is<IR::Constant>());
 }
 
+// Constants are substituted on the right side of an assignment, but not within its left side
+TEST_F(P4CConstantFoldingValidation, assignment_target) {
+    createPasses(nullptr);
+
+    auto *program = parseAndProcess(P4_SOURCE(R"(
+        const bit<32> HI = 3;
+        control c(inout bit<8> x, in bit<8> y) {
+            apply {
+                x[HI:0] = y[HI:0];
+            }
+        }
+    )"))->to<IR::P4Program>();
+    ASSERT_TRUE(program);
+
+    const IR::P4Control *control = nullptr;
+    for (const auto *d : *program->getDeclarations())
+        if (const auto *c = d->to<IR::P4Control>()) control = c;
+    ASSERT_TRUE(control);
+    ASSERT_EQ(control->body->components.size(), 1u);
+    const auto *assign = control->body->components[0]->to<IR::AssignmentStatement>();
+    ASSERT_TRUE(assign);
+    const auto *left = assign->left->to<IR::Slice>();
+    ASSERT_TRUE(left);
+    EXPECT_TRUE(left->e1->is<IR::PathExpression>());
+    const auto *right = assign->right->to<IR::Slice>();
+    ASSERT_TRUE(right);
+    EXPECT_TRUE(right->e1->is<IR::Constant>());
+}
+
 }  // namespace P4::Test
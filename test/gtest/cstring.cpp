@@ -7,6 +7,21 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "config.h"
+
+#if HAVE_LIBGC
+#include <gc/gc.h>
+#endif
+
 namespace P4::Test {
 
 using namespace P4::literals;
@@ -147,4 +162,146 @@ TEST(cstring, get_cached) {
     EXPECT_FALSE(cstring::get_cached("test").isNullOrEmpty());
 }
 
+namespace {
+
+/// Run @p fn on @p count threads known to the garbage collector, passing each its index.
+template <typename Fn>
+void runOnThreads(unsigned count, Fn fn) {
+#if HAVE_LIBGC
+    GC_allow_register_threads();
+#endif
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < count; ++i) {
+        threads.emplace_back([i, &fn] {
+#if HAVE_LIBGC
+            GC_stack_base sb;
+            GC_get_stack_base(&sb);
+            GC_register_my_thread(&sb);
+#endif
+            fn(i);
+#if HAVE_LIBGC
+            GC_unregister_my_thread();
+#endif
+        });
+    }
+    for (auto &thread : threads) thread.join();
+}
+
+}  // namespace
+
+TEST(cstring, concurrentInterning) {
+    constexpr unsigned threadCount = 8;
+    constexpr unsigned stringCount = 2000;
+    std::vector<std::vector<const char *>> interned(threadCount);
+    runOnThreads(threadCount, [&](unsigned thread) {
+        // Every thread interns the same strings, in a different order.
+        for (unsigned i = 0; i < stringCount; ++i) {
+            unsigned n = (i * (2 * thread + 1)) % stringCount;
+            interned[thread].push_back(
+                cstring("concurrent interning " + std::to_string(n)).c_str());
+        }
+    });
+    for (unsigned thread = 0; thread < threadCount; ++thread) {
+        for (unsigned i = 0; i < stringCount; ++i) {
+            unsigned n = (i * (2 * thread + 1)) % stringCount;
+            cstring expected("concurrent interning " + std::to_string(n));
+            EXPECT_EQ(interned[thread][i], expected.c_str());
+        }
+    }
+}
+
+/// The sharded intern table must behave like a single table: checks the pointers it returns
+/// against an unsharded map from string to the pointer first returned for it.
+TEST(cstring, internedPointers) {
+    constexpr unsigned stringCount = 5000;
+    std::unordered_map<std::string, const char *> reference;
+    std::unordered_set<const char *> pointers;
+    for (unsigned round = 0; round < 3; ++round) {
+        for (unsigned i = 0; i < stringCount; ++i) {
+            // Every round interns all strings in another order, each through another
+            // constructor than before.
+            unsigned n = (i * 7919 + round * 13) % stringCount;
+            std::string string = "interned pointer " + std::string(n % 40, 'x') + std::to_string(n);
+            const char *interned = nullptr;
+            switch ((n + round) % 3) {
+                case 0:
+                    interned = cstring(string).c_str();
+                    break;
+                case 1:
+                    interned = cstring(string.c_str()).c_str();
+                    break;
+                default:
+                    interned = cstring(std::string_view(string)).c_str();
+                    break;
+            }
+            ASSERT_NE(interned, string.c_str());
+            EXPECT_EQ(std::string_view(interned), string);
+            auto [it, inserted] = reference.emplace(string, interned);
+            EXPECT_EQ(it->second, interned) << string;
+            if (inserted) EXPECT_TRUE(pointers.insert(interned).second) << string;
+            EXPECT_TRUE(cstring::is_cached(string));
+            EXPECT_EQ(cstring::get_cached(string).c_str(), interned);
+        }
+    }
+    EXPECT_EQ(reference.size(), pointers.size());
+    EXPECT_FALSE(cstring::is_cached("interned pointer never interned"));
+}
+
+namespace {
+
+/// Interns @p strings @p rounds times and returns the time per string in nanoseconds. Only the
+/// first round inserts; the others find the strings already interned.
+long long internNanoseconds(const std::vector<std::string> &strings, unsigned rounds) {
+    auto start = std::chrono::steady_clock::now();
+    size_t distinct = 0;
+    for (unsigned round = 0; round < rounds; ++round) {
+        const char *previous = nullptr;
+        for (const auto &string : strings) {
+            const char *current = cstring(string).c_str();
+            distinct += current != previous;
+            previous = current;
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(distinct, strings.size() * rounds);
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return ns / static_cast<long long>(strings.size() * rounds);
+}
+
+std::vector<std::string> benchmarkStrings(const std::string &prefix, unsigned count) {
+    std::vector<std::string> strings;
+    for (unsigned i = 0; i < count; ++i) strings.push_back(prefix + std::to_string(i));
+    return strings;
+}
+
+}  // namespace
+
+/// Single-threaded intern throughput, so that locking in the intern table does not go
+/// unnoticed on the main-thread path. Disabled by default because it only reports timings;
+/// run it with --gtest_also_run_disabled_tests.
+TEST(cstring, DISABLED_internThroughput) {
+    auto strings = benchmarkStrings("intern throughput identifier_", 100000);
+    auto ns = internNanoseconds(strings, 5);
+    std::cout << "cstring intern, 1 thread: " << ns << " ns/string (" << strings.size()
+              << " strings, first round inserts)" << std::endl;
+}
+
+/// Intern throughput while several threads intern at once, half of the strings shared between
+/// all threads and half private to each, to show how much the shards contend.
+TEST(cstring, DISABLED_internThroughputContended) {
+    constexpr unsigned threadCount = 8;
+    auto shared = benchmarkStrings("intern contention shared_", 50000);
+    std::vector<long long> ns(threadCount);
+    runOnThreads(threadCount, [&](unsigned thread) {
+        auto strings =
+            benchmarkStrings("intern contention thread" + std::to_string(thread) + "_", 50000);
+        strings.insert(strings.end(), shared.begin(), shared.end());
+        ns[thread] = internNanoseconds(strings, 5);
+    });
+    for (unsigned thread = 0; thread < threadCount; ++thread) {
+        std::cout << "cstring intern, thread " << thread << " of " << threadCount << ": "
+                  << ns[thread] << " ns/string" << std::endl;
+    }
+}
+
 }  // namespace P4::Test
@@ -7,7 +7,10 @@
 
 #include <gtest/gtest.h>
 
+#include "helpers.h"
 #include "ir/ir.h"
+#include "ir/pass_manager.h"
+#include "midend/local_copyprop.h"
 
 using namespace P4;
 using namespace P4::literals;
@@ -36,3 +39,68 @@ TEST(expr_uses, expr_uses) {
     EXPECT_TRUE(exprUses(add2, "obj1.f1"_cs));
     EXPECT_TRUE(exprUses(add2, "obj1.f11"_cs));
 }
+
+TEST(expr_uses, cached) {
+    auto obj1_f1 = new IR::Member(new IR::PathExpression("obj1"), "f1");
+    auto add = new IR::Add(obj1_f1, new IR::PathExpression("obj2"));
+
+    auto observers = ProgramChangeObserver::observers().size();
+    {
+        ExprUsesCache cache;
+        for (int i = 0; i < 2; ++i) {
+            EXPECT_TRUE(exprUses(add, "obj1.f1"_cs, &cache));
+            EXPECT_FALSE(exprUses(add, "obj1.f11"_cs, &cache));
+            EXPECT_TRUE(exprUses(obj1_f1, "obj1"_cs, &cache));
+        }
+        EXPECT_EQ(cache.size(), 2u);
+        ASSERT_NE(cache.find(add), nullptr);
+        EXPECT_EQ(cache.find(add)->size(), 2u);
+    }
+    // The cache stops observing the program when it goes away.
+    EXPECT_EQ(ProgramChangeObserver::observers().size(), observers);
+}
+
+namespace P4::Test {
+
+class LocalCopyPropagationCache : public P4CTest {};
+
+TEST_F(LocalCopyPropagationCache, KeptUntilARunChangesNothing) {
+    auto test = FrontendTestCase::create(P4_SOURCE(P4Headers::V1MODEL, R"(
+header H { bit<32> f1; bit<32> f2; }
+struct Headers { H h; }
+struct Metadata { }
+parser p(packet_in pkt, out Headers hdr, inout Metadata m, inout standard_metadata_t sm) {
+    state start { pkt.extract(hdr.h); transition accept; }
+}
+control vc(inout Headers hdr, inout Metadata m) { apply { } }
+control ingress(inout Headers hdr, inout Metadata m, inout standard_metadata_t sm) {
+    apply {
+        bit<32> x = hdr.h.f1;
+        hdr.h.f2 = x + 1;
+    }
+}
+control egress(inout Headers hdr, inout Metadata m, inout standard_metadata_t sm) { apply { } }
+control cc(inout Headers hdr, inout Metadata m) { apply { } }
+control d(packet_out pkt, in Headers hdr) { apply { pkt.emit(hdr.h); } }
+V1Switch(p(), vc(), ingress(), egress(), cc(), d()) main;
+)"));
+    ASSERT_TRUE(test);
+
+    TypeMap typeMap;
+    LocalCopyPropagation copyProp(&typeMap);
+    auto observers = ProgramChangeObserver::observers().size();
+    const IR::Node *program = test->program->apply(copyProp);
+    ASSERT_NE(program, test->program);
+    // The results are kept for the next run, as in a PassRepeated.
+    EXPECT_EQ(ProgramChangeObserver::observers().size(), observers + 1);
+
+    for (int run = 0; run < 4; ++run) {
+        const auto *next = program->apply(copyProp);
+        if (next == program) break;
+        program = next;
+    }
+    // A run that changes nothing frees them.
+    EXPECT_EQ(ProgramChangeObserver::observers().size(), observers);
+}
+
+}  // namespace P4::Test
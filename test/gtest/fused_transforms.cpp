@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "frontends/common/constantFolding.h"
+#include "frontends/common/parseInput.h"
+#include "frontends/p4/frontend.h"
+#include "frontends/p4/reassociation.h"
+#include "frontends/p4/strengthReduction.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "frontends/p4/uselessCasts.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "ir/pass_manager.h"
+#include "test/gtest/env.h"
+
+namespace P4::Test {
+
+class FusedTransformsTest : public P4CTest {};
+
+namespace {
+
+const char *simplifications = P4_SOURCE(R"(
+const bit<8> C = 2 + 3;
+control c(inout bit<8> x, inout bit<8> y, inout bool b) {
+    apply {
+        x = (x + 1) + C;
+        y = (y * 1) | (bit<8>)0;
+        b = !(x == y) && true;
+        x = (bit<8>)(x - 0) + (x << 0);
+        if (2 > 1) { y = y * 4; } else { y = 0; }
+        @disable_optimization {
+            x = x + 0;
+        }
+    }
+}
+)");
+
+/// Samples with many opportunities for the fused passes.
+const char *samples[] = {"arith-bmv2.p4",
+                         "array-copy-bmv2.p4",
+                         "bool_cast.p4",
+                         "cast_noop.p4",
+                         "concat-fold.p4",
+                         "constant-in-calculation-bmv2.p4",
+                         "constant_folding.p4",
+                         "issue3488-bmv2.p4",
+                         "saturated-bmv2.p4",
+                         "shift-int-const.p4",
+                         "strength.p4",
+                         "strength2.p4",
+                         "strength3.p4",
+                         "strength4-bmv2.p4",
+                         "strength5.p4",
+                         "strength6.p4",
+                         "strength7.p4",
+                         "useless-cast.p4",
+                         "x-bmv2.p4"};
+
+/// @returns the program in @p file from testdata/p4_16_samples as the front end hands it to
+/// the fused passes, or nullptr if it does not compile.
+const IR::P4Program *beforeFusedPasses(const char *file) {
+    AutoCompileContext autoContext(new GTestContext);
+    auto &options = GTestContext::get().options();
+    options.langVersion = CompilerOptions::FrontendVersion::P4_16;
+    options.file = sourcePath;
+    options.file /= "testdata/p4_16_samples";
+    options.file /= file;
+    std::string includeDir = std::string(buildPath) + "p4include";
+    const char *originalEnv = getenv("P4C_16_INCLUDE_PATH");
+    setenv("P4C_16_INCLUDE_PATH", includeDir.c_str(), 1);
+    const auto *program = parseP4File(options);
+    if (!originalEnv)
+        unsetenv("P4C_16_INCLUDE_PATH");
+    else
+        setenv("P4C_16_INCLUDE_PATH", originalEnv, 1);
+    if (!program) return nullptr;
+
+    const IR::P4Program *before = nullptr;
+    FrontEnd frontend;
+    frontend.addDebugHook([&](const char *, unsigned, const char *pass, const IR::Node *node) {
+        if (!before && strcmp(pass, "TableKeyNames") == 0) before = node->to<IR::P4Program>();
+    });
+    if (!frontend.run(options, program) || ::P4::errorCount() > 0) return nullptr;
+    return before;
+}
+
+/// Rewrites `x + 0` to `x`, and counts the nodes it visits.
+class RemoveAddZero : public Transform {
+    bool honorDisable;
+
+ public:
+    int visits = 0;
+    explicit RemoveAddZero(bool honorDisable) : honorDisable(honorDisable) {}
+    const IR::Node *preorder(IR::Node *n) override {
+        ++visits;
+        return n;
+    }
+    const IR::Node *preorder(IR::BlockStatement *bs) override {
+        ++visits;
+        if (honorDisable && bs->hasAnnotation(IR::Annotation::disableOptimizationAnnotation))
+            prune();
+        return bs;
+    }
+    const IR::Node *postorder(IR::Add *e) override {
+        if (auto *c = e->right->to<IR::Constant>(); c && c->value == 0) return e->left;
+        return e;
+    }
+};
+
+}  // namespace
+
+TEST_F(FusedTransformsTest, SameResultAsSequence) {
+    const auto *program = parseP4String(simplifications);
+    ASSERT_TRUE(program);
+
+    TypeMap sequenceTypes;
+    const auto *sequence = program->apply(PassRepeated({
+        new ConstantFolding(&sequenceTypes),
+        new StrengthReduction(&sequenceTypes),
+        new Reassociation(),
+        new UselessCasts(&sequenceTypes),
+    }));
+
+    TypeMap fusedTypes;
+    const auto *fused = program->apply(PassRepeated({
+        new TypeChecking(nullptr, &fusedTypes, true),
+        new FusedTransforms({
+            new DoConstantFolding(&fusedTypes),
+            new DoStrengthReduction(&fusedTypes, nullptr),
+            new Reassociation(),
+            new RemoveUselessCasts(&fusedTypes),
+        }),
+        new ClearTypeMap(&fusedTypes),
+    }));
+
+    EXPECT_EQ(::P4::errorCount(), 0u);
+    ASSERT_TRUE(sequence && fused);
+    EXPECT_NE(fused, program);
+    EXPECT_TRUE(fused->equiv(*sequence));
+}
+
+TEST_F(FusedTransformsTest, SameResultAsSequenceOnSamples) {
+    for (const char *file : samples) {
+        SCOPED_TRACE(file);
+        const auto *program = beforeFusedPasses(file);
+        ASSERT_TRUE(program);
+
+        TypeMap sequenceTypes;
+        const auto *sequence = program->apply(PassRepeated({
+            new ConstantFolding(&sequenceTypes),
+            new StrengthReduction(&sequenceTypes),
+            new Reassociation(),
+            new UselessCasts(&sequenceTypes),
+        }));
+
+        TypeMap fusedTypes;
+        const auto *fused = program->apply(PassRepeated({
+            new TypeChecking(nullptr, &fusedTypes, true),
+            new FusedTransforms({
+                new DoConstantFolding(&fusedTypes),
+                new DoStrengthReduction(&fusedTypes, nullptr),
+                new Reassociation(),
+                new RemoveUselessCasts(&fusedTypes),
+            }),
+            new ClearTypeMap(&fusedTypes),
+        }));
+
+        ASSERT_TRUE(sequence && fused);
+        EXPECT_TRUE(fused->equiv(*sequence));
+    }
+}
+
+TEST_F(FusedTransformsTest, PrunesPerPass) {
+    const auto *program = parseP4String(simplifications);
+    ASSERT_TRUE(program);
+
+    auto *pruningAlone = new RemoveAddZero(true);
+    const auto *sequence = program->apply(PassManager({pruningAlone, new RemoveAddZero(false)}));
+
+    // Only the pass that prunes the disabled block skips it.
+    auto *pruning = new RemoveAddZero(true);
+    const auto *fused = program->apply(FusedTransforms({pruning, new RemoveAddZero(false)}));
+
+    ASSERT_TRUE(sequence && fused);
+    EXPECT_TRUE(fused->equiv(*sequence));
+    EXPECT_EQ(pruning->visits, pruningAlone->visits);
+}
+
+}  // namespace P4::Test
@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "frontends/common/preprocessor.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "frontends/common/options.h"
+#include "helpers.h"
+#include "lib/error.h"
+
+namespace P4::Test {
+
+class PreprocessorTest : public P4CTest {
+ protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              absl::StrCat("p4c-preprocessor-", getpid(), "-",
+                           ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir / "include");
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    void write(const std::string &name, const std::string &contents) {
+        std::ofstream(dir / name) << contents;
+    }
+
+    /// Preprocesses @p source with the arguments @p args.
+    std::string preprocess(const std::string &source, const std::string &args = "",
+                           bool *ok = nullptr) {
+        write("main.p4", source);
+        auto preprocessor =
+            Preprocessor::create(absl::StrCat(args, " -I", (dir / "include").string()));
+        EXPECT_TRUE(preprocessor.has_value());
+        std::string out;
+        bool result = preprocessor->run(dir / "main.p4", out);
+        if (ok)
+            *ok = result;
+        else
+            EXPECT_TRUE(result);
+        return out;
+    }
+
+    /// The text of @p output, without line markers and empty lines.
+    static std::string text(const std::string &output) {
+        std::istringstream lines(output);
+        std::string result;
+        for (std::string line; std::getline(lines, line);) {
+            if (line.empty() || line.rfind("# ", 0) == 0) continue;
+            result += line + "\n";
+        }
+        return result;
+    }
+};
+
+TEST_F(PreprocessorTest, Arguments) {
+    EXPECT_TRUE(Preprocessor::create(""));
+    EXPECT_TRUE(Preprocessor::create(" -I/usr/include -I \"a dir\" -DX=1 -D Y -UZ"));
+    EXPECT_FALSE(Preprocessor::create(" -M"));
+    EXPECT_FALSE(Preprocessor::create(" -I"));
+    EXPECT_FALSE(Preprocessor::create("-DX=\"1"));
+}
+
+TEST_F(PreprocessorTest, Macros) {
+    auto out = preprocess(R"(#define N 8
+#define F(x, y) (x + y)
+#define S(x) #x
+#define C(a, b) a##b
+#define V(fmt, ...) fmt, ## __VA_ARGS__
+#define P +
+bit<N> F(1, F(2, 3)) S( a  "b" ) C(x, y) C(, z) V(1) V(1, 2, 3) +P
+F
+(4, 5) C(F, G) CMD
+)",
+                          "-DCMD=cmd -DGONE -UGONE");
+    EXPECT_EQ(text(out),
+              "bit<8> (1 + (2 + 3)) \"a \\\"b\\\"\" xy z 1 1, 2, 3 + +\n"
+              "(4 + 5) FG cmd\n");
+}
+
+TEST_F(PreprocessorTest, Recursion) {
+    auto out = preprocess(R"(#define A B + 1
+#define B A
+#define f(x) x f
+A f(f)(1)
+)");
+    EXPECT_EQ(text(out), "A + 1 f f(1)\n");
+}
+
+TEST_F(PreprocessorTest, Conditionals) {
+    auto out = preprocess(R"(#define ONE 1
+#if ONE && defined(ONE) && !defined TWO && (1 << 4) == 0x10 && -1 < 0 && UNDEFINED == 0
+a
+#elif 1
+b
+#endif
+#if 0
+#if garbage (
+#endif
+#elif 2 > 1 ? 0 : 1
+c
+#else
+d
+#endif
+#ifdef ONE
+e
+#endif
+#ifndef ONE
+f
+#endif
+)");
+    EXPECT_EQ(text(out), "a\nd\ne\n");
+}
+
+TEST_F(PreprocessorTest, Includes) {
+    write("local.p4", "local __FILE__ __INCLUDE_LEVEL__\n");
+    write("include/system.p4", "#pragma once\nsystem\n");
+    auto main = (dir / "main.p4").string();
+    auto out = preprocess(R"(#include "local.p4"
+#include <system.p4>
+#include <system.p4>
+#if __has_include(<system.p4>) && !__has_include("missing.p4")
+__LINE__
+#endif
+)");
+    auto local = (dir / "local.p4").string();
+    auto system = (dir / "include/system.p4").string();
+    EXPECT_EQ(out, absl::StrCat("# 1 \"", main, "\"\n", "# 1 \"", local, "\" 1\n", "local \"",
+                                local, "\" 1\n", "# 2 \"", main, "\" 2\n", "# 1 \"", system,
+                                "\" 1\n\n", "system\n", "# 3 \"", main, "\" 2\n\n\n", "5\n"));
+}
+
+TEST_F(PreprocessorTest, IncludeGuards) {
+    write("include/guarded.p4",
+          "// comment\n#ifndef GUARDED\n#define GUARDED\nguarded\n#endif\n");
+    auto out = preprocess("#include <guarded.p4>\n#include <guarded.p4>\n");
+    EXPECT_EQ(text(out), "// comment\nguarded\n");
+
+    // Cached files are read again when they change.
+    write("include/guarded.p4", "changed\n");
+    out = preprocess("#include <guarded.p4>\n#include <guarded.p4>\n");
+    EXPECT_EQ(text(out), "changed\nchanged\n");
+}
+
+TEST_F(PreprocessorTest, LineNumbers) {
+    auto out = preprocess(
+        "a\n\n\nb\n\n\n\n\n\n\n\n\n\n\nc /* two\nlines */ d\ne \\\nf\n#line 100 \"other.p4\"\n"
+        "g __LINE__ __FILE__\n");
+    auto main = (dir / "main.p4").string();
+    EXPECT_EQ(out, absl::StrCat("# 1 \"", main, "\"\na\n\n\nb\n# 15 \"", main,
+                                "\"\nc /* two\nlines */ d\ne f\n# 100 \"other.p4\"\n",
+                                "g 100 \"other.p4\"\n"));
+}
+
+TEST_F(PreprocessorTest, PassesUnknownDirectives) {
+    auto out = preprocess("#pragma anything\n#foo bar\n");
+    EXPECT_EQ(text(out), "#foo bar\n");
+}
+
+TEST_F(PreprocessorTest, Errors) {
+    bool ok = true;
+    preprocess("#error stop here\n", "", &ok);
+    EXPECT_FALSE(ok);
+    EXPECT_EQ(errorCount(), 1u);
+
+    preprocess("#include \"missing.p4\"\n", "", &ok);
+    EXPECT_FALSE(ok);
+
+    preprocess("#if 1 / 0\n#endif\n", "", &ok);
+    EXPECT_FALSE(ok);
+
+    preprocess("#if 1\n", "", &ok);
+    EXPECT_FALSE(ok);
+
+    preprocess("#define F(x) x\nF(1, 2)\n", "", &ok);
+    EXPECT_FALSE(ok);
+    EXPECT_EQ(errorCount(), 5u);
+}
+
+TEST_F(PreprocessorTest, ParserOptions) {
+    write("main.p4", "#define X x\nX Y\n");
+    CompilerOptions options;
+    options.file = dir / "main.p4";
+    options.preprocessor_options = cstring(" -DY=y");
+    auto result = options.preprocess();
+    ASSERT_TRUE(result.has_value());
+    std::string out;
+    char buffer[256];
+    while (size_t size = fread(buffer, 1, sizeof(buffer), result->get()))
+        out.append(buffer, size);
+    EXPECT_EQ(text(out), "x y\n");
+}
+
+}  // namespace P4::Test
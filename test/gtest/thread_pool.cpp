@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "lib/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "helpers.h"
+#include "lib/compile_context.h"
+
+namespace P4::Test {
+
+class ThreadPoolTest : public P4CTest {};
+
+TEST_F(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(1000);
+    parallel_for(pool, 4, 0, visits.size(), [&](size_t i) { ++visits[i]; });
+    for (auto &count : visits) EXPECT_EQ(count.load(), 1);
+
+    // An empty range does not call the body.
+    parallel_for(pool, 4, 5, 5, [](size_t) { FAIL(); });
+}
+
+TEST_F(ThreadPoolTest, WaitRethrowsException) {
+    ThreadPool pool(2);
+    std::atomic<int> finished = 0;
+    TaskGroup group(pool);
+    for (int i = 0; i < 8; ++i) {
+        group.run([&finished, i] {
+            if (i == 3) throw std::runtime_error("task failed");
+            ++finished;
+        });
+    }
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(finished.load(), 7);
+
+    // The exception is only reported once.
+    EXPECT_NO_THROW(group.wait());
+}
+
+TEST_F(ThreadPoolTest, TasksRunInCompileContext) {
+    ThreadPool pool(4);
+    auto *context = &CompileContextStack::top<ICompileContext>();
+    std::atomic<int> matches = 0;
+    parallel_for(pool, 4, 0, 64, [&](size_t) {
+        if (&CompileContextStack::top<ICompileContext>() == context) ++matches;
+    });
+    EXPECT_EQ(matches.load(), 64);
+}
+
+TEST_F(ThreadPoolTest, NestedGroups) {
+    // Fewer workers than outer tasks: the inner groups must not wait for busy workers.
+    ThreadPool pool(2);
+    std::atomic<int> count = 0;
+    parallel_for(pool, 8, 0, 8, [&](size_t) {
+        parallel_for(pool, 8, 0, 16, [&](size_t) { ++count; });
+    });
+    EXPECT_EQ(count.load(), 8 * 16);
+}
+
+TEST_F(ThreadPoolTest, PoolWithoutWorkers) {
+    // The tasks run on the waiting thread.
+    ThreadPool pool(0);
+    std::atomic<int> count = 0;
+    parallel_for(pool, 4, 0, 10, [&](size_t) { ++count; });
+    EXPECT_EQ(count.load(), 10);
+}
+
+}  // namespace P4::Test
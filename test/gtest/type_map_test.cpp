@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2026 The P4 Language Consortium
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "frontends/common/parseInput.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "ir/pass_manager.h"
+
+using namespace P4;
+
+namespace P4::Test {
+
+TEST(TypeMap, CanonicalTypes) {
+    TypeMap typeMap;
+    auto *b8 = IR::Type_Bits::get(8);
+    auto *b16 = IR::Type_Bits::get(16);
+
+    auto *t1 = new IR::Type_Tuple({b8, b16});
+    auto *t2 = new IR::Type_Tuple({IR::Type_Bits::get(8), IR::Type_Bits::get(16)});
+    auto *t3 = new IR::Type_Tuple({b16, b8});
+    auto *l1 = new IR::Type_List({b8, b16});
+    EXPECT_EQ(typeMap.getCanonical(t1), t1);
+    EXPECT_EQ(typeMap.getCanonical(t2), t1);
+    EXPECT_EQ(typeMap.getCanonical(t3), t3);
+    EXPECT_EQ(typeMap.getCanonical(l1), l1);
+
+    auto *s1 = new IR::Type_Array(t2, new IR::Constant(4));
+    auto *s2 = new IR::Type_Array(t1, new IR::Constant(4));
+    auto *s3 = new IR::Type_Array(t1, new IR::Constant(5));
+    EXPECT_EQ(typeMap.getCanonical(s1), s1);
+    EXPECT_EQ(typeMap.getCanonical(s2), s1);
+    EXPECT_EQ(typeMap.getCanonical(s3), s3);
+}
+
+TEST(TypeMap, CanonicalTypesScale) {
+    // Thousands of distinct tuple types used to make canonicalization quadratic.
+    TypeMap typeMap;
+    std::vector<const IR::Type *> canonical;
+    for (int i = 1; i <= 5000; ++i)
+        canonical.push_back(typeMap.getCanonical(
+            new IR::Type_Tuple({IR::Type_Bits::get(i), IR::Type_Boolean::get()})));
+    for (int i = 1; i <= 5000; ++i)
+        EXPECT_EQ(typeMap.getCanonical(
+                      new IR::Type_Tuple({IR::Type_Bits::get(i), IR::Type_Boolean::get()})),
+                  canonical[i - 1]);
+}
+
+struct IncrementalTypeChecking : P4CTest {
+    IncrementalTypeChecking() { TypeMap::incremental = TypeMap::Incremental::Verify; }
+    ~IncrementalTypeChecking() override { TypeMap::incremental = TypeMap::Incremental::Off; }
+
+    const IR::P4Program *program = P4::parseP4String(P4_SOURCE(R"(
+        control proto(inout bit<8> x);
+        package top(proto p);
+        control c(inout bit<8> x) {
+            bit<8> y = 8w3;
+            apply {
+                x = x + 8w1;
+                y = y;
+            }
+        }
+        top(c()) main;
+    )"));
+    TypeMap typeMap;
+};
+
+TEST_F(IncrementalTypeChecking, ReplacedExpression) {
+    ASSERT_TRUE(program);
+    // Replacing constants leaves all declared types unchanged, so the type map is kept
+    // and checked against a full type inference by the second type checking.
+    const IR::Constant *replaced = nullptr;
+    struct ReplaceConstant : public Transform {
+        const IR::Constant *&replaced;
+        explicit ReplaceConstant(const IR::Constant *&replaced) : replaced(replaced) {}
+        const IR::Node *postorder(IR::Constant *c) override {
+            return replaced = new IR::Constant(c->srcInfo, c->type, 5);
+        }
+    };
+    PassManager incremental({new TypeChecking(nullptr, &typeMap), new ReplaceConstant(replaced),
+                             new ClearTypeMap(&typeMap), new TypeChecking(nullptr, &typeMap)});
+    program = program->apply(incremental);
+    ASSERT_TRUE(program);
+    ASSERT_TRUE(replaced);
+    EXPECT_EQ(::P4::errorCount(), 0);
+    EXPECT_NE(typeMap.getType(replaced), nullptr);
+}
+
+TEST_F(IncrementalTypeChecking, ChangedDeclaredType) {
+    ASSERT_TRUE(program);
+    // Changing the type of a variable invalidates the types of its uses, so the map is
+    // cleared and recomputed.
+    struct WidenVariable : public Transform {
+        const IR::Node *postorder(IR::Declaration_Variable *decl) override {
+            decl->type = IR::Type_Bits::get(16);
+            decl->initializer = new IR::Constant(IR::Type_Bits::get(16), 3);
+            return decl;
+        }
+    };
+    PassManager changes({new TypeChecking(nullptr, &typeMap), new WidenVariable,
+                         new ClearTypeMap(&typeMap), new TypeChecking(nullptr, &typeMap)});
+    program = program->apply(changes);
+    ASSERT_TRUE(program);
+    EXPECT_EQ(::P4::errorCount(), 0);
+    const IR::PathExpression *use = nullptr;
+    forAllMatching<IR::PathExpression>(program, [&](const IR::PathExpression *path) {
+        if (path->path->name == "y") use = path;
+    });
+    ASSERT_TRUE(use);
+    auto type = typeMap.getType(use);
+    ASSERT_TRUE(type);
+    EXPECT_EQ(type->width_bits(), 16);
+}
+
+}  // namespace P4::Test
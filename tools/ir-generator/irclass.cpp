@@ -5,6 +5,9 @@
 
 #include "irclass.h"
 
+#include <cstdint>
+#include <string_view>
+
 #include "lib/enumerator.h"
 #include "lib/exceptions.h"
 
@@ -131,6 +134,8 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
         << std::endl;
 
     impl << "#include \"ir/ir-generated.h\"    // IWYU pragma: keep\n\n"
+         << "#include \"ir/binary_reader.h\"   // IWYU pragma: keep\n"
+         << "#include \"ir/binary_writer.h\"   // IWYU pragma: keep\n"
          << "#include \"ir/ir-inline.h\"       // IWYU pragma: keep\n"
          << "#include \"ir/json_generator.h\"  // IWYU pragma: keep\n"
          << "#include \"ir/json_loader.h\"     // IWYU pragma: keep\n"
@@ -141,7 +146,8 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
          << "using namespace P4;\n"
          << std::endl;
 
-    out << "#include <functional>\n"
+    out << "#include <cstdint>\n"
+        << "#include <functional>\n"
         << "#include <map>\n\n"
         << "#include \"lib/big_int.h\"        // IWYU pragma: keep\n"
         << "// Special IR classes and types\n"
@@ -158,9 +164,16 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
         << std::endl
         << "class JSONLoader;\n"
         << "using NodeFactoryFn = IR::Node*(*)(JSONLoader&);\n"
+        << "class BinaryReader;\n"
+        << "class BinaryWriter;\n"
+        << "using BinaryNodeFactoryFn = IR::Node*(*)(BinaryReader&);\n"
         << std::endl
         << "namespace IR {\n"
         << "extern std::map<cstring, NodeFactoryFn> unpacker_table;\n"
+        << "extern std::map<cstring, BinaryNodeFactoryFn> binary_unpacker_table;\n"
+        << "/// Fingerprint of the classes and fields of the IR, so that binary snapshots\n"
+        << "/// of a different IR are rejected rather than misread.\n"
+        << "extern const uint64_t binary_schema;\n"
         << "using namespace P4::literals;\n"
         << "}\n";
 
@@ -180,6 +193,37 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
     }
     impl << " };\n" << std::endl;
 
+    impl << "std::map<cstring, BinaryNodeFactoryFn> IR::binary_unpacker_table = {\n";
+    // FNV-1a over the names and field types of all classes, in declaration order.
+    uint64_t schema = 0xcbf29ce484222325ULL;
+    auto addToSchema = [&schema](std::string_view text) {
+        for (unsigned char c : text) schema = (schema ^ c) * 0x100000001b3ULL;
+        schema = (schema ^ ';') * 0x100000001b3ULL;
+    };
+    first = true;
+    for (auto cls : *getClasses()) {
+        addToSchema(cls->fullName());
+        for (auto *f : *cls->getFields()) {
+            if (f->type) {
+                addToSchema(f->type->toString().string_view());
+            } else if (auto *varF = f->to<IrVariantField>()) {
+                for (const auto *type : *varF->types) addToSchema(type->toString().string_view());
+            }
+            addToSchema(f->name.string_view());
+        }
+        if (cls->kind == NodeKind::Concrete) {
+            if (first)
+                first = false;
+            else
+                impl << ",\n";
+            impl << "{\"" << cls->name << "\"_cs, BinaryNodeFactoryFn(&IR::";
+            if (cls->containedIn && cls->containedIn->name) impl << cls->containedIn->name << "::";
+            impl << cls->name << "::fromBinary)}";
+        }
+    }
+    impl << " };\n" << std::endl;
+    impl << "const uint64_t IR::binary_schema = " << schema << "ULL;\n" << std::endl;
+
     impl << "template class IR::Vector<IR::Node>;" << std::endl;
     out << "extern template class IR::Vector<IR::Node>;" << std::endl;
     impl << "template class IR::IndexedVector<IR::Node>;" << std::endl;
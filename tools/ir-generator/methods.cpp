@@ -384,6 +384,50 @@ const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
               << cl->indent << "return rv;\n}";
           return {buf};
       }}},
+    {"toBinary"_cs,
+     {&NamedType::Void(),
+      {new IrField(new ReferenceType(&NamedType::BinaryWriter()), "out"_cs)},
+      CONST + IN_IMPL + OVERRIDE + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{" << std::endl;
+          if (auto parent = cl->getParent())
+              buf << cl->indent << parent->qualified_name(cl->containedIn) << "::toBinary(out);"
+                  << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (f->type && *f->type == NamedType::SourceInfo())
+                  continue;  // like toJSON, does not save the SourceInfo
+              buf << cl->indent << "out.write(" << f->name << ");" << std::endl;
+          }
+          buf << "}";
+          return {buf};
+      }}},
+    // Constructors are named after the class; the key only identifies the generator.
+    {"BinaryReader constructor"_cs,
+     {nullptr,
+      {new IrField(new ReferenceType(&NamedType::BinaryReader()), "in"_cs)},
+      IN_IMPL + CONSTRUCTOR + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          if (auto parent = cl->getParent())
+              buf << ": " << parent->qualified_name(cl->containedIn) << "(in)";
+          buf << " {" << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (f->type && *f->type == NamedType::SourceInfo()) continue;
+              buf << cl->indent << "in.read(" << f->name << ");" << std::endl;
+          }
+          buf << "}";
+          return {buf};
+      }}},
+    {"fromBinary"_cs,
+     {nullptr,
+      {new IrField(new ReferenceType(&NamedType::BinaryReader()), "in"_cs)},
+      FACTORY + IN_IMPL + CONCRETE_ONLY,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{ return new " << cl->name << "(in); }";
+          return {buf};
+      }}},
     {"toString"_cs,
      {&NamedType::Cstring(),
       {},
@@ -462,7 +506,7 @@ void IrClass::generateMethods() {
         if (!IrMethod::Generate.count(m->name))
             throw Util::CompilationError("Unrecognized predefined method %1%", m->name);
         auto &info = IrMethod::Generate.at(m->name);
-        if (m->name) {
+        if (m->name && !(info.flags & CONSTRUCTOR)) {
             if (info.rtype) {
                 // This predefined method has an explicit return type.
                 m->rtype = info.rtype;
@@ -110,6 +110,16 @@ NamedType &NamedType::JSONLoader() {
     return nt;
 }
 
+NamedType &NamedType::BinaryWriter() {
+    static NamedType nt("BinaryWriter"_cs);
+    return nt;
+}
+
+NamedType &NamedType::BinaryReader() {
+    static NamedType nt("BinaryReader"_cs);
+    return nt;
+}
+
 NamedType &NamedType::JSONObject() {
     static NamedType nt("JSONObject"_cs);
     return nt;
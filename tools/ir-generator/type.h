@@ -102,6 +102,8 @@ class NamedType : public Type {
     static NamedType &JSONGenerator();
     static NamedType &JSONLoader();
     static NamedType &JSONObject();
+    static NamedType &BinaryWriter();
+    static NamedType &BinaryReader();
     static NamedType &SourceInfo();
 };
 